@@ -0,0 +1,168 @@
+/* NOTE: `clock_gettime' and `pthread_barrier_t' are POSIX */
+#ifndef _POSIX_C_SOURCE
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <mir/common/concurrent/mpmc.h>
+#include <mir/common/mem.h> /* MIR_AlignedFree, MIR_CacheAlignedRealloc */
+
+
+/*
+ * Every thread pushes an element and then pops one, `OPS / threads` times.
+ * The same workload is run against `MIR_MPMC` and against a ring guarded by a
+ * single mutex.
+ *
+ * USAGE: mpmc_bench [max threads (64)] [ops per run (4000000)]
+ */
+
+
+#define QUEUE_CAP 1024u
+
+/* NOTE: the library may be built without its std allocator wrappers, but the
+ *       bench itself always has `realloc' (the slots are then not aligned to
+ *       cache lines) */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define QUEUE_REALLOC MIR_CacheAlignedRealloc
+#    define QUEUE_FREE MIR_AlignedFree
+#else
+#    define QUEUE_REALLOC realloc
+#    define QUEUE_FREE free
+#endif
+
+
+struct LockedRing {
+    pthread_mutex_t lock;
+    size_t data[QUEUE_CAP];
+    size_t head;
+    size_t len;
+};
+
+struct Run {
+    pthread_barrier_t start;
+    struct MIR_MPMC mpmc;
+    struct LockedRing locked;
+    size_t opsPerThread;
+    int useMPMC;
+};
+
+
+/* NOTE: every thread pops only after it has pushed, so the ring is never
+ *       empty on pop and never holds more than `threads` elements */
+static void LockedPush(struct LockedRing *r, size_t v) {
+    pthread_mutex_lock(&r->lock);
+    r->data[(r->head + r->len) % QUEUE_CAP] = v;
+    ++r->len;
+    pthread_mutex_unlock(&r->lock);
+}
+
+static size_t LockedPop(struct LockedRing *r) {
+    size_t v;
+
+    pthread_mutex_lock(&r->lock);
+    v = r->data[r->head];
+    r->head = (r->head + 1u) % QUEUE_CAP;
+    --r->len;
+    pthread_mutex_unlock(&r->lock);
+    return v;
+}
+
+static void *Worker(void *arg) {
+    struct Run *run = (struct Run *)arg;
+    size_t sum = 0;
+    size_t i;
+    size_t v;
+
+    pthread_barrier_wait(&run->start);
+    for (i = 0; i < run->opsPerThread; ++i) {
+        if (run->useMPMC) {
+            MIR_MPMC_Push(&run->mpmc, &i);
+            MIR_MPMC_Pop(&run->mpmc, &v);
+        } else {
+            LockedPush(&run->locked, i);
+            v = LockedPop(&run->locked);
+        }
+        sum += v;
+    }
+    return (void *)sum;
+}
+
+static double Now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* NOTE: returns millions of push+pop pairs per second */
+static double Measure(struct Run *run, size_t threads, size_t ops) {
+    pthread_t *tids = (pthread_t *)malloc(threads * sizeof(*tids));
+    double t0;
+    double t1;
+    size_t i;
+
+    if (tids == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    run->opsPerThread = ops / threads;
+    pthread_barrier_init(&run->start, NULL, (unsigned)threads + 1u);
+    for (i = 0; i < threads; ++i) {
+        if (pthread_create(&tids[i], NULL, Worker, run) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    pthread_barrier_wait(&run->start);
+    t0 = Now();
+    for (i = 0; i < threads; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+    t1 = Now();
+
+    pthread_barrier_destroy(&run->start);
+    free(tids);
+    return (double)(run->opsPerThread * threads) / (t1 - t0) * 1e-6;
+}
+
+
+int main(int argc, char *argv[]) {
+    static struct Run run;
+    size_t maxThreads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64u;
+    size_t ops = (argc > 2) ? strtoul(argv[2], NULL, 10) : 4000000u;
+    size_t threads;
+
+    if (maxThreads == 0u || maxThreads > QUEUE_CAP || ops == 0u) {
+        fprintf(stderr, "USAGE: %s [max threads] [ops per run]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (MIR_MPMC_InitByReallocF(
+            QUEUE_REALLOC, &run.mpmc, QUEUE_CAP, sizeof(size_t)
+        ) != MIR_MPMC_OK) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    pthread_mutex_init(&run.locked.lock, NULL);
+
+    printf("%8s %16s %16s\n", "threads", "MIR_MPMC Mop/s", "mutex Mop/s");
+    for (threads = 1; threads <= maxThreads; threads *= 2u) {
+        double mpmc;
+        double locked;
+
+        run.useMPMC = 1;
+        mpmc = Measure(&run, threads, ops);
+        run.useMPMC = 0;
+        locked = Measure(&run, threads, ops);
+        printf("%8zu %16.2f %16.2f\n", threads, mpmc, locked);
+    }
+
+    pthread_mutex_destroy(&run.locked.lock);
+    MIR_MPMC_DeinitByFreeF(QUEUE_FREE, &run.mpmc);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/**
+ * \file
+ *
+ * \brief Atomic operations.
+ *
+ * \details Thin wrappers that expand either into C11 `<stdatomic.h>` generic
+ * functions (if \ref MIR_HAS_C11_ATOMICS is defined) or into GCC/Clang
+ * `__atomic` builtins (if \ref MIR_HAS_GNU_ATOMICS is defined). Including this
+ * header is an error if neither is available.
+ *
+ * Objects accessed by these macros **MUST** be declared with \ref MIR_Atomic
+ * and **MUST** be accessed only by these macros.
+ *
+ * Memory orders:
+ * + \ref MIR_ATOMIC_RELAXED
+ * + \ref MIR_ATOMIC_ACQUIRE
+ * + \ref MIR_ATOMIC_RELEASE
+ * + \ref MIR_ATOMIC_ACQ_REL
+ * + \ref MIR_ATOMIC_SEQ_CST
+ */
+
+
+#ifndef _MIR_COMMON_ATOMIC_H
+#define _MIR_COMMON_ATOMIC_H
+
+
+#include <mir/common/env.h>
+
+
+#if defined(MIR_HAS_C11_ATOMICS)
+
+#    include <stdatomic.h>
+
+/**
+ * \brief Declares an atomic object of the given type.
+ *
+ * \param type integer or pointer type. **MAY** consist of several tokens
+ */
+#    define MIR_Atomic(type) _Atomic(type)
+
+#    define MIR_ATOMIC_RELAXED memory_order_relaxed
+#    define MIR_ATOMIC_ACQUIRE memory_order_acquire
+#    define MIR_ATOMIC_RELEASE memory_order_release
+#    define MIR_ATOMIC_ACQ_REL memory_order_acq_rel
+#    define MIR_ATOMIC_SEQ_CST memory_order_seq_cst
+
+#    define MIR_Atomic_Init(obj, val) atomic_init((obj), (val))
+#    define MIR_Atomic_Load(obj, order) atomic_load_explicit((obj), (order))
+#    define MIR_Atomic_Store(obj, val, order)                                  \
+        atomic_store_explicit((obj), (val), (order))
+#    define MIR_Atomic_Exchange(obj, val, order)                               \
+        atomic_exchange_explicit((obj), (val), (order))
+#    define MIR_Atomic_FetchAdd(obj, val, order)                               \
+        atomic_fetch_add_explicit((obj), (val), (order))
+#    define MIR_Atomic_FetchSub(obj, val, order)                               \
+        atomic_fetch_sub_explicit((obj), (val), (order))
+#    define MIR_Atomic_CompareExchangeWeak(obj, expected, desired, succ, fail) \
+        atomic_compare_exchange_weak_explicit(                                 \
+            (obj), (expected), (desired), (succ), (fail)                       \
+        )
+#    define MIR_Atomic_CompareExchangeStrong(                                  \
+        obj, expected, desired, succ, fail                                     \
+    )                                                                          \
+        atomic_compare_exchange_strong_explicit(                               \
+            (obj), (expected), (desired), (succ), (fail)                       \
+        )
+#    define MIR_Atomic_ThreadFence(order) atomic_thread_fence(order)
+
+#elif defined(MIR_HAS_GNU_ATOMICS)
+
+#    define MIR_Atomic(type) type
+
+#    define MIR_ATOMIC_RELAXED __ATOMIC_RELAXED
+#    define MIR_ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#    define MIR_ATOMIC_RELEASE __ATOMIC_RELEASE
+#    define MIR_ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#    define MIR_ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+#    define MIR_Atomic_Init(obj, val) (void)(*(obj) = (val))
+#    define MIR_Atomic_Load(obj, order) __atomic_load_n((obj), (order))
+#    define MIR_Atomic_Store(obj, val, order)                                  \
+        __atomic_store_n((obj), (val), (order))
+#    define MIR_Atomic_Exchange(obj, val, order)                               \
+        __atomic_exchange_n((obj), (val), (order))
+#    define MIR_Atomic_FetchAdd(obj, val, order)                               \
+        __atomic_fetch_add((obj), (val), (order))
+#    define MIR_Atomic_FetchSub(obj, val, order)                               \
+        __atomic_fetch_sub((obj), (val), (order))
+#    define MIR_Atomic_CompareExchangeWeak(obj, expected, desired, succ, fail) \
+        __atomic_compare_exchange_n(                                           \
+            (obj), (expected), (desired), 1, (succ), (fail)                    \
+        )
+#    define MIR_Atomic_CompareExchangeStrong(                                  \
+        obj, expected, desired, succ, fail                                     \
+    )                                                                          \
+        __atomic_compare_exchange_n(                                           \
+            (obj), (expected), (desired), 0, (succ), (fail)                    \
+        )
+#    define MIR_Atomic_ThreadFence(order) __atomic_thread_fence(order)
+
+#else
+#    error "mirlib: neither C11 atomics nor GCC/Clang atomic builtins available"
+#endif
+
+
+/**
+ * \def MIR_Atomic_SpinPause
+ *
+ * \brief Hints the CPU that the caller is busy-waiting (`pause` on x86,
+ * `yield` on AArch64). Expands to nothing elsewhere.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#    define MIR_Atomic_SpinPause() __builtin_ia32_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+#    define MIR_Atomic_SpinPause() __asm__ __volatile__("yield")
+#else
+#    define MIR_Atomic_SpinPause() ((void)0)
+#endif
+
+
+#endif /* _MIR_COMMON_ATOMIC_H */
@@ -0,0 +1,122 @@
+/**
+ * \file
+ *
+ * \brief Bit manipulation utilities.
+ *
+ * \details The functions expand into compiler builtins where available and
+ * into portable loops otherwise.
+ */
+
+
+#ifndef _MIR_COMMON_BITS_H
+#define _MIR_COMMON_BITS_H
+
+
+#include <stdint.h> /* uint32_t, uint64_t */
+
+#include <mir/common/macros.h> /* MIR_INLINE */
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h> /* _BitScanForward, _BitScanReverse, __popcnt */
+#endif
+
+
+/**
+ * \brief Counts trailing zero bits.
+ *
+ * \param x value. **MUST NOT** be `0`
+ *
+ * \return number of trailing zero bits
+ */
+MIR_INLINE unsigned MIR_Bits_Ctz32(uint32_t x) {
+#if defined(__clang__) || defined(__GNUC__)
+    return (unsigned)__builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    (void)_BitScanForward(&idx, x);
+    return (unsigned)idx;
+#else
+    unsigned n = 0;
+    while ((x & 1u) == 0u) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * \brief Counts trailing zero bits.
+ *
+ * \param x value. **MUST NOT** be `0`
+ *
+ * \return number of trailing zero bits
+ */
+MIR_INLINE unsigned MIR_Bits_Ctz64(uint64_t x) {
+#if defined(__clang__) || defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    return ((uint32_t)x != 0u) ? MIR_Bits_Ctz32((uint32_t)x)
+                               : 32u + MIR_Bits_Ctz32((uint32_t)(x >> 32));
+#endif
+}
+
+/**
+ * \brief Counts leading zero bits.
+ *
+ * \param x value. **MUST NOT** be `0`
+ *
+ * \return number of leading zero bits
+ */
+MIR_INLINE unsigned MIR_Bits_Clz32(uint32_t x) {
+#if defined(__clang__) || defined(__GNUC__)
+    return (unsigned)__builtin_clz(x);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    (void)_BitScanReverse(&idx, x);
+    return 31u - (unsigned)idx;
+#else
+    unsigned n = 0;
+    while ((x & 0x80000000u) == 0u) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * \brief Counts leading zero bits.
+ *
+ * \param x value. **MUST NOT** be `0`
+ *
+ * \return number of leading zero bits
+ */
+MIR_INLINE unsigned MIR_Bits_Clz64(uint64_t x) {
+#if defined(__clang__) || defined(__GNUC__)
+    return (unsigned)__builtin_clzll(x);
+#else
+    return ((x >> 32) != 0u) ? MIR_Bits_Clz32((uint32_t)(x >> 32))
+                             : 32u + MIR_Bits_Clz32((uint32_t)x);
+#endif
+}
+
+/**
+ * \brief Counts set bits.
+ *
+ * \param x value
+ *
+ * \return number of set bits
+ */
+MIR_INLINE unsigned MIR_Bits_Popcount64(uint64_t x) {
+#if defined(__clang__) || defined(__GNUC__)
+    return (unsigned)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555u);
+    x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+    return (unsigned)((x * 0x0101010101010101u) >> 56);
+#endif
+}
+
+
+#endif /* _MIR_COMMON_BITS_H */
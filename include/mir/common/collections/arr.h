@@ -14,6 +14,8 @@
 #    include <stdlib.h> /* free, malloc */
 #endif
 
+#include <mir/common/macros.h>    /* MIR_INLINE */
+#include <mir/common/mem.h>       /* MIR_AlignedMalloc, MIR_AlignedFree */
 #include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
 
 
@@ -43,6 +45,10 @@
  * + initialization
  *   - \ref MIR_Arr_Init - by standard library `malloc` function
  *   - \ref MIR_Arr_InitByMallocF - by given malloc-like function
+ *   - \ref MIR_Arr_InitAligned - with given alignment by \ref
+ *     MIR_AlignedMalloc function
+ *   - \ref MIR_Arr_InitByAlignedMallocF - with given alignment by given
+ *     aligned_alloc-like function
  * + get
  *   - \ref MIR_Arr_Get - the element
  *   - \ref MIR_Arr_GetPtr - a pointer to the element
@@ -51,6 +57,7 @@
  * + deinitialization
  *   - \ref MIR_Arr_Deinit - by standard library `free` function
  *   - \ref MIR_Arr_DeinitByFreeF - by given free-like function
+ *   - \ref MIR_Arr_DeinitAligned - by \ref MIR_AlignedFree function
  */
 #define MIR_Arr(type, structTag)                                               \
     struct structTag {                                                         \
@@ -75,6 +82,11 @@ extern int __MIR_Arr_InitByMallocF_impl(
     size_t length, size_t elemSize
 );
 
+extern int __MIR_Arr_InitByAlignedMallocF_impl(
+    void *(*aligned_malloc_f)(size_t, size_t), void const **member_data,
+    size_t *member_len, size_t length, size_t elemSize, size_t alignment
+);
+
 extern void __MIR_Arr_DeinitByFreeF_impl(
     void **member_data, size_t *member_len, void (*freeF)(void *)
 );
@@ -166,11 +178,53 @@ extern void __MIR_Arr_DeinitByFreeF_impl(
             )                                                                  \
         ),                                                                     \
         __MIR_Arr_InitByMallocF_impl(                                          \
-            (mallocF), (void **)&(arr)->data, &(arr)->len,                     \
+            (mallocF), (void const **)&(arr)->data, &(arr)->len,               \
             (length), sizeof(type)                                             \
         )                                                                      \
     ) /* clang-format on */
 
+/**
+ * \brief Inits \ref MIR_Arr struct using giving aligned_alloc-like function as
+ * an allocator.
+ *
+ * \param      type           type of elements. **MUST** be the same type as
+ *                            that passed to \ref MIR_Arr macro. `type`'s
+ *                            `sizeof` **MUST** be greater than `0`
+ * \param      alignedMallocF aligned_alloc-like function, i.e. a function with
+ *                            `void *(size_t alignment, size_t size)` signature
+ *                            (e.g. \ref MIR_AlignedMalloc)
+ * \param[out] arr            pointer to \ref MIR_Arr struct to be initialized
+ * \param      length         number of elements in the array. **MAY** be `0`
+ * \param      alignment      alignment in bytes. **MUST** be a power of two
+ *
+ * \return \ref MIR_Arr_OK on success; any other value indicates failure
+ */
+#define MIR_Arr_InitByAlignedMallocF(                                          \
+    type, alignedMallocF, arr, length, alignment                               \
+)                                                                              \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u,                                             \
+                "`sizeof(type)' MUST be greater than 0"                        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((arr) != NULL, "param `arr' MUST NOT be NULL"),   \
+            __MIR_ASSERT_MSG(                                                  \
+                (alignedMallocF) != NULL,                                      \
+                "param `alignedMallocF' MUST NOT be NULL"                      \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (alignment) != 0u && ((alignment) & ((alignment) - 1u)) == 0u, \
+                "param `alignment' MUST be a power of two"                     \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_Arr_InitByAlignedMallocF_impl(                                   \
+            (alignedMallocF), (void const **)&(arr)->data, &(arr)->len,        \
+            (length), sizeof(type), (alignment)                                \
+        )                                                                      \
+    ) /* clang-format on */
+
 /**
  * \brief Deinits \ref MIR_Arr struct using giving free-like function as a
  * deallocator.
@@ -264,7 +318,126 @@ extern void __MIR_Arr_DeinitByFreeF_impl(
             )                                                                  \
         ) /* clang-format on */
 
+/**
+ * \brief Inits \ref MIR_Arr struct with given alignment using \ref
+ * MIR_AlignedMalloc function as an allocator.
+ *
+ * \param      type      type of elements. **MUST** be the same type as that
+ *                       passed to \ref MIR_Arr macro
+ * \param[out] arr       pointer to \ref MIR_Arr struct to be initialized
+ * \param      length    number of elements in the array. **MAY** be `0`
+ * \param      alignment alignment in bytes. **MUST** be a power of two
+ *
+ * \return \ref MIR_Arr_OK on success; any other value indicates failure
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_Arr_InitAligned(type, arr, length, alignment)                  \
+        MIR_Arr_InitByAlignedMallocF(                                          \
+            type, MIR_AlignedMalloc, arr, length, alignment                    \
+        )
+
+/**
+ * \brief Deinits \ref MIR_Arr struct initialized by \ref MIR_Arr_InitAligned.
+ *
+ * \param[in,out] arr pointer to \ref MIR_Arr struct to be deinitialized
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_Arr_DeinitAligned(arr)                                         \
+        MIR_Arr_DeinitByFreeF(MIR_AlignedFree, arr)
+
 #endif /* MIR_NO_STD_ALLOCATOR */
 
 
+/**
+ * \brief Generates typed functions of the \ref MIR_Arr struct.
+ *
+ * \param type      elements type. **MUST** be the same type as that passed to
+ *                  \ref MIR_Arr macro
+ * \param structTag struct tag. **MUST** be the same as that passed to \ref
+ *                  MIR_Arr macro. It's also used as the functions prefix
+ *
+ * \details The same as \ref MIR_VEC_DEFINE but for \ref MIR_Arr: the
+ * functions evaluate their arguments once and are not expanded at every call
+ * site. All functions are `static`, so unused ones are dropped by the
+ * compiler.
+ *
+ * Generated functions (`arr` is `struct structTag *`; functions returning
+ * `int` return \ref MIR_Arr_OK on success and `1` on failure):
+ * + `int structTag##_InitByMallocF(mallocF, arr, size_t length)`
+ * + `type structTag##_Get(arr, size_t index)`
+ * + `type *structTag##_GetPtr(arr, size_t index)`
+ * + `void structTag##_Set(arr, size_t index, type elem)`
+ * + `void structTag##_DeinitByFreeF(freeF, arr)`
+ * + `structTag##_Init`, `structTag##_Deinit` - the same but by using
+ *   standard library `malloc` and `free` functions
+ */
+#define MIR_ARR_DEFINE(type, structTag)                                        \
+    __MIR_ARR_DEFINE_CORE(type, structTag)                                     \
+    __MIR_ARR_DEFINE_STD(type, structTag)
+
+#define __MIR_ARR_DEFINE_CORE(type, structTag)                                 \
+                                                                               \
+    MIR_INLINE int structTag##_InitByMallocF(                                  \
+        void *(*mallocF)(size_t), struct structTag *arr, size_t length         \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(mallocF != NULL, "param `mallocF' MUST NOT be NULL"); \
+        __MIR_ASSERT_MSG(arr != NULL, "param `arr' MUST NOT be NULL");         \
+        return __MIR_Arr_InitByMallocF_impl(                                   \
+            mallocF, (void const **)&arr->data, &arr->len, length,             \
+            sizeof(type)                                                       \
+        );                                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE type structTag##_Get(                                           \
+        const struct structTag *arr, size_t index                              \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < arr->len, "OOB: param `index' MUST be less than arr->len"  \
+        );                                                                     \
+        return arr->data[index];                                               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE type *structTag##_GetPtr(struct structTag *arr, size_t index) { \
+        __MIR_ASSERT_MSG(                                                      \
+            index < arr->len, "OOB: param `index' MUST be less than arr->len"  \
+        );                                                                     \
+        return &arr->data[index];                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_Set(                                           \
+        struct structTag *arr, size_t index, type elem                         \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < arr->len, "OOB: param `index' MUST be less than arr->len"  \
+        );                                                                     \
+        arr->data[index] = elem;                                               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *arr                           \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+        __MIR_ASSERT_MSG(arr != NULL, "param `arr' MUST NOT be NULL");         \
+        __MIR_Arr_DeinitByFreeF_impl((void **)&arr->data, &arr->len, freeF);   \
+    }
+
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define __MIR_ARR_DEFINE_STD(type, structTag)                              \
+                                                                               \
+        MIR_INLINE int structTag##_Init(struct structTag *arr, size_t length) {\
+            return structTag##_InitByMallocF(malloc, arr, length);             \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE void structTag##_Deinit(struct structTag *arr) {            \
+            structTag##_DeinitByFreeF(free, arr);                              \
+        }
+#else
+#    define __MIR_ARR_DEFINE_STD(type, structTag)
+#endif
+
+
 #endif /* _MIR_COMMON_COLLECTIONS_ARR_H */
@@ -0,0 +1,321 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Art - adaptive radix tree over byte-string keys
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_ART_H
+#define _MIR_COMMON_COLLECTIONS_ART_H
+
+
+#include <stddef.h> /* size_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/encodings/utf8.h> /* MIR_UTF8_BufIter */
+#include <mir/common/macros.h>         /* MIR_INLINE */
+#include <mir/common/slab.h>           /* MIR_Slab */
+
+
+/**
+ * \brief Number of bytes of a compressed path stored in an inner node.
+ *
+ * \details Longer paths are compared optimistically: only the first \ref
+ * MIR_ART_MAX_PREFIX bytes are checked on the way down and the rest is
+ * checked against the leaf. It's used only when building the library.
+ */
+#define MIR_ART_MAX_PREFIX 8u
+
+/**
+ * \brief Adaptive radix tree (ART) mapping byte strings to `void *` values.
+ *
+ * \details Keys are arbitrary byte strings (a key **MAY** be a prefix of
+ * another one and **MAY** contain `'\0'`); they are ordered lexicographically
+ * by unsigned bytes, which for UTF-8 is the code point order. Every inner
+ * node consumes one key byte and is one of four layouts chosen by the number
+ * of its children:
+ * + `Node4`, `Node16` - sorted arrays of key bytes and children. `Node16` is
+ *   searched with one SSE2 compare when available
+ * + `Node48` - 256-byte index into 48 children
+ * + `Node256` - array of 256 children
+ *
+ * Nodes grow and shrink between the layouts as children come and go. Chains
+ * of one-child nodes are collapsed into a prefix of the node below (path
+ * compression), and a key is stored in a leaf hanging right below the first
+ * node where it differs from the others (lazy expansion), so the tree is
+ * never deeper than needed to tell the keys apart.
+ *
+ * Inner nodes are carved out of one \ref MIR_Slab per layout; leaves (a copy
+ * of the key and the value) are allocated one by one. Nodes are aligned to
+ * cache lines if the realloc-like function is (e.g. \ref
+ * MIR_CacheAlignedRealloc); a `Node4` is exactly one cache line.
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_Art_Init, \ref MIR_Art_DeinitByFreeF
+ * + \ref MIR_Art_Len
+ * + \ref MIR_Art_Find, \ref MIR_Art_LongestPrefix
+ * + \ref MIR_Art_PutByReallocF, \ref MIR_Art_RemoveByFreeF
+ * + \ref MIR_Art_PrefixIterByReallocF, \ref MIR_Art_IterNext, \ref
+ *   MIR_Art_IterDeinitByFreeF - keys with a given prefix in the ascending
+ *   order
+ *
+ * \code{.c}
+ * struct MIR_Art routes;
+ * struct MIR_Art_Iter it;
+ * struct MIR_UTF8_BufIter key;
+ * void *val;
+ * MIR_UCP cp;
+ *
+ * MIR_Art_Init(&routes);
+ * MIR_Art_Put(&routes, "/api/users", 10, handler);
+ * ...
+ * if (MIR_Art_PrefixIter(&routes, "/api/", 5, &it) == MIR_Art_OK) {
+ *     while (MIR_Art_IterNext(&it, &key, &val) == MIR_Art_OK) {
+ *         while (MIR_UTF8_BufIter_Next(&key, &cp) != -1) {
+ *             ...
+ *         }
+ *     }
+ *     MIR_Art_IterDeinit(&it);
+ * }
+ * MIR_Art_Deinit(&routes);
+ * \endcode
+ */
+struct MIR_Art {
+    /**
+     * \brief The root: `NULL`, a leaf or an inner node.
+     */
+    void *root;
+
+    size_t len;
+
+    /**
+     * \brief The length of the longest key ever put. Bounds the depth.
+     */
+    size_t maxKeyLen;
+
+    /**
+     * \brief Allocators of `Node4`, `Node16`, `Node48` and `Node256`.
+     */
+    struct MIR_Slab slabs[4];
+};
+
+/**
+ * \brief Position in an inner node of \ref MIR_Art_Iter.
+ */
+struct MIR_Art_Frame {
+    const void *node;
+
+    /**
+     * \brief `0` if the key ending at the node is not visited yet; otherwise
+     * one plus the position where to look for the next child.
+     */
+    unsigned pos;
+};
+
+/**
+ * \brief Iterator over the keys of \ref MIR_Art with a common prefix.
+ *
+ * \warning It's invalidated by modifying the tree.
+ */
+struct MIR_Art_Iter {
+    /**
+     * \brief Stack of the inner nodes being visited.
+     */
+    struct MIR_Art_Frame *frames;
+    size_t depth;
+
+    /**
+     * \brief The only leaf to visit if the prefix leads to a leaf.
+     */
+    const void *leaf;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Art
+ * struct.
+ */
+#define MIR_Art_OK 0
+
+
+/**
+ * \brief Returns the number of keys.
+ */
+MIR_INLINE size_t MIR_Art_Len(const struct MIR_Art *art) {
+    return art->len;
+}
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Inits an empty tree without allocating.
+ *
+ * \param[out] art pointer to \ref MIR_Art struct
+ */
+extern void MIR_Art_Init(struct MIR_Art *art);
+
+/**
+ * \brief Looks up the key.
+ *
+ * \param[in] art pointer to \ref MIR_Art struct
+ * \param[in] key bytes of the key. **MAY** be `NULL` if `len` is `0`
+ * \param     len length of the key in bytes
+ *
+ * \return pointer to the value of the key or `NULL` if it's not in the tree.
+ * The pointer is invalidated by modifying the tree
+ */
+extern void **
+MIR_Art_Find(const struct MIR_Art *art, const void *key, size_t len);
+
+/**
+ * \brief Looks up the longest key of the tree that is a prefix of `key`
+ * (e.g. the most specific route).
+ *
+ * \param[in]  art       pointer to \ref MIR_Art struct
+ * \param[in]  key       bytes of the key. **MAY** be `NULL` if `len` is `0`
+ * \param      len       length of the key in bytes
+ * \param[out] prefixLen pointer where the length of the found key will be
+ *                       written (if found). **MAY** be `NULL`
+ *
+ * \return pointer to the value of the found key or `NULL` if no key of the
+ * tree is a prefix of `key`
+ */
+extern void **MIR_Art_LongestPrefix(
+    const struct MIR_Art *art, const void *key, size_t len, size_t *prefixLen
+);
+
+/**
+ * \brief Puts the value of the key, replacing the old one if the key is
+ * already in the tree.
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in,out] art      pointer to \ref MIR_Art struct
+ * \param[in]     key      bytes of the key. **MAY** be `NULL` if `len` is `0`
+ * \param         len      length of the key in bytes. **MUST** be less than
+ *                         `UINT32_MAX`
+ * \param[in]     val      value
+ *
+ * \return \ref MIR_Art_OK on success; `1` on failure (the tree is left
+ * unchanged)
+ */
+extern int MIR_Art_PutByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Art *art, const void *key,
+    size_t len, void *val
+);
+
+/**
+ * \brief Removes the key.
+ *
+ * \param[in]     freeF free-like function
+ * \param[in,out] art   pointer to \ref MIR_Art struct
+ * \param[in]     key   bytes of the key. **MAY** be `NULL` if `len` is `0`
+ * \param         len   length of the key in bytes
+ * \param[out]    val   pointer where the value of the removed key will be
+ *                      written. **MAY** be `NULL`
+ *
+ * \return \ref MIR_Art_OK if the key has been removed; `1` if it's not in the
+ * tree
+ */
+extern int MIR_Art_RemoveByFreeF(
+    void (*freeF)(void *), struct MIR_Art *art, const void *key, size_t len,
+    void **val
+);
+
+/**
+ * \brief Inits the iterator over the keys starting with `prefix`.
+ *
+ * \details The stack of the iterator is allocated here, so \ref
+ * MIR_Art_IterNext never fails.
+ *
+ * \param[in]  reallocF realloc-like function
+ * \param[in]  art      pointer to \ref MIR_Art struct
+ * \param[in]  prefix   bytes of the prefix. **MAY** be `NULL` if `len` is `0`
+ * \param      len      length of the prefix in bytes. `0` visits all keys
+ * \param[out] iter     pointer to the iterator
+ *
+ * \return \ref MIR_Art_OK on success; `1` on failure
+ */
+extern int MIR_Art_PrefixIterByReallocF(
+    void *(*reallocF)(void *, size_t), const struct MIR_Art *art,
+    const void *prefix, size_t len, struct MIR_Art_Iter *iter
+);
+
+/**
+ * \brief Advances the iterator to the next key in the ascending order.
+ *
+ * \param[in,out] iter pointer to the iterator
+ * \param[out]    key  pointer to the iterator over the bytes of the key
+ *                     (pointing into the tree). `replVal` is set to \ref
+ *                     MIR_REPLACEMENT_CHARACTER_CP and `eofVal` to
+ *                     `UINT_LEAST32_MAX`. **MAY** be `NULL`
+ * \param[out]    val  pointer where the value will be written. **MAY** be
+ *                     `NULL`
+ *
+ * \return \ref MIR_Art_OK on success; `1` if there are no more keys
+ */
+extern int MIR_Art_IterNext(
+    struct MIR_Art_Iter *iter, struct MIR_UTF8_BufIter *key, void **val
+);
+
+/**
+ * \brief Frees the iterator stack by using provided free-like function.
+ */
+extern void
+MIR_Art_IterDeinitByFreeF(void (*freeF)(void *), struct MIR_Art_Iter *iter);
+
+/**
+ * \brief Frees all nodes and leaves and leaves the tree empty.
+ *
+ * \param[in]     freeF free-like function
+ * \param[in,out] art   pointer to \ref MIR_Art struct
+ */
+extern void MIR_Art_DeinitByFreeF(void (*freeF)(void *), struct MIR_Art *art);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Art_PutByReallocF but uses `realloc`.
+ */
+#    define MIR_Art_Put(art, key, len, val)                                    \
+        MIR_Art_PutByReallocF(realloc, (art), (key), (len), (val))
+
+/**
+ * \brief The same as \ref MIR_Art_RemoveByFreeF but uses `free`.
+ */
+#    define MIR_Art_Remove(art, key, len, val)                                 \
+        MIR_Art_RemoveByFreeF(free, (art), (key), (len), (val))
+
+/**
+ * \brief The same as \ref MIR_Art_PrefixIterByReallocF but uses `realloc`.
+ */
+#    define MIR_Art_PrefixIter(art, prefix, len, iter)                         \
+        MIR_Art_PrefixIterByReallocF(realloc, (art), (prefix), (len), (iter))
+
+/**
+ * \brief The same as \ref MIR_Art_IterDeinitByFreeF but uses `free`.
+ */
+#    define MIR_Art_IterDeinit(iter) MIR_Art_IterDeinitByFreeF(free, (iter))
+
+/**
+ * \brief The same as \ref MIR_Art_DeinitByFreeF but uses `free`.
+ */
+#    define MIR_Art_Deinit(art) MIR_Art_DeinitByFreeF(free, (art))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_ART_H */
@@ -0,0 +1,349 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_BitVec utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_BITVEC_H
+#define _MIR_COMMON_COLLECTIONS_BITVEC_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint64_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/macros.h>   /* MIR_INLINE */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Growable bit vector packed into 64-bit words.
+ *
+ * \details Bit `i` is bit `i % 64` of `words[i / 64]`. The bits of the last
+ * word past `len` are always `0`, so whole-word operations never have to mask
+ * them.
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_BitVec_Init, \ref MIR_BitVec_DeinitByFreeF
+ * + \ref MIR_BitVec_ReserveByReallocF, \ref MIR_BitVec_ResizeByReallocF,
+ *   \ref MIR_BitVec_PushByReallocF
+ * + \ref MIR_BitVec_Get, \ref MIR_BitVec_Set, \ref MIR_BitVec_TestAndSet,
+ *   \ref MIR_BitVec_Fill
+ * + \ref MIR_BitVec_And, \ref MIR_BitVec_Or, \ref MIR_BitVec_Xor, \ref
+ *   MIR_BitVec_AndNot - in place, a vector register at a time (AVX2 or SSE2
+ *   if enabled at the library build time)
+ * + \ref MIR_BitVec_Count, \ref MIR_BitVec_FindNext, \ref MIR_BITVEC_FOREACH
+ *   - a word at a time
+ * + \ref MIR_BitVec_Index - `O(1)` rank and `O(log)` select
+ */
+struct MIR_BitVec {
+    uint64_t *words;
+
+    /**
+     * \brief Length in bits.
+     */
+    size_t len;
+
+    /**
+     * \brief Capacity in words.
+     */
+    size_t cap;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_BitVec
+ * struct.
+ */
+#define MIR_BitVec_OK 0
+
+/**
+ * \brief Number of bits in a \ref MIR_BitVec_Index block.
+ */
+#define MIR_BITVEC_BLOCK_BITS 512u
+
+/**
+ * \brief Every this many set bits \ref MIR_BitVec_Index remembers the block of
+ * the bit.
+ */
+#define MIR_BITVEC_SELECT_SAMPLE 4096u
+
+/**
+ * \brief Rank/select directory of a \ref MIR_BitVec.
+ *
+ * \details `blocks[b]` is the number of set bits before the block `b` of \ref
+ * MIR_BITVEC_BLOCK_BITS bits (`blocks[nblocks]` is the total), so rank needs
+ * one lookup and at most 8 word popcounts. `samples[j]` is the block of the
+ * set bit `j * MIR_BITVEC_SELECT_SAMPLE` (`samples[nsamples]` is `nblocks`),
+ * so select binary-searches `blocks` only between two samples. The directory
+ * takes about 1/8 of the bit vector memory.
+ *
+ * \warning The directory describes the bits at the time it was built and
+ * **MUST** be rebuilt after they change. Members **MUST NOT** be modified
+ * directly.
+ */
+struct MIR_BitVec_Index {
+    uint64_t *blocks;
+    size_t *samples;
+    size_t nblocks;
+    size_t nsamples;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref
+ * MIR_BitVec_Index struct.
+ */
+#define MIR_BitVec_Index_OK 0
+
+
+/**
+ * \brief Inits an empty bit vector.
+ *
+ * \param[out] bv pointer to \ref MIR_BitVec struct
+ */
+MIR_INLINE void MIR_BitVec_Init(struct MIR_BitVec *bv) {
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    bv->words = NULL;
+    bv->len = 0;
+    bv->cap = 0;
+}
+
+/**
+ * \brief Returns the bit at the specified index (`0` or `1`).
+ */
+MIR_INLINE int MIR_BitVec_Get(const struct MIR_BitVec *bv, size_t index) {
+    __MIR_ASSERT_MSG(
+        index < bv->len, "OOB: param `index' MUST be less than bv->len"
+    );
+
+    return (int)((bv->words[index / 64u] >> (index % 64u)) & 1u);
+}
+
+/**
+ * \brief Sets the bit at the specified index to `bit != 0`.
+ */
+MIR_INLINE void MIR_BitVec_Set(struct MIR_BitVec *bv, size_t index, int bit) {
+    uint64_t mask = (uint64_t)1 << (index % 64u);
+
+    __MIR_ASSERT_MSG(
+        index < bv->len, "OOB: param `index' MUST be less than bv->len"
+    );
+
+    /* NOTE: branchless: `-(bit != 0)' is either all ones or all zeros */
+    bv->words[index / 64u] = (bv->words[index / 64u] & ~mask) |
+                             (mask & (uint64_t)(-(int64_t)(bit != 0)));
+}
+
+/**
+ * \brief Sets the bit at the specified index and returns its old value.
+ */
+MIR_INLINE int MIR_BitVec_TestAndSet(struct MIR_BitVec *bv, size_t index) {
+    uint64_t mask = (uint64_t)1 << (index % 64u);
+    uint64_t old;
+
+    __MIR_ASSERT_MSG(
+        index < bv->len, "OOB: param `index' MUST be less than bv->len"
+    );
+
+    old = bv->words[index / 64u];
+    bv->words[index / 64u] = old | mask;
+    return (old & mask) != 0u;
+}
+
+/**
+ * \brief Iterates over the indices of the set bits in ascending order.
+ *
+ * \param[in] bv pointer to \ref MIR_BitVec struct. The bits **MAY** be
+ *               changed at indices not greater than the current one
+ * \param     i  `size_t` lvalue receiving the index
+ */
+#define MIR_BITVEC_FOREACH(bv, i)                                              \
+    for ((i) = MIR_BitVec_FindNext((bv), 0); (i) < (bv)->len;                  \
+         (i) = MIR_BitVec_FindNext((bv), (i) + 1u))
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Reserves enough words to hold at least `nbits` bits by using
+ * provided realloc-like function.
+ *
+ * \return \ref MIR_BitVec_OK on success; `1` on failure
+ */
+extern int MIR_BitVec_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, size_t nbits
+);
+
+/**
+ * \brief Changes the length to `nbits` by using provided realloc-like
+ * function. New bits are `0`.
+ *
+ * \return \ref MIR_BitVec_OK on success; `1` on failure
+ */
+extern int MIR_BitVec_ResizeByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, size_t nbits
+);
+
+/**
+ * \brief Appends the bit `bit != 0` by using provided realloc-like function.
+ *
+ * \details Doubles the capacity if the vector is full.
+ *
+ * \return \ref MIR_BitVec_OK on success; `1` on failure
+ */
+extern int MIR_BitVec_PushByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, int bit
+);
+
+/**
+ * \brief Frees the memory by using provided free-like function.
+ */
+extern void
+MIR_BitVec_DeinitByFreeF(void (*freeF)(void *), struct MIR_BitVec *bv);
+
+/**
+ * \brief Sets all bits to `bit != 0`.
+ */
+extern void MIR_BitVec_Fill(struct MIR_BitVec *bv, int bit);
+
+/**
+ * \brief `dst &= src`. The lengths **MUST** be equal.
+ */
+extern void
+MIR_BitVec_And(struct MIR_BitVec *dst, const struct MIR_BitVec *src);
+
+/**
+ * \brief `dst |= src`. The lengths **MUST** be equal.
+ */
+extern void MIR_BitVec_Or(struct MIR_BitVec *dst, const struct MIR_BitVec *src);
+
+/**
+ * \brief `dst ^= src`. The lengths **MUST** be equal.
+ */
+extern void
+MIR_BitVec_Xor(struct MIR_BitVec *dst, const struct MIR_BitVec *src);
+
+/**
+ * \brief `dst &= ~src`. The lengths **MUST** be equal.
+ */
+extern void
+MIR_BitVec_AndNot(struct MIR_BitVec *dst, const struct MIR_BitVec *src);
+
+/**
+ * \brief Returns the number of set bits.
+ */
+extern size_t MIR_BitVec_Count(const struct MIR_BitVec *bv);
+
+/**
+ * \brief Returns the index of the first set bit not less than `from`, or
+ * `bv->len` if there's none.
+ */
+extern size_t MIR_BitVec_FindNext(const struct MIR_BitVec *bv, size_t from);
+
+/**
+ * \brief Builds the rank/select directory of the bit vector by using provided
+ * realloc-like function.
+ *
+ * \param[in]  reallocF realloc-like function
+ * \param[out] idx      pointer to \ref MIR_BitVec_Index struct
+ * \param[in]  bv       pointer to \ref MIR_BitVec struct
+ *
+ * \return \ref MIR_BitVec_Index_OK on success; `1` on failure
+ */
+extern int MIR_BitVec_Index_BuildByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec_Index *idx,
+    const struct MIR_BitVec *bv
+);
+
+/**
+ * \brief Frees the directory by using provided free-like function.
+ */
+extern void MIR_BitVec_Index_DeinitByFreeF(
+    void (*freeF)(void *), struct MIR_BitVec_Index *idx
+);
+
+/**
+ * \brief Returns the number of set bits before the index `pos`.
+ *
+ * \param[in] bv  pointer to \ref MIR_BitVec struct
+ * \param[in] idx pointer to \ref MIR_BitVec_Index struct built for `bv`
+ * \param     pos index. **MUST NOT** be greater than `bv->len`
+ */
+extern size_t MIR_BitVec_Rank(
+    const struct MIR_BitVec *bv, const struct MIR_BitVec_Index *idx, size_t pos
+);
+
+/**
+ * \brief Returns the index of the set bit number `k` (`0` is the first one),
+ * or `bv->len` if there are not that many.
+ *
+ * \param[in] bv  pointer to \ref MIR_BitVec struct
+ * \param[in] idx pointer to \ref MIR_BitVec_Index struct built for `bv`
+ * \param     k   number of the set bit
+ */
+extern size_t MIR_BitVec_Select(
+    const struct MIR_BitVec *bv, const struct MIR_BitVec_Index *idx, size_t k
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_BitVec_ReserveByReallocF but uses standard
+ * library `realloc`.
+ */
+#    define MIR_BitVec_Reserve(bv, nbits)                                      \
+        MIR_BitVec_ReserveByReallocF(realloc, (bv), (nbits))
+
+/**
+ * \brief The same as \ref MIR_BitVec_ResizeByReallocF but uses standard
+ * library `realloc`.
+ */
+#    define MIR_BitVec_Resize(bv, nbits)                                       \
+        MIR_BitVec_ResizeByReallocF(realloc, (bv), (nbits))
+
+/**
+ * \brief The same as \ref MIR_BitVec_PushByReallocF but uses standard library
+ * `realloc`.
+ */
+#    define MIR_BitVec_Push(bv, bit)                                           \
+        MIR_BitVec_PushByReallocF(realloc, (bv), (bit))
+
+/**
+ * \brief The same as \ref MIR_BitVec_DeinitByFreeF but uses standard library
+ * `free`.
+ */
+#    define MIR_BitVec_Deinit(bv) MIR_BitVec_DeinitByFreeF(free, (bv))
+
+/**
+ * \brief The same as \ref MIR_BitVec_Index_BuildByReallocF but uses standard
+ * library `realloc`.
+ */
+#    define MIR_BitVec_Index_Build(idx, bv)                                    \
+        MIR_BitVec_Index_BuildByReallocF(realloc, (idx), (bv))
+
+/**
+ * \brief The same as \ref MIR_BitVec_Index_DeinitByFreeF but uses standard
+ * library `free`.
+ */
+#    define MIR_BitVec_Index_Deinit(idx)                                       \
+        MIR_BitVec_Index_DeinitByFreeF(free, (idx))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_BITVEC_H */
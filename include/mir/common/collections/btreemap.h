@@ -0,0 +1,862 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_BTreeMap utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_BTREEMAP_H
+#define _MIR_COMMON_COLLECTIONS_BTREEMAP_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <string.h> /* memcpy, memmove */
+
+#include <mir/common/macros.h>   /* MIR_INLINE, MIR_PREFETCH */
+#include <mir/common/mem.h>      /* MIR_CacheAlignedRealloc */
+#include <mir/common/search.h>   /* MIR_SEARCH_DEFINE */
+#include <mir/common/slab.h>     /* MIR_Slab */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Number of bytes of keys per \ref MIR_BTreeMap node.
+ *
+ * \details A node holds `MIR_BTREEMAP_NODE_KEY_BYTES / sizeof(K)` keys (but
+ * at least `8`), i.e. the keys of a node span a few cache lines and are
+ * searched without chasing pointers.
+ */
+#define MIR_BTREEMAP_NODE_KEY_BYTES 256u
+
+/**
+ * \brief Maximal height of a \ref MIR_BTreeMap.
+ *
+ * \details Every inner node but the root has at least `4` children, so it's
+ * enough for any number of keys that fits into memory.
+ */
+#define MIR_BTREEMAP_MAX_HEIGHT 32u
+
+/* NOTE: number of keys per node */
+#define __MIR_BTREEMAP_B(K)                                                    \
+    ((sizeof(K) * 8u <= MIR_BTREEMAP_NODE_KEY_BYTES)                           \
+         ? MIR_BTREEMAP_NODE_KEY_BYTES / sizeof(K)                             \
+         : 8u)
+
+/**
+ * \brief Defines an ordered map struct - a B+ tree.
+ *
+ * \param K         key type. **MAY** consist of several tokens
+ * \param V         value type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MUST NOT** be empty
+ *
+ * \details It also defines:
+ * + `struct structTag##_Entry` with members `key` and `val` - the element of
+ *   a sorted array for bulk loading
+ * + `struct structTag##_Node` - a node: `len` keys, followed by `len` values
+ *   (in a leaf) or `len + 1` children (in an inner node). Keys and values are
+ *   stored in separate arrays, so a node search touches only the keys
+ * + `struct structTag##_Iter` - a position in the map
+ *
+ * ## Layout
+ *
+ * All entries are stored in the leaves, which are linked in the key order, so
+ * a range scan is a walk over dense arrays. Key `i` of an inner node is not
+ * greater than any key under child `i + 1` and greater than all keys under
+ * child `i`. Every node but the root is at least half full.
+ *
+ * Nodes come from a \ref MIR_Slab, whose chunks are taken from the
+ * realloc-like function passed to the functions that insert. The standard
+ * allocator variants use \ref MIR_CacheAlignedRealloc, so nodes start at
+ * cache line boundaries.
+ *
+ * Members:
+ *   1. `root` - the root node. `NULL` if the map is empty
+ *   2. `first` - the leftmost leaf. `NULL` if the map is empty
+ *   3. `len` - number of entries
+ *   4. `height` - number of levels. `0` if the map is empty
+ *   5. `slab` - node allocator
+ *
+ * ## Interface
+ *
+ * Functions are generated by \ref MIR_BTreeMap_DEFINE. See it for details.
+ */
+#define MIR_BTreeMap(K, V, structTag)                                          \
+    struct structTag##_Entry {                                                 \
+        K key;                                                                 \
+        V val;                                                                 \
+    };                                                                         \
+    struct structTag##_Node {                                                  \
+        K keys[__MIR_BTREEMAP_B(K)];                                           \
+        union {                                                                \
+            V vals[__MIR_BTREEMAP_B(K)];                                       \
+            struct structTag##_Node *children[__MIR_BTREEMAP_B(K) + 1u];       \
+        } u;                                                                   \
+        struct structTag##_Node *next;                                         \
+        size_t len;                                                            \
+    };                                                                         \
+    struct structTag##_Iter {                                                  \
+        struct structTag##_Node *leaf;                                         \
+        size_t pos;                                                            \
+    };                                                                         \
+    struct structTag {                                                         \
+        struct structTag##_Node *root;                                         \
+        struct structTag##_Node *first;                                        \
+        size_t len;                                                            \
+        size_t height;                                                         \
+        struct MIR_Slab slab;                                                  \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref
+ * MIR_BTreeMap struct.
+ */
+#define MIR_BTreeMap_OK 0
+
+
+/**
+ * \brief Bulk loads a map from a sorted \ref MIR_Arr of `struct
+ * structTag##_Entry` by using provided realloc-like function.
+ *
+ * \see `structTag##_BulkLoadByReallocF` in \ref MIR_BTreeMap_DEFINE
+ */
+#define MIR_BTreeMap_BulkLoadArrByReallocF(structTag, reallocF, map, arr)      \
+    structTag##_BulkLoadByReallocF((reallocF), (map), (arr)->data, (arr)->len)
+
+#ifndef MIR_NO_STD_ALLOCATOR
+/**
+ * \brief The same as \ref MIR_BTreeMap_BulkLoadArrByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc.
+ */
+#    define MIR_BTreeMap_BulkLoadArr(structTag, map, arr)                      \
+        MIR_BTreeMap_BulkLoadArrByReallocF(                                    \
+            structTag, MIR_CacheAlignedRealloc, map, arr                       \
+        )
+#endif
+
+
+/**
+ * \brief Generates the functions of \ref MIR_BTreeMap.
+ *
+ * \param K         key type. **MUST** be the same type as that passed to \ref
+ *                  MIR_BTreeMap macro
+ * \param V         value type. **MUST** be the same type as that passed to
+ *                  \ref MIR_BTreeMap macro
+ * \param structTag struct tag. **MUST** be the same as that passed to \ref
+ *                  MIR_BTreeMap macro. It's also used as the functions prefix
+ * \param LESS      macro or function `int LESS(const K *a, const K *b)` - a
+ *                  strict weak ordering, see \ref MIR_SORT_DEFINE
+ *
+ * \details The functions are `static` (see \ref MIR_INLINE), so the macro
+ * **MAY** be used in headers. Keys and values are copied by `memcpy`.
+ * Pointers to the stored values are invalidated by any insertion or removal.
+ *
+ * ## Generated functions
+ *
+ * \note Functions without `ByReallocF`/`ByFreeF` suffix that allocate or free
+ * will be defined only if `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + `void structTag##_Init(struct structTag *map)` - inits an empty map
+ *   without allocating
+ * + `V *structTag##_Find(const struct structTag *map, const K *key)` - returns
+ *   a pointer to the value or `NULL` if there is no such key
+ * + `int structTag##_PutByReallocF(reallocF, map, const K *key, const V *val)`
+ *   - inserts the entry or overwrites the value of the existing one. On
+ *   failure the map is left untouched
+ * + `int structTag##_BulkLoadByReallocF(reallocF, map, const struct
+ *   structTag##_Entry *entries, size_t len)` - builds the tree bottom-up from
+ *   entries sorted by strictly increasing keys in `O(len)`. Every level has
+ *   the fewest nodes that can hold it, and its items are spread evenly over
+ *   them (node lengths differ by at most one, every node is at least half
+ *   full). The map **MUST** be empty
+ * + `int structTag##_Remove(struct structTag *map, const K *key, V *out)` -
+ *   removes the entry and writes its value into `out` (if not `NULL`).
+ *   Returns `1` if there is no such key
+ * + `void structTag##_First(const struct structTag *map, struct
+ *   structTag##_Iter *it)` - positions `it` at the smallest key
+ * + `void structTag##_LowerBound(const struct structTag *map, const K *key,
+ *   struct structTag##_Iter *it)` - positions `it` at the first key not less
+ *   than `*key`
+ * + `V *structTag##_Next(struct structTag##_Iter *it, const K **key)` -
+ *   returns the value at `it` (and its key into `key` if not `NULL`) and
+ *   advances `it`. Returns `NULL` past the last entry
+ * + `void structTag##_DeinitByFreeF(freeF, map)` - frees all nodes
+ * + `structTag##_Put`, `structTag##_BulkLoad`, `structTag##_Deinit` - the
+ *   same but by using \ref MIR_CacheAlignedRealloc and \ref MIR_AlignedFree
+ *
+ * Functions returning `int` return \ref MIR_BTreeMap_OK on success; any other
+ * value indicates failure.
+ *
+ * ### Example
+ *
+ * \code{.c}
+ * #define IntLess(a, b) (*(a) < *(b))
+ *
+ * MIR_BTreeMap(int, double, IntTree);
+ * MIR_BTreeMap_DEFINE(int, double, IntTree, IntLess)
+ *
+ * struct IntTree map;
+ * struct IntTree_Iter it;
+ * const int *key;
+ * double *val;
+ * int lo = 10, hi = 20;
+ *
+ * IntTree_Init(&map);
+ * ...
+ * IntTree_LowerBound(&map, &lo, &it);
+ * while ((val = IntTree_Next(&it, &key)) != NULL && *key < hi) {
+ *     ...
+ * }
+ * IntTree_Deinit(&map);
+ * \endcode
+ */
+#define MIR_BTreeMap_DEFINE(K, V, structTag, LESS)                             \
+    MIR_SEARCH_DEFINE(K, structTag##__Keys, LESS)                              \
+    __MIR_BTreeMap_DEFINE_CORE(K, V, structTag, LESS)                          \
+    __MIR_BTreeMap_DEFINE_REMOVE(K, V, structTag, LESS)                        \
+    __MIR_BTreeMap_DEFINE_BULK(K, V, structTag, LESS)                          \
+    __MIR_BTreeMap_DEFINE_STD(K, V, structTag)
+
+#define __MIR_BTreeMap_DEFINE_CORE(K, V, structTag, LESS)                      \
+                                                                               \
+    MIR_INLINE void structTag##_Init(struct structTag *map) {                  \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        map->root = NULL;                                                      \
+        map->first = NULL;                                                     \
+        map->len = 0;                                                          \
+        map->height = 0;                                                       \
+        MIR_Slab_Init(                                                         \
+            &map->slab, sizeof(struct structTag##_Node), MIR_SLAB_CHUNK_OBJS   \
+        );                                                                     \
+    }                                                                          \
+                                                                               \
+    /* NOTE: descends to the leaf that may hold `key`, recording the inner     \
+     *       nodes and the children taken in `nodes` and `idx` if not NULL */  \
+    MIR_INLINE struct structTag##_Node *structTag##__Descend(                  \
+        const struct structTag *map, const K *key,                             \
+        struct structTag##_Node **nodes, size_t *idx                           \
+    ) {                                                                        \
+        struct structTag##_Node *node = map->root;                             \
+        size_t h;                                                              \
+        size_t i;                                                              \
+                                                                               \
+        for (h = 0; h + 1u < map->height; ++h) {                               \
+            i = structTag##__Keys_UpperBound(node->keys, node->len, key);      \
+            if (nodes != NULL) {                                               \
+                nodes[h] = node;                                               \
+                idx[h] = i;                                                    \
+            }                                                                  \
+            node = node->u.children[i];                                        \
+        }                                                                      \
+        return node;                                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE V *structTag##_Find(                                            \
+        const struct structTag *map, const K *key                              \
+    ) {                                                                        \
+        struct structTag##_Node *leaf;                                         \
+        size_t i;                                                              \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+                                                                               \
+        if (map->height == 0u) {                                               \
+            return NULL;                                                       \
+        }                                                                      \
+        leaf = structTag##__Descend(map, key, NULL, NULL);                     \
+        i = structTag##__Keys_LowerBound(leaf->keys, leaf->len, key);          \
+        return (i < leaf->len && !(LESS(key, &leaf->keys[i])))                 \
+                   ? &leaf->u.vals[i]                                          \
+                   : NULL;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##__LeafInsert(                                   \
+        struct structTag##_Node *leaf, size_t pos, const K *key, const V *val  \
+    ) {                                                                        \
+        memmove(                                                               \
+            leaf->keys + pos + 1u, leaf->keys + pos,                           \
+            (leaf->len - pos) * sizeof(K)                                      \
+        );                                                                     \
+        memmove(                                                               \
+            leaf->u.vals + pos + 1u, leaf->u.vals + pos,                       \
+            (leaf->len - pos) * sizeof(V)                                      \
+        );                                                                     \
+        memcpy(&leaf->keys[pos], key, sizeof(K));                              \
+        memcpy(&leaf->u.vals[pos], val, sizeof(V));                            \
+        ++leaf->len;                                                           \
+    }                                                                          \
+                                                                               \
+    /* NOTE: inserts `sep` as key `i` and `child` as child `i + 1` */          \
+    MIR_INLINE void structTag##__InnerInsert(                                  \
+        struct structTag##_Node *node, size_t i, const K *sep,                 \
+        struct structTag##_Node *child                                         \
+    ) {                                                                        \
+        memmove(                                                               \
+            node->keys + i + 1u, node->keys + i, (node->len - i) * sizeof(K)   \
+        );                                                                     \
+        memmove(                                                               \
+            node->u.children + i + 2u, node->u.children + i + 1u,              \
+            (node->len - i) * sizeof(node->u.children[0])                      \
+        );                                                                     \
+        memcpy(&node->keys[i], sep, sizeof(K));                                \
+        node->u.children[i + 1u] = child;                                      \
+        ++node->len;                                                           \
+    }                                                                          \
+                                                                               \
+    /* NOTE: splits the full inner `node` while inserting `*sep` and `child`   \
+     *       at `i`; the left half stays in `node`, the right one goes to      \
+     *       `right` and the key between them is written to `*sep` */          \
+    MIR_INLINE void structTag##__InnerSplit(                                   \
+        struct structTag##_Node *node, size_t i, K *sep,                       \
+        struct structTag##_Node *child, struct structTag##_Node *right         \
+    ) {                                                                        \
+        K keys[__MIR_BTREEMAP_B(K) + 1u];                                      \
+        struct structTag##_Node *children[__MIR_BTREEMAP_B(K) + 2u];           \
+        const size_t b = __MIR_BTREEMAP_B(K);                                  \
+        const size_t m = (b + 1u) / 2u;                                        \
+                                                                               \
+        memcpy(keys, node->keys, i * sizeof(K));                               \
+        memcpy(&keys[i], sep, sizeof(K));                                      \
+        memcpy(keys + i + 1u, node->keys + i, (b - i) * sizeof(K));            \
+        memcpy(children, node->u.children, (i + 1u) * sizeof(children[0]));    \
+        children[i + 1u] = child;                                              \
+        memcpy(                                                                \
+            children + i + 2u, node->u.children + i + 1u,                      \
+            (b - i) * sizeof(children[0])                                      \
+        );                                                                     \
+                                                                               \
+        memcpy(node->keys, keys, m * sizeof(K));                               \
+        memcpy(node->u.children, children, (m + 1u) * sizeof(children[0]));    \
+        node->len = m;                                                         \
+        memcpy(sep, &keys[m], sizeof(K));                                      \
+        memcpy(right->keys, keys + m + 1u, (b - m) * sizeof(K));               \
+        memcpy(                                                                \
+            right->u.children, children + m + 1u,                              \
+            (b - m + 1u) * sizeof(children[0])                                 \
+        );                                                                     \
+        right->len = b - m;                                                    \
+        right->next = NULL;                                                    \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PutByReallocF(                                  \
+        void *(*reallocF)(void *, size_t), struct structTag *map,              \
+        const K *key, const V *val                                             \
+    ) {                                                                        \
+        struct structTag##_Node *nodes[MIR_BTREEMAP_MAX_HEIGHT];               \
+        size_t idx[MIR_BTREEMAP_MAX_HEIGHT];                                   \
+        struct structTag##_Node *spare[MIR_BTREEMAP_MAX_HEIGHT + 1u];          \
+        struct structTag##_Node *leaf;                                         \
+        struct structTag##_Node *right;                                        \
+        const size_t b = __MIR_BTREEMAP_B(K);                                  \
+        size_t nspare;                                                         \
+        size_t need;                                                           \
+        size_t pos;                                                            \
+        size_t h;                                                              \
+        K sep;                                                                 \
+                                                                               \
+        __MIR_ASSERT_MSG(                                                      \
+            reallocF != NULL, "param `reallocF' MUST NOT be NULL"              \
+        );                                                                     \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(val != NULL, "param `val' MUST NOT be NULL");         \
+                                                                               \
+        if (map->height == 0u) {                                               \
+            leaf = (struct structTag##_Node *)MIR_Slab_AllocByReallocF(        \
+                reallocF, &map->slab                                           \
+            );                                                                 \
+            if (leaf == NULL) {                                                \
+                return 1;                                                      \
+            }                                                                  \
+            leaf->len = 0;                                                     \
+            leaf->next = NULL;                                                 \
+            structTag##__LeafInsert(leaf, 0, key, val);                        \
+            map->root = leaf;                                                  \
+            map->first = leaf;                                                 \
+            map->height = 1;                                                   \
+            map->len = 1;                                                      \
+            return MIR_BTreeMap_OK;                                            \
+        }                                                                      \
+                                                                               \
+        leaf = structTag##__Descend(map, key, nodes, idx);                     \
+        pos = structTag##__Keys_LowerBound(leaf->keys, leaf->len, key);        \
+        if (pos < leaf->len && !(LESS(key, &leaf->keys[pos]))) {               \
+            memcpy(&leaf->u.vals[pos], val, sizeof(V));                        \
+            return MIR_BTreeMap_OK;                                            \
+        }                                                                      \
+        if (leaf->len < b) {                                                   \
+            structTag##__LeafInsert(leaf, pos, key, val);                      \
+            ++map->len;                                                        \
+            return MIR_BTreeMap_OK;                                            \
+        }                                                                      \
+                                                                               \
+        /* NOTE: take all nodes the splits need up front, so that a failure    \
+         *       leaves the tree untouched */                                  \
+        need = 1;                                                              \
+        for (h = map->height - 1u; h-- > 0u && nodes[h]->len == b;) {          \
+            ++need;                                                            \
+        }                                                                      \
+        if (need == map->height) {                                             \
+            if (map->height == MIR_BTREEMAP_MAX_HEIGHT) {                      \
+                return 1;                                                      \
+            }                                                                  \
+            ++need;                                                            \
+        }                                                                      \
+        for (nspare = 0; nspare < need; ++nspare) {                            \
+            spare[nspare] = (struct structTag##_Node *)                        \
+                MIR_Slab_AllocByReallocF(reallocF, &map->slab);                \
+            if (spare[nspare] == NULL) {                                       \
+                while (nspare-- > 0u) {                                        \
+                    MIR_Slab_Free(&map->slab, spare[nspare]);                  \
+                }                                                              \
+                return 1;                                                      \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        right = spare[--nspare];                                               \
+        memcpy(right->keys, leaf->keys + b / 2u, (b - b / 2u) * sizeof(K));    \
+        memcpy(                                                                \
+            right->u.vals, leaf->u.vals + b / 2u, (b - b / 2u) * sizeof(V)     \
+        );                                                                     \
+        right->len = b - b / 2u;                                               \
+        leaf->len = b / 2u;                                                    \
+        right->next = leaf->next;                                              \
+        leaf->next = right;                                                    \
+        if (pos <= b / 2u) {                                                   \
+            structTag##__LeafInsert(leaf, pos, key, val);                      \
+        } else {                                                               \
+            structTag##__LeafInsert(right, pos - b / 2u, key, val);            \
+        }                                                                      \
+        ++map->len;                                                            \
+        memcpy(&sep, &right->keys[0], sizeof(K));                              \
+                                                                               \
+        for (h = map->height - 1u; h-- > 0u;) {                                \
+            if (nodes[h]->len < b) {                                           \
+                structTag##__InnerInsert(nodes[h], idx[h], &sep, right);       \
+                return MIR_BTreeMap_OK;                                        \
+            }                                                                  \
+            structTag##__InnerSplit(                                           \
+                nodes[h], idx[h], &sep, right, spare[nspare - 1u]              \
+            );                                                                 \
+            right = spare[--nspare];                                           \
+        }                                                                      \
+                                                                               \
+        /* NOTE: the root has been split */                                    \
+        nodes[0] = spare[--nspare];                                            \
+        memcpy(&nodes[0]->keys[0], &sep, sizeof(K));                           \
+        nodes[0]->u.children[0] = map->root;                                   \
+        nodes[0]->u.children[1] = right;                                       \
+        nodes[0]->len = 1;                                                     \
+        nodes[0]->next = NULL;                                                 \
+        map->root = nodes[0];                                                  \
+        ++map->height;                                                         \
+        return MIR_BTreeMap_OK;                                                \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_First(                                         \
+        const struct structTag *map, struct structTag##_Iter *it               \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(it != NULL, "param `it' MUST NOT be NULL");           \
+                                                                               \
+        it->leaf = map->first;                                                 \
+        it->pos = 0;                                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_LowerBound(                                    \
+        const struct structTag *map, const K *key,                             \
+        struct structTag##_Iter *it                                            \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(it != NULL, "param `it' MUST NOT be NULL");           \
+                                                                               \
+        it->leaf = NULL;                                                       \
+        it->pos = 0;                                                           \
+        if (map->height != 0u) {                                               \
+            it->leaf = structTag##__Descend(map, key, NULL, NULL);             \
+            it->pos = structTag##__Keys_LowerBound(                            \
+                it->leaf->keys, it->leaf->len, key                             \
+            );                                                                 \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE V *structTag##_Next(                                            \
+        struct structTag##_Iter *it, const K **key                             \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(it != NULL, "param `it' MUST NOT be NULL");           \
+                                                                               \
+        while (it->leaf != NULL && it->pos >= it->leaf->len) {                 \
+            it->leaf = it->leaf->next;                                         \
+            it->pos = 0;                                                       \
+        }                                                                      \
+        if (it->leaf == NULL) {                                                \
+            return NULL;                                                       \
+        }                                                                      \
+        if (it->pos == 0u && it->leaf->next != NULL) {                         \
+            MIR_PREFETCH(it->leaf->next);                                      \
+        }                                                                      \
+        if (key != NULL) {                                                     \
+            *key = &it->leaf->keys[it->pos];                                   \
+        }                                                                      \
+        return &it->leaf->u.vals[it->pos++];                                   \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *map                           \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+                                                                               \
+        /* NOTE: all nodes live in the slab chunks */                          \
+        MIR_Slab_DeinitByFreeF(freeF, &map->slab);                             \
+        structTag##_Init(map);                                                 \
+    }
+
+#define __MIR_BTreeMap_DEFINE_REMOVE(K, V, structTag, LESS)                    \
+                                                                               \
+    /* NOTE: moves the last entry of `left` to the front of `node`, its right  \
+     *       sibling under `parent` (child `c`) */                             \
+    MIR_INLINE void structTag##__BorrowLeft(                                   \
+        struct structTag##_Node *parent, size_t c,                             \
+        struct structTag##_Node *left, struct structTag##_Node *node,          \
+        int leaf                                                               \
+    ) {                                                                        \
+        memmove(node->keys + 1, node->keys, node->len * sizeof(K));            \
+        if (leaf) {                                                            \
+            memmove(node->u.vals + 1, node->u.vals, node->len * sizeof(V));    \
+            memcpy(&node->keys[0], &left->keys[left->len - 1u], sizeof(K));    \
+            memcpy(                                                            \
+                &node->u.vals[0], &left->u.vals[left->len - 1u], sizeof(V)     \
+            );                                                                 \
+            memcpy(&parent->keys[c - 1u], &node->keys[0], sizeof(K));          \
+        } else {                                                               \
+            memmove(                                                           \
+                node->u.children + 1, node->u.children,                        \
+                (node->len + 1u) * sizeof(node->u.children[0])                 \
+            );                                                                 \
+            memcpy(&node->keys[0], &parent->keys[c - 1u], sizeof(K));          \
+            node->u.children[0] = left->u.children[left->len];                 \
+            memcpy(&parent->keys[c - 1u], &left->keys[left->len - 1u],         \
+                   sizeof(K));                                                 \
+        }                                                                      \
+        --left->len;                                                           \
+        ++node->len;                                                           \
+    }                                                                          \
+                                                                               \
+    /* NOTE: moves the first entry of `right` to the end of `node`, its left   \
+     *       sibling under `parent` (child `c`) */                             \
+    MIR_INLINE void structTag##__BorrowRight(                                  \
+        struct structTag##_Node *parent, size_t c,                             \
+        struct structTag##_Node *node, struct structTag##_Node *right,         \
+        int leaf                                                               \
+    ) {                                                                        \
+        if (leaf) {                                                            \
+            memcpy(&node->keys[node->len], &right->keys[0], sizeof(K));        \
+            memcpy(&node->u.vals[node->len], &right->u.vals[0], sizeof(V));    \
+            memmove(                                                           \
+                right->u.vals, right->u.vals + 1,                              \
+                (right->len - 1u) * sizeof(V)                                  \
+            );                                                                 \
+        } else {                                                               \
+            memcpy(&node->keys[node->len], &parent->keys[c], sizeof(K));       \
+            node->u.children[node->len + 1u] = right->u.children[0];           \
+            memmove(                                                           \
+                right->u.children, right->u.children + 1,                      \
+                right->len * sizeof(right->u.children[0])                      \
+            );                                                                 \
+        }                                                                      \
+        ++node->len;                                                           \
+        if (leaf) {                                                            \
+            memmove(                                                           \
+                right->keys, right->keys + 1, (right->len - 1u) * sizeof(K)    \
+            );                                                                 \
+            memcpy(&parent->keys[c], &right->keys[0], sizeof(K));              \
+        } else {                                                               \
+            memcpy(&parent->keys[c], &right->keys[0], sizeof(K));              \
+            memmove(                                                           \
+                right->keys, right->keys + 1, (right->len - 1u) * sizeof(K)    \
+            );                                                                 \
+        }                                                                      \
+        --right->len;                                                          \
+    }                                                                          \
+                                                                               \
+    /* NOTE: appends `right` (child `s + 1` of `parent`) to `left` (child `s`) \
+     *       and removes it with the key `s` from `parent` */                  \
+    MIR_INLINE void structTag##__Merge(                                        \
+        struct structTag *map, struct structTag##_Node *parent, size_t s,      \
+        struct structTag##_Node *left, struct structTag##_Node *right,         \
+        int leaf                                                               \
+    ) {                                                                        \
+        if (leaf) {                                                            \
+            memcpy(                                                            \
+                left->keys + left->len, right->keys, right->len * sizeof(K)    \
+            );                                                                 \
+            memcpy(                                                            \
+                left->u.vals + left->len, right->u.vals,                       \
+                right->len * sizeof(V)                                         \
+            );                                                                 \
+            left->len += right->len;                                           \
+            left->next = right->next;                                          \
+        } else {                                                               \
+            memcpy(&left->keys[left->len], &parent->keys[s], sizeof(K));       \
+            memcpy(                                                            \
+                left->keys + left->len + 1u, right->keys,                      \
+                right->len * sizeof(K)                                         \
+            );                                                                 \
+            memcpy(                                                            \
+                left->u.children + left->len + 1u, right->u.children,          \
+                (right->len + 1u) * sizeof(right->u.children[0])               \
+            );                                                                 \
+            left->len += right->len + 1u;                                      \
+        }                                                                      \
+        memmove(                                                               \
+            parent->keys + s, parent->keys + s + 1u,                           \
+            (parent->len - s - 1u) * sizeof(K)                                 \
+        );                                                                     \
+        memmove(                                                               \
+            parent->u.children + s + 1u, parent->u.children + s + 2u,          \
+            (parent->len - s - 1u) * sizeof(parent->u.children[0])             \
+        );                                                                     \
+        --parent->len;                                                         \
+        MIR_Slab_Free(&map->slab, right);                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_Remove(                                         \
+        struct structTag *map, const K *key, V *out                            \
+    ) {                                                                        \
+        struct structTag##_Node *nodes[MIR_BTREEMAP_MAX_HEIGHT];               \
+        size_t idx[MIR_BTREEMAP_MAX_HEIGHT];                                   \
+        struct structTag##_Node *node;                                         \
+        struct structTag##_Node *parent;                                       \
+        struct structTag##_Node *left;                                         \
+        struct structTag##_Node *right;                                        \
+        const size_t b = __MIR_BTREEMAP_B(K);                                  \
+        size_t minLen;                                                         \
+        size_t pos;                                                            \
+        size_t h;                                                              \
+        size_t c;                                                              \
+        int leaf;                                                              \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+                                                                               \
+        if (map->height == 0u) {                                               \
+            return 1;                                                          \
+        }                                                                      \
+        node = structTag##__Descend(map, key, nodes, idx);                     \
+        pos = structTag##__Keys_LowerBound(node->keys, node->len, key);        \
+        if (pos >= node->len || LESS(key, &node->keys[pos])) {                 \
+            return 1;                                                          \
+        }                                                                      \
+        if (out != NULL) {                                                     \
+            memcpy(out, &node->u.vals[pos], sizeof(V));                        \
+        }                                                                      \
+        memmove(                                                               \
+            node->keys + pos, node->keys + pos + 1u,                           \
+            (node->len - pos - 1u) * sizeof(K)                                 \
+        );                                                                     \
+        memmove(                                                               \
+            node->u.vals + pos, node->u.vals + pos + 1u,                       \
+            (node->len - pos - 1u) * sizeof(V)                                 \
+        );                                                                     \
+        --node->len;                                                           \
+        --map->len;                                                            \
+                                                                               \
+        /* NOTE: `h` is the level of `node`; borrow from a sibling that can    \
+         *       spare an entry, otherwise merge with one and go up */         \
+        for (h = map->height - 1u; h > 0u; --h) {                              \
+            leaf = (h == map->height - 1u);                                    \
+            minLen = (leaf) ? b / 2u : (b - 1u) / 2u;                          \
+            if (node->len >= minLen) {                                         \
+                return MIR_BTreeMap_OK;                                        \
+            }                                                                  \
+            parent = nodes[h - 1u];                                            \
+            c = idx[h - 1u];                                                   \
+            left = (c > 0u) ? parent->u.children[c - 1u] : NULL;               \
+            right = (c < parent->len) ? parent->u.children[c + 1u] : NULL;     \
+            if (left != NULL && left->len > minLen) {                          \
+                structTag##__BorrowLeft(parent, c, left, node, leaf);          \
+                return MIR_BTreeMap_OK;                                        \
+            }                                                                  \
+            if (right != NULL && right->len > minLen) {                        \
+                structTag##__BorrowRight(parent, c, node, right, leaf);        \
+                return MIR_BTreeMap_OK;                                        \
+            }                                                                  \
+            if (left != NULL) {                                                \
+                structTag##__Merge(map, parent, c - 1u, left, node, leaf);     \
+            } else {                                                           \
+                structTag##__Merge(map, parent, c, node, right, leaf);         \
+            }                                                                  \
+            node = parent;                                                     \
+        }                                                                      \
+                                                                               \
+        /* NOTE: `node` is the root */                                         \
+        if (node->len == 0u) {                                                 \
+            if (map->height == 1u) {                                           \
+                map->root = NULL;                                              \
+                map->first = NULL;                                             \
+            } else {                                                           \
+                map->root = node->u.children[0];                               \
+            }                                                                  \
+            MIR_Slab_Free(&map->slab, node);                                   \
+            --map->height;                                                     \
+        }                                                                      \
+        return MIR_BTreeMap_OK;                                                \
+    }
+
+#define __MIR_BTreeMap_DEFINE_BULK(K, V, structTag, LESS)                      \
+                                                                               \
+    /* NOTE: smallest key under `node`, which is `levels` levels above the     \
+     *       leaves */                                                         \
+    MIR_INLINE const K *structTag##__MinKey(                                   \
+        const struct structTag##_Node *node, size_t levels                     \
+    ) {                                                                        \
+        while (levels-- > 0u) {                                                \
+            node = node->u.children[0];                                        \
+        }                                                                      \
+        return &node->keys[0];                                                 \
+    }                                                                          \
+                                                                               \
+    /* NOTE: returns all nodes of the levels (linked through `next`) to the    \
+     *       slab */                                                           \
+    MIR_INLINE void structTag##__FreeLevels(                                   \
+        struct structTag *map, struct structTag##_Node **levels, size_t n      \
+    ) {                                                                        \
+        struct structTag##_Node *node;                                         \
+                                                                               \
+        while (n-- > 0u) {                                                     \
+            while (levels[n] != NULL) {                                        \
+                node = levels[n];                                              \
+                levels[n] = node->next;                                        \
+                MIR_Slab_Free(&map->slab, node);                               \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_BulkLoadByReallocF(                             \
+        void *(*reallocF)(void *, size_t), struct structTag *map,              \
+        const struct structTag##_Entry *entries, size_t len                    \
+    ) {                                                                        \
+        struct structTag##_Node *levels[MIR_BTREEMAP_MAX_HEIGHT];              \
+        struct structTag##_Node **tail;                                        \
+        struct structTag##_Node *node;                                         \
+        struct structTag##_Node *child;                                        \
+        const size_t b = __MIR_BTREEMAP_B(K);                                  \
+        size_t height = 0;                                                     \
+        size_t count;                                                          \
+        size_t n;                                                              \
+        size_t k;                                                              \
+        size_t i;                                                              \
+        size_t j;                                                              \
+        size_t e = 0;                                                          \
+                                                                               \
+        __MIR_ASSERT_MSG(                                                      \
+            reallocF != NULL, "param `reallocF' MUST NOT be NULL"              \
+        );                                                                     \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(map->height == 0u, "param `map' MUST be empty");      \
+        __MIR_ASSERT_MSG(                                                      \
+            entries != NULL || len == 0u, "param `entries' MUST NOT be NULL"   \
+        );                                                                     \
+                                                                               \
+        if (len == 0u) {                                                       \
+            return MIR_BTreeMap_OK;                                            \
+        }                                                                      \
+                                                                               \
+        /* NOTE: `count` nodes of the level get `n / count` or one more        \
+         *       items, so that all are at least half full */                  \
+        n = len;                                                               \
+        count = (n + b - 1u) / b;                                              \
+        levels[0] = NULL;                                                      \
+        tail = &levels[0];                                                     \
+        ++height;                                                              \
+        for (k = 0; k < count; ++k) {                                          \
+            node = (struct structTag##_Node *)MIR_Slab_AllocByReallocF(        \
+                reallocF, &map->slab                                           \
+            );                                                                 \
+            if (node == NULL) {                                                \
+                structTag##__FreeLevels(map, levels, height);                  \
+                return 1;                                                      \
+            }                                                                  \
+            node->next = NULL;                                                 \
+            *tail = node;                                                      \
+            tail = &node->next;                                                \
+            node->len = n / count + (k < n % count);                           \
+            for (i = 0; i < node->len; ++i, ++e) {                             \
+                __MIR_ASSERT_MSG(                                              \
+                    e == 0u || LESS(&entries[e - 1u].key, &entries[e].key),    \
+                    "keys of `entries' MUST be strictly increasing"            \
+                );                                                             \
+                memcpy(&node->keys[i], &entries[e].key, sizeof(K));            \
+                memcpy(&node->u.vals[i], &entries[e].val, sizeof(V));          \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        for (n = count; n > 1u; n = count) {                                   \
+            if (height == MIR_BTREEMAP_MAX_HEIGHT) {                           \
+                structTag##__FreeLevels(map, levels, height);                  \
+                return 1;                                                      \
+            }                                                                  \
+            count = (n + b) / (b + 1u);                                        \
+            child = levels[height - 1u];                                       \
+            levels[height] = NULL;                                             \
+            tail = &levels[height];                                            \
+            ++height;                                                          \
+            for (k = 0; k < count; ++k) {                                      \
+                node = (struct structTag##_Node *)MIR_Slab_AllocByReallocF(    \
+                    reallocF, &map->slab                                       \
+                );                                                             \
+                if (node == NULL) {                                            \
+                    structTag##__FreeLevels(map, levels, height);              \
+                    return 1;                                                  \
+                }                                                              \
+                node->next = NULL;                                             \
+                *tail = node;                                                  \
+                tail = &node->next;                                            \
+                node->len = n / count + (k < n % count) - 1u;                  \
+                for (j = 0; j <= node->len; ++j, child = child->next) {        \
+                    node->u.children[j] = child;                               \
+                    if (j > 0u) {                                              \
+                        memcpy(                                                \
+                            &node->keys[j - 1u],                               \
+                            structTag##__MinKey(child, height - 2u), sizeof(K) \
+                        );                                                     \
+                    }                                                          \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        map->root = levels[height - 1u];                                       \
+        map->first = levels[0];                                                \
+        map->len = len;                                                        \
+        map->height = height;                                                  \
+        return MIR_BTreeMap_OK;                                                \
+    }
+
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define __MIR_BTreeMap_DEFINE_STD(K, V, structTag)                         \
+                                                                               \
+        MIR_INLINE int structTag##_Put(                                        \
+            struct structTag *map, const K *key, const V *val                  \
+        ) {                                                                    \
+            return structTag##_PutByReallocF(                                  \
+                MIR_CacheAlignedRealloc, map, key, val                         \
+            );                                                                 \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE int structTag##_BulkLoad(                                   \
+            struct structTag *map, const struct structTag##_Entry *entries,    \
+            size_t len                                                         \
+        ) {                                                                    \
+            return structTag##_BulkLoadByReallocF(                             \
+                MIR_CacheAlignedRealloc, map, entries, len                     \
+            );                                                                 \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE void structTag##_Deinit(struct structTag *map) {            \
+            structTag##_DeinitByFreeF(MIR_AlignedFree, map);                   \
+        }
+#else
+#    define __MIR_BTreeMap_DEFINE_STD(K, V, structTag)
+#endif
+
+#endif /* _MIR_COMMON_COLLECTIONS_BTREEMAP_H */
@@ -0,0 +1,558 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Deque utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_DEQUE_H
+#define _MIR_COMMON_COLLECTIONS_DEQUE_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#if __STDC_VERSION__ >= 199901L
+#    include <stdint.h> /* SIZE_MAX */
+#else
+#    include <mir/stdlib/stdint.h> /* SIZE_MAX */
+#endif
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a double-ended queue struct - a ring buffer whose capacity is
+ * a power of two.
+ *
+ * \param type      elements type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \note Be aware that prior to C99, the C standard did not specify behavior for
+ * macros with empty arguments.
+ *
+ * \details Members:
+ *   1. `data` - pointer to the underlying array. **MAY** be `NULL`
+ *   2. `head` - index (in the underlying array) of the first element
+ *   3. `len` - number of elements currently stored. **MAY** be `0`
+ *   4. `cap` - capacity (in elements) of the underlying array. Either `0` or a
+ *      power of two
+ *
+ * The element `i` lives at `data[(head + i) & (cap - 1)]`, so the elements
+ * occupy at most two contiguous runs of the underlying array: `[head, cap)`
+ * and `[0, head + len - cap)`.
+ *
+ * Rules:
+ *   1. `type`'s `sizeof` **MUST** be greater than `0`
+ *   2. member `cap` **MUST** be always greater or equal to member `len`
+ *   3. member `data` **MUST** be `NULL` only if member `cap` is equal to `0`
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix that allocate or free
+ * will be defined only if `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + initialization
+ *   - \ref MIR_Deque_Init - with zero capacity
+ * + get / set
+ *   - \ref MIR_Deque_Get, \ref MIR_Deque_GetPtr, \ref MIR_Deque_Set
+ * + reserve
+ *   - \ref MIR_Deque_Reserve, \ref MIR_Deque_ReserveByReallocF
+ * + push / pop (amortized `O(1)`)
+ *   - \ref MIR_Deque_PushBack, \ref MIR_Deque_PushBackByReallocF
+ *   - \ref MIR_Deque_PushFront, \ref MIR_Deque_PushFrontByReallocF
+ *   - \ref MIR_Deque_PopBack, \ref MIR_Deque_PopFront
+ * + bulk push / pop (see \ref MIR_Deque_Spans)
+ *   - \ref MIR_Deque_PushBackN, \ref MIR_Deque_PushBackNByReallocF - make
+ *     room for `n` elements at the back and return it as spans
+ *   - \ref MIR_Deque_PopFrontN - remove up to `n` elements from the front and
+ *     return them as spans
+ *   - \ref MIR_Deque_PushBackArr, \ref MIR_Deque_PushBackArrByReallocF, \ref
+ *     MIR_Deque_PopFrontArr - the same, but copy from/to an array
+ * + deinitialization
+ *   - \ref MIR_Deque_Deinit, \ref MIR_Deque_DeinitByFreeF
+ */
+#define MIR_Deque(type, structTag)                                             \
+    struct structTag {                                                         \
+        type *data;                                                            \
+        size_t head;                                                           \
+        size_t len;                                                            \
+        size_t cap;                                                            \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Deque
+ * struct.
+ */
+#define MIR_Deque_OK 0
+
+/**
+ * \brief Up to two contiguous runs of deque elements.
+ *
+ * \details The runs are in deque order: `first` holds `firstLen` elements,
+ * followed (logically) by `second` with `secondLen` elements. `second` is
+ * `NULL` iff `secondLen` is `0`. The pointers have to be cast to the element
+ * type.
+ */
+struct MIR_Deque_Spans {
+    void *first;
+    size_t firstLen;
+    void *second;
+    size_t secondLen;
+};
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern int __MIR_Deque_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t *member_head,
+    size_t *member_cap, size_t len, size_t new_capacity, size_t elemSize
+);
+
+extern void __MIR_Deque_Spans_impl(
+    void *data, size_t cap, size_t start, size_t n, size_t elemSize,
+    struct MIR_Deque_Spans *spans
+);
+
+extern size_t __MIR_Deque_PopFrontN_impl(
+    void *data, size_t *member_head, size_t *member_len, size_t cap, size_t n,
+    size_t elemSize, struct MIR_Deque_Spans *spans
+);
+
+extern void __MIR_Deque_CopySpans_impl(
+    const struct MIR_Deque_Spans *spans, void *arr, int toSpans,
+    size_t elemSize
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/**
+ * \brief Returns the element at the specified index (`0` is the front).
+ *
+ * \param[in] deq   pointer to \ref MIR_Deque struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_Deque_Get(deq, index)                                              \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (deq)->len,                                              \
+            "OOB: param `index' MUST be less than (deq)->len"                  \
+        ),                                                                     \
+        (deq)->data[((deq)->head + (index)) & ((deq)->cap - 1u)]               \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \param[in] deq   pointer to \ref MIR_Deque struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_Deque_GetPtr(deq, index)                                           \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (deq)->len,                                              \
+            "OOB: param `index' MUST be less than (deq)->len"                  \
+        ),                                                                     \
+        &(deq)->data[((deq)->head + (index)) & ((deq)->cap - 1u)]              \
+    ) /* clang-format on */
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] deq   pointer to \ref MIR_Deque struct
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_Deque_Set(deq, index, elem)                                        \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (deq)->len,                                              \
+            "OOB: param `index' MUST be less than (deq)->len"                  \
+        ),                                                                     \
+        (deq)->data[((deq)->head + (index)) & ((deq)->cap - 1u)] = (elem)      \
+    ) /* clang-format on */
+
+/**
+ * \brief Init deque with zero capacity.
+ *
+ * \param[out] deq pointer to \ref MIR_Deque struct
+ */
+#define MIR_Deque_Init(deq)                                                    \
+    __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL");           \
+    (deq)->data = NULL;                                                        \
+    (deq)->head = 0;                                                           \
+    (deq)->len = 0;                                                            \
+    (deq)->cap = 0
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than `deq->cap`.
+ * Otherwise the capacity is rounded up to a power of two, the underlying array
+ * is reallocated and the ring is unwrapped: the shorter of the two runs is
+ * moved, so that the elements are contiguous modulo the new capacity again.
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_Deque macro
+ * \param[in]     reallocF      realloc-like function to be used
+ * \param[in,out] deq           pointer to \ref MIR_Deque struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_Deque_OK on success; any other value indicates failure
+ */
+#define MIR_Deque_ReserveByReallocF(type, reallocF, deq, new_capacity)         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),   \
+            __MIR_ASSERT_MSG(                                                  \
+                ((deq)->cap == 0u) ? ((deq)->data == NULL) : 1,                \
+                "if `deq->cap == 0' then `deq->data' MUST be NULL"             \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_Deque_ReserveByReallocF_impl(                                    \
+            reallocF, (void **)&(deq)->data, &(deq)->head, &(deq)->cap,        \
+            (deq)->len, new_capacity, sizeof(type)                             \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Grows the deque (if it's full) so that one more element fits.
+ */
+#define __MIR_Deque_GrowIfFullByReallocF(type, reallocF, deq)                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        ((deq)->len < (deq)->cap)                                              \
+            ?   MIR_Deque_OK                                                   \
+            :                                                                  \
+                (                                                              \
+                        MIR_u_Mul_WillOverflow((deq)->cap, 2u, SIZE_MAX)       \
+                    ?   1                                                      \
+                    :                                                          \
+                        MIR_Deque_ReserveByReallocF(                           \
+                            type, reallocF, deq,                               \
+                            ((deq)->cap == 0u) ? 1u : ((deq)->cap * 2u)        \
+                        )                                                      \
+                )                                                              \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends the element to the back by using provided realloc-like
+ * function.
+ *
+ * \details Doubles the capacity if the deque is full.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Deque macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] deq      pointer to \ref MIR_Deque struct
+ * \param[in]     elem     pointer to the element to be appended
+ *
+ * \return \ref MIR_Deque_OK on success; any other value indicates failure
+ */
+#define MIR_Deque_PushBackByReallocF(type, reallocF, deq, elem)                \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((elem) != NULL, "param `elem' MUST NOT be NULL"),     \
+            (__MIR_Deque_GrowIfFullByReallocF(type, reallocF, deq) != 0)       \
+        ?   1                                                                  \
+        :                                                                      \
+            (                                                                  \
+                (deq)->data[((deq)->head + (deq)->len) & ((deq)->cap - 1u)] =  \
+                    *(elem),                                                   \
+                ++((deq)->len),                                                \
+                MIR_Deque_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Prepends the element to the front by using provided realloc-like
+ * function.
+ *
+ * \details See \ref MIR_Deque_PushBackByReallocF.
+ */
+#define MIR_Deque_PushFrontByReallocF(type, reallocF, deq, elem)               \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((elem) != NULL, "param `elem' MUST NOT be NULL"),     \
+            (__MIR_Deque_GrowIfFullByReallocF(type, reallocF, deq) != 0)       \
+        ?   1                                                                  \
+        :                                                                      \
+            (                                                                  \
+                (deq)->head = ((deq)->head - 1u) & ((deq)->cap - 1u),          \
+                (deq)->data[(deq)->head] = *(elem),                            \
+                ++((deq)->len),                                                \
+                MIR_Deque_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Removes the last element. It never reclaims memory.
+ *
+ * \param[in,out] deq pointer to \ref MIR_Deque struct
+ * \param[out]    out pointer where the removed element will be written
+ *
+ * \return \ref MIR_Deque_OK on success; `1` if the deque is empty
+ */
+#define MIR_Deque_PopBack(deq, out)                                            \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((out) != NULL, "param `out' MUST not be NULL"),       \
+        ((deq)->len == 0u)                                                     \
+            ? 1                                                                \
+            : (                                                                \
+                  --((deq)->len),                                              \
+                  *(out) = (deq)->data[                                        \
+                      ((deq)->head + (deq)->len) & ((deq)->cap - 1u)           \
+                  ],                                                           \
+                  MIR_Deque_OK                                                 \
+              )                                                                \
+    ) /* clang-format on */
+
+/**
+ * \brief Removes the first element. It never reclaims memory.
+ *
+ * \param[in,out] deq pointer to \ref MIR_Deque struct
+ * \param[out]    out pointer where the removed element will be written
+ *
+ * \return \ref MIR_Deque_OK on success; `1` if the deque is empty
+ */
+#define MIR_Deque_PopFront(deq, out)                                           \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((out) != NULL, "param `out' MUST not be NULL"),       \
+        ((deq)->len == 0u)                                                     \
+            ? 1                                                                \
+            : (                                                                \
+                  *(out) = (deq)->data[(deq)->head],                           \
+                  (deq)->head = ((deq)->head + 1u) & ((deq)->cap - 1u),        \
+                  --((deq)->len),                                              \
+                  MIR_Deque_OK                                                 \
+              )                                                                \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends `n` uninitialized elements to the back and returns them as
+ * spans to be filled by the caller.
+ *
+ * \details Grows the capacity to at least twice the old one (or to `len + n`
+ * if it's greater) if the elements don't fit.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Deque macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] deq      pointer to \ref MIR_Deque struct
+ * \param         n        number of elements
+ * \param[out]    spans    pointer to \ref MIR_Deque_Spans struct. The spans
+ *                         are valid until the next reallocation
+ *
+ * \return \ref MIR_Deque_OK on success; any other value indicates failure (the
+ * deque is not changed)
+ */
+#define MIR_Deque_PushBackNByReallocF(type, reallocF, deq, n, spans)           \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((spans) != NULL, "param `spans' MUST not be NULL"),   \
+            (                                                                  \
+                ((n) > SIZE_MAX - (deq)->len)                                  \
+                ||                                                             \
+                (                                                              \
+                    ((deq)->len + (n) > (deq)->cap)                            \
+                    &&                                                         \
+                    MIR_Deque_ReserveByReallocF(                               \
+                        type, reallocF, deq,                                   \
+                        ((deq)->cap <= SIZE_MAX / 2u &&                        \
+                         (deq)->cap * 2u > (deq)->len + (n))                   \
+                            ? (deq)->cap * 2u                                  \
+                            : (deq)->len + (n)                                 \
+                    ) != MIR_Deque_OK                                          \
+                )                                                              \
+            )                                                                  \
+        ?   1                                                                  \
+        :                                                                      \
+            (                                                                  \
+                __MIR_Deque_Spans_impl(                                        \
+                    (deq)->data, (deq)->cap, (deq)->head + (deq)->len, (n),    \
+                    sizeof(type), (spans)                                      \
+                ),                                                             \
+                (deq)->len += (n),                                             \
+                MIR_Deque_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Removes up to `n` elements from the front and returns them as spans.
+ *
+ * \details It never reclaims memory.
+ *
+ * \param         type  type of elements. **MUST** be the same type as that
+ *                      passed to \ref MIR_Deque macro
+ * \param[in,out] deq   pointer to \ref MIR_Deque struct
+ * \param         n     maximum number of elements to remove
+ * \param[out]    spans pointer to \ref MIR_Deque_Spans struct. The spans are
+ *                      valid until the next push
+ *
+ * \return number of removed elements
+ */
+#define MIR_Deque_PopFrontN(type, deq, n, spans)                               \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((deq) != NULL, "param `deq' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((spans) != NULL, "param `spans' MUST not be NULL"),   \
+        __MIR_Deque_PopFrontN_impl(                                            \
+            (deq)->data, &(deq)->head, &(deq)->len, (deq)->cap, (n),           \
+            sizeof(type), (spans)                                              \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends `n` elements copied from the array to the back.
+ *
+ * \details See \ref MIR_Deque_PushBackNByReallocF. Copying is done by at most
+ * two `memcpy` calls.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Deque macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] deq      pointer to \ref MIR_Deque struct
+ * \param[in]     arr      pointer to the first element to be copied. **MUST
+ *                         NOT** point into the deque
+ * \param         n        number of elements
+ * \param[out]    spans    pointer to scratch \ref MIR_Deque_Spans struct
+ *
+ * \return \ref MIR_Deque_OK on success; any other value indicates failure
+ */
+#define MIR_Deque_PushBackArrByReallocF(type, reallocF, deq, arr, n, spans)    \
+    /* clang-format off */                                                     \
+    (                                                                          \
+            (MIR_Deque_PushBackNByReallocF(type, reallocF, deq, n, spans) != 0)\
+        ?   1                                                                  \
+        :                                                                      \
+            (                                                                  \
+                __MIR_Deque_CopySpans_impl((spans), (void *)(arr), 1,          \
+                                           sizeof(type)),                      \
+                MIR_Deque_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Removes up to `n` elements from the front and copies them to the
+ * array.
+ *
+ * \details See \ref MIR_Deque_PopFrontN.
+ *
+ * \param         type  type of elements. **MUST** be the same type as that
+ *                      passed to \ref MIR_Deque macro
+ * \param[in,out] deq   pointer to \ref MIR_Deque struct
+ * \param[out]    arr   pointer to the array of at least `n` elements
+ * \param         n     maximum number of elements to remove
+ * \param[out]    spans pointer to scratch \ref MIR_Deque_Spans struct
+ *
+ * \return number of removed elements
+ */
+#define MIR_Deque_PopFrontArr(type, deq, arr, n, spans)                        \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        MIR_Deque_PopFrontN(type, deq, n, spans),                              \
+        __MIR_Deque_CopySpans_impl((spans), (arr), 0, sizeof(type)),           \
+        (spans)->firstLen + (spans)->secondLen                                 \
+    ) /* clang-format on */
+
+/**
+ * \brief Deinits the deque by using provided free-like function.
+ *
+ * \param[in]     freeF free-like function to be used
+ * \param[in,out] deq   pointer to \ref MIR_Deque struct
+ */
+#define MIR_Deque_DeinitByFreeF(freeF, deq)                                    \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                (freeF) != NULL,                                               \
+                "param `freeF' MUST not be NULL"                               \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (deq) != NULL,                                                 \
+                "param `deq' MUST not be NULL"                                 \
+            )                                                                  \
+        ),                                                                     \
+        /* NOTE: it's okay to pass NULL to free function */                    \
+        (freeF)((deq)->data)                                                   \
+    ) /* clang-format on */
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Deque_ReserveByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Deque_Reserve(type, deq, new_capacity)                         \
+        MIR_Deque_ReserveByReallocF(type, realloc, deq, new_capacity)
+
+/**
+ * \brief The same as \ref MIR_Deque_PushBackByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Deque_PushBack(type, deq, elem)                                \
+        MIR_Deque_PushBackByReallocF(type, realloc, deq, elem)
+
+/**
+ * \brief The same as \ref MIR_Deque_PushFrontByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Deque_PushFront(type, deq, elem)                               \
+        MIR_Deque_PushFrontByReallocF(type, realloc, deq, elem)
+
+/**
+ * \brief The same as \ref MIR_Deque_PushBackNByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Deque_PushBackN(type, deq, n, spans)                           \
+        MIR_Deque_PushBackNByReallocF(type, realloc, deq, n, spans)
+
+/**
+ * \brief The same as \ref MIR_Deque_PushBackArrByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Deque_PushBackArr(type, deq, arr, n, spans)                    \
+        MIR_Deque_PushBackArrByReallocF(type, realloc, deq, arr, n, spans)
+
+/**
+ * \brief The same as \ref MIR_Deque_DeinitByFreeF but uses standard library
+ * `free` function.
+ */
+#    define MIR_Deque_Deinit(deq) MIR_Deque_DeinitByFreeF(free, deq)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_DEQUE_H */
@@ -0,0 +1,564 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_HashMap utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_HASHMAP_H
+#define _MIR_COMMON_COLLECTIONS_HASHMAP_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, uint32_t */
+#include <string.h> /* memset */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define __MIR_HASHMAP_SSE2 1
+#endif
+
+#include <mir/common/arith.h>    /* MIR_u_*_WillOverflow */
+#include <mir/common/bits.h>     /* MIR_Bits_Ctz32, MIR_Bits_Clz32 */
+#include <mir/common/macros.h>   /* MIR_INLINE, MIR_LIKELY */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a hash map struct - an open-addressing hash table with
+ * Swiss-table layout.
+ *
+ * \param K         key type. **MAY** consist of several tokens
+ * \param V         value type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MUST NOT** be empty
+ *
+ * \details It also defines `struct structTag##_Slot` with members `key` and
+ * `val`.
+ *
+ * ## Layout
+ *
+ * The table is a single allocation of `cap` slots followed by `cap +
+ * MIR_HashMap_GROUP_WIDTH - 1` control bytes. A control byte is either \ref
+ * MIR_HashMap_CTRL_EMPTY, \ref MIR_HashMap_CTRL_DELETED (a tombstone) or the
+ * 7 low bits of the hash of the key stored in the slot (the *H2* tag). Lookups
+ * probe \ref MIR_HashMap_GROUP_WIDTH control bytes at once (with SSE2 if
+ * available) and compare keys only in slots whose tag matches. The first
+ * `MIR_HashMap_GROUP_WIDTH - 1` control bytes are mirrored after the last one,
+ * so that every group can be loaded without wrapping.
+ *
+ * Members:
+ *   1. `slots` - pointer to the first slot (and to the allocation). **MAY** be
+ *      `NULL` if `cap` is `0`
+ *   2. `ctrl` - pointer to the first control byte. **MAY** be `NULL` if `cap`
+ *      is `0`
+ *   3. `len` - number of stored entries
+ *   4. `cap` - number of slots. Either `0` or a power of two not less than
+ *      \ref MIR_HashMap_GROUP_WIDTH
+ *   5. `growthLeft` - number of entries that can be inserted into empty slots
+ *      before the table has to be rehashed. The maximum load factor is `7/8`
+ *
+ * ## Interface
+ *
+ * Functions are generated by \ref MIR_HashMap_DEFINE. See it for details.
+ */
+#define MIR_HashMap(K, V, structTag)                                           \
+    struct structTag##_Slot {                                                  \
+        K key;                                                                 \
+        V val;                                                                 \
+    };                                                                         \
+    struct structTag {                                                         \
+        struct structTag##_Slot *slots;                                        \
+        unsigned char *ctrl;                                                   \
+        size_t len;                                                            \
+        size_t cap;                                                            \
+        size_t growthLeft;                                                     \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_HashMap
+ * struct.
+ */
+#define MIR_HashMap_OK 0
+
+/**
+ * \brief Number of control bytes probed at once.
+ */
+#define MIR_HashMap_GROUP_WIDTH 16u
+
+/**
+ * \brief Control byte of an empty slot.
+ */
+#define MIR_HashMap_CTRL_EMPTY ((unsigned char)0x80u)
+
+/**
+ * \brief Control byte of a slot whose entry was removed (a tombstone).
+ */
+#define MIR_HashMap_CTRL_DELETED ((unsigned char)0xFEu)
+
+/**
+ * \brief Checks whether the control byte belongs to an occupied slot.
+ */
+#define MIR_HashMap_CtrlIsFull(ctrl) ((ctrl) < 0x80u)
+
+
+/**
+ * \brief Returns the bitmask of the bytes of the group equal to `h2`.
+ */
+MIR_INLINE uint32_t
+__MIR_HashMap_GroupMatch(const unsigned char *group, unsigned char h2) {
+#ifdef __MIR_HASHMAP_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)(const void *)group);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char)h2), ctrl)
+    );
+#else
+    uint32_t mask = 0;
+    unsigned i;
+    for (i = 0; i < MIR_HashMap_GROUP_WIDTH; ++i) {
+        mask |= (uint32_t)(group[i] == h2) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * \brief Returns the bitmask of the empty bytes of the group.
+ */
+MIR_INLINE uint32_t __MIR_HashMap_GroupMatchEmpty(const unsigned char *group) {
+    return __MIR_HashMap_GroupMatch(group, MIR_HashMap_CTRL_EMPTY);
+}
+
+/**
+ * \brief Returns the bitmask of the empty or deleted bytes of the group.
+ */
+MIR_INLINE uint32_t
+__MIR_HashMap_GroupMatchEmptyOrDeleted(const unsigned char *group) {
+#ifdef __MIR_HASHMAP_SSE2
+    /* NOTE: only empty and deleted bytes have the high bit set */
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i *)(const void *)group)
+    );
+#else
+    uint32_t mask = 0;
+    unsigned i;
+    for (i = 0; i < MIR_HashMap_GROUP_WIDTH; ++i) {
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * \brief Sets the control byte `i` and its mirror (if any).
+ */
+MIR_INLINE void __MIR_HashMap_SetCtrl(
+    unsigned char *ctrl, size_t cap, size_t i, unsigned char h
+) {
+    ctrl[i] = h;
+    /* NOTE: for `i < GROUP_WIDTH - 1` it's `cap + i`, otherwise it's `i` */
+    ctrl[((i - (MIR_HashMap_GROUP_WIDTH - 1u)) & (cap - 1u)) +
+         (MIR_HashMap_GROUP_WIDTH - 1u)] = h;
+}
+
+/**
+ * \brief Finds the first empty or deleted slot in the probe sequence of the
+ * hash.
+ *
+ * \warning The table **MUST** have at least one empty or deleted slot.
+ */
+MIR_INLINE size_t
+__MIR_HashMap_FindNonFull(const unsigned char *ctrl, size_t cap, size_t hash) {
+    size_t mask = cap - 1u;
+    size_t pos = (hash >> 7) & mask;
+    size_t step = 0;
+    uint32_t match;
+
+    for (;;) {
+        match = __MIR_HashMap_GroupMatchEmptyOrDeleted(ctrl + pos);
+        if (match != 0u) {
+            return (pos + MIR_Bits_Ctz32(match)) & mask;
+        }
+        step += MIR_HashMap_GROUP_WIDTH;
+        pos = (pos + step) & mask;
+    }
+}
+
+/**
+ * \brief Marks the slot `i` as free.
+ *
+ * \details The slot becomes empty (instead of deleted) if no probe sequence
+ * could have ever passed over it, i.e. if there is no window of \ref
+ * MIR_HashMap_GROUP_WIDTH non-empty control bytes containing it.
+ *
+ * \return `1` if the slot became empty, `0` if it became a tombstone
+ */
+MIR_INLINE int
+__MIR_HashMap_EraseCtrl(unsigned char *ctrl, size_t cap, size_t i) {
+    size_t before = (i - MIR_HashMap_GROUP_WIDTH) & (cap - 1u);
+    uint32_t emptyBefore = __MIR_HashMap_GroupMatchEmpty(ctrl + before);
+    uint32_t emptyAfter = __MIR_HashMap_GroupMatchEmpty(ctrl + i);
+
+    if (emptyBefore != 0u && emptyAfter != 0u &&
+        MIR_Bits_Ctz32(emptyAfter) + (MIR_Bits_Clz32(emptyBefore) - 16u) <
+            MIR_HashMap_GROUP_WIDTH) {
+        __MIR_HashMap_SetCtrl(ctrl, cap, i, MIR_HashMap_CTRL_EMPTY);
+        return 1;
+    }
+
+    __MIR_HashMap_SetCtrl(ctrl, cap, i, MIR_HashMap_CTRL_DELETED);
+    return 0;
+}
+
+/**
+ * \brief Returns the smallest valid capacity that can hold `n` entries.
+ *
+ * \return capacity or `0` on overflow
+ */
+MIR_INLINE size_t __MIR_HashMap_CapacityFor(size_t n) {
+    size_t cap = MIR_HashMap_GROUP_WIDTH;
+
+    /* NOTE: `cap - cap / 8` is the maximum number of entries */
+    while (cap - cap / 8u < n) {
+        if (cap > SIZE_MAX / 2u) {
+            return 0;
+        }
+        cap *= 2u;
+    }
+    return cap;
+}
+
+
+/**
+ * \brief Generates the functions of \ref MIR_HashMap.
+ *
+ * \param K         key type. **MUST** be the same type as that passed to \ref
+ *                  MIR_HashMap macro
+ * \param V         value type. **MUST** be the same type as that passed to
+ *                  \ref MIR_HashMap macro
+ * \param structTag struct tag. **MUST** be the same as that passed to \ref
+ *                  MIR_HashMap macro. It's also used as the functions prefix
+ * \param HASH      hash function or function-like macro. It takes a pointer
+ *                  to const `K` and returns `size_t`. All bits of the result
+ *                  **SHOULD** be well mixed (the 7 low bits are used as the tag
+ *                  and the rest select the group)
+ * \param EQ        equality function or function-like macro. It takes two
+ *                  pointers to const `K` and returns non-zero if the keys are
+ *                  equal
+ *
+ * \details The functions are `static` (see \ref MIR_INLINE), so the macro
+ * **MAY** be used in headers.
+ *
+ * Keys and values are copied into the table by assignment. Pointers to the
+ * stored entries are invalidated by any insertion that rehashes the table.
+ *
+ * ## Generated functions
+ *
+ * \note Functions without `ByReallocF`/`ByFreeF` suffix that allocate or free
+ * will be defined only if `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + `void structTag##_Init(struct structTag *map)` - inits an empty map
+ *   without allocating
+ * + `V *structTag##_Find(const struct structTag *map, const K *key)` - returns
+ *   a pointer to the value or `NULL` if there is no such key
+ * + `int structTag##_PutByReallocF(reallocF, freeF, map, const K *key, const
+ *   V *val)` - inserts the entry or overwrites the value of the existing one.
+ *   `reallocF` is used as a malloc-like function (with `NULL` as the first
+ *   argument) and `freeF` frees the old table on rehash
+ * + `int structTag##_ReserveByReallocF(reallocF, freeF, map, size_t n)` -
+ *   makes room for `n` entries without rehashing
+ * + `int structTag##_Remove(struct structTag *map, const K *key, V *out)` -
+ *   removes the entry and writes its value into `out` (if not `NULL`).
+ *   Returns `1` if there is no such key
+ * + `struct structTag##_Slot *structTag##_Next(const struct structTag *map,
+ *   size_t *iter)` - iterates over the entries. `*iter` **MUST** be `0`
+ *   before the first call. Returns `NULL` after the last entry
+ * + `void structTag##_DeinitByFreeF(freeF, map)` - frees the table
+ * + `structTag##_Put`, `structTag##_Reserve`, `structTag##_Deinit` - the same
+ *   but by using standard library `realloc` and `free` functions
+ *
+ * Functions returning `int` return \ref MIR_HashMap_OK on success; any other
+ * value indicates failure.
+ *
+ * ### Example
+ *
+ * \code{.c}
+ * #define IntHash(k) ((size_t)*(k) * 0x9E3779B97F4A7C15u)
+ * #define IntEq(a, b) (*(a) == *(b))
+ *
+ * MIR_HashMap(int, double, IntMap);
+ * MIR_HashMap_DEFINE(int, double, IntMap, IntHash, IntEq)
+ *
+ * struct IntMap map;
+ * int key = 1;
+ * double val = 2.0;
+ *
+ * IntMap_Init(&map);
+ * IntMap_Put(&map, &key, &val);
+ * IntMap_Find(&map, &key); // points to 2.0
+ * IntMap_Deinit(&map);
+ * \endcode
+ */
+#define MIR_HashMap_DEFINE(K, V, structTag, HASH, EQ)                          \
+    __MIR_HashMap_DEFINE_CORE(K, V, structTag, HASH, EQ)                       \
+    __MIR_HashMap_DEFINE_STD(K, V, structTag)
+
+#define __MIR_HashMap_DEFINE_CORE(K, V, structTag, HASH, EQ)                   \
+                                                                               \
+    MIR_INLINE void structTag##_Init(struct structTag *map) {                  \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        map->slots = NULL;                                                     \
+        map->ctrl = NULL;                                                      \
+        map->len = 0;                                                          \
+        map->cap = 0;                                                          \
+        map->growthLeft = 0;                                                   \
+    }                                                                          \
+                                                                               \
+    /* NOTE: returns the slot index or `map->cap` if there is no such key */  \
+    MIR_INLINE size_t structTag##__FindIndex(                                  \
+        const struct structTag *map, const K *key, size_t hash                 \
+    ) {                                                                        \
+        size_t mask = map->cap - 1u;                                           \
+        size_t pos = (hash >> 7) & mask;                                       \
+        size_t step = 0;                                                       \
+        size_t i;                                                              \
+        uint32_t match;                                                        \
+        unsigned char h2 = (unsigned char)(hash & 0x7Fu);                      \
+                                                                               \
+        if (map->cap == 0u) {                                                  \
+            return 0;                                                          \
+        }                                                                      \
+        for (;;) {                                                             \
+            match = __MIR_HashMap_GroupMatch(map->ctrl + pos, h2);             \
+            while (match != 0u) {                                              \
+                i = (pos + MIR_Bits_Ctz32(match)) & mask;                      \
+                if (MIR_LIKELY(EQ(key, &map->slots[i].key))) {                 \
+                    return i;                                                  \
+                }                                                              \
+                match &= match - 1u;                                           \
+            }                                                                  \
+            if (MIR_LIKELY(                                                    \
+                    __MIR_HashMap_GroupMatchEmpty(map->ctrl + pos) != 0u       \
+                )) {                                                           \
+                return map->cap;                                               \
+            }                                                                  \
+            step += MIR_HashMap_GROUP_WIDTH;                                   \
+            pos = (pos + step) & mask;                                         \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE V *structTag##_Find(                                            \
+        const struct structTag *map, const K *key                              \
+    ) {                                                                        \
+        size_t i;                                                              \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+                                                                               \
+        i = structTag##__FindIndex(map, key, (size_t)(HASH(key)));             \
+        return (i < map->cap) ? &map->slots[i].val : NULL;                     \
+    }                                                                          \
+                                                                               \
+    /* NOTE: moves all entries into a new table with `newCap` slots */        \
+    MIR_INLINE int structTag##__RehashByReallocF(                              \
+        void *(*reallocF)(void *, size_t), void (*freeF)(void *),              \
+        struct structTag *map, size_t newCap                                   \
+    ) {                                                                        \
+        struct structTag##_Slot *slots;                                        \
+        unsigned char *ctrl;                                                   \
+        size_t size;                                                           \
+        size_t i;                                                              \
+        size_t j;                                                              \
+        size_t hash;                                                           \
+                                                                               \
+        if (MIR_u_Mul_WillOverflow(newCap, sizeof(*slots), SIZE_MAX) != 0) {   \
+            return 1;                                                          \
+        }                                                                      \
+        size = newCap * sizeof(*slots);                                        \
+        if (MIR_u_Add_WillOverflow(                                            \
+                size, newCap + MIR_HashMap_GROUP_WIDTH - 1u                    \
+            ) != 0) {                                                          \
+            return 1;                                                          \
+        }                                                                      \
+        size += newCap + MIR_HashMap_GROUP_WIDTH - 1u;                         \
+                                                                               \
+        slots = (struct structTag##_Slot *)reallocF(NULL, size);               \
+        if (slots == NULL) {                                                   \
+            return 1;                                                          \
+        }                                                                      \
+        ctrl = (unsigned char *)(slots + newCap);                              \
+        memset(                                                                \
+            ctrl, MIR_HashMap_CTRL_EMPTY,                                      \
+            newCap + MIR_HashMap_GROUP_WIDTH - 1u                              \
+        );                                                                     \
+                                                                               \
+        for (i = 0; i < map->cap; ++i) {                                       \
+            if (!MIR_HashMap_CtrlIsFull(map->ctrl[i])) {                       \
+                continue;                                                      \
+            }                                                                  \
+            hash = (size_t)(HASH(&map->slots[i].key));                         \
+            j = __MIR_HashMap_FindNonFull(ctrl, newCap, hash);                 \
+            __MIR_HashMap_SetCtrl(                                             \
+                ctrl, newCap, j, (unsigned char)(hash & 0x7Fu)                 \
+            );                                                                 \
+            slots[j] = map->slots[i];                                          \
+        }                                                                      \
+                                                                               \
+        if (map->slots != NULL) {                                              \
+            freeF(map->slots);                                                 \
+        }                                                                      \
+        map->slots = slots;                                                    \
+        map->ctrl = ctrl;                                                      \
+        map->cap = newCap;                                                     \
+        map->growthLeft = newCap - newCap / 8u - map->len;                     \
+        return MIR_HashMap_OK;                                                 \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_ReserveByReallocF(                              \
+        void *(*reallocF)(void *, size_t), void (*freeF)(void *),              \
+        struct structTag *map, size_t n                                        \
+    ) {                                                                        \
+        size_t newCap;                                                         \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(                                                      \
+            reallocF != NULL, "param `reallocF' MUST NOT be NULL"              \
+        );                                                                     \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+                                                                               \
+        if (n <= map->len + map->growthLeft) {                                 \
+            return MIR_HashMap_OK;                                             \
+        }                                                                      \
+        newCap = __MIR_HashMap_CapacityFor(n);                                 \
+        if (newCap == 0u) {                                                    \
+            return 1;                                                          \
+        }                                                                      \
+        return structTag##__RehashByReallocF(reallocF, freeF, map, newCap);    \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PutByReallocF(                                  \
+        void *(*reallocF)(void *, size_t), void (*freeF)(void *),              \
+        struct structTag *map, const K *key, const V *val                      \
+    ) {                                                                        \
+        size_t hash;                                                           \
+        size_t i;                                                              \
+        size_t newCap;                                                         \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(val != NULL, "param `val' MUST NOT be NULL");         \
+                                                                               \
+        hash = (size_t)(HASH(key));                                            \
+        i = structTag##__FindIndex(map, key, hash);                            \
+        if (i < map->cap) {                                                    \
+            map->slots[i].val = *val;                                          \
+            return MIR_HashMap_OK;                                             \
+        }                                                                      \
+                                                                               \
+        if (map->cap != 0u) {                                                  \
+            i = __MIR_HashMap_FindNonFull(map->ctrl, map->cap, hash);          \
+        }                                                                      \
+        /* NOTE: reusing a tombstone does not consume the growth budget */    \
+        if (map->cap == 0u ||                                                  \
+            (map->growthLeft == 0u &&                                          \
+             map->ctrl[i] != MIR_HashMap_CTRL_DELETED)) {                      \
+            /* NOTE: if at least a half of the budget is eaten by tombstones, \
+             *       rehash in place instead of growing */                    \
+            if (map->cap == 0u) {                                              \
+                newCap = MIR_HashMap_GROUP_WIDTH;                              \
+            } else if (map->len <= (map->cap - map->cap / 8u) / 2u) {          \
+                newCap = map->cap;                                             \
+            } else if (map->cap > SIZE_MAX / 2u) {                             \
+                return 1;                                                      \
+            } else {                                                           \
+                newCap = map->cap * 2u;                                        \
+            }                                                                  \
+            if (structTag##__RehashByReallocF(reallocF, freeF, map, newCap) != \
+                MIR_HashMap_OK) {                                              \
+                return 1;                                                      \
+            }                                                                  \
+            i = __MIR_HashMap_FindNonFull(map->ctrl, map->cap, hash);          \
+        }                                                                      \
+                                                                               \
+        if (map->ctrl[i] == MIR_HashMap_CTRL_EMPTY) {                          \
+            --map->growthLeft;                                                 \
+        }                                                                      \
+        __MIR_HashMap_SetCtrl(                                                 \
+            map->ctrl, map->cap, i, (unsigned char)(hash & 0x7Fu)              \
+        );                                                                     \
+        map->slots[i].key = *key;                                              \
+        map->slots[i].val = *val;                                              \
+        ++map->len;                                                            \
+        return MIR_HashMap_OK;                                                 \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_Remove(                                         \
+        struct structTag *map, const K *key, V *out                            \
+    ) {                                                                        \
+        size_t i;                                                              \
+                                                                               \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+                                                                               \
+        i = structTag##__FindIndex(map, key, (size_t)(HASH(key)));             \
+        if (i >= map->cap) {                                                   \
+            return 1;                                                          \
+        }                                                                      \
+        if (out != NULL) {                                                     \
+            *out = map->slots[i].val;                                          \
+        }                                                                      \
+        map->growthLeft +=                                                     \
+            (size_t)__MIR_HashMap_EraseCtrl(map->ctrl, map->cap, i);           \
+        --map->len;                                                            \
+        return MIR_HashMap_OK;                                                 \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE struct structTag##_Slot *structTag##_Next(                      \
+        const struct structTag *map, size_t *iter                              \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");       \
+                                                                               \
+        for (; *iter < map->cap; ++*iter) {                                    \
+            if (MIR_HashMap_CtrlIsFull(map->ctrl[*iter])) {                    \
+                return &map->slots[(*iter)++];                                 \
+            }                                                                  \
+        }                                                                      \
+        return NULL;                                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *map                           \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+        __MIR_ASSERT_MSG(map != NULL, "param `map' MUST NOT be NULL");         \
+                                                                               \
+        if (map->slots != NULL) {                                              \
+            freeF(map->slots);                                                 \
+        }                                                                      \
+        structTag##_Init(map);                                                 \
+    }
+
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define __MIR_HashMap_DEFINE_STD(K, V, structTag)                          \
+                                                                               \
+        MIR_INLINE int structTag##_Reserve(struct structTag *map, size_t n) {  \
+            return structTag##_ReserveByReallocF(realloc, free, map, n);       \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE int structTag##_Put(                                        \
+            struct structTag *map, const K *key, const V *val                  \
+        ) {                                                                    \
+            return structTag##_PutByReallocF(realloc, free, map, key, val);    \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE void structTag##_Deinit(struct structTag *map) {            \
+            structTag##_DeinitByFreeF(free, map);                              \
+        }
+#else
+#    define __MIR_HashMap_DEFINE_STD(K, V, structTag)
+#endif
+
+#endif /* _MIR_COMMON_COLLECTIONS_HASHMAP_H */
@@ -0,0 +1,585 @@
+/**
+ * \file
+ *
+ * \brief d-ary heaps (priority queues) on \ref MIR_Vec
+ *
+ * \details
+ * + \ref MIR_HEAP_DEFINE generates a min-heap over an array of `type`
+ *   ordered by `LESS`. The `MIR_Vec_Heap...` macros use the elements of a
+ *   \ref MIR_Vec as the heap
+ * + \ref MIR_IndexedHeap - a heap of `(key, id)` items that knows where every
+ *   id is, so the key of an id can be decreased (e.g. for Dijkstra's
+ *   algorithm)
+ *
+ * The children of node `i` are nodes `D * i + 1 ... D * i + D`, where `D` is
+ * the arity. A wider node makes the heap `log2(D)` times shallower, so a
+ * pop touches fewer cache lines: all `D` children of a node are adjacent and
+ * are compared in one pass, and the group of the grandchildren is prefetched
+ * while it happens. With `D * sizeof(type)` not exceeding \ref
+ * MIR_CACHE_LINE_SIZE a group spans at most two cache lines. Comparisons are
+ * inlined, as in \ref MIR_SORT_DEFINE.
+ *
+ * \code{.c}
+ * #define TaskLess(a, b) ((a)->deadline < (b)->deadline)
+ * MIR_HEAP_DEFINE(struct Task, Tasks, TaskLess, 4)
+ *
+ * MIR_Vec(struct Task, TaskVec) queue;
+ * struct Task task;
+ * ...
+ * MIR_Vec_Heapify(Tasks, &queue);
+ * MIR_Vec_HeapPush(Tasks, struct Task, &queue, &task);
+ * MIR_Vec_HeapPop(Tasks, &queue, &task);
+ * \endcode
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_HEAP_H
+#define _MIR_COMMON_COLLECTIONS_HEAP_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+#include <string.h> /* memcpy */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/collections/vec.h> /* MIR_Vec */
+#include <mir/common/macros.h>          /* MIR_INLINE, MIR_PREFETCH */
+#include <mir/internal/assert.h>        /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Turns the elements of a \ref MIR_Vec into a heap in `O(len)`.
+ *
+ * \param name name passed to \ref MIR_HEAP_DEFINE
+ * \param vec  pointer to \ref MIR_Vec struct
+ */
+#define MIR_Vec_Heapify(name, vec) name##_Heapify((vec)->data, (vec)->len)
+
+/**
+ * \brief Returns a pointer to the smallest element of a heap.
+ *
+ * \param[in] vec pointer to non-empty \ref MIR_Vec struct
+ */
+#define MIR_Vec_HeapTop(vec) MIR_Vec_GetPtr(vec, 0u)
+
+/**
+ * \brief Pushes the element onto a heap by using provided realloc-like
+ * function.
+ *
+ * \param         name     name passed to \ref MIR_HEAP_DEFINE
+ * \param         type     type of elements
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param[in]     elem     pointer to the element
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#define MIR_Vec_HeapPushByReallocF(name, type, reallocF, vec, elem)            \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (MIR_Vec_PushByReallocF(type, reallocF, vec, elem) != MIR_Vec_OK)      \
+            ? 1                                                                \
+            : (name##_SiftUp((vec)->data, (vec)->len - 1u), MIR_Vec_OK)        \
+    ) /* clang-format on */
+
+/**
+ * \brief Pushes `n` elements onto a heap by using provided realloc-like
+ * function.
+ *
+ * \details Reserves the space once. Depending on how many elements are
+ * pushed, they are either sifted up one by one or the whole heap is rebuilt.
+ *
+ * \param         name     name passed to \ref MIR_HEAP_DEFINE
+ * \param         type     type of elements
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param[in]     elems    pointer to `n` elements
+ * \param         n        number of elements
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#define MIR_Vec_HeapPushBatchByReallocF(name, type, reallocF, vec, elems, n)   \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        ((n) > SIZE_MAX - (vec)->len ||                                        \
+         MIR_Vec_ReserveByReallocF(                                            \
+             type, reallocF, vec, (vec)->len + (n)                             \
+         ) != MIR_Vec_OK)                                                      \
+            ? 1                                                                \
+            : (name##_PushBatch((vec)->data, &(vec)->len, (elems), (n)),       \
+               MIR_Vec_OK)                                                     \
+    ) /* clang-format on */
+
+/**
+ * \brief Pops the smallest element of a heap.
+ *
+ * \param         name name passed to \ref MIR_HEAP_DEFINE
+ * \param[in,out] vec  pointer to \ref MIR_Vec struct
+ * \param[out]    out  pointer where the element will be written
+ *
+ * \return \ref MIR_Vec_OK on success; `1` if the heap is empty
+ */
+#define MIR_Vec_HeapPop(name, vec, out)                                        \
+    name##_Pop((vec)->data, &(vec)->len, (out))
+
+/**
+ * \brief Pops at most `n` smallest elements of a heap in the ascending order.
+ *
+ * \param         name name passed to \ref MIR_HEAP_DEFINE
+ * \param[in,out] vec  pointer to \ref MIR_Vec struct
+ * \param[out]    out  pointer to room for `n` elements
+ * \param         n    maximal number of elements to pop
+ *
+ * \return number of popped elements
+ */
+#define MIR_Vec_HeapPopBatch(name, vec, out, n)                                \
+    name##_PopBatch((vec)->data, &(vec)->len, (out), (n))
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Vec_HeapPushByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Vec_HeapPush(name, type, vec, elem)                            \
+        MIR_Vec_HeapPushByReallocF(name, type, realloc, vec, elem)
+
+/**
+ * \brief The same as \ref MIR_Vec_HeapPushBatchByReallocF but uses standard
+ * library `realloc` function.
+ */
+#    define MIR_Vec_HeapPushBatch(name, type, vec, elems, n)                   \
+        MIR_Vec_HeapPushBatchByReallocF(name, type, realloc, vec, elems, n)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+/**
+ * \brief Defines min-heap functions for arrays of `type` ordered by `LESS`.
+ *
+ * \param type  elements type. **MAY** consist of several tokens
+ * \param name  prefix of the generated functions
+ * \param LESS  macro or function `int LESS(const type *a, const type *b)`,
+ *              see \ref MIR_SORT_DEFINE
+ * \param ARITY number of children of a node. **SHOULD** be `4` or `8`
+ *
+ * \details Generated functions:
+ * + `void name##_SiftUp(type *data, size_t i)` - restores the heap after
+ *   element `i` has been decreased (or appended)
+ * + `void name##_SiftDown(type *data, size_t len, size_t i)` - restores the
+ *   heap after element `i` has been increased
+ * + `void name##_Heapify(type *data, size_t len)` - builds a heap in `O(len)`
+ * + `void name##_PushBatch(type *data, size_t *len, const type *elems,
+ *   size_t n)` - appends `n` elements and restores the heap. `data` **MUST**
+ *   have room for them
+ * + `int name##_Pop(type *data, size_t *len, type *out)` - moves the smallest
+ *   element to `out`; returns `1` if the heap is empty
+ * + `size_t name##_PopBatch(type *data, size_t *len, type *out, size_t n)` -
+ *   pops at most `n` elements in the ascending order, returns their number
+ */
+#define MIR_HEAP_DEFINE(type, name, LESS, ARITY)                               \
+                                                                               \
+    MIR_INLINE void name##_SiftUp(type *data, size_t i) {                      \
+        type x = data[i];                                                      \
+        size_t p;                                                              \
+                                                                               \
+        while (i > 0u) {                                                       \
+            p = (i - 1u) / (ARITY);                                            \
+            if (!(LESS(&x, &data[p]))) {                                       \
+                break;                                                         \
+            }                                                                  \
+            data[i] = data[p];                                                 \
+            i = p;                                                             \
+        }                                                                      \
+        data[i] = x;                                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##_SiftDown(type *data, size_t len, size_t i) {        \
+        type x = data[i];                                                      \
+        size_t best;                                                           \
+        size_t end;                                                            \
+        size_t c;                                                              \
+        size_t j;                                                              \
+        size_t g;                                                              \
+                                                                               \
+        while ((c = (ARITY) * i + 1u) < len) {                                 \
+            /* NOTE: the grandchildren are the children of one of `c..`,       \
+             *       so fetch the first and the last of their groups (the      \
+             *       last one clamped, so the pointer stays in the array) */   \
+            if ((ARITY) * c + 1u < len) {                                      \
+                MIR_PREFETCH(data + (ARITY) * c + 1u);                         \
+                g = (ARITY) * (c + (ARITY) - 1u) + 1u;                         \
+                MIR_PREFETCH(data + ((g < len) ? g : len - 1u));               \
+            }                                                                  \
+            end = (len - c > (ARITY)) ? c + (ARITY) : len;                     \
+            best = c;                                                          \
+            for (j = c + 1u; j < end; ++j) {                                   \
+                best = (LESS(&data[j], &data[best])) ? j : best;               \
+            }                                                                  \
+            if (!(LESS(&data[best], &x))) {                                    \
+                break;                                                         \
+            }                                                                  \
+            data[i] = data[best];                                              \
+            i = best;                                                          \
+        }                                                                      \
+        data[i] = x;                                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##_Heapify(type *data, size_t len) {                   \
+        size_t i;                                                              \
+                                                                               \
+        if (len < 2u) {                                                        \
+            return;                                                            \
+        }                                                                      \
+        for (i = (len - 2u) / (ARITY) + 1u; i-- > 0u;) {                       \
+            name##_SiftDown(data, len, i);                                     \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##_PushBatch(                                          \
+        type *data, size_t *len, const type *elems, size_t n                   \
+    ) {                                                                        \
+        size_t i;                                                              \
+                                                                               \
+        if (n == 0u) {                                                         \
+            return;                                                            \
+        }                                                                      \
+        memcpy(data + *len, elems, n * sizeof(type));                          \
+        /* NOTE: rebuilding costs `O(len + n)`, sifting up `O(n log(len))` */  \
+        if (n > *len / (ARITY)) {                                              \
+            *len += n;                                                         \
+            name##_Heapify(data, *len);                                        \
+            return;                                                            \
+        }                                                                      \
+        for (i = *len; i < *len + n; ++i) {                                    \
+            name##_SiftUp(data, i);                                            \
+        }                                                                      \
+        *len += n;                                                             \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int name##_Pop(type *data, size_t *len, type *out) {            \
+        __MIR_ASSERT_MSG(len != NULL, "param `len' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(out != NULL, "param `out' MUST NOT be NULL");         \
+                                                                               \
+        if (*len == 0u) {                                                      \
+            return 1;                                                          \
+        }                                                                      \
+        *out = data[0];                                                        \
+        if (--*len > 0u) {                                                     \
+            data[0] = data[*len];                                              \
+            name##_SiftDown(data, *len, 0);                                    \
+        }                                                                      \
+        return 0;                                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE size_t name##_PopBatch(                                         \
+        type *data, size_t *len, type *out, size_t n                           \
+    ) {                                                                        \
+        size_t i;                                                              \
+                                                                               \
+        for (i = 0; i < n && name##_Pop(data, len, &out[i]) == 0; ++i) {       \
+        }                                                                      \
+        return i;                                                              \
+    }
+
+
+/**
+ * \brief Defines an indexed heap struct.
+ *
+ * \param type      key type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MUST NOT** be empty
+ *
+ * \details The heap holds items `struct structTag##_Item {type key; size_t
+ * id;}`, at most one per id. Ids are small non-negative integers (e.g. graph
+ * vertices): `pos` maps every id to the index of its item in `items`, or to
+ * `SIZE_MAX` if the id is not in the heap, so the key of an id can be
+ * found and decreased in `O(log(len))` without searching.
+ *
+ * Members:
+ *   1. `items` - \ref MIR_Vec of items in the heap order
+ *   2. `pos` - \ref MIR_Vec of positions, indexed by id
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ *
+ * ## Interface
+ *
+ * Functions are generated by \ref MIR_INDEXEDHEAP_DEFINE.
+ */
+#define MIR_IndexedHeap(type, structTag)                                       \
+    struct structTag##_Item {                                                  \
+        type key;                                                              \
+        size_t id;                                                             \
+    };                                                                         \
+    struct structTag {                                                         \
+        MIR_Vec(struct structTag##_Item, structTag##_Items) items;             \
+        MIR_Vec(size_t, structTag##_Pos) pos;                                  \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref
+ * MIR_IndexedHeap struct.
+ */
+#define MIR_IndexedHeap_OK 0
+
+/**
+ * \brief Generates the functions of \ref MIR_IndexedHeap.
+ *
+ * \param type      key type. **MUST** be the same type as that passed to \ref
+ *                  MIR_IndexedHeap macro
+ * \param structTag struct tag. **MUST** be the same as that passed to \ref
+ *                  MIR_IndexedHeap macro. It's also used as the functions
+ *                  prefix
+ * \param LESS      macro or function `int LESS(const type *a, const type *b)`
+ * \param ARITY     number of children of a node. **SHOULD** be `4` or `8`
+ *
+ * \details Generated functions:
+ * + `void structTag##_Init(struct structTag *heap)`
+ * + `int structTag##_ReserveByReallocF(reallocF, heap, size_t ids)` - makes
+ *   room for ids `0 ... ids - 1` so that pushing them does not allocate
+ * + `int structTag##_PushByReallocF(reallocF, heap, size_t id, const type
+ *   *key)` - inserts the id. It **MUST NOT** be in the heap
+ * + `void structTag##_DecreaseKey(heap, size_t id, const type *key)` - sets a
+ *   smaller key of the id. It **MUST** be in the heap
+ * + `int structTag##_PushOrDecreaseByReallocF(reallocF, heap, size_t id,
+ *   const type *key)` - inserts the id, or decreases its key if `key` is
+ *   smaller than the current one (otherwise does nothing)
+ * + `const type *structTag##_Find(const struct structTag *heap, size_t id)` -
+ *   the key of the id or `NULL` if it's not in the heap
+ * + `int structTag##_Pop(heap, size_t *id, type *key)` - removes the item with
+ *   the smallest key. `id` and `key` **MAY** be `NULL`. Returns `1` if the
+ *   heap is empty
+ * + `void structTag##_DeinitByFreeF(freeF, heap)`
+ * + `structTag##_Reserve`, `structTag##_Push`, `structTag##_PushOrDecrease`,
+ *   `structTag##_Deinit` - the same but by using standard library `realloc`
+ *   and `free` functions
+ *
+ * Functions returning `int` return \ref MIR_IndexedHeap_OK on success; any
+ * other value indicates failure.
+ */
+#define MIR_INDEXEDHEAP_DEFINE(type, structTag, LESS, ARITY)                   \
+    __MIR_INDEXEDHEAP_DEFINE_CORE(type, structTag, LESS, ARITY)                \
+    __MIR_INDEXEDHEAP_DEFINE_STD(type, structTag)
+
+#define __MIR_INDEXEDHEAP_DEFINE_CORE(type, structTag, LESS, ARITY)            \
+                                                                               \
+    MIR_INLINE void structTag##_Init(struct structTag *heap) {                 \
+        __MIR_ASSERT_MSG(heap != NULL, "param `heap' MUST NOT be NULL");       \
+        MIR_Vec_Init(&heap->items);                                            \
+        MIR_Vec_Init(&heap->pos);                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##__SiftUp(struct structTag *heap, size_t i) {    \
+        struct structTag##_Item *items = heap->items.data;                     \
+        struct structTag##_Item x = items[i];                                  \
+        size_t p;                                                              \
+                                                                               \
+        while (i > 0u) {                                                       \
+            p = (i - 1u) / (ARITY);                                            \
+            if (!(LESS(&x.key, &items[p].key))) {                              \
+                break;                                                         \
+            }                                                                  \
+            items[i] = items[p];                                               \
+            heap->pos.data[items[i].id] = i;                                   \
+            i = p;                                                             \
+        }                                                                      \
+        items[i] = x;                                                          \
+        heap->pos.data[x.id] = i;                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##__SiftDown(struct structTag *heap, size_t i) {  \
+        struct structTag##_Item *items = heap->items.data;                     \
+        struct structTag##_Item x = items[i];                                  \
+        size_t len = heap->items.len;                                          \
+        size_t best;                                                           \
+        size_t end;                                                            \
+        size_t c;                                                              \
+        size_t j;                                                              \
+        size_t g;                                                              \
+                                                                               \
+        while ((c = (ARITY) * i + 1u) < len) {                                 \
+            if ((ARITY) * c + 1u < len) {                                      \
+                MIR_PREFETCH(items + (ARITY) * c + 1u);                        \
+                g = (ARITY) * (c + (ARITY) - 1u) + 1u;                         \
+                MIR_PREFETCH(items + ((g < len) ? g : len - 1u));              \
+            }                                                                  \
+            end = (len - c > (ARITY)) ? c + (ARITY) : len;                     \
+            best = c;                                                          \
+            for (j = c + 1u; j < end; ++j) {                                   \
+                best = (LESS(&items[j].key, &items[best].key)) ? j : best;     \
+            }                                                                  \
+            if (!(LESS(&items[best].key, &x.key))) {                           \
+                break;                                                         \
+            }                                                                  \
+            items[i] = items[best];                                            \
+            heap->pos.data[items[i].id] = i;                                   \
+            i = best;                                                          \
+        }                                                                      \
+        items[i] = x;                                                          \
+        heap->pos.data[x.id] = i;                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_ReserveByReallocF(                              \
+        void *(*reallocF)(void *, size_t), struct structTag *heap, size_t ids  \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(heap != NULL, "param `heap' MUST NOT be NULL");       \
+                                                                               \
+        if (MIR_Vec_ReserveByReallocF(size_t, reallocF, &heap->pos, ids) !=    \
+                MIR_Vec_OK ||                                                  \
+            MIR_Vec_ReserveByReallocF(                                         \
+                struct structTag##_Item, reallocF, &heap->items, ids           \
+            ) != MIR_Vec_OK) {                                                 \
+            return 1;                                                          \
+        }                                                                      \
+        while (heap->pos.len < ids) {                                          \
+            heap->pos.data[heap->pos.len++] = SIZE_MAX;                        \
+        }                                                                      \
+        return MIR_IndexedHeap_OK;                                             \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE const type *structTag##_Find(                                   \
+        const struct structTag *heap, size_t id                                \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(heap != NULL, "param `heap' MUST NOT be NULL");       \
+                                                                               \
+        return (id < heap->pos.len && heap->pos.data[id] != SIZE_MAX)          \
+                   ? &heap->items.data[heap->pos.data[id]].key                 \
+                   : NULL;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PushByReallocF(                                 \
+        void *(*reallocF)(void *, size_t), struct structTag *heap, size_t id,  \
+        const type *key                                                        \
+    ) {                                                                        \
+        struct structTag##_Item item;                                          \
+        size_t ids;                                                            \
+                                                                               \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(                                                      \
+            structTag##_Find(heap, id) == NULL,                                \
+            "param `id' MUST NOT be in the heap"                               \
+        );                                                                     \
+                                                                               \
+        /* NOTE: grow the positions geometrically as ids usually come in       \
+         *       increasing order */                                           \
+        if (id >= heap->pos.len) {                                             \
+            if (id == SIZE_MAX) {                                              \
+                return 1;                                                      \
+            }                                                                  \
+            ids = (heap->pos.cap > SIZE_MAX / 2u) ? SIZE_MAX                   \
+                                                  : heap->pos.cap * 2u;        \
+            if (structTag##_ReserveByReallocF(                                 \
+                    reallocF, heap, (id + 1u > ids) ? id + 1u : ids            \
+                ) != MIR_IndexedHeap_OK) {                                     \
+                return 1;                                                      \
+            }                                                                  \
+        }                                                                      \
+        item.key = *key;                                                       \
+        item.id = id;                                                          \
+        if (MIR_Vec_PushByReallocF(                                            \
+                struct structTag##_Item, reallocF, &heap->items, &item         \
+            ) != MIR_Vec_OK) {                                                 \
+            return 1;                                                          \
+        }                                                                      \
+        structTag##__SiftUp(heap, heap->items.len - 1u);                       \
+        return MIR_IndexedHeap_OK;                                             \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DecreaseKey(                                   \
+        struct structTag *heap, size_t id, const type *key                     \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(key != NULL, "param `key' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(                                                      \
+            structTag##_Find(heap, id) != NULL,                                \
+            "param `id' MUST be in the heap"                                   \
+        );                                                                     \
+        __MIR_ASSERT_MSG(                                                      \
+            !(LESS(structTag##_Find(heap, id), key)),                          \
+            "param `key' MUST NOT be greater than the current key"             \
+        );                                                                     \
+                                                                               \
+        heap->items.data[heap->pos.data[id]].key = *key;                       \
+        structTag##__SiftUp(heap, heap->pos.data[id]);                         \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PushOrDecreaseByReallocF(                       \
+        void *(*reallocF)(void *, size_t), struct structTag *heap, size_t id,  \
+        const type *key                                                        \
+    ) {                                                                        \
+        const type *cur = structTag##_Find(heap, id);                          \
+                                                                               \
+        if (cur == NULL) {                                                     \
+            return structTag##_PushByReallocF(reallocF, heap, id, key);        \
+        }                                                                      \
+        if (LESS(key, cur)) {                                                  \
+            structTag##_DecreaseKey(heap, id, key);                            \
+        }                                                                      \
+        return MIR_IndexedHeap_OK;                                             \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_Pop(                                            \
+        struct structTag *heap, size_t *id, type *key                          \
+    ) {                                                                        \
+        struct structTag##_Item *items = heap->items.data;                     \
+                                                                               \
+        __MIR_ASSERT_MSG(heap != NULL, "param `heap' MUST NOT be NULL");       \
+                                                                               \
+        if (heap->items.len == 0u) {                                           \
+            return 1;                                                          \
+        }                                                                      \
+        if (id != NULL) {                                                      \
+            *id = items[0].id;                                                 \
+        }                                                                      \
+        if (key != NULL) {                                                     \
+            *key = items[0].key;                                               \
+        }                                                                      \
+        heap->pos.data[items[0].id] = SIZE_MAX;                                \
+        if (--heap->items.len > 0u) {                                          \
+            items[0] = items[heap->items.len];                                 \
+            structTag##__SiftDown(heap, 0);                                    \
+        }                                                                      \
+        return MIR_IndexedHeap_OK;                                             \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *heap                          \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(heap != NULL, "param `heap' MUST NOT be NULL");       \
+                                                                               \
+        MIR_Vec_DeinitByFreeF(freeF, &heap->items);                            \
+        MIR_Vec_DeinitByFreeF(freeF, &heap->pos);                              \
+        structTag##_Init(heap);                                                \
+    }
+
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define __MIR_INDEXEDHEAP_DEFINE_STD(type, structTag)                      \
+                                                                               \
+        MIR_INLINE int structTag##_Reserve(                                    \
+            struct structTag *heap, size_t ids                                 \
+        ) {                                                                    \
+            return structTag##_ReserveByReallocF(realloc, heap, ids);          \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE int structTag##_Push(                                       \
+            struct structTag *heap, size_t id, const type *key                 \
+        ) {                                                                    \
+            return structTag##_PushByReallocF(realloc, heap, id, key);         \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE int structTag##_PushOrDecrease(                             \
+            struct structTag *heap, size_t id, const type *key                 \
+        ) {                                                                    \
+            return structTag##_PushOrDecreaseByReallocF(                       \
+                realloc, heap, id, key                                         \
+            );                                                                 \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE void structTag##_Deinit(struct structTag *heap) {           \
+            structTag##_DeinitByFreeF(free, heap);                             \
+        }
+#else
+#    define __MIR_INDEXEDHEAP_DEFINE_STD(type, structTag)
+#endif
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_HEAP_H */
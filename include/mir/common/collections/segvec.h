@@ -0,0 +1,411 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_SegVec utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_SEGVEC_H
+#define _MIR_COMMON_COLLECTIONS_SEGVEC_H
+
+
+#include <limits.h> /* CHAR_BIT */
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint64_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/bits.h>     /* MIR_Bits_Clz64 */
+#include <mir/common/macros.h>   /* MIR_INLINE */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \def MIR_SEGVEC_FIRST_SHIFT
+ *
+ * \brief Binary logarithm of the length of the first segment of a \ref
+ * MIR_SegVec.
+ *
+ * \details Segment `s` holds `MIR_SEGVEC_FIRST_LEN << s` elements, so the
+ * capacity doubles with every segment. It can be redefined at the library
+ * build time.
+ */
+#ifndef MIR_SEGVEC_FIRST_SHIFT
+#    define MIR_SEGVEC_FIRST_SHIFT 4u
+#endif
+
+/**
+ * \brief Length of the first segment of a \ref MIR_SegVec.
+ */
+#define MIR_SEGVEC_FIRST_LEN ((size_t)1 << MIR_SEGVEC_FIRST_SHIFT)
+
+/**
+ * \brief Maximal number of segments of a \ref MIR_SegVec.
+ */
+#define MIR_SEGVEC_MAX_SEGS (sizeof(size_t) * CHAR_BIT - MIR_SEGVEC_FIRST_SHIFT)
+
+/**
+ * \brief Defines a segmented vector struct.
+ *
+ * \param type      elements type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \details A segmented vector is a vector whose storage is a list of
+ * segments, each twice as long as the previous one. Growing allocates a new
+ * segment and never moves the existing ones, so pointers to elements stay
+ * valid until the element is removed and no element is ever copied. Element
+ * `i` lives in segment `s = log2(i + F) - log2(F)` at offset
+ * `i + F - (F << s)`, where `F` is \ref MIR_SEGVEC_FIRST_LEN, which is a
+ * count-leading-zeros and a subtraction.
+ *
+ * Members:
+ *   1. `segs` - segments. `segs[s]` is valid if `s` is less than the number
+ *      of segments covering `cap`
+ *   2. `len` - number of elements currently stored. **MAY** be `0`
+ *   3. `cap` - capacity (in elements) of all allocated segments. **MAY** be
+ *      `0`
+ *
+ * Rules:
+ *   1. `type`'s `sizeof` **MUST** be greater than `0`
+ *   2. member `cap` **MUST** be always greater or equal to member `len`
+ *   3. members **MUST NOT** be modified directly, except for the elements
+ *
+ * ## Interface
+ *
+ * \note \ref MIR_SegVec_Reserve, \ref MIR_SegVec_Push, \ref
+ * MIR_SegVec_ShrinkToFit and \ref MIR_SegVec_Deinit will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_SegVec_Get, \ref MIR_SegVec_GetPtr, \ref MIR_SegVec_Set
+ * + \ref MIR_SegVec_Init, \ref MIR_SegVec_ReserveByReallocF, \ref
+ *   MIR_SegVec_PushByReallocF, \ref MIR_SegVec_Pop, \ref MIR_SegVec_Truncate,
+ *   \ref MIR_SegVec_ShrinkToFitByFreeF, \ref MIR_SegVec_DeinitByFreeF
+ * + \ref MIR_SegVec_SegLen - to process the elements a segment at a time
+ */
+#define MIR_SegVec(type, structTag)                                            \
+    struct structTag {                                                         \
+        type *segs[MIR_SEGVEC_MAX_SEGS];                                       \
+        size_t len;                                                            \
+        size_t cap;                                                            \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_SegVec
+ * struct.
+ */
+#define MIR_SegVec_OK 0
+
+
+/* NOTE: segment of the element `index'. `index + F' can't overflow as it's
+ *       at most the capacity of all segments */
+MIR_INLINE size_t __MIR_SegVec_Seg(size_t index) {
+    return 63u - MIR_Bits_Clz64((uint64_t)index + MIR_SEGVEC_FIRST_LEN) -
+           MIR_SEGVEC_FIRST_SHIFT;
+}
+
+/* NOTE: offset of the element `index' in its segment */
+MIR_INLINE size_t __MIR_SegVec_Off(size_t index) {
+    return index + MIR_SEGVEC_FIRST_LEN -
+           (MIR_SEGVEC_FIRST_LEN << __MIR_SegVec_Seg(index));
+}
+
+#define __MIR_SegVec_At(vec, index)                                            \
+    (vec)->segs[__MIR_SegVec_Seg(index)][__MIR_SegVec_Off(index)]
+
+
+/**
+ * \brief Returns the length of segment `seg`.
+ */
+#define MIR_SegVec_SegLen(seg) (MIR_SEGVEC_FIRST_LEN << (seg))
+
+/**
+ * \brief Returns the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_SegVec struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_SegVec_Get(vec, index)                                             \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (vec)->len,                                              \
+            "OOB: param `index' MUST be less than (vec)->len"                  \
+        ),                                                                     \
+        __MIR_SegVec_At(vec, index)                                            \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \details The pointer stays valid until the element is removed.
+ *
+ * \param[in] vec   pointer to \ref MIR_SegVec struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_SegVec_GetPtr(vec, index)                                          \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (vec)->len,                                              \
+            "OOB: param `index' MUST be less than (vec)->len"                  \
+        ),                                                                     \
+        &__MIR_SegVec_At(vec, index)                                           \
+    ) /* clang-format on */
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] vec   pointer to \ref MIR_SegVec struct
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_SegVec_Set(vec, index, elem)                                       \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (vec)->len,                                              \
+            "OOB: param `index' MUST be less than (vec)->len"                  \
+        ),                                                                     \
+        __MIR_SegVec_At(vec, index) = (elem)                                   \
+    ) /* clang-format on */
+
+/**
+ * \brief Init segmented vector with zero capacity.
+ *
+ * \param[out] vec pointer to \ref MIR_SegVec struct
+ */
+#define MIR_SegVec_Init(vec)                                                   \
+    __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL");           \
+    (vec)->len = 0;                                                            \
+    (vec)->cap = 0
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than `vec->cap`.
+ * Otherwise allocates new segments (calling `reallocF` with `NULL`) until the
+ * capacity is enough. The existing segments are not touched.
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_SegVec macro
+ * \param[in]     reallocF      realloc-like function to be used
+ * \param[in,out] vec           pointer to \ref MIR_SegVec struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_SegVec_OK on success; any other value indicates failure.
+ * On failure the segments allocated before the failing one are kept
+ */
+#define MIR_SegVec_ReserveByReallocF(type, reallocF, vec, new_capacity)        \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL")    \
+        ),                                                                     \
+        __MIR_SegVec_ReserveByReallocF_impl(                                   \
+            reallocF, (void **)(vec)->segs, &(vec)->cap,                       \
+            new_capacity, sizeof(type)                                         \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends the given element to the end of the segmented vector by
+ * using provided realloc-like function.
+ *
+ * \details If the vector is full, a new segment as long as all the previous
+ * ones together is allocated.
+ *
+ * \param         type     type of elements. **MUST** be the same type as
+ *                         that passed to \ref MIR_SegVec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_SegVec struct
+ * \param         elem     pointer to the element to be appended
+ *
+ * \return \ref MIR_SegVec_OK on success; any other value indicates failure
+ */
+#define MIR_SegVec_PushByReallocF(type, reallocF, vec, elem)                   \
+    /* clang-format off */                                                     \
+    (                                                                          \
+            (                                                                  \
+                __MIR_ASSERT_MSG(                                              \
+                    (vec) != NULL, "param `vec' MUST not be NULL"              \
+                ),                                                             \
+                __MIR_ASSERT_MSG(                                              \
+                    (elem) != NULL, "param `elem' MUST NOT be NULL"            \
+                ),                                                             \
+                (MIR_LIKELY((vec)->len < (vec)->cap)                           \
+                    || MIR_SegVec_ReserveByReallocF(                           \
+                           type, reallocF, vec, (vec)->len + 1u                \
+                       ) == MIR_SegVec_OK)                                     \
+            )                                                                  \
+        ?                                                                      \
+            (                                                                  \
+                __MIR_SegVec_At(vec, (vec)->len) = *(elem),                    \
+                ++((vec)->len),                                                \
+                MIR_SegVec_OK                                                  \
+            )                                                                  \
+        :   1                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Removes the last element of the segmented vector and writes it to
+ * `out`.
+ *
+ * \param[in,out] vec pointer to \ref MIR_SegVec struct
+ * \param[out]    out pointer where the removed element will be written
+ *
+ * \return \ref MIR_SegVec_OK on success; `1` if the vector is empty
+ */
+#define MIR_SegVec_Pop(vec, out)                                               \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((out) != NULL, "param `out' MUST not be NULL"),       \
+        ((vec)->len == 0u)                                                     \
+            ? 1                                                                \
+            : (--((vec)->len),                                                 \
+               *(out) = __MIR_SegVec_At(vec, (vec)->len),                      \
+               MIR_SegVec_OK)                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Shortens the segmented vector, keeping the first `new_len`
+ * elements. Does nothing if `new_len` is greater or equal to `vec->len`.
+ *
+ * \param[in,out] vec     pointer to \ref MIR_SegVec struct
+ * \param         new_len new length
+ */
+#define MIR_SegVec_Truncate(vec, new_len)                                      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        ((new_len) < (vec)->len) ? (void)((vec)->len = (new_len)) : (void)0    \
+    ) /* clang-format on */
+
+/**
+ * \brief Frees the segments holding no elements by using provided free-like
+ * function.
+ *
+ * \param[in]     freeF free-like function to be used
+ * \param[in,out] vec   pointer to \ref MIR_SegVec struct
+ */
+#define MIR_SegVec_ShrinkToFitByFreeF(freeF, vec)                              \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((freeF) != NULL, "param `freeF' MUST not be NULL"),   \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        __MIR_SegVec_ShrinkByFreeF_impl(                                       \
+            freeF, (void **)(vec)->segs, &(vec)->cap, (vec)->len               \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Deinits the \ref MIR_SegVec struct by freeing all segments with
+ * provided free-like function.
+ *
+ * \param[in]     freeF free-like function to be used
+ * \param[in,out] vec   pointer to \ref MIR_SegVec struct to be deinitialized
+ */
+#define MIR_SegVec_DeinitByFreeF(freeF, vec)                                   \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((freeF) != NULL, "param `freeF' MUST not be NULL"),   \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        __MIR_SegVec_ShrinkByFreeF_impl(                                       \
+            freeF, (void **)(vec)->segs, &(vec)->cap, 0u                       \
+        ),                                                                     \
+        (vec)->len = 0                                                         \
+    ) /* clang-format on */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Allocates segments until the capacity is at least `new_capacity`.
+ *
+ * \param[in]     reallocF     realloc-like function, called with `NULL`
+ * \param[in,out] member_segs  `segs` member
+ * \param[in,out] member_cap   pointer to `cap` member
+ * \param         new_capacity new capacity. **MAY** be `0`
+ * \param         elemSize     size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_SegVec_OK on success; `1` on failure
+ */
+extern int __MIR_SegVec_ReserveByReallocF_impl(
+    void *(*reallocF)(void *, size_t), void **member_segs, size_t *member_cap,
+    size_t new_capacity, size_t elemSize
+);
+
+/**
+ * \brief Frees the trailing segments not needed to hold `len` elements.
+ *
+ * \param[in]     freeF       free-like function
+ * \param[in,out] member_segs `segs` member
+ * \param[in,out] member_cap  pointer to `cap` member
+ * \param         len         number of elements to keep
+ */
+extern void __MIR_SegVec_ShrinkByFreeF_impl(
+    void (*freeF)(void *), void **member_segs, size_t *member_cap, size_t len
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_SegVec_ReserveByReallocF but uses standard
+ * library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SegVec_Reserve(type, vec, new_capacity)                        \
+        MIR_SegVec_ReserveByReallocF(type, realloc, vec, new_capacity)
+
+/**
+ * \brief The same as \ref MIR_SegVec_PushByReallocF but uses standard
+ * library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SegVec_Push(type, vec, elem)                                   \
+        MIR_SegVec_PushByReallocF(type, realloc, vec, elem)
+
+/**
+ * \brief The same as \ref MIR_SegVec_ShrinkToFitByFreeF but uses standard
+ * library `free` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SegVec_ShrinkToFit(vec) MIR_SegVec_ShrinkToFitByFreeF(free, vec)
+
+/**
+ * \brief Deinits the \ref MIR_SegVec struct by using standard library `free`
+ * function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SegVec_Deinit(vec) MIR_SegVec_DeinitByFreeF(free, vec)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_SEGVEC_H */
@@ -0,0 +1,315 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Slice utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_SLICE_H
+#define _MIR_COMMON_COLLECTIONS_SLICE_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* UINT_LEAST32_MAX */
+
+#include <mir/common/encodings/utf8.h> /* MIR_UTF8_BufIter */
+#include <mir/common/macros.h>         /* MIR_FOREACH_RANGE, MIR_INLINE */
+#include <mir/common/unicode.h>        /* MIR_REPLACEMENT_CHARACTER_CP */
+#include <mir/internal/assert.h>       /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a non-owning view of a contiguous range of elements.
+ *
+ * \param type      elements type. **MAY** consist of several tokens (e.g.
+ *                  `const char` for a read-only view)
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \details Members:
+ *   1. `data` - pointer to the first element. **MAY** be `NULL` if `len` is
+ *      `0`
+ *   2. `len` - number of elements
+ *
+ * A slice points into memory owned by something else (\ref MIR_Arr, \ref
+ * MIR_Vec, a byte buffer, ...) and never allocates or frees. It's invalidated
+ * whenever the owner moves its elements (e.g. when a \ref MIR_Vec grows).
+ * Taking a subslice is `O(1)`, so e.g. a tokenizer can return views into its
+ * input instead of copies.
+ *
+ * ## Interface
+ *
+ * + initialization
+ *   - \ref MIR_Slice_Init - from a pointer and a length
+ *   - \ref MIR_Slice_FromArr, \ref MIR_Slice_FromVec - all elements of \ref
+ *     MIR_Arr or \ref MIR_Vec
+ *   - \ref MIR_Slice_FromBufIter - not yet read bytes of \ref
+ *     MIR_UTF8_BufIter
+ * + element access (bounds are asserted)
+ *   - \ref MIR_Slice_Get, \ref MIR_Slice_GetPtr, \ref MIR_Slice_Set
+ * + subslices (bounds are checked)
+ *   - \ref MIR_Slice_Sub - `[from, to)`
+ *   - \ref MIR_Slice_Split - `[0, at)` and `[at, len)`
+ * + \ref MIR_Slice_ForEach
+ * + \ref MIR_Slice_AsBufIter - iterator over the code points of a byte slice
+ *
+ * \code{.c}
+ * MIR_Slice(const char, Span);
+ *
+ * struct Span input;
+ * struct Span word;
+ *
+ * MIR_Slice_Init(&input, text, textLen);
+ * while (input.len > 0u) {
+ *     MIR_Slice_Split(&word, &input, &input, WordLen(&input));
+ *     ...
+ * }
+ * \endcode
+ */
+#define MIR_Slice(type, structTag)                                             \
+    struct structTag {                                                         \
+        type *data;                                                            \
+        size_t len;                                                            \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Slice
+ * struct.
+ */
+#define MIR_Slice_OK 0
+
+
+MIR_INLINE int __MIR_Slice_Sub_impl(size_t len, size_t from, size_t to) {
+    return (from <= to && to <= len) ? MIR_Slice_OK : 1;
+}
+
+MIR_INLINE int __MIR_Slice_Split_impl(
+    size_t len, size_t at, size_t *leftLen, size_t *rightLen
+) {
+    if (at > len) {
+        return 1;
+    }
+
+    /* NOTE: `len' and `at' are evaluated by the caller before either of the
+     *       lengths is written, so they may alias them */
+    *rightLen = len - at;
+    *leftLen = at;
+    return MIR_Slice_OK;
+}
+
+MIR_INLINE void __MIR_Slice_AsBufIter_impl(
+    const void *data, size_t len, struct MIR_UTF8_BufIter *iter
+) {
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    iter->buf = (const unsigned char *)data;
+    iter->cur = iter->buf;
+    iter->lim = (len > 0u) ? iter->buf + len : iter->buf;
+    iter->replVal = MIR_REPLACEMENT_CHARACTER_CP;
+    iter->eofVal = UINT_LEAST32_MAX;
+}
+
+
+/**
+ * \brief Inits the slice with a pointer and a length.
+ *
+ * \param[out] slice  pointer to \ref MIR_Slice struct
+ * \param[in]  ptr    pointer to the first element. **MAY** be `NULL` if
+ *                    `length` is `0`
+ * \param      length number of elements
+ */
+#define MIR_Slice_Init(slice, ptr, length)                                     \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (ptr) != NULL || (length) == 0u,                                   \
+            "param `ptr' MUST NOT be NULL if `length' is not 0"                \
+        ),                                                                     \
+        (slice)->data = (ptr),                                                 \
+        (slice)->len = (length),                                               \
+        (void)0                                                                \
+    ) /* clang-format on */
+
+/**
+ * \brief Inits the slice with all elements of \ref MIR_Arr.
+ *
+ * \param[out] slice pointer to \ref MIR_Slice struct
+ * \param[in]  arr   pointer to \ref MIR_Arr struct
+ */
+#define MIR_Slice_FromArr(slice, arr)                                          \
+    ((slice)->data = (arr)->data, (slice)->len = (arr)->len, (void)0)
+
+/**
+ * \brief Inits the slice with all elements of \ref MIR_Vec.
+ *
+ * \param[out] slice pointer to \ref MIR_Slice struct
+ * \param[in]  vec   pointer to \ref MIR_Vec struct
+ */
+#define MIR_Slice_FromVec(slice, vec)                                          \
+    ((slice)->data = (vec)->data, (slice)->len = (vec)->len, (void)0)
+
+/**
+ * \brief Inits the byte slice with the bytes of \ref MIR_UTF8_BufIter that
+ * are not read yet (from `cur` to `lim`).
+ *
+ * \param      type  elements type of the slice. `type`'s `sizeof` **MUST** be
+ *                   `1` (e.g. `const char`)
+ * \param[out] slice pointer to \ref MIR_Slice struct
+ * \param[in]  iter  pointer to \ref MIR_UTF8_BufIter struct
+ */
+#define MIR_Slice_FromBufIter(type, slice, iter)                               \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(sizeof(type) == 1u, "`sizeof(type)' MUST be 1"),      \
+        (slice)->data = (type *)(iter)->cur,                                   \
+        (slice)->len = (size_t)((iter)->lim - (iter)->cur),                    \
+        (void)0                                                                \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns the element at the specified index.
+ *
+ * \param[in] slice pointer to \ref MIR_Slice struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_Slice_Get(slice, index)                                            \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (slice)->len,                                            \
+            "OOB: param `index' MUST be less than (slice)->len"                \
+        ),                                                                     \
+        (slice)->data[(index)]                                                 \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \param[in] slice pointer to \ref MIR_Slice struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_Slice_GetPtr(slice, index)                                         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (slice)->len,                                            \
+            "OOB: param `index' MUST be less than (slice)->len"                \
+        ),                                                                     \
+        &(slice)->data[(index)]                                                \
+    ) /* clang-format on */
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] slice pointer to \ref MIR_Slice struct of non-const elements
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_Slice_Set(slice, index, elem)                                      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (slice)->len,                                            \
+            "OOB: param `index' MUST be less than (slice)->len"                \
+        ),                                                                     \
+        (slice)->data[(index)] = (elem)                                        \
+    ) /* clang-format on */
+
+/**
+ * \brief Makes `dst` a view of elements `[from, to)` of `src`.
+ *
+ * \param[out] dst  pointer to \ref MIR_Slice struct. **MAY** be `src`
+ * \param[in]  src  pointer to \ref MIR_Slice struct
+ * \param      from index of the first element
+ * \param      to   index past the last element
+ *
+ * \details `src->data` is assigned to `dst->data`, so the element types are
+ * checked at compile time. `from` and `to` **MAY** be evaluated more than
+ * once, but always before `dst->len` is written; if `dst` is `src`, they
+ * **MUST NOT** read `src->data`.
+ *
+ * \return \ref MIR_Slice_OK on success; `1` if `from > to` or `to >
+ * src->len` (`dst` is left untouched)
+ */
+#define MIR_Slice_Sub(dst, src, from, to)                                      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (__MIR_Slice_Sub_impl((src)->len, (from), (to)) != MIR_Slice_OK)       \
+            ? 1                                                                \
+            : (                                                                \
+                (dst)->data = ((from) > 0u) ? (src)->data + (from)             \
+                                            : (src)->data,                     \
+                (dst)->len = (to) - (from),                                    \
+                MIR_Slice_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Splits `src` into elements `[0, at)` and `[at, src->len)`.
+ *
+ * \param[out] left  pointer to \ref MIR_Slice struct. **MAY** be `src`
+ * \param[out] right pointer to \ref MIR_Slice struct. **MAY** be `src`.
+ *                   **MUST NOT** be `left`
+ * \param[in]  src   pointer to \ref MIR_Slice struct
+ * \param      at    number of elements of `left`
+ *
+ * \details The element types are checked as in \ref MIR_Slice_Sub. `at` is
+ * evaluated exactly once, before `left` or `right` is written, so it **MAY**
+ * depend on `src` even if `src` is one of them.
+ *
+ * \return \ref MIR_Slice_OK on success; `1` if `at > src->len` (`left` and
+ * `right` are left untouched)
+ */
+#define MIR_Slice_Split(left, right, src, at)                                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (__MIR_Slice_Split_impl(                                               \
+             (src)->len, (at), &(left)->len, &(right)->len                     \
+         ) != MIR_Slice_OK)                                                    \
+            ? 1                                                                \
+            : (                                                                \
+                (left)->data = (src)->data,                                    \
+                (right)->data = ((left)->len > 0u)                             \
+                                    ? (left)->data + (left)->len               \
+                                    : (left)->data,                            \
+                MIR_Slice_OK                                                   \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Iterates over the elements of the slice.
+ *
+ * \param[in]  slice pointer to \ref MIR_Slice struct
+ * \param[out] i     writes the current element index here
+ * \param[out] elem  writes the pointer to the current element here
+ *
+ * \details See \ref MIR_FOREACH_RANGE.
+ */
+#define MIR_Slice_ForEach(slice, i, elem)                                      \
+    MIR_FOREACH_RANGE ((slice)->data, 0u, (slice)->len, i, elem)
+
+/**
+ * \brief Inits the iterator over the code points of the byte slice without
+ * copying.
+ *
+ * \details `replVal` is set to \ref MIR_REPLACEMENT_CHARACTER_CP and `eofVal`
+ * to `UINT_LEAST32_MAX`.
+ *
+ * \param[in]  slice pointer to \ref MIR_Slice struct. `sizeof` of its elements
+ *                   **MUST** be `1`
+ * \param[out] iter  pointer to \ref MIR_UTF8_BufIter struct
+ */
+#define MIR_Slice_AsBufIter(slice, iter)                                       \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            sizeof(*(slice)->data) == 1u,                                      \
+            "elements of param `slice' MUST be bytes"                          \
+        ),                                                                     \
+        __MIR_Slice_AsBufIter_impl((slice)->data, (slice)->len, (iter))        \
+    ) /* clang-format on */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_SLICE_H */
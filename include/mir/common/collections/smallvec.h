@@ -0,0 +1,345 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_SmallVec utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_SMALLVEC_H
+#define _MIR_COMMON_COLLECTIONS_SMALLVEC_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#if __STDC_VERSION__ >= 199901L
+#    include <stdint.h> /* SIZE_MAX */
+#else
+#    include <mir/stdlib/stdint.h> /* SIZE_MAX */
+#endif
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/arith.h>           /* MIR_u_Mul_WillOverflow */
+#include <mir/common/collections/vec.h> /* MIR_Vec_Get, MIR_Vec_OK */
+#include <mir/internal/assert.h>        /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a vector struct with inline storage for `N` elements - a
+ * small vector.
+ *
+ * \param type      elements type. **MAY** consist of several tokens
+ * \param N         number of elements stored inline. **MUST** be greater than
+ *                  `0`
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \note Be aware that prior to C99, the C standard did not specify behavior for
+ * macros with empty arguments.
+ *
+ * \details Members:
+ *   1. `data` - pointer to the first element of underlying array. It points
+ *      either to member `buf` (while the vector is *inline*) or to the heap
+ *      allocated array (once the vector has *spilled*). **MUST NOT** be `NULL`
+ *      after initialization
+ *   2. `len` - number of elements currently stored in the underlying array.
+ *      **MAY** be `0`
+ *   3. `cap` - capacity (in elements) of the underlying array. It's never less
+ *      than `N`
+ *   4. `buf` - inline storage
+ *
+ * The first three members have the same names and semantics as those of \ref
+ * MIR_Vec. Therefore, any \ref MIR_Vec macro that does not allocate (e.g. \ref
+ * MIR_Vec_Get) can also be used with a small vector.
+ *
+ * Rules:
+ *   1. `type`'s `sizeof` **MUST** be greater than `0`
+ *   2. member `cap` **MUST** be always greater or equal to member `len`
+ *   3. the struct **MUST NOT** be copied or moved (e.g. by `memcpy` or by
+ *      assignment) while \ref MIR_SmallVec_IsInline is true, as member `data`
+ *      would still point to the `buf` member of the original struct
+ *
+ * ## Interface
+ *
+ * \note \ref MIR_SmallVec_Reserve, \ref MIR_SmallVec_Push, \ref
+ * MIR_SmallVec_Deinit will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ *
+ * + initialization
+ *   - \ref MIR_SmallVec_Init - with inline capacity
+ * + get
+ *   - \ref MIR_SmallVec_Get - the element
+ *   - \ref MIR_SmallVec_GetPtr - a pointer to the element
+ * + set
+ *   - \ref MIR_SmallVec_Set - the element
+ * + reserve
+ *   - \ref MIR_SmallVec_Reserve - by using standard library `realloc` function
+ *   - \ref MIR_SmallVec_ReserveByReallocF - by using provided realloc-like
+ *     function
+ * + push_back
+ *   - \ref MIR_SmallVec_Push - by using standard library `realloc` function
+ *   - \ref MIR_SmallVec_PushByReallocF - by using provided realloc-like
+ *     function
+ * + deinitialization
+ *   - \ref MIR_SmallVec_Deinit - by using standard library `free` function
+ *   - \ref MIR_SmallVec_DeinitByFreeF - by using provided free-like function
+ */
+#define MIR_SmallVec(type, N, structTag)                                       \
+    struct structTag {                                                         \
+        type *data;                                                            \
+        size_t len;                                                            \
+        size_t cap;                                                            \
+        type buf[N];                                                           \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref
+ * MIR_SmallVec struct.
+ */
+#define MIR_SmallVec_OK MIR_Vec_OK
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern int __MIR_SmallVec_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t *member_cap,
+    void *member_buf, size_t len, size_t new_capacity, size_t elemSize
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/**
+ * \brief Checks whether the small vector still uses its inline storage.
+ *
+ * \param[in] vec pointer to \ref MIR_SmallVec struct
+ *
+ * \return `1` if the elements are stored inline, `0` otherwise
+ */
+#define MIR_SmallVec_IsInline(vec) ((vec)->data == (vec)->buf)
+
+/**
+ * \brief Returns the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_SmallVec struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_SmallVec_Get(vec, index) MIR_Vec_Get(vec, index)
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_SmallVec struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_SmallVec_GetPtr(vec, index) MIR_Vec_GetPtr(vec, index)
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] vec   pointer to \ref MIR_SmallVec struct
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_SmallVec_Set(vec, index, elem) MIR_Vec_Set(vec, index, elem)
+
+/**
+ * \brief Inits small vector with its inline capacity.
+ *
+ * \details It never allocates.
+ *
+ * \param[out] vec pointer to \ref MIR_SmallVec struct
+ */
+#define MIR_SmallVec_Init(vec)                                                 \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        (vec)->data = (vec)->buf,                                              \
+        (vec)->len = 0,                                                        \
+        (vec)->cap = sizeof((vec)->buf) / sizeof((vec)->buf[0])                \
+    ) /* clang-format on */
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than `vec->cap`.
+ * Otherwise, if the vector is inline, the elements are moved to a newly
+ * allocated heap array (`reallocF` is called with `NULL` as the first
+ * argument).
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_SmallVec macro
+ * \param[in]     reallocF      realloc-like function to be used
+ * \param[in,out] vec           pointer to \ref MIR_SmallVec struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_SmallVec_OK on success; any other value indicates failure
+ */
+#define MIR_SmallVec_ReserveByReallocF(type, reallocF, vec, new_capacity)      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),    \
+            __MIR_ASSERT_MSG(                                                  \
+                (vec)->data != NULL, "`vec->data' MUST NOT be NULL"            \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_SmallVec_ReserveByReallocF_impl(                                 \
+            reallocF, (void **)&(vec)->data, &(vec)->cap, (vec)->buf,          \
+            (vec)->len, new_capacity, sizeof(type)                             \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends the given element to the end of the small vector by using
+ * provided realloc-like function.
+ *
+ * \details Allocates only if the vector is full. The growth policy is the same
+ * as that of \ref MIR_Vec_PushByReallocF.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_SmallVec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_SmallVec struct
+ * \param         elem     pointer to the element to be appended. **MUST** point
+ *                         to the same type as that passed to \ref MIR_SmallVec
+ *                         macro
+ *
+ * \return \ref MIR_SmallVec_OK on success; any other value indicates failure
+ */
+#define MIR_SmallVec_PushByReallocF(type, reallocF, vec, elem)                 \
+    /* clang-format off */                                                     \
+    (                                                                          \
+            (                                                                  \
+                __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),\
+                ((vec)->len < (vec)->cap)                                      \
+            )                                                                  \
+        ?                                                                      \
+            (                                                                  \
+                __MIR_ASSERT_MSG(                                              \
+                    (elem) != NULL, "param `elem' MUST NOT be NULL"            \
+                ),                                                             \
+                (vec)->data[(vec)->len] = *(elem),                             \
+                ++((vec)->len),                                                \
+                MIR_SmallVec_OK                                                \
+            )                                                                  \
+        :                                                                      \
+                (                                                              \
+                        MIR_u_Mul_WillOverflow((vec)->cap, 2u, SIZE_MAX)       \
+                    ?   1                                                      \
+                    :                                                          \
+                        (                                                      \
+                            MIR_SmallVec_ReserveByReallocF(                    \
+                                type, reallocF, vec, (vec)->cap * 2u           \
+                            )                                                  \
+                            == 1                                               \
+                        )                                                      \
+                )                                                              \
+            ?   1                                                              \
+            :                                                                  \
+                (                                                              \
+                    (vec)->data[(vec)->len] = *(elem),                         \
+                    ++((vec)->len),                                            \
+                    MIR_SmallVec_OK                                            \
+                )                                                              \
+    ) /* clang-format on */
+
+/**
+ * \brief Deinits the \ref MIR_SmallVec struct by using provided free-like
+ * function.
+ *
+ * \details Frees the memory using free-like function if the vector has
+ * spilled to the heap. Does nothing otherwise.
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] freeF free-like function to be used
+ * \param[in] vec   pointer to \ref MIR_SmallVec struct to be deinitialized
+ */
+#define MIR_SmallVec_DeinitByFreeF(freeF, vec)                                 \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                (freeF) != NULL,                                               \
+                "param `freeF' MUST not be NULL"                               \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (vec) != NULL,                                                 \
+                "param `vec' MUST not be NULL"                                 \
+            )                                                                  \
+        ),                                                                     \
+        MIR_SmallVec_IsInline(vec) ? (void)0 : (freeF)((vec)->data)            \
+    ) /* clang-format on */
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * standard library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_SmallVec macro
+ * \param[in,out] vec           pointer to \ref MIR_SmallVec struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_SmallVec_OK on success; any other value indicates failure
+ */
+#    define MIR_SmallVec_Reserve(type, vec, new_capacity)                      \
+        MIR_SmallVec_ReserveByReallocF(type, realloc, vec, new_capacity)
+
+/**
+ * \brief Appends the given element to the end of the small vector by using
+ * standard library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type type of elements. **MUST** be the same type as that
+ *                     passed to \ref MIR_SmallVec macro
+ * \param[in,out] vec  pointer to \ref MIR_SmallVec struct
+ * \param         elem pointer to the element to be appended
+ *
+ * \return \ref MIR_SmallVec_OK on success; any other value indicates failure
+ */
+#    define MIR_SmallVec_Push(type, vec, elem)                                 \
+        MIR_SmallVec_PushByReallocF(type, realloc, vec, elem)
+
+/**
+ * \brief Deinits the \ref MIR_SmallVec struct
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \details Frees the memory using standard library `free` function if the
+ * vector has spilled to the heap.
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] vec pointer to \ref MIR_SmallVec struct to be deinitialized
+ */
+#    define MIR_SmallVec_Deinit(vec) MIR_SmallVec_DeinitByFreeF(free, vec)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_SMALLVEC_H */
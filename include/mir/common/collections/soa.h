@@ -0,0 +1,475 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_SoA utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_SOA_H
+#define _MIR_COMMON_COLLECTIONS_SOA_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/common/macros.h>   /* MIR_INLINE */
+#include <mir/common/mem.h>      /* MIR_CacheAlignedRealloc */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a struct-of-arrays container: one contiguous column per
+ * field, all sharing a single length and capacity.
+ *
+ * \param FIELDS    field list macro: `FIELDS(X)` **MUST** expand to
+ *                  `X(type, name)` for every field. Field types **MAY**
+ *                  consist of several tokens only if wrapped in a typedef
+ * \param structTag struct tag. **MUST NOT** be empty
+ *
+ * \details Defines two structs:
+ *   1. `struct structTag##_Row` - one row, a member per field
+ *   2. `struct structTag` - the container. Members:
+ *      1. a `type *name` column per field. **MAY** be `NULL`
+ *      2. `block` - the single allocation holding all columns. **MAY** be
+ *         `NULL`
+ *      3. `len` - number of rows. **MAY** be `0`
+ *      4. `cap` - capacity (in rows) of every column. **MAY** be `0`
+ *
+ * All columns live in one block, each starting at a multiple of \ref
+ * MIR_SOA_ALIGN from the beginning of the block, so a kernel over one field
+ * streams exactly the bytes of that field and, with a cache-line-aligned
+ * allocator, can use aligned vector loads. Columns are plain arrays and
+ * **MAY** be passed to any function taking `type *` and a length.
+ *
+ * Rules:
+ *   1. every field's `sizeof` **MUST** be greater than `0`
+ *   2. fields **MUST NOT** be named `block`, `len` or `cap`
+ *   3. member `cap` **MUST** be always greater or equal to member `len`
+ *   4. member `block` **MUST** be `NULL` only if member `cap` is equal to `0`
+ *
+ * Functions operating on the container are generated by \ref MIR_SOA_DEFINE.
+ *
+ * \code{.c}
+ * #define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(uint32_t, id)
+ * MIR_SoA(PARTICLE_FIELDS, Particles);
+ * MIR_SOA_DEFINE(PARTICLE_FIELDS, Particles)
+ *
+ * struct Particles ps;
+ * struct Particles_Row row = {1.0f, 2.0f, 7u};
+ *
+ * MIR_SoA_Init(Particles, &ps);
+ * MIR_SoA_Push(Particles, &ps, &row);
+ * Scale(MIR_SoA_Column(&ps, x), ps.len, 2.0f);
+ * MIR_SoA_Deinit(Particles, &ps);
+ * \endcode
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix (except for getters and
+ * setters) will be defined only if `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_SoA_Column, \ref MIR_SoA_Get, \ref MIR_SoA_GetPtr, \ref
+ *   MIR_SoA_Set - a single field
+ * + \ref MIR_SoA_Load, \ref MIR_SoA_Store - a whole row
+ * + \ref MIR_SoA_Init, \ref MIR_SoA_ReserveByReallocF, \ref
+ *   MIR_SoA_PushByReallocF, \ref MIR_SoA_Pop, \ref MIR_SoA_Truncate, \ref
+ *   MIR_SoA_DeinitByFreeF
+ */
+#define MIR_SoA(FIELDS, structTag)                                             \
+    struct structTag##_Row {                                                   \
+        FIELDS(__MIR_SOA_ROW_MEMBER)                                           \
+    };                                                                         \
+    struct structTag {                                                         \
+        FIELDS(__MIR_SOA_COLUMN_MEMBER)                                        \
+        void *block;                                                           \
+        size_t len;                                                            \
+        size_t cap;                                                            \
+    }
+
+#define __MIR_SOA_ROW_MEMBER(type, name)    type name;
+#define __MIR_SOA_COLUMN_MEMBER(type, name) type *name;
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_SoA
+ * struct.
+ */
+#define MIR_SoA_OK 0
+
+/**
+ * \brief Alignment (in bytes, relative to the block) of every column of a
+ * \ref MIR_SoA.
+ */
+#define MIR_SOA_ALIGN MIR_CACHE_LINE_SIZE
+
+
+/**
+ * \brief Returns the column of the specified field.
+ *
+ * \param[in] soa   pointer to \ref MIR_SoA struct
+ * \param     field field name
+ *
+ * \return pointer to the first element of the column (`soa->len` elements).
+ * It is invalidated by any operation changing the capacity
+ */
+#define MIR_SoA_Column(soa, field) ((soa)->field)
+
+/**
+ * \brief Returns the specified field of the row at the specified index.
+ *
+ * \param[in] soa   pointer to \ref MIR_SoA struct
+ * \param     field field name
+ * \param     index index of the row
+ */
+#define MIR_SoA_Get(soa, field, index)                                         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (soa)->len,                                              \
+            "OOB: param `index' MUST be less than (soa)->len"                  \
+        ),                                                                     \
+        (soa)->field[(index)]                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns a pointer to the specified field of the row at the specified
+ * index.
+ *
+ * \param[in] soa   pointer to \ref MIR_SoA struct
+ * \param     field field name
+ * \param     index index of the row
+ */
+#define MIR_SoA_GetPtr(soa, field, index)                                      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (soa)->len,                                              \
+            "OOB: param `index' MUST be less than (soa)->len"                  \
+        ),                                                                     \
+        &(soa)->field[(index)]                                                 \
+    ) /* clang-format on */
+
+/**
+ * \brief Sets the specified field of the row at the specified index.
+ *
+ * \param[out] soa   pointer to \ref MIR_SoA struct
+ * \param      field field name
+ * \param      index index of the row
+ * \param      value value to set
+ */
+#define MIR_SoA_Set(soa, field, index, value)                                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < (soa)->len,                                              \
+            "OOB: param `index' MUST be less than (soa)->len"                  \
+        ),                                                                     \
+        (soa)->field[(index)] = (value)                                        \
+    ) /* clang-format on */
+
+/**
+ * \brief Inits the container with zero capacity.
+ *
+ * \param      structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[out] soa       pointer to \ref MIR_SoA struct
+ */
+#define MIR_SoA_Init(structTag, soa) structTag##_Init(soa)
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` rows in every
+ * column by using provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than
+ * `soa->cap`. Otherwise the block is reallocated once and the columns are
+ * moved to their new offsets in it.
+ *
+ * \param         structTag    struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[in]     reallocF     realloc-like function to be used
+ * \param[in,out] soa          pointer to \ref MIR_SoA struct
+ * \param         new_capacity minimum new capacity
+ *
+ * \return \ref MIR_SoA_OK on success; any other value indicates failure
+ */
+#define MIR_SoA_ReserveByReallocF(structTag, reallocF, soa, new_capacity)      \
+    structTag##_ReserveByReallocF((reallocF), (soa), (new_capacity))
+
+/**
+ * \brief Appends a row by using provided realloc-like function.
+ *
+ * \details The capacity is doubled when the container is full.
+ *
+ * \param         structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[in]     reallocF  realloc-like function to be used
+ * \param[in,out] soa       pointer to \ref MIR_SoA struct
+ * \param[in]     row       pointer to `struct structTag##_Row`
+ *
+ * \return \ref MIR_SoA_OK on success; any other value indicates failure
+ */
+#define MIR_SoA_PushByReallocF(structTag, reallocF, soa, row)                  \
+    structTag##_PushByReallocF((reallocF), (soa), (row))
+
+/**
+ * \brief Removes the last row.
+ *
+ * \param         structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[in,out] soa       pointer to \ref MIR_SoA struct
+ * \param[out]    out       pointer to `struct structTag##_Row` where the
+ *                          removed row will be written. **MAY** be `NULL`
+ *
+ * \return \ref MIR_SoA_OK on success; `1` if the container is empty
+ */
+#define MIR_SoA_Pop(structTag, soa, out) structTag##_Pop((soa), (out))
+
+/**
+ * \brief Shortens the container to `new_len` rows. Does nothing if `new_len`
+ * is greater than or equal to `soa->len`.
+ */
+#define MIR_SoA_Truncate(soa, new_len)                                         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (soa)->len = ((new_len) < (soa)->len) ? (new_len) : (soa)->len         \
+    ) /* clang-format on */
+
+/**
+ * \brief Gathers the row at the specified index.
+ *
+ * \param      structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[in]  soa       pointer to \ref MIR_SoA struct
+ * \param      index     index of the row
+ * \param[out] out       pointer to `struct structTag##_Row`
+ */
+#define MIR_SoA_Load(structTag, soa, index, out)                               \
+    structTag##_Load((soa), (index), (out))
+
+/**
+ * \brief Scatters a row into the specified index.
+ *
+ * \param      structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[out] soa       pointer to \ref MIR_SoA struct
+ * \param      index     index of the row
+ * \param[in]  row       pointer to `struct structTag##_Row`
+ */
+#define MIR_SoA_Store(structTag, soa, index, row)                              \
+    structTag##_Store((soa), (index), (row))
+
+/**
+ * \brief Frees the block by using provided free-like function.
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param     structTag struct tag passed to \ref MIR_SOA_DEFINE
+ * \param[in] freeF     free-like function to be used
+ * \param[in] soa       pointer to \ref MIR_SoA struct to be deinitialized
+ */
+#define MIR_SoA_DeinitByFreeF(structTag, freeF, soa)                           \
+    structTag##_DeinitByFreeF((freeF), (soa))
+
+
+/**
+ * \brief Defines the functions operating on a \ref MIR_SoA.
+ *
+ * \param FIELDS    the same field list as passed to \ref MIR_SoA
+ * \param structTag the same struct tag as passed to \ref MIR_SoA
+ *
+ * \details Generated functions (see the macros of the same name):
+ * + `void structTag##_Init(struct structTag *soa)`
+ * + `int structTag##_ReserveByReallocF(reallocF, struct structTag *soa,
+ *   size_t new_capacity)`
+ * + `int structTag##_PushByReallocF(reallocF, struct structTag *soa,
+ *   const struct structTag##_Row *row)`
+ * + `int structTag##_Pop(struct structTag *soa, struct structTag##_Row *out)`
+ * + `void structTag##_Load(const struct structTag *soa, size_t index,
+ *   struct structTag##_Row *out)`
+ * + `void structTag##_Store(struct structTag *soa, size_t index,
+ *   const struct structTag##_Row *row)`
+ * + `void structTag##_DeinitByFreeF(freeF, struct structTag *soa)`
+ */
+#define MIR_SOA_DEFINE(FIELDS, structTag)                                      \
+                                                                               \
+    MIR_INLINE void structTag##_Init(struct structTag *soa) {                  \
+        __MIR_ASSERT_MSG(soa != NULL, "param `soa' MUST NOT be NULL");         \
+        FIELDS(__MIR_SOA_INIT_COLUMN)                                          \
+        soa->block = NULL;                                                     \
+        soa->len = 0;                                                          \
+        soa->cap = 0;                                                          \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_ReserveByReallocF(                              \
+        void *(*reallocF)(void *, size_t), struct structTag *soa,              \
+        size_t new_capacity                                                    \
+    ) {                                                                        \
+        static const size_t sizes[] = {FIELDS(__MIR_SOA_FIELD_SIZE)};          \
+        size_t offsets[sizeof(sizes) / sizeof(sizes[0])];                      \
+        size_t k = 0;                                                          \
+                                                                               \
+        __MIR_ASSERT_MSG(                                                      \
+            reallocF != NULL, "param `reallocF' MUST NOT be NULL"              \
+        );                                                                     \
+        __MIR_ASSERT_MSG(soa != NULL, "param `soa' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(                                                      \
+            (soa->cap == 0u) ? (soa->block == NULL) : 1,                       \
+            "if `soa->cap == 0' then `soa->block' MUST be NULL"                \
+        );                                                                     \
+                                                                               \
+        if (new_capacity <= soa->cap) {                                        \
+            return MIR_SoA_OK;                                                 \
+        }                                                                      \
+        if (__MIR_SoA_ReserveByReallocF_impl(                                  \
+                reallocF, &soa->block, &soa->cap, soa->len, new_capacity,      \
+                sizes, sizeof(sizes) / sizeof(sizes[0]), offsets               \
+            ) != MIR_SoA_OK) {                                                 \
+            return 1;                                                          \
+        }                                                                      \
+        FIELDS(__MIR_SOA_PLACE_COLUMN)                                         \
+        (void)k;                                                               \
+        return MIR_SoA_OK;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PushByReallocF(                                 \
+        void *(*reallocF)(void *, size_t), struct structTag *soa,              \
+        const struct structTag##_Row *row                                      \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(soa != NULL, "param `soa' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(row != NULL, "param `row' MUST NOT be NULL");         \
+                                                                               \
+        if (MIR_UNLIKELY(soa->len == soa->cap)) {                              \
+            if (MIR_u_Mul_WillOverflow(soa->cap, 2u, SIZE_MAX) ||              \
+                structTag##_ReserveByReallocF(                                 \
+                    reallocF, soa, (soa->cap == 0u) ? 4u : soa->cap * 2u       \
+                ) != MIR_SoA_OK) {                                             \
+                return 1;                                                      \
+            }                                                                  \
+        }                                                                      \
+        FIELDS(__MIR_SOA_STORE_FIELD_AT_LEN)                                   \
+        ++soa->len;                                                            \
+        return MIR_SoA_OK;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_Load(                                          \
+        const struct structTag *soa, size_t index,                             \
+        struct structTag##_Row *out                                            \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < soa->len, "OOB: param `index' MUST be less than soa->len"  \
+        );                                                                     \
+        FIELDS(__MIR_SOA_LOAD_FIELD)                                           \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_Store(                                         \
+        struct structTag *soa, size_t index,                                   \
+        const struct structTag##_Row *row                                      \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < soa->len, "OOB: param `index' MUST be less than soa->len"  \
+        );                                                                     \
+        FIELDS(__MIR_SOA_STORE_FIELD)                                          \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_Pop(                                            \
+        struct structTag *soa, struct structTag##_Row *out                     \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(soa != NULL, "param `soa' MUST NOT be NULL");         \
+                                                                               \
+        if (soa->len == 0u) {                                                  \
+            return 1;                                                          \
+        }                                                                      \
+        if (out != NULL) {                                                     \
+            structTag##_Load(soa, soa->len - 1u, out);                         \
+        }                                                                      \
+        --soa->len;                                                            \
+        return MIR_SoA_OK;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *soa                           \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+        __MIR_ASSERT_MSG(soa != NULL, "param `soa' MUST NOT be NULL");         \
+                                                                               \
+        /* NOTE: it's okay to pass NULL to free function */                    \
+        freeF(soa->block);                                                     \
+    }
+
+#define __MIR_SOA_INIT_COLUMN(type, name) soa->name = NULL;
+#define __MIR_SOA_FIELD_SIZE(type, name)  sizeof(type),
+#define __MIR_SOA_PLACE_COLUMN(type, name)                                     \
+    soa->name = (type *)(void *)((unsigned char *)soa->block + offsets[k++]);
+#define __MIR_SOA_STORE_FIELD_AT_LEN(type, name)                               \
+    soa->name[soa->len] = row->name;
+#define __MIR_SOA_LOAD_FIELD(type, name)  out->name = soa->name[index];
+#define __MIR_SOA_STORE_FIELD(type, name) soa->name[index] = row->name;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Grows the block of a \ref MIR_SoA to `new_capacity` rows.
+ *
+ * \details Column `k` starts at `offsets[k]`: the sum of the sizes of the
+ * preceding columns, each rounded up to \ref MIR_SOA_ALIGN. The block is
+ * reallocated once and the first `len` elements of every column are moved
+ * from the old offsets to the new ones.
+ *
+ * \param[in]     reallocF     realloc-like function to be used
+ * \param[in,out] member_block pointer to `block` member
+ * \param[in,out] member_cap   pointer to `cap` member
+ * \param         len          number of rows to preserve
+ * \param         new_capacity new capacity. **MUST** be greater than
+ *                             `*member_cap`
+ * \param[in]     sizes        element size of every column
+ * \param         nfields      number of columns
+ * \param[out]    offsets      new offset of every column
+ *
+ * \return \ref MIR_SoA_OK on success; `1` on failure
+ */
+extern int __MIR_SoA_ReserveByReallocF_impl(
+    void *(*reallocF)(void *, size_t), void **member_block, size_t *member_cap,
+    size_t len, size_t new_capacity, const size_t *sizes, size_t nfields,
+    size_t *offsets
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_SoA_ReserveByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc, so every column is cache-line-aligned.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SoA_Reserve(structTag, soa, new_capacity)                      \
+        MIR_SoA_ReserveByReallocF(                                             \
+            structTag, MIR_CacheAlignedRealloc, soa, new_capacity              \
+        )
+
+/**
+ * \brief The same as \ref MIR_SoA_PushByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc, so every column is cache-line-aligned.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ */
+#    define MIR_SoA_Push(structTag, soa, row)                                  \
+        MIR_SoA_PushByReallocF(structTag, MIR_CacheAlignedRealloc, soa, row)
+
+/**
+ * \brief Deinits the \ref MIR_SoA struct by using \ref MIR_AlignedFree.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ */
+#    define MIR_SoA_Deinit(structTag, soa)                                     \
+        MIR_SoA_DeinitByFreeF(structTag, MIR_AlignedFree, soa)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_SOA_H */
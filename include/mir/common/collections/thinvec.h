@@ -0,0 +1,372 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_ThinVec utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_THINVEC_H
+#define _MIR_COMMON_COLLECTIONS_THINVEC_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/collections/vec.h> /* MIR_Vec_OK */
+#include <mir/internal/assert.h>        /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a dynamic size array struct that consists of a single pointer
+ * - a thin vector.
+ *
+ * \param type      elements type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \note Be aware that prior to C99, the C standard did not specify behavior for
+ * macros with empty arguments.
+ *
+ * \details The length and the capacity (both are `uint32_t`) are stored in a
+ * header right in front of the heap allocated array (see \ref
+ * MIR_ThinVec_Header). Therefore, an empty thin vector takes only one pointer
+ * and does not allocate at all.
+ *
+ * Members:
+ *   1. `data` - pointer to the first element of underlying array. **MAY** be
+ *      `NULL`
+ *
+ * Rules:
+ *   1. `type`'s `sizeof` **MUST** be greater than `0`
+ *   2. member `data` **MUST** be `NULL` only if the capacity is equal to `0`
+ *   3. `type`'s alignment **MUST NOT** be stricter than that of \ref
+ *      MIR_ThinVec_Header
+ *
+ * ## Interface
+ *
+ * \note \ref MIR_ThinVec_Reserve, \ref MIR_ThinVec_Push, \ref
+ * MIR_ThinVec_Deinit will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ *
+ * + initialization
+ *   - \ref MIR_ThinVec_Init - with zero capacity
+ * + length and capacity
+ *   - \ref MIR_ThinVec_Len
+ *   - \ref MIR_ThinVec_Cap
+ * + get
+ *   - \ref MIR_ThinVec_Get - the element
+ *   - \ref MIR_ThinVec_GetPtr - a pointer to the element
+ * + set
+ *   - \ref MIR_ThinVec_Set - the element
+ * + reserve
+ *   - \ref MIR_ThinVec_Reserve - by using standard library `realloc` function
+ *   - \ref MIR_ThinVec_ReserveByReallocF - by using provided realloc-like
+ *     function
+ * + push_back
+ *   - \ref MIR_ThinVec_Push - by using standard library `realloc` function
+ *   - \ref MIR_ThinVec_PushByReallocF - by using provided realloc-like function
+ * + deinitialization
+ *   - \ref MIR_ThinVec_Deinit - by using standard library `free` function
+ *   - \ref MIR_ThinVec_DeinitByFreeF - by using provided free-like function
+ */
+#define MIR_ThinVec(type, structTag)                                           \
+    struct structTag {                                                         \
+        type *data;                                                            \
+    }
+
+/**
+ * \brief Header of the heap allocated array of a \ref MIR_ThinVec.
+ *
+ * \details It's a union only to make the array which follows it suitably
+ * aligned for any scalar type.
+ */
+union MIR_ThinVec_Header {
+    struct {
+        /**
+         * \brief Number of elements currently stored in the array.
+         */
+        uint32_t len;
+        /**
+         * \brief Capacity (in elements) of the array.
+         */
+        uint32_t cap;
+    } h;
+
+    /* NOTE: alignment only */
+    long double __ld;
+    void *__ptr;
+    long __l;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_ThinVec
+ * struct.
+ */
+#define MIR_ThinVec_OK MIR_Vec_OK
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern int __MIR_ThinVec_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t new_capacity,
+    size_t elemSize
+);
+
+extern int __MIR_ThinVec_GrowByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t elemSize
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/**
+ * \brief Returns a pointer to the header of the non-empty heap allocated array.
+ */
+#define __MIR_ThinVec_Hdr(data)                                                \
+    (&((union MIR_ThinVec_Header *)(void *)(data) - 1)->h)
+
+/**
+ * \brief Returns the length of the thin vector.
+ *
+ * \param[in] vec pointer to \ref MIR_ThinVec struct
+ *
+ * \return length as `uint32_t`
+ */
+#define MIR_ThinVec_Len(vec)                                                   \
+    ((vec)->data == NULL ? (uint32_t)0u : __MIR_ThinVec_Hdr((vec)->data)->len)
+
+/**
+ * \brief Returns the capacity of the thin vector.
+ *
+ * \param[in] vec pointer to \ref MIR_ThinVec struct
+ *
+ * \return capacity as `uint32_t`
+ */
+#define MIR_ThinVec_Cap(vec)                                                   \
+    ((vec)->data == NULL ? (uint32_t)0u : __MIR_ThinVec_Hdr((vec)->data)->cap)
+
+/**
+ * \brief Returns the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_ThinVec struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_ThinVec_Get(vec, index)                                            \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < MIR_ThinVec_Len(vec),                                    \
+            "OOB: param `index' MUST be less than the vector length"           \
+        ),                                                                     \
+        (vec)->data[(index)]                                                   \
+    ) /* clang-format on */
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_ThinVec struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_ThinVec_GetPtr(vec, index)                                         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < MIR_ThinVec_Len(vec),                                    \
+            "OOB: param `index' MUST be less than the vector length"           \
+        ),                                                                     \
+        &(vec)->data[(index)]                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] vec   pointer to \ref MIR_ThinVec struct
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_ThinVec_Set(vec, index, elem)                                      \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG(                                                      \
+            (index) < MIR_ThinVec_Len(vec),                                    \
+            "OOB: param `index' MUST be less than the vector length"           \
+        ),                                                                     \
+        (vec)->data[(index)] = (elem)                                          \
+    ) /* clang-format on */
+
+/**
+ * \brief Init thin vector with zero capacity.
+ *
+ * \param[out] vec pointer to \ref MIR_ThinVec struct
+ */
+#define MIR_ThinVec_Init(vec)                                                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        (vec)->data = NULL                                                     \
+    ) /* clang-format on */
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than the current
+ * capacity. Fails if `new_capacity` is greater than `UINT32_MAX`.
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_ThinVec macro
+ * \param[in]     reallocF      realloc-like function to be used
+ * \param[in,out] vec           pointer to \ref MIR_ThinVec struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_ThinVec_OK on success; any other value indicates failure
+ */
+#define MIR_ThinVec_ReserveByReallocF(type, reallocF, vec, new_capacity)       \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL")     \
+        ),                                                                     \
+        __MIR_ThinVec_ReserveByReallocF_impl(                                  \
+            reallocF, (void **)&(vec)->data, new_capacity, sizeof(type)        \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends the given element to the end of the thin vector by using
+ * provided realloc-like function.
+ *
+ * \details The growth policy is the same as that of \ref
+ * MIR_Vec32_PushByReallocF.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_ThinVec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_ThinVec struct
+ * \param         elem     pointer to the element to be appended. **MUST** point
+ *                         to the same type as that passed to \ref MIR_ThinVec
+ *                         macro
+ *
+ * \return \ref MIR_ThinVec_OK on success; any other value indicates failure
+ */
+#define MIR_ThinVec_PushByReallocF(type, reallocF, vec, elem)                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),        \
+        __MIR_ASSERT_MSG((elem) != NULL, "param `elem' MUST NOT be NULL"),     \
+            (                                                                  \
+                (MIR_ThinVec_Len(vec) < MIR_ThinVec_Cap(vec))                  \
+                ||                                                             \
+                (                                                              \
+                    __MIR_ThinVec_GrowByReallocF_impl(                         \
+                        reallocF, (void **)&(vec)->data, sizeof(type)          \
+                    ) == MIR_ThinVec_OK                                        \
+                )                                                              \
+            )                                                                  \
+        ?                                                                      \
+            (                                                                  \
+                (vec)->data[__MIR_ThinVec_Hdr((vec)->data)->len] = *(elem),    \
+                ++(__MIR_ThinVec_Hdr((vec)->data)->len),                       \
+                MIR_ThinVec_OK                                                 \
+            )                                                                  \
+        :                                                                      \
+            1                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Deinits the \ref MIR_ThinVec struct by using provided free-like
+ * function.
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] freeF free-like function to be used
+ * \param[in] vec   pointer to \ref MIR_ThinVec struct to be deinitialized
+ */
+#define MIR_ThinVec_DeinitByFreeF(freeF, vec)                                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                (freeF) != NULL,                                               \
+                "param `freeF' MUST not be NULL"                               \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (vec) != NULL,                                                 \
+                "param `vec' MUST not be NULL"                                 \
+            )                                                                  \
+        ),                                                                     \
+        ((vec)->data == NULL)                                                  \
+            ? (void)0                                                          \
+            : (freeF)((union MIR_ThinVec_Header *)(void *)(vec)->data - 1)     \
+    ) /* clang-format on */
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * standard library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_ThinVec macro
+ * \param[in,out] vec           pointer to \ref MIR_ThinVec struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_ThinVec_OK on success; any other value indicates failure
+ */
+#    define MIR_ThinVec_Reserve(type, vec, new_capacity)                       \
+        MIR_ThinVec_ReserveByReallocF(type, realloc, vec, new_capacity)
+
+/**
+ * \brief Appends the given element to the end of the thin vector by using
+ * standard library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type type of elements. **MUST** be the same type as that
+ *                     passed to \ref MIR_ThinVec macro
+ * \param[in,out] vec  pointer to \ref MIR_ThinVec struct
+ * \param         elem pointer to the element to be appended
+ *
+ * \return \ref MIR_ThinVec_OK on success; any other value indicates failure
+ */
+#    define MIR_ThinVec_Push(type, vec, elem)                                  \
+        MIR_ThinVec_PushByReallocF(type, realloc, vec, elem)
+
+/**
+ * \brief Deinits the \ref MIR_ThinVec struct
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] vec pointer to \ref MIR_ThinVec struct to be deinitialized
+ */
+#    define MIR_ThinVec_Deinit(vec) MIR_ThinVec_DeinitByFreeF(free, vec)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_THINVEC_H */
@@ -19,6 +19,8 @@
 #endif
 
 #include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/common/macros.h>   /* MIR_COLD, MIR_INLINE, MIR_NOINLINE */
+#include <mir/common/mem.h>      /* MIR_AlignedRealloc */
 #include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
 
 
@@ -64,12 +66,33 @@
  * + reserve
  *   - \ref MIR_Vec_Reserve - by using standard library `realloc` function
  *   - \ref MIR_Vec_ReserveByReallocF - by using provided realloc-like function
+ *   - \ref MIR_Vec_ReserveAligned - with given alignment by using \ref
+ *     MIR_AlignedRealloc function
+ *   - \ref MIR_Vec_ReserveByAlignedReallocF - with given alignment by using
+ *     provided aligned realloc-like function
  * + push_back
  *   - \ref MIR_Vec_Push - by using standard library `realloc` function
  *   - \ref MIR_Vec_PushByReallocF - by using provided realloc-like function
+ * + pop_back / truncate
+ *   - \ref MIR_Vec_Pop - without reclaiming memory
+ *   - \ref MIR_Vec_Truncate - without reclaiming memory
+ *   - \ref MIR_Vec_PopAndShrink, \ref MIR_Vec_TruncateAndShrink - with
+ *     hysteresis shrinking by using standard library `realloc` and `free`
+ *     functions
+ *   - \ref MIR_Vec_PopAndShrinkByReallocF, \ref
+ *     MIR_Vec_TruncateAndShrinkByReallocF - with hysteresis shrinking by using
+ *     provided realloc-like and free-like functions
+ * + shrink
+ *   - \ref MIR_Vec_ShrinkTo, \ref MIR_Vec_ShrinkToFit - by using standard
+ *     library `realloc` and `free` functions
+ *   - \ref MIR_Vec_ShrinkToByReallocF, \ref MIR_Vec_ShrinkToFitByReallocF -
+ *     by using provided realloc-like and free-like functions
  * + deinitialization
  *   - \ref MIR_Vec_Deinit - by using standard library `free` function
  *   - \ref MIR_Vec_DeinitByFreeF - by using provided free-like function
+ *
+ * The macros above expand in place. \ref MIR_VEC_DEFINE generates typed
+ * functions doing the same, which is better for hot call sites.
  */
 #define MIR_Vec(type, structTag)                                               \
     struct structTag {                                                         \
@@ -84,6 +107,16 @@
  */
 #define MIR_Vec_OK 0
 
+/**
+ * \brief Default shrink factor of the hysteresis shrinking policy.
+ *
+ * \details See \ref MIR_Vec_PopAndShrinkByReallocF. **MAY** be defined by the
+ * user prior to including this header.
+ */
+#ifndef MIR_Vec_SHRINK_FACTOR
+#    define MIR_Vec_SHRINK_FACTOR 4u
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -95,6 +128,23 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
     size_t capacity, size_t elemSize
 );
 
+extern int __MIR_Vec_ReserveByAlignedReallocF_impl(
+    void *(*aligned_realloc_f)(void *, size_t, size_t), void **member_data,
+    size_t *member_cap, size_t capacity, size_t elemSize, size_t alignment
+);
+
+extern int __MIR_Vec_ShrinkToByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void (*free_f)(void *),
+    void **member_data, size_t *member_cap, size_t len, size_t capacity,
+    size_t elemSize
+);
+
+extern void __MIR_Vec_AutoShrinkByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void (*free_f)(void *),
+    void **member_data, size_t *member_cap, size_t len, size_t factor,
+    size_t elemSize
+);
+
 
 #ifdef __cplusplus
 }
@@ -201,6 +251,57 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
         )                                                                      \
     ) /* clang-format on */
 
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided aligned realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than `vec->cap`.
+ *
+ * \warning The vector **MUST** keep using an allocator with the same alignment
+ * for its whole life (e.g. \ref MIR_CacheAlignedRealloc with \ref
+ * MIR_Vec_PushByReallocF if the alignment is \ref MIR_CACHE_LINE_SIZE).
+ *
+ * \param         type            type of elements. **MUST** be the same type
+ *                                as that passed to \ref MIR_Vec macro
+ * \param[in]     alignedReallocF aligned realloc-like function, i.e. a function
+ *                                with `void *(void *ptr, size_t alignment,
+ *                                size_t size)` signature (e.g. \ref
+ *                                MIR_AlignedRealloc)
+ * \param[in,out] vec             pointer to \ref MIR_Vec struct
+ * \param         new_capacity    minimum new capacity
+ * \param         alignment       alignment in bytes. **MUST** be a power of two
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#define MIR_Vec_ReserveByAlignedReallocF(                                      \
+    type, alignedReallocF, vec, new_capacity, alignment                        \
+)                                                                              \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (alignedReallocF) != NULL,                                     \
+                "param `alignedReallocF' MUST not be NULL"                     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),    \
+            __MIR_ASSERT_MSG(                                                  \
+                ((vec)->cap == 0u) ? ((vec)->data == NULL) : 1,                \
+                "if `vec->cap == 0' then `vec->data' MUST be NULL"             \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (alignment) != 0u && ((alignment) & ((alignment) - 1u)) == 0u, \
+                "param `alignment' MUST be a power of two"                     \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_Vec_ReserveByAlignedReallocF_impl(                               \
+            alignedReallocF, (void **)&(vec)->data, &(vec)->cap,               \
+            new_capacity, sizeof(type), alignment                              \
+        )                                                                      \
+    ) /* clang-format on */
+
 /**
  * \brief Inits \ref MIR_Vec struct with given capacity by using provided
  * realloc-like function.
@@ -283,6 +384,172 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
                 )                                                              \
     ) /* clang-format on */
 
+/**
+ * \brief Removes the last element of the vector.
+ *
+ * \details It never reclaims memory.
+ *
+ * \param[in,out] vec pointer to \ref MIR_Vec struct
+ * \param[out]    out pointer where the removed element will be written
+ *
+ * \return \ref MIR_Vec_OK on success; `1` if the vector is empty
+ */
+#define MIR_Vec_Pop(vec, out)                                                  \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        __MIR_ASSERT_MSG((out) != NULL, "param `out' MUST not be NULL"),       \
+        ((vec)->len == 0u)                                                     \
+            ? 1                                                                \
+            : (*(out) = (vec)->data[--((vec)->len)], MIR_Vec_OK)               \
+    ) /* clang-format on */
+
+/**
+ * \brief Shortens the vector, keeping the first `new_len` elements.
+ *
+ * \details Does nothing if `new_len` is equal to or greater than `vec->len`.
+ * It never reclaims memory.
+ *
+ * \param[in,out] vec     pointer to \ref MIR_Vec struct
+ * \param         new_len new length
+ */
+#define MIR_Vec_Truncate(vec, new_len)                                         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST not be NULL"),       \
+        ((new_len) < (vec)->len) ? (void)((vec)->len = (new_len)) : (void)0    \
+    ) /* clang-format on */
+
+/**
+ * \brief Shrinks the capacity of the vector to `capacity` by using provided
+ * realloc-like and free-like functions.
+ *
+ * \details The capacity will never become less than `vec->len`. Does nothing
+ * if the capacity is already equal to or less than `capacity`. If the
+ * resulting capacity is `0` the memory is freed by `freeF`, so that
+ * `realloc(.., 0)` is never called.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in]     freeF    free-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param         capacity desired capacity
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure (the
+ * vector is left untouched in this case)
+ */
+#define MIR_Vec_ShrinkToByReallocF(type, reallocF, freeF, vec, capacity)       \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (freeF) != NULL, "param `freeF' MUST not be NULL"              \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),    \
+            __MIR_ASSERT_MSG(                                                  \
+                ((vec)->cap == 0u) ? ((vec)->data == NULL) : 1,                \
+                "if `vec->cap == 0' then `vec->data' MUST be NULL"             \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_Vec_ShrinkToByReallocF_impl(                                     \
+            reallocF, freeF, (void **)&(vec)->data, &(vec)->cap, (vec)->len,   \
+            capacity, sizeof(type)                                             \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Shrinks the capacity of the vector to its length by using provided
+ * realloc-like and free-like functions.
+ *
+ * \details See \ref MIR_Vec_ShrinkToByReallocF.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in]     freeF    free-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#define MIR_Vec_ShrinkToFitByReallocF(type, reallocF, freeF, vec)              \
+    MIR_Vec_ShrinkToByReallocF(type, reallocF, freeF, vec, 0u)
+
+/**
+ * \brief Removes the last element of the vector and shrinks the capacity if
+ * the vector became sparse by using provided realloc-like and free-like
+ * functions.
+ *
+ * \details Hysteresis policy: once `vec->len` drops below `vec->cap / factor`
+ * the capacity is shrunk to `2 * vec->len`. Therefore, the vector neither
+ * shrinks on every removal nor regrows right after a shrink. Shrinking is best
+ * effort: if it fails the vector keeps its capacity.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in]     freeF    free-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param[out]    out      pointer where the removed element will be written
+ * \param         factor   shrink factor. **MUST** be greater than `2`. Usually
+ *                         \ref MIR_Vec_SHRINK_FACTOR is used
+ *
+ * \return \ref MIR_Vec_OK on success; `1` if the vector is empty
+ */
+#define MIR_Vec_PopAndShrinkByReallocF(type, reallocF, freeF, vec, out, factor)\
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (MIR_Vec_Pop(vec, out) != MIR_Vec_OK)                                  \
+            ? 1                                                                \
+            : (                                                                \
+                __MIR_ASSERT_MSG(                                              \
+                    (factor) > 2u, "param `factor' MUST be greater than 2"     \
+                ),                                                             \
+                __MIR_Vec_AutoShrinkByReallocF_impl(                           \
+                    reallocF, freeF, (void **)&(vec)->data, &(vec)->cap,       \
+                    (vec)->len, factor, sizeof(type)                           \
+                ),                                                             \
+                MIR_Vec_OK                                                     \
+            )                                                                  \
+    ) /* clang-format on */
+
+/**
+ * \brief Shortens the vector, keeping the first `new_len` elements, and shrinks
+ * the capacity if the vector became sparse by using provided realloc-like and
+ * free-like functions.
+ *
+ * \details See \ref MIR_Vec_PopAndShrinkByReallocF for the shrinking policy.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in]     freeF    free-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param         new_len  new length
+ * \param         factor   shrink factor. **MUST** be greater than `2`
+ */
+#define MIR_Vec_TruncateAndShrinkByReallocF(                                   \
+    type, reallocF, freeF, vec, new_len, factor                                \
+)                                                                              \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        MIR_Vec_Truncate(vec, new_len),                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            (factor) > 2u, "param `factor' MUST be greater than 2"             \
+        ),                                                                     \
+        __MIR_Vec_AutoShrinkByReallocF_impl(                                   \
+            reallocF, freeF, (void **)&(vec)->data, &(vec)->cap, (vec)->len,   \
+            factor, sizeof(type)                                               \
+        )                                                                      \
+    ) /* clang-format on */
+
+
 /**
  * \brief Deinits the \ref MIR_Vec struct by using provided free-like function.
  *
@@ -335,6 +602,29 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
 #    define MIR_Vec_Reserve(type, vec, new_capacity)                           \
         MIR_Vec_ReserveByReallocF(type, realloc, vec, new_capacity)
 
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items with
+ * given alignment by using \ref MIR_AlignedRealloc function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \details The memory **MUST** be freed by \ref MIR_AlignedFree. See \ref
+ * MIR_Vec_ReserveByAlignedReallocF.
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_Vec macro
+ * \param[in,out] vec           pointer to \ref MIR_Vec struct
+ * \param         new_capacity  minimum new capacity
+ * \param         alignment     alignment in bytes. **MUST** be a power of two
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec_ReserveAligned(type, vec, new_capacity, alignment)         \
+        MIR_Vec_ReserveByAlignedReallocF(                                      \
+            type, MIR_AlignedRealloc, vec, new_capacity, alignment             \
+        )
+
 /**
  * \brief Inits \ref MIR_Vec struct with given capacity by using standard
  * library `realloc` function.
@@ -370,6 +660,83 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
 #    define MIR_Vec_Push(type, vec, elem)                                      \
         MIR_Vec_PushByReallocF(type, realloc, vec, elem)
 
+/**
+ * \brief Shrinks the capacity of the vector to `capacity` by using standard
+ * library `realloc` and `free` functions.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \details See \ref MIR_Vec_ShrinkToByReallocF.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec macro
+ * \param[in,out] vec      pointer to \ref MIR_Vec struct
+ * \param         capacity desired capacity
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec_ShrinkTo(type, vec, capacity)                              \
+        MIR_Vec_ShrinkToByReallocF(type, realloc, free, vec, capacity)
+
+/**
+ * \brief Shrinks the capacity of the vector to its length by using standard
+ * library `realloc` and `free` functions.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type type of elements. **MUST** be the same type as that
+ *                     passed to \ref MIR_Vec macro
+ * \param[in,out] vec  pointer to \ref MIR_Vec struct
+ *
+ * \return \ref MIR_Vec_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec_ShrinkToFit(type, vec)                                     \
+        MIR_Vec_ShrinkToFitByReallocF(type, realloc, free, vec)
+
+/**
+ * \brief Removes the last element of the vector and shrinks the capacity
+ * (with \ref MIR_Vec_SHRINK_FACTOR) by using standard library `realloc` and
+ * `free` functions.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \details See \ref MIR_Vec_PopAndShrinkByReallocF.
+ *
+ * \param         type type of elements. **MUST** be the same type as that
+ *                     passed to \ref MIR_Vec macro
+ * \param[in,out] vec  pointer to \ref MIR_Vec struct
+ * \param[out]    out  pointer where the removed element will be written
+ *
+ * \return \ref MIR_Vec_OK on success; `1` if the vector is empty
+ */
+#    define MIR_Vec_PopAndShrink(type, vec, out)                               \
+        MIR_Vec_PopAndShrinkByReallocF(                                        \
+            type, realloc, free, vec, out, MIR_Vec_SHRINK_FACTOR               \
+        )
+
+/**
+ * \brief Shortens the vector and shrinks the capacity (with \ref
+ * MIR_Vec_SHRINK_FACTOR) by using standard library `realloc` and `free`
+ * functions.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \details See \ref MIR_Vec_TruncateAndShrinkByReallocF.
+ *
+ * \param         type    type of elements. **MUST** be the same type as that
+ *                        passed to \ref MIR_Vec macro
+ * \param[in,out] vec     pointer to \ref MIR_Vec struct
+ * \param         new_len new length
+ */
+#    define MIR_Vec_TruncateAndShrink(type, vec, new_len)                      \
+        MIR_Vec_TruncateAndShrinkByReallocF(                                   \
+            type, realloc, free, vec, new_len, MIR_Vec_SHRINK_FACTOR           \
+        )
+
 /**
  * \brief Deinits the \ref MIR_Vec struct
  *
@@ -387,4 +754,182 @@ extern int __MIR_Vec_ReserveByReallocF_impl(
 #endif /* MIR_NO_STD_ALLOCATOR */
 
 
+/**
+ * \brief Generates typed functions of the \ref MIR_Vec struct.
+ *
+ * \param type      elements type. **MUST** be the same type as that passed to
+ *                  \ref MIR_Vec macro
+ * \param structTag struct tag. **MUST** be the same as that passed to \ref
+ *                  MIR_Vec macro. It's also used as the functions prefix
+ *
+ * \details The `MIR_Vec_*` macros expand their whole body, including the
+ * growth path, at every call site and evaluate their arguments several times.
+ * The generated functions evaluate arguments once and keep only the fast path
+ * inline: \ref MIR_Vec_PushByReallocF's reallocation lives in a separate
+ * \ref MIR_NOINLINE \ref MIR_COLD function, so a push in a hot loop is a
+ * compare, a store and an increment. All functions are `static`, so unused
+ * ones are dropped by the compiler.
+ *
+ * Generated functions (`vec` is `struct structTag *`; functions returning
+ * `int` return \ref MIR_Vec_OK on success and `1` on failure):
+ * + `void structTag##_Init(vec)`
+ * + `type structTag##_Get(vec, size_t index)`
+ * + `type *structTag##_GetPtr(vec, size_t index)`
+ * + `void structTag##_Set(vec, size_t index, type elem)`
+ * + `int structTag##_ReserveByReallocF(reallocF, vec, size_t capacity)`
+ * + `int structTag##_PushByReallocF(reallocF, vec, const type *elem)` -
+ *   `elem` **MAY** point into the vector
+ * + `int structTag##_Pop(vec, type *out)` - `1` if the vector is empty
+ * + `void structTag##_Truncate(vec, size_t len)`
+ * + `void structTag##_DeinitByFreeF(freeF, vec)` - frees the memory and
+ *   leaves the vector empty
+ * + `structTag##_Reserve`, `structTag##_Push`, `structTag##_Deinit` - the
+ *   same but by using standard library `realloc` and `free` functions
+ *
+ * \code{.c}
+ * MIR_Vec(struct Token, Tokens);
+ * MIR_VEC_DEFINE(struct Token, Tokens)
+ *
+ * struct Tokens tokens;
+ * Tokens_Init(&tokens);
+ * if (Tokens_Push(&tokens, &token) != MIR_Vec_OK) {
+ *     ...
+ * }
+ * Tokens_Deinit(&tokens);
+ * \endcode
+ */
+#define MIR_VEC_DEFINE(type, structTag)                                        \
+    __MIR_VEC_DEFINE_CORE(type, structTag)                                     \
+    __MIR_VEC_DEFINE_STD(type, structTag)
+
+#define __MIR_VEC_DEFINE_CORE(type, structTag)                                 \
+                                                                               \
+    MIR_INLINE void structTag##_Init(struct structTag *vec) {                  \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        vec->data = NULL;                                                      \
+        vec->len = 0;                                                          \
+        vec->cap = 0;                                                          \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE type structTag##_Get(                                           \
+        const struct structTag *vec, size_t index                              \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < vec->len, "OOB: param `index' MUST be less than vec->len"  \
+        );                                                                     \
+        return vec->data[index];                                               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE type *structTag##_GetPtr(struct structTag *vec, size_t index) { \
+        __MIR_ASSERT_MSG(                                                      \
+            index < vec->len, "OOB: param `index' MUST be less than vec->len"  \
+        );                                                                     \
+        return &vec->data[index];                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_Set(                                           \
+        struct structTag *vec, size_t index, type elem                         \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            index < vec->len, "OOB: param `index' MUST be less than vec->len"  \
+        );                                                                     \
+        vec->data[index] = elem;                                               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_ReserveByReallocF(                              \
+        void *(*reallocF)(void *, size_t), struct structTag *vec,              \
+        size_t capacity                                                        \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(                                                      \
+            reallocF != NULL, "param `reallocF' MUST NOT be NULL"              \
+        );                                                                     \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        return __MIR_Vec_ReserveByReallocF_impl(                               \
+            reallocF, (void **)&vec->data, &vec->cap, capacity, sizeof(type)   \
+        );                                                                     \
+    }                                                                          \
+                                                                               \
+    /* NOTE: the element is copied before growing as it may be inside */       \
+    static MIR_MAYBE_UNUSED MIR_NOINLINE MIR_COLD int                          \
+    structTag##__GrowAndPushByReallocF(                                        \
+        void *(*reallocF)(void *, size_t), struct structTag *vec,              \
+        const type *elem                                                       \
+    ) {                                                                        \
+        type copy = *elem;                                                     \
+                                                                               \
+        if (vec->cap > SIZE_MAX / 2u ||                                        \
+            __MIR_Vec_ReserveByReallocF_impl(                                  \
+                reallocF, (void **)&vec->data, &vec->cap,                      \
+                (vec->cap == 0u) ? 1u : vec->cap * 2u, sizeof(type)            \
+            ) != MIR_Vec_OK) {                                                 \
+            return 1;                                                          \
+        }                                                                      \
+        vec->data[vec->len++] = copy;                                          \
+        return MIR_Vec_OK;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_PushByReallocF(                                 \
+        void *(*reallocF)(void *, size_t), struct structTag *vec,              \
+        const type *elem                                                       \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(elem != NULL, "param `elem' MUST NOT be NULL");       \
+                                                                               \
+        if (MIR_LIKELY(vec->len < vec->cap)) {                                 \
+            vec->data[vec->len++] = *elem;                                     \
+            return MIR_Vec_OK;                                                 \
+        }                                                                      \
+        return structTag##__GrowAndPushByReallocF(reallocF, vec, elem);        \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE int structTag##_Pop(struct structTag *vec, type *out) {         \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(out != NULL, "param `out' MUST NOT be NULL");         \
+                                                                               \
+        if (vec->len == 0u) {                                                  \
+            return 1;                                                          \
+        }                                                                      \
+        *out = vec->data[--vec->len];                                          \
+        return MIR_Vec_OK;                                                     \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_Truncate(struct structTag *vec, size_t len) {  \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        if (len < vec->len) {                                                  \
+            vec->len = len;                                                    \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void structTag##_DeinitByFreeF(                                 \
+        void (*freeF)(void *), struct structTag *vec                           \
+    ) {                                                                        \
+        __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");     \
+        __MIR_ASSERT_MSG(vec != NULL, "param `vec' MUST NOT be NULL");         \
+        freeF(vec->data);                                                      \
+        structTag##_Init(vec);                                                 \
+    }
+
+#ifndef MIR_NO_STD_ALLOCATOR
+#    define __MIR_VEC_DEFINE_STD(type, structTag)                              \
+                                                                               \
+        MIR_INLINE int structTag##_Reserve(                                    \
+            struct structTag *vec, size_t capacity                             \
+        ) {                                                                    \
+            return structTag##_ReserveByReallocF(realloc, vec, capacity);      \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE int structTag##_Push(                                       \
+            struct structTag *vec, const type *elem                            \
+        ) {                                                                    \
+            return structTag##_PushByReallocF(realloc, vec, elem);             \
+        }                                                                      \
+                                                                               \
+        MIR_INLINE void structTag##_Deinit(struct structTag *vec) {            \
+            structTag##_DeinitByFreeF(free, vec);                              \
+        }
+#else
+#    define __MIR_VEC_DEFINE_STD(type, structTag)
+#endif
+
+
 #endif /* _MIR_COMMON_COLLECTIONS_VEC_H */
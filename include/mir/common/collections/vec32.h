@@ -0,0 +1,333 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Vec32 utilities
+ */
+
+#ifndef _MIR_COMMON_COLLECTIONS_VEC32_H
+#define _MIR_COMMON_COLLECTIONS_VEC32_H
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint32_t, UINT32_MAX */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/arith.h>           /* MIR_u_Mul_WillOverflow */
+#include <mir/common/collections/vec.h> /* MIR_Vec_Get, MIR_Vec_OK */
+#include <mir/internal/assert.h>        /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Defines a dynamic size array struct with 32-bit length and capacity -
+ * a compact vector.
+ *
+ * \param type      elements type. **MAY** consist of several tokens
+ * \param structTag struct tag. **MAY** be empty if no struct tag is desired
+ *
+ * \note Be aware that prior to C99, the C standard did not specify behavior for
+ * macros with empty arguments.
+ *
+ * \details It's the same as \ref MIR_Vec except that members `len` and `cap`
+ * are of type `uint32_t`. On 64-bit platforms the struct takes 16 bytes instead
+ * of 24. The capacity is limited by `UINT32_MAX` elements.
+ *
+ * Members and rules are the same as those of \ref MIR_Vec. Therefore, any \ref
+ * MIR_Vec macro that does not allocate (e.g. \ref MIR_Vec_Get) can also be used
+ * with a compact vector.
+ *
+ * ## Interface
+ *
+ * \note \ref MIR_Vec32_InitWithCapacity, \ref MIR_Vec32_Deinit, \ref
+ * MIR_Vec32_Reserve, \ref MIR_Vec32_Push will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + initialization
+ *   - \ref MIR_Vec32_Init - with zero capacity
+ *   - \ref MIR_Vec32_InitWithCapacity - with given capacity by using standard
+ *     library `realloc` function
+ *   - \ref MIR_Vec32_InitWithCapacityByReallocF - with given capacity by using
+ *     provided realloc-like function
+ * + get
+ *   - \ref MIR_Vec32_Get - the element
+ *   - \ref MIR_Vec32_GetPtr - a pointer to the element
+ * + set
+ *   - \ref MIR_Vec32_Set - the element
+ * + reserve
+ *   - \ref MIR_Vec32_Reserve - by using standard library `realloc` function
+ *   - \ref MIR_Vec32_ReserveByReallocF - by using provided realloc-like
+ *     function
+ * + push_back
+ *   - \ref MIR_Vec32_Push - by using standard library `realloc` function
+ *   - \ref MIR_Vec32_PushByReallocF - by using provided realloc-like function
+ * + deinitialization
+ *   - \ref MIR_Vec32_Deinit - by using standard library `free` function
+ *   - \ref MIR_Vec32_DeinitByFreeF - by using provided free-like function
+ *
+ * \sa \ref MIR_ThinVec - for a vector that takes only one pointer
+ */
+#define MIR_Vec32(type, structTag)                                             \
+    struct structTag {                                                         \
+        type *data;                                                            \
+        uint32_t len;                                                          \
+        uint32_t cap;                                                          \
+    }
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Vec32
+ * struct.
+ */
+#define MIR_Vec32_OK MIR_Vec_OK
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern int __MIR_Vec32_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data,
+    uint32_t *member_cap, size_t new_capacity, size_t elemSize
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/**
+ * \brief Returns the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_Vec32 struct
+ * \param     index index of the element to be returned
+ *
+ * \return element at the specified index
+ */
+#define MIR_Vec32_Get(vec, index) MIR_Vec_Get(vec, index)
+
+/**
+ * \brief Returns a pointer to the element at the specified index.
+ *
+ * \param[in] vec   pointer to \ref MIR_Vec32 struct
+ * \param     index index of the element whose pointer is to be returned
+ *
+ * \return pointer to the element at the specified index
+ */
+#define MIR_Vec32_GetPtr(vec, index) MIR_Vec_GetPtr(vec, index)
+
+/**
+ * \brief Sets the element at the specified index.
+ *
+ * \param[out] vec   pointer to \ref MIR_Vec32 struct
+ * \param      index index of the element to be set
+ * \param      elem  element to set at the specified index
+ */
+#define MIR_Vec32_Set(vec, index, elem) MIR_Vec_Set(vec, index, elem)
+
+/**
+ * \brief Init vector with zero capacity.
+ *
+ * \param[out] vec pointer to \ref MIR_Vec32 struct
+ */
+#define MIR_Vec32_Init(vec) MIR_Vec_Init(vec)
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * provided realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than `vec->cap`.
+ * Fails if `new_capacity` is greater than `UINT32_MAX`.
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_Vec32 macro
+ * \param[in]     reallocF      realloc-like function to be used
+ * \param[in,out] vec           pointer to \ref MIR_Vec32 struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#define MIR_Vec32_ReserveByReallocF(type, reallocF, vec, new_capacity)         \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (                                                                      \
+            __MIR_ASSERT_MSG(                                                  \
+                sizeof(type) > 0u, "`sizeof(type)' MUST be greater than 0"     \
+            ),                                                                 \
+            __MIR_ASSERT_MSG(                                                  \
+                (reallocF) != NULL, "param `reallocF' MUST not be NULL"        \
+            ),                                                                 \
+            __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),    \
+            __MIR_ASSERT_MSG(                                                  \
+                ((vec)->cap == 0u) ? ((vec)->data == NULL) : 1,                \
+                "if `vec->cap == 0' then `vec->data' MUST be NULL"             \
+            )                                                                  \
+        ),                                                                     \
+        __MIR_Vec32_ReserveByReallocF_impl(                                    \
+            reallocF, (void **)&(vec)->data, &(vec)->cap,                      \
+            new_capacity, sizeof(type)                                         \
+        )                                                                      \
+    ) /* clang-format on */
+
+/**
+ * \brief Inits \ref MIR_Vec32 struct with given capacity by using provided
+ * realloc-like function.
+ *
+ * \param      type     type of elements. **MUST** be the same type as that
+ *                      passed to \ref MIR_Vec32 macro
+ * \param[in]  reallocF realloc-like function to be used
+ * \param[out] vec      pointer to \ref MIR_Vec32 struct to be initalized
+ * \param      capacity initial capacity
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#define MIR_Vec32_InitWithCapacityByReallocF(type, reallocF, vec, capacity)    \
+    /* clang-format off */                                                     \
+    (                                                                          \
+        (vec)->data = NULL,                                                    \
+        (vec)->len = 0,                                                        \
+        (vec)->cap = 0,                                                        \
+        MIR_Vec32_ReserveByReallocF(type, reallocF, vec, capacity)             \
+    ) /* clang-format on */
+
+/**
+ * \brief Appends the given element to the end of the vector by using
+ * provided realloc-like function.
+ *
+ * \details The growth policy is the same as that of \ref
+ * MIR_Vec_PushByReallocF, but the doubled capacity is clamped to `UINT32_MAX`.
+ *
+ * \param         type     type of elements. **MUST** be the same type as that
+ *                         passed to \ref MIR_Vec32 macro
+ * \param[in]     reallocF realloc-like function to be used
+ * \param[in,out] vec      pointer to \ref MIR_Vec32 struct
+ * \param         elem     pointer to the element to be appended. **MUST** point
+ *                         to the same type as that passed to \ref MIR_Vec32
+ *                         macro
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#define MIR_Vec32_PushByReallocF(type, reallocF, vec, elem)                    \
+    /* clang-format off */                                                     \
+    (                                                                          \
+            (                                                                  \
+                __MIR_ASSERT_MSG((vec) != NULL, "param `vec' MUST no be NULL"),\
+                ((vec)->len < (vec)->cap)                                      \
+            )                                                                  \
+        ?                                                                      \
+            (                                                                  \
+                __MIR_ASSERT_MSG(                                              \
+                    (elem) != NULL, "param `elem' MUST NOT be NULL"            \
+                ),                                                             \
+                (vec)->data[(vec)->len] = *(elem),                             \
+                ++((vec)->len),                                                \
+                MIR_Vec32_OK                                                   \
+            )                                                                  \
+        :                                                                      \
+                (                                                              \
+                        ((vec)->cap == UINT32_MAX)                             \
+                    ?   1                                                      \
+                    :                                                          \
+                        (                                                      \
+                            MIR_Vec32_ReserveByReallocF(                       \
+                                type, reallocF, vec,                           \
+                                ((vec)->cap == 0u)                             \
+                                    ? (size_t)1u                               \
+                                    : ((vec)->cap > UINT32_MAX / 2u)           \
+                                        ? (size_t)UINT32_MAX                   \
+                                        : (size_t)(vec)->cap * 2u              \
+                            )                                                  \
+                            == 1                                               \
+                        )                                                      \
+                )                                                              \
+            ?   1                                                              \
+            :                                                                  \
+                (                                                              \
+                    (vec)->data[(vec)->len] = *(elem),                         \
+                    ++((vec)->len),                                            \
+                    MIR_Vec32_OK                                               \
+                )                                                              \
+    ) /* clang-format on */
+
+/**
+ * \brief Deinits the \ref MIR_Vec32 struct by using provided free-like
+ * function.
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] freeF free-like function to be used
+ * \param[in] vec   pointer to \ref MIR_Vec32 struct to be deinitialized
+ */
+#define MIR_Vec32_DeinitByFreeF(freeF, vec) MIR_Vec_DeinitByFreeF(freeF, vec)
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items by using
+ * standard library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type          type of elements. **MUST** be the same type as
+ *                              that passed to \ref MIR_Vec32 macro
+ * \param[in,out] vec           pointer to \ref MIR_Vec32 struct
+ * \param         new_capacity  minimum new capacity
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec32_Reserve(type, vec, new_capacity)                         \
+        MIR_Vec32_ReserveByReallocF(type, realloc, vec, new_capacity)
+
+/**
+ * \brief Inits \ref MIR_Vec32 struct with given capacity by using standard
+ * library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param      type     type of elements. **MUST** be the same type as that
+ *                      passed to \ref MIR_Vec32 macro
+ * \param[out] vec      pointer to \ref MIR_Vec32 struct to be initalized
+ * \param      capacity initial capacity
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec32_InitWithCapacity(type, vec, capacity)                    \
+        MIR_Vec32_InitWithCapacityByReallocF(type, realloc, vec, capacity)
+
+/**
+ * \brief Appends the given element to the end of the vector by using standard
+ * library `realloc` function.
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \param         type type of elements. **MUST** be the same type as that
+ *                     passed to \ref MIR_Vec32 macro
+ * \param[in,out] vec  pointer to \ref MIR_Vec32 struct
+ * \param         elem pointer to the element to be appended
+ *
+ * \return \ref MIR_Vec32_OK on success; any other value indicates failure
+ */
+#    define MIR_Vec32_Push(type, vec, elem)                                    \
+        MIR_Vec32_PushByReallocF(type, realloc, vec, elem)
+
+/**
+ * \brief Deinits the \ref MIR_Vec32 struct
+ *
+ * \note This macros will be defined only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined
+ *
+ * \warning It only frees the memory. It does not update the struct members.
+ *
+ * \param[in] vec pointer to \ref MIR_Vec32 struct to be deinitialized
+ */
+#    define MIR_Vec32_Deinit(vec) MIR_Vec32_DeinitByFreeF(free, vec)
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_COLLECTIONS_VEC32_H */
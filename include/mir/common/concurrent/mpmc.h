@@ -0,0 +1,191 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_MPMC - bounded lock-free multi-producer/multi-consumer queue
+ *
+ * \details The queue is an array of slots, each holding a sequence number and
+ * an element (D. Vyukov's bounded MPMC queue). A producer claims the slot at
+ * the enqueue index with a single CAS once the sequence number says the slot
+ * is free, copies the element and publishes it by bumping the sequence
+ * number. Consumers do the same with the dequeue index. Producers and
+ * consumers contend only on their own index and never take a lock.
+ *
+ * + \ref MIR_MPMC_TryPush, \ref MIR_MPMC_TryPop - never block. Note that
+ *   \ref MIR_MPMC_TryPop reports an empty queue while the producer that
+ *   claimed the oldest slot is still copying into it (and \ref
+ *   MIR_MPMC_TryPush reports a full one in the symmetric case)
+ * + \ref MIR_MPMC_Push, \ref MIR_MPMC_Pop - spin for a while and then park the
+ *   thread until the queue is not full/empty
+ *
+ * ## Parking
+ *
+ * On Linux a blocked thread sleeps in `futex(FUTEX_WAIT)` on an event counter
+ * and is woken by the opposite side only if someone is actually waiting, so
+ * the non-blocking path pays only for a fence and a load. On other platforms
+ * the blocking variants keep spinning.
+ *
+ * ## Memory layout
+ *
+ * The enqueue index, the dequeue index, the two parking events (written by
+ * every park and wake-up, read by every push/pop) and the read-only part
+ * (buffer pointer and sizes, set at init) are kept `2 * MIR_CACHE_LINE_SIZE`
+ * bytes apart. The slot array is allocated by a realloc-like function that
+ * **SHOULD** return cache-line-aligned blocks (e.g. \ref
+ * MIR_CacheAlignedRealloc, which is what \ref MIR_MPMC_Init uses).
+ *
+ * All functions except init/deinit are thread-safe.
+ */
+
+#ifndef _MIR_COMMON_CONCURRENT_MPMC_H
+#define _MIR_COMMON_CONCURRENT_MPMC_H
+
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint32_t */
+
+#include <mir/common/atomic.h> /* MIR_Atomic */
+#include <mir/common/mem.h>    /* MIR_CACHE_LINE_SIZE */
+
+
+/**
+ * \brief Event counter a thread can park on.
+ */
+struct __MIR_MPMC_Event {
+    /**
+     * \brief Bumped by every wake-up. It's the futex word.
+     */
+    MIR_Atomic(uint32_t) seq;
+
+    /**
+     * \brief Number of parked (or about to park) threads.
+     */
+    MIR_Atomic(uint32_t) waiters;
+};
+
+/**
+ * \brief Bounded multi-producer/multi-consumer queue.
+ *
+ * \warning Members **MUST NOT** be accessed directly.
+ */
+struct MIR_MPMC {
+    union {
+        struct {
+            unsigned char *slots;
+            size_t mask;
+            size_t slotSize;
+            size_t elemSize;
+        } s;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } shared;
+
+    union {
+        struct __MIR_MPMC_Event e;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } notEmpty;
+
+    union {
+        struct __MIR_MPMC_Event e;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } notFull;
+
+    union {
+        MIR_Atomic(size_t) pos;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } enq;
+
+    union {
+        MIR_Atomic(size_t) pos;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } deq;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_MPMC
+ * struct.
+ */
+#define MIR_MPMC_OK 0
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Inits the queue by using provided realloc-like function.
+ *
+ * \param[in]  reallocF realloc-like function
+ * \param[out] q        pointer to \ref MIR_MPMC struct
+ * \param      capacity capacity in elements. Rounded up to a power of two (at
+ *                      least `2`)
+ * \param      elemSize element size. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_MPMC_OK on success; `1` on failure
+ */
+extern int MIR_MPMC_InitByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_MPMC *q, size_t capacity,
+    size_t elemSize
+);
+
+/**
+ * \brief Frees the slot array by using provided free-like function.
+ *
+ * \warning No thread may be blocked on the queue.
+ */
+extern void MIR_MPMC_DeinitByFreeF(void (*freeF)(void *), struct MIR_MPMC *q);
+
+/**
+ * \brief Returns the capacity in elements.
+ */
+extern size_t MIR_MPMC_Cap(const struct MIR_MPMC *q);
+
+/**
+ * \brief Copies the element into the queue.
+ *
+ * \return \ref MIR_MPMC_OK on success; `1` if the queue is full
+ */
+extern int MIR_MPMC_TryPush(struct MIR_MPMC *q, const void *elem);
+
+/**
+ * \brief Copies the oldest element out of the queue.
+ *
+ * \return \ref MIR_MPMC_OK on success; `1` if the queue is empty
+ */
+extern int MIR_MPMC_TryPop(struct MIR_MPMC *q, void *out);
+
+/**
+ * \brief Copies the element into the queue, waiting while it's full.
+ */
+extern void MIR_MPMC_Push(struct MIR_MPMC *q, const void *elem);
+
+/**
+ * \brief Copies the oldest element out of the queue, waiting while it's
+ * empty.
+ */
+extern void MIR_MPMC_Pop(struct MIR_MPMC *q, void *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_MPMC_InitByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc.
+ */
+#    define MIR_MPMC_Init(q, capacity, elemSize)                               \
+        MIR_MPMC_InitByReallocF(                                               \
+            MIR_CacheAlignedRealloc, (q), (capacity), (elemSize)               \
+        )
+
+/**
+ * \brief The same as \ref MIR_MPMC_DeinitByFreeF but uses \ref
+ * MIR_AlignedFree.
+ */
+#    define MIR_MPMC_Deinit(q) MIR_MPMC_DeinitByFreeF(MIR_AlignedFree, (q))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_CONCURRENT_MPMC_H */
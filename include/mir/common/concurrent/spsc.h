@@ -0,0 +1,304 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_SPSC - bounded lock-free single-producer/single-consumer ring
+ *
+ * \details The ring is used in one of two modes chosen at initialization:
+ * + *element* mode (\ref MIR_SPSC_InitByMallocF with `elemSize > 0`) -
+ *   fixed-size elements:
+ *   - \ref MIR_SPSC_TryPush, \ref MIR_SPSC_TryPop - one element
+ *   - \ref MIR_SPSC_PushN, \ref MIR_SPSC_PopN - batch copy with a single
+ *     publication
+ *   - \ref MIR_SPSC_Reserve / \ref MIR_SPSC_Commit and \ref MIR_SPSC_Peek /
+ *     \ref MIR_SPSC_Release - zero-copy batches via \ref MIR_SPSC_Spans
+ * + *record* mode (\ref MIR_SPSC_InitByMallocF with `elemSize == 0`) -
+ *   variable-length byte records:
+ *   - \ref MIR_SPSC_BeginRecord / \ref MIR_SPSC_Publish - the producer writes
+ *     any number of records in place and publishes them at once
+ *   - \ref MIR_SPSC_NextRecord / \ref MIR_SPSC_Consume - the consumer reads
+ *     any number of records in place and releases their space at once
+ *   - \ref MIR_SPSC_TryPushRecord, \ref MIR_SPSC_TryPopRecord - copying
+ *     shortcuts
+ *
+ * ## Threading
+ *
+ * Producer functions **MUST** be called by one thread at a time, consumer
+ * functions - by one (other) thread at a time. Init/deinit **MUST NOT** race
+ * with anything.
+ *
+ * ## Memory layout
+ *
+ * The producer and the consumer state are kept `2 * MIR_CACHE_LINE_SIZE`
+ * bytes apart, so they never share a cache line regardless of the alignment
+ * of the struct. They also stay out of each other's adjacent-line prefetch
+ * pair only if the struct is `2 * MIR_CACHE_LINE_SIZE`-aligned (e.g.
+ * allocated by \ref MIR_AlignedMalloc); otherwise the end of one side and
+ * the start of the other may fall into the same pair. Each side keeps
+ * a cached copy of the index of the other side and re-reads the shared index
+ * (with acquire ordering) only when the cached one says the ring is
+ * full/empty. Indices are free-running counters, so `tail - head` is the
+ * number of used slots (bytes in record mode).
+ *
+ * Atomics come from \ref mir/common/atomic.h "atomic.h" (C11 `<stdatomic.h>`
+ * or the GCC/Clang `__atomic` builtins, as detected by `env.h`).
+ */
+
+#ifndef _MIR_COMMON_CONCURRENT_SPSC_H
+#define _MIR_COMMON_CONCURRENT_SPSC_H
+
+
+#include <stddef.h> /* size_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, malloc */
+#endif
+
+#include <mir/common/atomic.h> /* MIR_Atomic */
+#include <mir/common/mem.h>    /* MIR_CACHE_LINE_SIZE */
+
+
+/**
+ * \brief State of one side of \ref MIR_SPSC.
+ *
+ * \details The read-only members are duplicated in both sides, so that each
+ * side touches only its own cache lines in the fast path.
+ */
+struct __MIR_SPSC_Side {
+    /**
+     * \brief Published index (`tail` of the producer, `head` of the consumer).
+     */
+    MIR_Atomic(size_t) pos;
+
+    /**
+     * \brief Not yet published index. Owned by the side.
+     */
+    size_t local;
+
+    /**
+     * \brief Last seen published index of the other side.
+     */
+    size_t cachedOther;
+
+    unsigned char *buf;
+    size_t cap;
+    size_t elemSize;
+};
+
+/**
+ * \brief Bounded single-producer/single-consumer ring.
+ *
+ * \warning Members **MUST NOT** be accessed directly.
+ */
+struct MIR_SPSC {
+    union {
+        struct __MIR_SPSC_Side s;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } prod;
+
+    union {
+        struct __MIR_SPSC_Side s;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } cons;
+};
+
+/**
+ * \brief Up to two contiguous runs of ring slots (in ring order).
+ *
+ * \details `second` is `NULL` iff `secondLen` is `0`. Lengths are in elements.
+ */
+struct MIR_SPSC_Spans {
+    void *first;
+    size_t firstLen;
+    void *second;
+    size_t secondLen;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_SPSC
+ * struct.
+ */
+#define MIR_SPSC_OK 0
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Inits the ring by using provided malloc-like function.
+ *
+ * \param[in]  mallocF  malloc-like function
+ * \param[out] ring     pointer to \ref MIR_SPSC struct
+ * \param      capacity capacity in elements (element mode) or in bytes (record
+ *                      mode). Rounded up to a power of two (at least `16` in
+ *                      record mode)
+ * \param      elemSize element size, or `0` for record mode
+ *
+ * \return \ref MIR_SPSC_OK on success; `1` on failure
+ */
+extern int MIR_SPSC_InitByMallocF(
+    void *(*mallocF)(size_t), struct MIR_SPSC *ring, size_t capacity,
+    size_t elemSize
+);
+
+/**
+ * \brief Frees the buffer by using provided free-like function.
+ */
+extern void
+MIR_SPSC_DeinitByFreeF(void (*freeF)(void *), struct MIR_SPSC *ring);
+
+/**
+ * \brief Returns the capacity (in elements or bytes).
+ */
+extern size_t MIR_SPSC_Cap(const struct MIR_SPSC *ring);
+
+
+/* ---------------------------- Element mode ------------------------------- */
+
+/**
+ * \brief Producer: copies one element into the ring and publishes it.
+ *
+ * \return \ref MIR_SPSC_OK on success; `1` if the ring is full
+ */
+extern int MIR_SPSC_TryPush(struct MIR_SPSC *ring, const void *elem);
+
+/**
+ * \brief Consumer: copies one element out of the ring and releases its slot.
+ *
+ * \return \ref MIR_SPSC_OK on success; `1` if the ring is empty
+ */
+extern int MIR_SPSC_TryPop(struct MIR_SPSC *ring, void *out);
+
+/**
+ * \brief Producer: copies up to `n` elements into the ring (at most two
+ * `memcpy` calls) and publishes them with a single store.
+ *
+ * \return number of pushed elements
+ */
+extern size_t
+MIR_SPSC_PushN(struct MIR_SPSC *ring, const void *elems, size_t n);
+
+/**
+ * \brief Consumer: copies up to `n` elements out of the ring and releases
+ * their slots with a single store.
+ *
+ * \return number of popped elements
+ */
+extern size_t MIR_SPSC_PopN(struct MIR_SPSC *ring, void *out, size_t n);
+
+/**
+ * \brief Producer: returns up to `n` free slots as spans to be filled in
+ * place. Nothing is published until \ref MIR_SPSC_Commit.
+ *
+ * \return number of reserved slots (`spans->firstLen + spans->secondLen`)
+ */
+extern size_t
+MIR_SPSC_Reserve(struct MIR_SPSC *ring, size_t n, struct MIR_SPSC_Spans *spans);
+
+/**
+ * \brief Producer: publishes `n` slots returned by the last \ref
+ * MIR_SPSC_Reserve.
+ */
+extern void MIR_SPSC_Commit(struct MIR_SPSC *ring, size_t n);
+
+/**
+ * \brief Consumer: returns up to `n` published elements as spans to be read
+ * in place. Their slots are not released until \ref MIR_SPSC_Release.
+ *
+ * \return number of returned elements
+ */
+extern size_t
+MIR_SPSC_Peek(struct MIR_SPSC *ring, size_t n, struct MIR_SPSC_Spans *spans);
+
+/**
+ * \brief Consumer: releases `n` elements returned by the last \ref
+ * MIR_SPSC_Peek.
+ */
+extern void MIR_SPSC_Release(struct MIR_SPSC *ring, size_t n);
+
+
+/* ----------------------------- Record mode ------------------------------- */
+
+/**
+ * \brief Producer: allocates space for a record of `len` bytes.
+ *
+ * \details The record is not visible to the consumer until \ref
+ * MIR_SPSC_Publish. The record is contiguous and aligned to `sizeof(size_t)`.
+ * It takes a `size_t` header plus `len` rounded up to `sizeof(size_t)` bytes,
+ * which **MUST NOT** exceed a half of the capacity.
+ *
+ * \return pointer to the payload or `NULL` if there is not enough free space
+ * (or the record is too large)
+ */
+extern void *MIR_SPSC_BeginRecord(struct MIR_SPSC *ring, size_t len);
+
+/**
+ * \brief Producer: publishes all records begun since the last call.
+ */
+extern void MIR_SPSC_Publish(struct MIR_SPSC *ring);
+
+/**
+ * \brief Consumer: returns the next published record.
+ *
+ * \details The record stays valid until \ref MIR_SPSC_Consume.
+ *
+ * \param[in,out] ring pointer to \ref MIR_SPSC struct
+ * \param[out]    len  pointer where the record length will be written
+ *
+ * \return pointer to the payload or `NULL` if there are no more published
+ * records
+ */
+extern const void *MIR_SPSC_NextRecord(struct MIR_SPSC *ring, size_t *len);
+
+/**
+ * \brief Consumer: releases the space of all records returned since the last
+ * call.
+ */
+extern void MIR_SPSC_Consume(struct MIR_SPSC *ring);
+
+/**
+ * \brief Producer: copies the record into the ring and publishes it (along
+ * with all begun records).
+ *
+ * \return \ref MIR_SPSC_OK on success; `1` if there is not enough free space
+ */
+extern int
+MIR_SPSC_TryPushRecord(struct MIR_SPSC *ring, const void *data, size_t len);
+
+/**
+ * \brief Consumer: copies the next record out of the ring and releases it
+ * (along with all records returned by \ref MIR_SPSC_NextRecord).
+ *
+ * \param[in,out] ring   pointer to \ref MIR_SPSC struct
+ * \param[out]    out    buffer for the payload
+ * \param         outCap size of the buffer
+ * \param[out]    len    pointer where the record length will be written
+ *
+ * \return \ref MIR_SPSC_OK on success; `1` if the ring is empty; `2` if the
+ * buffer is too small (`*len` is set and the record is left in the ring)
+ */
+extern int MIR_SPSC_TryPopRecord(
+    struct MIR_SPSC *ring, void *out, size_t outCap, size_t *len
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_SPSC_InitByMallocF but uses `malloc`.
+ */
+#    define MIR_SPSC_Init(ring, capacity, elemSize)                            \
+        MIR_SPSC_InitByMallocF(malloc, (ring), (capacity), (elemSize))
+
+/**
+ * \brief The same as \ref MIR_SPSC_DeinitByFreeF but uses `free`.
+ */
+#    define MIR_SPSC_Deinit(ring) MIR_SPSC_DeinitByFreeF(free, (ring))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_CONCURRENT_SPSC_H */
@@ -0,0 +1,229 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_ThreadPool - work-stealing thread pool for data-parallel
+ * loops
+ *
+ * \details Every worker owns a bounded Chase-Lev deque of index ranges. \ref
+ * MIR_ThreadPool_ParallelFor splits the range in halves, pushes the upper
+ * halves to the deque of the calling thread and keeps splitting the lower one
+ * until it's at most `grain` indices long, then runs it. Idle workers pop
+ * ranges from their own deque (LIFO, cache-friendly) and steal them from the
+ * top of other deques (FIFO, the biggest ranges first). The calling thread
+ * helps until the whole range is done, so nested parallel loops (called from
+ * the loop body) are fine.
+ *
+ * Memory is bounded: each deque holds at most \ref MIR_THREADPOOL_DEQUE_CAP
+ * ranges, and a range that doesn't fit is run by the thread that split it.
+ * Workers that find no work for a while sleep on a condition variable and are
+ * woken when ranges are pushed.
+ *
+ * Calls from threads that are not workers of the pool are serialized.
+ *
+ * \ref MIR_PARALLEL_FOR runs a loop over a \ref MIR_Arr or a \ref MIR_Vec on
+ * the default pool (see \ref MIR_ThreadPool_SetDefault), or serially if
+ * there's no default pool or no POSIX threads (see \ref MIR_HAS_PTHREADS).
+ */
+
+#ifndef _MIR_COMMON_CONCURRENT_THREADPOOL_H
+#define _MIR_COMMON_CONCURRENT_THREADPOOL_H
+
+
+#include <stddef.h> /* size_t */
+
+#include <mir/common/env.h> /* MIR_HAS_PTHREADS */
+#include <mir/common/mem.h> /* MIR_AlignedFree, MIR_CacheAlignedRealloc */
+
+
+#ifdef MIR_HAS_PTHREADS
+
+/**
+ * \brief Capacity of a worker deque (in ranges). **MUST** be a power of two.
+ *
+ * \details It's used only when building the library, so it **MUST** be
+ * redefined at the library build time to take effect. Each worker takes about
+ * `3 * sizeof(size_t)` bytes per range.
+ */
+#    ifndef MIR_THREADPOOL_DEQUE_CAP
+#        define MIR_THREADPOOL_DEQUE_CAP 256u
+#    endif
+
+/**
+ * \brief Work-stealing thread pool.
+ *
+ * \warning Members **MUST NOT** be accessed directly.
+ */
+struct MIR_ThreadPool {
+    /**
+     * \brief Workers, synchronization and the deque of the non-worker
+     * threads. Opaque.
+     */
+    struct __MIR_ThreadPool_State *state;
+
+    size_t nthreads;
+};
+
+/**
+ * \brief Per-worker counters.
+ *
+ * \details They are updated with relaxed atomics and are meant for profiling
+ * only.
+ */
+struct MIR_ThreadPool_Stats {
+    /**
+     * \brief Ranges run by the worker.
+     */
+    size_t tasks;
+
+    /**
+     * \brief Ranges stolen from other deques.
+     */
+    size_t steals;
+
+    /**
+     * \brief Steal attempts that lost a race with the owner or another thief.
+     */
+    size_t failedSteals;
+
+    /**
+     * \brief Scans of all deques that found no work.
+     */
+    size_t idle;
+
+    /**
+     * \brief Times the worker went to sleep.
+     */
+    size_t parks;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref
+ * MIR_ThreadPool struct.
+ */
+#    define MIR_ThreadPool_OK 0
+
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+/**
+ * \brief Starts the workers. Memory is allocated by provided realloc-like
+ * function.
+ *
+ * \param[in]  reallocF realloc-like function. It **SHOULD** return
+ *                      cache-line-aligned blocks (e.g. \ref
+ *                      MIR_CacheAlignedRealloc)
+ * \param[in]  freeF    free-like function (used on failure)
+ * \param[out] pool     pointer to \ref MIR_ThreadPool struct
+ * \param      nthreads number of workers, or `0` for the number of online
+ *                      CPUs
+ *
+ * \return \ref MIR_ThreadPool_OK on success; `1` on failure
+ */
+extern int MIR_ThreadPool_InitByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_ThreadPool *pool, size_t nthreads
+);
+
+/**
+ * \brief Stops and joins the workers and frees the memory by using provided
+ * free-like function.
+ *
+ * \warning No loop may be running on the pool. If the pool is the default one,
+ * it **MUST** be unset first.
+ */
+extern void MIR_ThreadPool_DeinitByFreeF(
+    void (*freeF)(void *), struct MIR_ThreadPool *pool
+);
+
+/**
+ * \brief Calls `fn(ctx, b, e)` for disjoint subranges `[b, e)` covering
+ * `[begin, end)`, in parallel, and returns when all of them are done.
+ *
+ * \param[in] pool  pointer to \ref MIR_ThreadPool struct or `NULL` to run
+ *                  serially
+ * \param     begin first index
+ * \param     end   one past the last index
+ * \param     grain maximal subrange length worth splitting no further. `0` is
+ *                  treated as `1`
+ * \param[in] fn    loop body. It **MAY** call this function recursively
+ * \param     ctx   argument for `fn`
+ */
+extern void MIR_ThreadPool_ParallelFor(
+    struct MIR_ThreadPool *pool, size_t begin, size_t end, size_t grain,
+    void (*fn)(void *ctx, size_t begin, size_t end), void *ctx
+);
+
+/**
+ * \brief Reads the counters of the worker `index`.
+ *
+ * \details Index `pool->nthreads` denotes the non-worker threads that called
+ * \ref MIR_ThreadPool_ParallelFor.
+ */
+extern void MIR_ThreadPool_GetStats(
+    const struct MIR_ThreadPool *pool, size_t index,
+    struct MIR_ThreadPool_Stats *stats
+);
+
+/**
+ * \brief Sets the pool used by \ref MIR_PARALLEL_FOR. **MAY** be `NULL`.
+ */
+extern void MIR_ThreadPool_SetDefault(struct MIR_ThreadPool *pool);
+
+/**
+ * \brief Returns the pool used by \ref MIR_PARALLEL_FOR or `NULL`.
+ */
+extern struct MIR_ThreadPool *MIR_ThreadPool_GetDefault(void);
+
+#    ifdef __cplusplus
+}
+#    endif
+
+
+/**
+ * \brief Calls `fn(ctx, b, e)` for disjoint subranges `[b, e)` of `[0,
+ * (arr)->len)` on the default pool.
+ *
+ * \param[in] arr   pointer to \ref MIR_Arr or \ref MIR_Vec struct. `fn`
+ *                  **SHOULD** reach it through `ctx`
+ * \param     grain see \ref MIR_ThreadPool_ParallelFor
+ * \param[in] fn    loop body
+ * \param     ctx   argument for `fn`
+ */
+#    define MIR_PARALLEL_FOR(arr, grain, fn, ctx)                              \
+        MIR_ThreadPool_ParallelFor(                                            \
+            MIR_ThreadPool_GetDefault(), 0, (arr)->len, (grain), (fn), (ctx)   \
+        )
+
+
+#    ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_ThreadPool_InitByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc.
+ */
+#        define MIR_ThreadPool_Init(pool, nthreads)                            \
+            MIR_ThreadPool_InitByReallocF(                                     \
+                MIR_CacheAlignedRealloc, MIR_AlignedFree, (pool), (nthreads)   \
+            )
+
+/**
+ * \brief The same as \ref MIR_ThreadPool_DeinitByFreeF but uses \ref
+ * MIR_AlignedFree.
+ */
+#        define MIR_ThreadPool_Deinit(pool)                                    \
+            MIR_ThreadPool_DeinitByFreeF(MIR_AlignedFree, (pool))
+
+#    endif /* MIR_NO_STD_ALLOCATOR */
+
+#else /* MIR_HAS_PTHREADS */
+
+#    define MIR_PARALLEL_FOR(arr, grain, fn, ctx)                              \
+        ((void)(grain),                                                        \
+         ((arr)->len != 0u) ? (fn)((ctx), 0, (arr)->len) : (void)0)
+
+#endif /* MIR_HAS_PTHREADS */
+
+
+#endif /* _MIR_COMMON_CONCURRENT_THREADPOOL_H */
@@ -8,6 +8,8 @@
 #ifndef _MIR_COMMON_ENCODINGS_UTF8_H_
 #define _MIR_COMMON_ENCODINGS_UTF8_H_
 
+#include <stddef.h> /* size_t */
+
 #include <mir/common/unicode.h>
 
 
@@ -213,6 +215,20 @@ MIR_UTF8_BufIter_PeekNext(struct MIR_UTF8_BufIter *iter, MIR_UCP *cp);
  */
 extern int MIR_UTF8_BufIter_SkipBOM(struct MIR_UTF8_BufIter *iter);
 
+/**
+ * \brief Checks whether the buffer is a well-formed UTF-8 code unit sequence.
+ *
+ * \details A buffer is well-formed iff \ref MIR_UTF8_BufIter_Next would never
+ * return \c 1 while iterating over it (see it for the list of errors). Runs of
+ * ASCII bytes are skipped a word at a time.
+ *
+ * \param buf pointer to the buffer. **MAY** be \c NULL if \a len is \c 0
+ * \param len buffer length in bytes
+ *
+ * \return \c 1 if the buffer is well-formed, \c 0 otherwise
+ */
+extern int MIR_UTF8_IsValid(const unsigned char *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,14 @@
  * compiler
  * + \ref MIR_COMPILER_TCC "MIR_COMPILER_TCC" - for [Tiny C
  * Compiler](https://en.wikipedia.org/wiki/Tiny_C_Compiler)
+ *
+ * Also it detects the available concurrency primitives:
+ * + \ref MIR_HAS_C11_ATOMICS "MIR_HAS_C11_ATOMICS" - C11 `<stdatomic.h>`
+ * + \ref MIR_HAS_GNU_ATOMICS "MIR_HAS_GNU_ATOMICS" - GCC/Clang `__atomic`
+ * builtins
+ * + \ref MIR_THREAD_LOCAL "MIR_THREAD_LOCAL" - thread-local storage class
+ * specifier
+ * + \ref MIR_HAS_PTHREADS "MIR_HAS_PTHREADS" - POSIX threads
  */
 
 #if !defined(MIR_COMPILER_MSVC) && !defined(MIR_COMPILER_GCC) && !defined(MIR_COMPILER_CLANG) &&   \
@@ -71,4 +79,59 @@
 
 #endif
 
+
+#if !defined(MIR_HAS_C11_ATOMICS) && defined(__STDC_VERSION__) &&              \
+    __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+/**
+ * \def MIR_HAS_C11_ATOMICS
+ *
+ * \brief C11 atomics (`<stdatomic.h>`) are available.
+ */
+#    define MIR_HAS_C11_ATOMICS 1
+#endif
+
+#if !defined(MIR_HAS_GNU_ATOMICS) && defined(__ATOMIC_RELAXED)
+/**
+ * \def MIR_HAS_GNU_ATOMICS
+ *
+ * \brief GCC/Clang `__atomic` builtins are available (GCC 4.7+, Clang 3.1+).
+ *
+ * \sa [Built-in Functions for Memory Model Aware Atomic
+ * Operations](https://gcc.gnu.org/onlinedocs/gcc/_005f_005fatomic-Builtins.html)
+ */
+#    define MIR_HAS_GNU_ATOMICS 1
+#endif
+
+#ifndef MIR_THREAD_LOCAL
+#    if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L &&             \
+        !defined(__STDC_NO_THREADS__)
+/**
+ * \def MIR_THREAD_LOCAL
+ *
+ * \brief Thread-local storage class specifier.
+ *
+ * \details It's not defined if thread-local storage is not supported.
+ */
+#        define MIR_THREAD_LOCAL _Thread_local
+#    elif defined(MIR_COMPILER_GCC) || defined(MIR_COMPILER_CLANG)
+#        define MIR_THREAD_LOCAL __thread
+#    elif defined(MIR_COMPILER_MSVC)
+#        define MIR_THREAD_LOCAL __declspec(thread)
+#    endif
+#endif
+
+#if !defined(MIR_HAS_PTHREADS) && !defined(MIR_NO_PTHREADS) &&                 \
+    (defined(__unix__) || (defined(__APPLE__) && defined(__MACH__)))
+/**
+ * \def MIR_HAS_PTHREADS
+ *
+ * \brief POSIX threads are available.
+ *
+ * \details It's assumed on Unix-like systems unless `MIR_NO_PTHREADS` is
+ * defined. Code that depends on it (e.g. \ref MIR_ThreadPool) requires
+ * linking with the threads library.
+ */
+#    define MIR_HAS_PTHREADS 1
+#endif
+
 #endif /* _MIR_COMMON_ENV_H */
@@ -0,0 +1,193 @@
+/**
+ * \file
+ *
+ * \brief Fast non-cryptographic hashing
+ *
+ * \details
+ * + \ref MIR_Hash_Bytes - 64-bit hash of a byte buffer (wyhash-style: 48-byte
+ *   blocks in three independent lanes folded with 64x64->128 bit multiplies)
+ * + \ref MIR_Hash_UTF8BufIter - the same for the rest of a UTF-8 buffer
+ * + \ref MIR_Hash_U64, \ref MIR_Hash_UCP, \ref MIR_Hash_Size - one-multiply
+ *   integer mixers for hash table keys
+ *
+ * All functions take an explicit seed. \ref MIR_Hash_Seed returns a random
+ * per-process seed which **SHOULD** be used for tables whose keys may be
+ * controlled by an attacker (hash-flooding resistance): the seed is mixed
+ * into both operands of every multiplication, so inputs that zero an operand
+ * (and thus collide) differ from seed to seed. Fixed seeds give reproducible
+ * results on any platform, e.g. for seed `0`:
+ *
+ * | Input                          | \ref MIR_Hash_Bytes        |
+ * |--------------------------------|----------------------------|
+ * | `""`                           | `0xa6dc601bc3257c4b`       |
+ * | `"a"`                          | `0x8c83531b1eda0096`       |
+ * | `"abc"`                        | `0x77af92db2746f1ae`       |
+ * | `"message digest"`             | `0xda5621b998be86b2`       |
+ * | `"abcdefghijklmnopqrstuvwxyz"` | `0x5e08f8efd5913e34`       |
+ *
+ * | Input                          | \ref MIR_Hash_U64          |
+ * |--------------------------------|----------------------------|
+ * | `0`                            | `0xca813bf4c7abf0a9`       |
+ * | `1`                            | `0x0193556b07301504`       |
+ *
+ * \warning None of the functions is suitable for cryptographic purposes.
+ */
+
+#ifndef _MIR_COMMON_HASH_H
+#define _MIR_COMMON_HASH_H
+
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint64_t */
+#if defined(_MSC_VER) && defined(_M_X64)
+#    include <intrin.h> /* _umul128 */
+#endif
+
+#include <mir/common/encodings/utf8.h> /* MIR_UTF8_BufIter */
+#include <mir/common/macros.h>         /* MIR_INLINE */
+#include <mir/common/unicode.h>        /* MIR_UCP */
+
+
+/* NOTE: the secrets are odd, have 32 set bits and no long runs of equal bits */
+#define __MIR_HASH_SECRET0 0x2d358dccaa6c78a5ull
+#define __MIR_HASH_SECRET1 0x8bb84b93962eacc9ull
+#define __MIR_HASH_SECRET2 0x4b33a62ed433d4a3ull
+#define __MIR_HASH_SECRET3 0x4d5a2da51de1aa47ull
+
+
+/**
+ * \brief Multiplies two 64-bit numbers and folds the 128-bit product (`high ^
+ * low`).
+ */
+MIR_INLINE uint64_t __MIR_Hash_Mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 U128;
+    U128 r = (U128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t hi;
+    uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#else
+    uint64_t ha = a >> 32, hb = b >> 32;
+    uint64_t la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+
+/**
+ * \brief Mixes a 64-bit integer.
+ *
+ * \details All bits of the result depend on all bits of \a x; the mapping is
+ * not guaranteed to be a bijection.
+ *
+ * \param x    integer to hash
+ * \param seed seed (see \ref MIR_Hash_Seed)
+ *
+ * \return hash
+ */
+MIR_INLINE uint64_t MIR_Hash_U64(uint64_t x, uint64_t seed) {
+    /* NOTE: `x' and the seed are in both multiplicands, so the value of `x'
+     *       zeroing the product is different for every seed */
+    return __MIR_Hash_Mum(
+        x ^ seed ^ __MIR_HASH_SECRET0, x ^ seed ^ __MIR_HASH_SECRET1
+    );
+}
+
+/**
+ * \brief Mixes a code point. See \ref MIR_Hash_U64.
+ */
+MIR_INLINE uint64_t MIR_Hash_UCP(MIR_UCP cp, uint64_t seed) {
+    return MIR_Hash_U64((uint64_t)cp, seed);
+}
+
+/**
+ * \brief Mixes a `size_t` integer. See \ref MIR_Hash_U64.
+ *
+ * \details The result is truncated to `size_t`. The `HASH` of \ref
+ * MIR_HashMap_DEFINE takes a pointer to the key, so a table keyed by `size_t`
+ * needs a wrapper that supplies the seed:
+ *
+ * \code{.c}
+ * #define SIZE_HASH(key) MIR_Hash_Size(*(key), tableSeed)
+ * #define SIZE_EQ(a, b) (*(a) == *(b))
+ *
+ * MIR_HashMap(size_t, int, Counts);
+ * MIR_HashMap_DEFINE(size_t, int, Counts, SIZE_HASH, SIZE_EQ)
+ * \endcode
+ */
+MIR_INLINE size_t MIR_Hash_Size(size_t x, uint64_t seed) {
+    return (size_t)MIR_Hash_U64((uint64_t)x, seed);
+}
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Hashes a byte buffer.
+ *
+ * \details The result does not depend on the alignment of \a data nor on the
+ * endianness of the platform.
+ *
+ * \param data pointer to the buffer. **MAY** be `NULL` if \a len is `0`
+ * \param len  buffer length in bytes
+ * \param seed seed (see \ref MIR_Hash_Seed)
+ *
+ * \return hash
+ */
+extern uint64_t MIR_Hash_Bytes(const void *data, size_t len, uint64_t seed);
+
+/**
+ * \brief Hashes the not yet consumed part (from `cur` to `lim`) of the buffer
+ * of the iterator.
+ *
+ * \details The bytes are hashed as is (no decoding/normalization is done), so
+ * the result is equal to that of \ref MIR_Hash_Bytes for the same bytes. The
+ * iterator is not modified.
+ *
+ * \param iter pointer to the iterator. `iter->cur` **MAY** be `NULL` if the
+ *             buffer is empty
+ * \param seed seed (see \ref MIR_Hash_Seed)
+ *
+ * \return hash
+ */
+extern uint64_t
+MIR_Hash_UTF8BufIter(const struct MIR_UTF8_BufIter *iter, uint64_t seed);
+
+/**
+ * \brief Returns the per-process seed.
+ *
+ * \details The seed is generated on the first call (from the kernel-provided
+ * random bytes if available, otherwise from time, clock and addresses of
+ * objects randomized by ASLR) and is the same for all threads. Calls after the
+ * first one are a single atomic load.
+ *
+ * \return seed
+ */
+extern uint64_t MIR_Hash_Seed(void);
+
+/**
+ * \brief Overrides the per-process seed.
+ *
+ * \details Intended for reproducible runs. It **MUST** be called before any
+ * table using \ref MIR_Hash_Seed is filled. If \a seed is `0`, a new random
+ * seed will be generated by the next \ref MIR_Hash_Seed call.
+ *
+ * \param seed new seed
+ */
+extern void MIR_Hash_SetSeed(uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* _MIR_COMMON_HASH_H */
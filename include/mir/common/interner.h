@@ -0,0 +1,216 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Interner utilities
+ */
+
+#ifndef _MIR_COMMON_INTERNER_H
+#define _MIR_COMMON_INTERNER_H
+
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint32_t, uint64_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/collections/vec.h> /* MIR_Vec */
+#include <mir/common/macros.h>          /* MIR_INLINE */
+#include <mir/internal/assert.h>        /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Slot of the \ref MIR_Interner index.
+ */
+struct MIR_Interner_Slot {
+    /**
+     * \brief ID plus one. `0` marks an empty slot.
+     */
+    uint32_t id;
+
+    /**
+     * \brief The low 32 bits of the hash of the string.
+     *
+     * \details Cached to reject most mismatches without touching the arena
+     * and to grow the index without rehashing the strings.
+     */
+    uint32_t hash;
+};
+
+MIR_Vec(char, MIR_Interner_Bytes);
+MIR_Vec(size_t, MIR_Interner_Offsets);
+
+/**
+ * \brief String interning table. Maps byte strings to dense 32-bit IDs.
+ *
+ * \details IDs are assigned in the order of the first interning, starting with
+ * `0`. Two strings are equal iff their IDs are equal.
+ *
+ * All bytes live in one arena (`bytes`); every string is followed by `'\0'`,
+ * so \ref MIR_Interner_Data of a string without embedded `'\0'` is a valid C
+ * string. `offsets[id]` is the offset of the string in the arena. The index is
+ * an open-addressing (linear probing) table of \ref MIR_Interner_Slot with a
+ * power-of-two number of slots and the maximum load factor of `1/2`.
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_Interner_Init, \ref MIR_Interner_DeinitByFreeF
+ * + \ref MIR_Interner_InternByReallocF - ID of the string (interns it if
+ *   needed)
+ * + \ref MIR_Interner_Find - ID of the string if it's interned
+ * + \ref MIR_Interner_Count, \ref MIR_Interner_Data, \ref MIR_Interner_Len -
+ *   `O(1)` ID-to-span lookup
+ * + \ref MIR_Interner_ReserveByReallocF
+ */
+struct MIR_Interner {
+    struct MIR_Interner_Bytes bytes;
+    struct MIR_Interner_Offsets offsets;
+    struct MIR_Interner_Slot *index;
+    size_t indexCap;
+    uint64_t seed;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Interner
+ * struct.
+ */
+#define MIR_Interner_OK 0
+
+
+/**
+ * \brief Returns the number of interned strings.
+ */
+MIR_INLINE size_t MIR_Interner_Count(const struct MIR_Interner *in) {
+    return in->offsets.len;
+}
+
+/**
+ * \brief Returns the pointer to the bytes of the string.
+ *
+ * \warning The pointer is invalidated by interning a new string.
+ *
+ * \param in pointer to \ref MIR_Interner struct
+ * \param id ID. **MUST** be less than \ref MIR_Interner_Count
+ */
+MIR_INLINE const char *
+MIR_Interner_Data(const struct MIR_Interner *in, uint32_t id) {
+    __MIR_ASSERT_MSG(id < in->offsets.len, "param `id' is out of bounds");
+    return in->bytes.data + in->offsets.data[id];
+}
+
+/**
+ * \brief Returns the length of the string in bytes (without `'\0'`).
+ *
+ * \param in pointer to \ref MIR_Interner struct
+ * \param id ID. **MUST** be less than \ref MIR_Interner_Count
+ */
+MIR_INLINE size_t MIR_Interner_Len(const struct MIR_Interner *in, uint32_t id) {
+    __MIR_ASSERT_MSG(id < in->offsets.len, "param `id' is out of bounds");
+    return ((id + 1u < in->offsets.len) ? in->offsets.data[id + 1u]
+                                        : in->bytes.len) -
+           in->offsets.data[id] - 1u;
+}
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Inits an empty interner without allocating.
+ *
+ * \details The index is seeded with \ref MIR_Hash_Seed. IDs don't depend on
+ * the seed.
+ *
+ * \param[out] in pointer to \ref MIR_Interner struct
+ */
+extern void MIR_Interner_Init(struct MIR_Interner *in);
+
+/**
+ * \brief Returns the ID of the string, interning it first if needed.
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in]     freeF    free-like function (frees the old index on growth)
+ * \param[in,out] in       pointer to \ref MIR_Interner struct
+ * \param[in]     data     bytes of the string. **MAY** be `NULL` if `len` is
+ *                         `0`. **MUST NOT** point into the arena
+ * \param         len      length of the string in bytes
+ * \param[out]    id       pointer where the ID will be written
+ *
+ * \return \ref MIR_Interner_OK on success; `1` on failure (including running
+ * out of 32-bit IDs)
+ */
+extern int MIR_Interner_InternByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, const void *data, size_t len, uint32_t *id
+);
+
+/**
+ * \brief Looks up the string without interning it.
+ *
+ * \param[in]  in   pointer to \ref MIR_Interner struct
+ * \param[in]  data bytes of the string. **MAY** be `NULL` if `len` is `0`
+ * \param      len  length of the string in bytes
+ * \param[out] id   pointer where the ID will be written (if found)
+ *
+ * \return \ref MIR_Interner_OK if found; `1` otherwise
+ */
+extern int MIR_Interner_Find(
+    const struct MIR_Interner *in, const void *data, size_t len, uint32_t *id
+);
+
+/**
+ * \brief Makes room for `count` strings of `bytes` bytes in total, so that
+ * interning them won't reallocate.
+ *
+ * \return \ref MIR_Interner_OK on success; `1` on failure
+ */
+extern int MIR_Interner_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, size_t count, size_t bytes
+);
+
+/**
+ * \brief Frees all memory. All IDs become invalid.
+ *
+ * \param[in]     freeF free-like function
+ * \param[in,out] in    pointer to \ref MIR_Interner struct
+ */
+extern void
+MIR_Interner_DeinitByFreeF(void (*freeF)(void *), struct MIR_Interner *in);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Interner_InternByReallocF but uses `realloc`
+ * and `free`.
+ */
+#    define MIR_Interner_Intern(in, data, len, id)                             \
+        MIR_Interner_InternByReallocF(realloc, free, (in), (data), (len), (id))
+
+/**
+ * \brief The same as \ref MIR_Interner_ReserveByReallocF but uses `realloc`
+ * and `free`.
+ */
+#    define MIR_Interner_Reserve(in, count, bytes)                             \
+        MIR_Interner_ReserveByReallocF(realloc, free, (in), (count), (bytes))
+
+/**
+ * \brief The same as \ref MIR_Interner_DeinitByFreeF but uses `free`.
+ */
+#    define MIR_Interner_Deinit(in) MIR_Interner_DeinitByFreeF(free, (in))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_INTERNER_H */
@@ -73,6 +73,106 @@
 #define MIR_FOREACH(arr, len, i, elem) MIR_FOREACH_RANGE (arr, 0, len, i, elem)
 
 
+/**
+ * \def MIR_INLINE
+ *
+ * \brief Storage class and function specifiers for functions defined in
+ * headers.
+ *
+ * \details It's `static inline` since C99 (or the compiler-specific
+ * equivalent), and just `static` otherwise.
+ */
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 199901L
+#    define MIR_INLINE static inline
+#elif defined(__clang__) || defined(__GNUC__)
+#    define MIR_INLINE static __inline__
+#elif defined(_MSC_VER)
+#    define MIR_INLINE static __inline
+#else
+#    define MIR_INLINE static
+#endif
+
+/**
+ * \def MIR_LIKELY
+ *
+ * \brief Hints the compiler that the condition \a x is likely to be true.
+ *
+ * \return `0` or `1`
+ */
+/**
+ * \def MIR_UNLIKELY
+ *
+ * \brief Hints the compiler that the condition \a x is likely to be false.
+ *
+ * \return `0` or `1`
+ */
+#if defined(__clang__) || defined(__GNUC__)
+#    define MIR_LIKELY(x) __builtin_expect(!!(x), 1)
+#    define MIR_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#    define MIR_LIKELY(x) (!!(x))
+#    define MIR_UNLIKELY(x) (!!(x))
+#endif
+
+
+/**
+ * \def MIR_PREFETCH
+ *
+ * \brief Hints the processor to fetch the cache line at \a addr for reading.
+ *
+ * \details The instruction itself never faults, but forming a pointer
+ * outside of an array is already undefined behavior, so \a addr **MUST**
+ * point into the array (or one past its end) or be `NULL`. Clamp the index
+ * instead of prefetching past the end.
+ */
+/**
+ * \def MIR_PREFETCH_W
+ *
+ * \brief The same as \ref MIR_PREFETCH but for writing.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+#    define MIR_PREFETCH(addr) __builtin_prefetch((addr), 0)
+#    define MIR_PREFETCH_W(addr) __builtin_prefetch((addr), 1)
+#else
+#    define MIR_PREFETCH(addr) ((void)(addr))
+#    define MIR_PREFETCH_W(addr) ((void)(addr))
+#endif
+
+
+/**
+ * \def MIR_NOINLINE
+ *
+ * \brief Function specifier that keeps the function out of its callers.
+ */
+/**
+ * \def MIR_COLD
+ *
+ * \brief Function specifier that marks the function as rarely called, so
+ * that it's optimized for size and placed away from the hot code.
+ *
+ * \details Branches leading to calls of it are treated as unlikely.
+ */
+/**
+ * \def MIR_MAYBE_UNUSED
+ *
+ * \brief Function specifier that silences warnings about an unused `static`
+ * function (e.g. one emitted by a generator macro in a header).
+ */
+#if defined(__clang__) || defined(__GNUC__)
+#    define MIR_NOINLINE __attribute__((noinline))
+#    define MIR_COLD __attribute__((cold))
+#    define MIR_MAYBE_UNUSED __attribute__((unused))
+#elif defined(_MSC_VER)
+#    define MIR_NOINLINE __declspec(noinline)
+#    define MIR_COLD
+#    define MIR_MAYBE_UNUSED
+#else
+#    define MIR_NOINLINE
+#    define MIR_COLD
+#    define MIR_MAYBE_UNUSED
+#endif
+
+
 #if defined __STDC_VERSION__ && __STDC_VERSION__ < 199901L
 
 /* NOTE: tcc (`__TINYC__') only supports C99 and C11 standards, where `restrict'
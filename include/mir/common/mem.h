@@ -20,4 +20,211 @@
 void *MIR_FailRealloc(void *__ptr, size_t __newSize);
 
 
+/**
+ * \brief Assumed size of a cache line in bytes.
+ */
+#define MIR_CACHE_LINE_SIZE 64u
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief Allocates a block aligned to `alignment` by using standard library
+ * `malloc` function.
+ *
+ * \details Has the same signature as C11 `aligned_alloc`, but does not require
+ * `size` to be a multiple of `alignment`.
+ *
+ * \warning Blocks returned by this function **MUST** be freed by \ref
+ * MIR_AlignedFree.
+ *
+ * \note This function is available only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ *
+ * \param alignment alignment in bytes. **MUST** be a power of two
+ * \param size      size in bytes. **MUST** be greater than `0`
+ *
+ * \return pointer to the block or \c NULL on failure
+ */
+void *MIR_AlignedMalloc(size_t alignment, size_t size);
+
+/**
+ * \brief Realloc-like function that keeps the block aligned to `alignment`.
+ *
+ * \details It uses standard library `realloc` function internally. If the
+ * block is moved by `realloc` to an address with a different misalignment, the
+ * data is additionally moved in place.
+ *
+ * \warning Blocks returned by this function **MUST** be freed by \ref
+ * MIR_AlignedFree. `alignment` **MUST** be the same for every call with the
+ * same block.
+ *
+ * \note This function is available only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ *
+ * \param[in] ptr       pointer returned by \ref MIR_AlignedMalloc or by this
+ *                      function or \c NULL
+ * \param     alignment alignment in bytes. **MUST** be a power of two
+ * \param     size      new size in bytes. **MUST** be greater than `0`
+ *
+ * \return pointer to the block or \c NULL on failure (in which case the
+ * original block is left untouched)
+ */
+void *MIR_AlignedRealloc(void *ptr, size_t alignment, size_t size);
+
+/**
+ * \brief Realloc-like function that keeps the block aligned to \ref
+ * MIR_CACHE_LINE_SIZE.
+ *
+ * \details It's \ref MIR_AlignedRealloc with fixed alignment, so it can be
+ * passed to any `...ByReallocF` macro (e.g. \ref MIR_Vec_PushByReallocF) to
+ * keep the vector suitable for SIMD kernels.
+ *
+ * \warning Blocks returned by this function **MUST** be freed by \ref
+ * MIR_AlignedFree.
+ *
+ * \note This function is available only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ */
+void *MIR_CacheAlignedRealloc(void *ptr, size_t size);
+
+/**
+ * \brief Free-like function for blocks returned by \ref MIR_AlignedMalloc,
+ * \ref MIR_AlignedRealloc and \ref MIR_CacheAlignedRealloc.
+ *
+ * \note This function is available only if `MIR_NO_STD_ALLOCATOR` is not
+ * defined.
+ *
+ * \param[in] ptr pointer to the block or \c NULL
+ */
+void MIR_AlignedFree(void *ptr);
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#if defined(__linux__) && !defined(MIR_NO_STD_ALLOCATOR)
+
+/**
+ * \brief Size (in bytes) starting from which \ref MIR_MremapRealloc serves
+ * blocks directly from `mmap`.
+ *
+ * \details It's used only when building the library, so it **MUST** be
+ * redefined at the library build time to take effect.
+ */
+#    ifndef MIR_MREMAP_THRESHOLD
+#        define MIR_MREMAP_THRESHOLD ((size_t)1u << 20)
+#    endif
+
+/**
+ * \brief Realloc-like function that grows large blocks without copying.
+ *
+ * \details Blocks smaller than \ref MIR_MREMAP_THRESHOLD are allocated by the
+ * standard library `malloc`/`realloc` functions. Larger blocks are mapped with
+ * `mmap` and are grown (or shrunk) with `mremap(.., MREMAP_MAYMOVE)`, which
+ * remaps the pages instead of copying them. Once a block has been mapped it
+ * stays mapped. A block is copied at most once - when it crosses the threshold.
+ *
+ * It's intended to be passed to any `...ByReallocF` macro, e.g.:
+ * \code{.c}
+ * MIR_Vec_PushByReallocF(char, MIR_MremapRealloc, &vec, &c);
+ * ...
+ * MIR_Vec_DeinitByFreeF(MIR_MremapFree, &vec);
+ * \endcode
+ *
+ * \warning Blocks returned by this function **MUST** be freed by \ref
+ * MIR_MremapFree and **MUST NOT** be passed to other allocators.
+ *
+ * \note This function is available only on Linux and only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * \param[in] ptr     pointer returned by this function or \c NULL
+ * \param     newSize new size in bytes. **MUST** be greater than `0`
+ *
+ * \return pointer to the (possibly moved) block, or \c NULL on failure (in
+ * which case the original block is left untouched)
+ */
+void *MIR_MremapRealloc(void *ptr, size_t newSize);
+
+/**
+ * \brief Free-like function for blocks returned by \ref MIR_MremapRealloc.
+ *
+ * \param[in] ptr pointer returned by \ref MIR_MremapRealloc or \c NULL
+ */
+void MIR_MremapFree(void *ptr);
+
+
+/**
+ * \brief Size of a huge page in bytes.
+ */
+#    define MIR_HUGE_PAGE_SIZE ((size_t)2u << 20)
+
+/**
+ * \brief Size (in bytes) starting from which \ref MIR_HugePageMalloc serves
+ * blocks from huge pages.
+ *
+ * \details It's used only when building the library, so it **MUST** be
+ * redefined at the library build time to take effect.
+ */
+#    ifndef MIR_HUGE_PAGE_THRESHOLD
+#        define MIR_HUGE_PAGE_THRESHOLD MIR_HUGE_PAGE_SIZE
+#    endif
+
+/**
+ * \brief Malloc-like function that backs large blocks by transparent huge
+ * pages.
+ *
+ * \details Blocks smaller than \ref MIR_HUGE_PAGE_THRESHOLD are allocated by
+ * the standard library `malloc` function. Larger blocks are mapped with `mmap`
+ * at a \ref MIR_HUGE_PAGE_SIZE aligned address and are advised with
+ * `madvise(.., MADV_HUGEPAGE)`. If the kernel does not support transparent
+ * huge pages, the advice is ignored and the block is backed by regular pages.
+ * Large blocks are aligned to \ref MIR_CACHE_LINE_SIZE.
+ *
+ * It's intended to be passed to `...ByMallocF` macros, e.g.:
+ * \code{.c}
+ * MIR_Arr_InitByMallocF(uint64_t, MIR_HugePageMalloc, &table, n);
+ * ...
+ * MIR_Arr_DeinitByFreeF(MIR_HugePageFree, &table);
+ * \endcode
+ *
+ * \warning Blocks returned by this function **MUST** be freed by \ref
+ * MIR_HugePageFree.
+ *
+ * \note This function is available only on Linux and only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * \param size size in bytes. **MUST** be greater than `0`
+ *
+ * \return pointer to the block or \c NULL on failure
+ */
+void *MIR_HugePageMalloc(size_t size);
+
+/**
+ * \brief Realloc-like counterpart of \ref MIR_HugePageMalloc.
+ *
+ * \details Large blocks are grown with `mremap`: in place if the address
+ * space after them is free, otherwise their pages are moved (not copied) to a
+ * new \ref MIR_HUGE_PAGE_SIZE aligned address. The grown block is advised
+ * with `madvise(.., MADV_HUGEPAGE)` again.
+ *
+ * \param[in] ptr     pointer returned by \ref MIR_HugePageMalloc or by this
+ *                    function or \c NULL
+ * \param     newSize new size in bytes. **MUST** be greater than `0`
+ *
+ * \return pointer to the block or \c NULL on failure (in which case the
+ * original block is left untouched)
+ */
+void *MIR_HugePageRealloc(void *ptr, size_t newSize);
+
+/**
+ * \brief Free-like function for blocks returned by \ref MIR_HugePageMalloc
+ * and \ref MIR_HugePageRealloc.
+ *
+ * \param[in] ptr pointer to the block or \c NULL
+ */
+void MIR_HugePageFree(void *ptr);
+
+#endif /* __linux__ && !MIR_NO_STD_ALLOCATOR */
+
+
 #endif /* _MIR_COMMON_MEM_H_ */
@@ -0,0 +1,182 @@
+/**
+ * \file
+ *
+ * \brief Allocation instrumentation
+ *
+ * \details Instrumenting allocators that can be passed to any `...ByMallocF`,
+ * `...ByReallocF` and `...ByFreeF` macro:
+ * + \ref MIR_InstrMalloc - malloc-like function
+ * + \ref MIR_InstrRealloc - realloc-like function
+ * + \ref MIR_InstrFree - free-like function
+ *
+ * They forward the calls to the backend (standard library `realloc` and `free`
+ * functions by default, see \ref MIR_Instr_SetBackend) and count:
+ * + the number of allocations, reallocations, frees and failures
+ * + bytes requested, bytes live and bytes moved by reallocations
+ * + slack - the difference between the usable size reported by the backend
+ *   (only for the default backend with glibc) and the requested size
+ * + size-class histogram (by the position of the highest set bit of the
+ *   requested size)
+ *
+ * Counters are kept per thread (if \ref MIR_THREAD_LOCAL is available) and
+ * are merged on read by \ref MIR_Instr_GetStats.
+ *
+ * ## Compile-time switch
+ *
+ * The instrumentation is compiled in only if `MIR_MEM_INSTR` is defined (see
+ * the `MIR_MEM_INSTR` CMake option). Otherwise, \ref MIR_InstrMalloc, \ref
+ * MIR_InstrRealloc and \ref MIR_InstrFree are defined as the standard library
+ * `malloc`, `realloc` and `free` functions, and \ref MIR_Instr_GetStats
+ * returns zeroed stats, so the instrumented call sites cost nothing.
+ *
+ * ### Example
+ *
+ * \code{.c}
+ * struct MIR_InstrStats stats;
+ *
+ * MIR_Vec_PushByReallocF(int, MIR_InstrRealloc, &vec, &elem);
+ * ...
+ * MIR_Instr_GetStats(&stats);
+ * \endcode
+ */
+
+
+#ifndef _MIR_COMMON_MEMINSTR_H
+#define _MIR_COMMON_MEMINSTR_H
+
+
+#include <stddef.h> /* size_t */
+#if !defined(MIR_MEM_INSTR) && !defined(MIR_NO_STD_ALLOCATOR)
+#    include <stdlib.h> /* free, malloc, realloc */
+#endif
+
+
+/**
+ * \brief Number of size classes in \ref MIR_InstrStats::sizeClasses.
+ */
+#define MIR_INSTR_SIZE_CLASSES 64
+
+
+/**
+ * \brief Allocation stats.
+ */
+struct MIR_InstrStats {
+    /**
+     * \brief Number of successful allocations (including `realloc(NULL, ..)`).
+     */
+    size_t allocs;
+    /**
+     * \brief Number of successful reallocations of non-NULL blocks.
+     */
+    size_t reallocs;
+    /**
+     * \brief Number of frees of non-NULL blocks.
+     */
+    size_t frees;
+    /**
+     * \brief Number of failed allocations and reallocations.
+     */
+    size_t failures;
+    /**
+     * \brief Total number of bytes requested by allocations and
+     * reallocations.
+     */
+    size_t bytesRequested;
+    /**
+     * \brief Number of bytes currently allocated (as requested).
+     */
+    size_t bytesLive;
+    /**
+     * \brief Number of bytes moved by reallocations that changed the address
+     * of the block.
+     */
+    size_t bytesMoved;
+    /**
+     * \brief Total usable size reported by the backend minus total requested
+     * size over all allocations and reallocations.
+     */
+    size_t bytesSlack;
+    /**
+     * \brief Histogram of requested sizes. Element `i` counts requests of size
+     * `[2^(i-1), 2^i)` (element `0` counts zero-sized requests).
+     */
+    size_t sizeClasses[MIR_INSTR_SIZE_CLASSES];
+};
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * \brief Merges the counters of all threads.
+ *
+ * \details The counters are read with relaxed atomics, so the result is
+ * consistent per counter but not necessarily across counters while other
+ * threads keep allocating.
+ *
+ * \param[out] stats pointer where the stats will be written
+ */
+extern void MIR_Instr_GetStats(struct MIR_InstrStats *stats);
+
+#ifdef MIR_MEM_INSTR
+
+extern void *MIR_InstrMalloc(size_t size);
+extern void *MIR_InstrRealloc(void *ptr, size_t size);
+extern void MIR_InstrFree(void *ptr);
+
+/**
+ * \brief Sets the backend of the instrumenting allocators.
+ *
+ * \warning It **MUST** be called before the first instrumented allocation.
+ * Blocks allocated with one backend **MUST NOT** be passed to another one.
+ *
+ * \param[in] reallocF realloc-like function. `reallocF(NULL, size)` is used as
+ *                     malloc
+ * \param[in] freeF    free-like function
+ */
+extern void MIR_Instr_SetBackend(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *)
+);
+
+#endif /* MIR_MEM_INSTR */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#if !defined(MIR_MEM_INSTR) && !defined(MIR_NO_STD_ALLOCATOR)
+/**
+ * \def MIR_InstrMalloc
+ *
+ * \brief Instrumenting malloc-like function.
+ *
+ * \details It's the standard library `malloc` function if `MIR_MEM_INSTR` is
+ * not defined.
+ */
+#    define MIR_InstrMalloc malloc
+/**
+ * \def MIR_InstrRealloc
+ *
+ * \brief Instrumenting realloc-like function.
+ *
+ * \details It's the standard library `realloc` function if `MIR_MEM_INSTR` is
+ * not defined.
+ */
+#    define MIR_InstrRealloc realloc
+/**
+ * \def MIR_InstrFree
+ *
+ * \brief Instrumenting free-like function.
+ *
+ * \details It's the standard library `free` function if `MIR_MEM_INSTR` is
+ * not defined.
+ */
+#    define MIR_InstrFree free
+#endif
+
+
+#endif /* _MIR_COMMON_MEMINSTR_H */
@@ -0,0 +1,236 @@
+/**
+ * \file
+ *
+ * \brief Radix sorting of unsigned integers, keyed records and byte strings
+ *
+ * \details
+ * + \ref MIR_Radix_SortU32ByReallocF, \ref MIR_Radix_SortU64ByReallocF,
+ *   \ref MIR_Radix_SortKeyedByReallocF - stable LSD radix sort with 8-bit
+ *   digits. One pass counts all digits; digits that are the same for every
+ *   key are skipped. The scatter goes through per-bucket write-combining
+ *   buffers of one cache line instead of random element-sized stores: the
+ *   first write of a bucket fills up the line its range starts in, the
+ *   following ones are whole aligned lines if the element size divides the
+ *   line (otherwise they're line-sized but may straddle two lines). Records
+ *   too large for that are scattered directly, with the destinations
+ *   prefetched ahead
+ * + \ref MIR_Radix_SortSpansByReallocF - MSD radix sort of byte strings
+ *   (lexicographic byte order, which for UTF-8 is the code point order). The
+ *   byte at the current depth is read once per string and cached, buckets of
+ *   fewer than \ref MIR_RADIX_SPANS_SMALL strings are insertion-sorted
+ *
+ * If a \ref MIR_ThreadPool is given and the array has at least \ref
+ * MIR_RADIX_PARALLEL_MIN elements, the LSD sorts split it into one chunk per
+ * thread: the chunks are counted and scattered in parallel into disjoint
+ * destination ranges (chunk `c` of bucket `b` goes after the chunks `< c`),
+ * which keeps the sort stable. The MSD sort partitions serially until the
+ * strings are split and then sorts the buckets in parallel.
+ *
+ * Every function allocates a scratch array as large as the input and
+ * returns `1` if it fails, leaving the input untouched.
+ *
+ * \code{.c}
+ * struct Item { uint64_t key; uint32_t payload; };
+ * MIR_Vec(struct Item, Items) items;
+ * ...
+ * MIR_Vec_RadixSortKeyed(struct Item, key, &items, NULL);
+ * \endcode
+ */
+
+#ifndef _MIR_COMMON_RADIX_H
+#define _MIR_COMMON_RADIX_H
+
+
+#include <stddef.h> /* offsetof, size_t */
+#include <stdint.h> /* uint32_t, uint64_t */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+
+/**
+ * \brief Minimal number of elements for a parallel sort.
+ *
+ * \details It's used only when building the library, so it **MUST** be
+ * redefined at the library build time to take effect.
+ */
+#ifndef MIR_RADIX_PARALLEL_MIN
+#    define MIR_RADIX_PARALLEL_MIN 65536u
+#endif
+
+/**
+ * \brief Buckets of at most this many strings are insertion-sorted.
+ *
+ * \details It's used only when building the library, so it **MUST** be
+ * redefined at the library build time to take effect.
+ */
+#ifndef MIR_RADIX_SPANS_SMALL
+#    define MIR_RADIX_SPANS_SMALL 32u
+#endif
+
+/**
+ * \brief A constant indicating a successful sort.
+ */
+#define MIR_Radix_OK 0
+
+
+struct MIR_ThreadPool;
+
+/**
+ * \brief Byte string to be sorted by \ref MIR_Radix_SortSpansByReallocF.
+ */
+struct MIR_Radix_Span {
+    const unsigned char *data;
+    size_t len;
+};
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Sorts 32-bit unsigned integers.
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in]     freeF    free-like function
+ * \param[in,out] data     array of `len` integers
+ * \param         len      number of integers
+ * \param[in]     pool     pointer to \ref MIR_ThreadPool struct or `NULL` to
+ *                         sort in the calling thread
+ *
+ * \return \ref MIR_Radix_OK on success; `1` on failure
+ */
+extern int MIR_Radix_SortU32ByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), uint32_t *data,
+    size_t len, struct MIR_ThreadPool *pool
+);
+
+/**
+ * \brief Sorts 64-bit unsigned integers.
+ *
+ * \see MIR_Radix_SortU32ByReallocF
+ */
+extern int MIR_Radix_SortU64ByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), uint64_t *data,
+    size_t len, struct MIR_ThreadPool *pool
+);
+
+extern int __MIR_Radix_SortKeyed_impl(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), void *data,
+    size_t len, size_t elemSize, size_t keyOffset, size_t keySize,
+    struct MIR_ThreadPool *pool
+);
+
+/**
+ * \brief Stably sorts records of type `type` by their unsigned integer
+ * member `keyField`.
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in]     freeF    free-like function
+ * \param         type     records type
+ * \param         keyField name of the key member. Its size **MUST** be 1, 2,
+ *                         4 or 8 bytes
+ * \param[in,out] data     array of `len` records
+ * \param         len      number of records
+ * \param[in]     pool     see \ref MIR_Radix_SortU32ByReallocF
+ *
+ * \return \ref MIR_Radix_OK on success; `1` on failure
+ */
+#define MIR_Radix_SortKeyedByReallocF(                                         \
+    reallocF, freeF, type, keyField, data, len, pool                           \
+)                                                                              \
+    __MIR_Radix_SortKeyed_impl(                                                \
+        (reallocF), (freeF), (data), (len), sizeof(type),                      \
+        offsetof(type, keyField), sizeof(((type *)0)->keyField), (pool)        \
+    )
+
+/**
+ * \brief Sorts byte strings lexicographically (a proper prefix goes first).
+ *
+ * \details Only the spans are moved, the bytes are not.
+ *
+ * \see MIR_Radix_SortU32ByReallocF
+ */
+extern int MIR_Radix_SortSpansByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Radix_Span *data, size_t len, struct MIR_ThreadPool *pool
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Radix_SortU32ByReallocF but uses standard
+ * library allocator.
+ */
+#    define MIR_Radix_SortU32(data, len, pool)                                 \
+        MIR_Radix_SortU32ByReallocF(realloc, free, (data), (len), (pool))
+
+/**
+ * \brief The same as \ref MIR_Radix_SortU64ByReallocF but uses standard
+ * library allocator.
+ */
+#    define MIR_Radix_SortU64(data, len, pool)                                 \
+        MIR_Radix_SortU64ByReallocF(realloc, free, (data), (len), (pool))
+
+/**
+ * \brief The same as \ref MIR_Radix_SortKeyedByReallocF but uses standard
+ * library allocator.
+ */
+#    define MIR_Radix_SortKeyed(type, keyField, data, len, pool)               \
+        MIR_Radix_SortKeyedByReallocF(                                         \
+            realloc, free, type, keyField, (data), (len), (pool)               \
+        )
+
+/**
+ * \brief The same as \ref MIR_Radix_SortSpansByReallocF but uses standard
+ * library allocator.
+ */
+#    define MIR_Radix_SortSpans(data, len, pool)                               \
+        MIR_Radix_SortSpansByReallocF(realloc, free, (data), (len), (pool))
+
+/**
+ * \brief Radix-sorts an \ref MIR_Arr.
+ *
+ * \param kind `U32`, `U64` or `Spans`
+ * \param arr  pointer to \ref MIR_Arr struct of the corresponding elements
+ * \param pool see \ref MIR_Radix_SortU32ByReallocF
+ *
+ * \return \ref MIR_Radix_OK on success; `1` on failure
+ */
+#    define MIR_Arr_RadixSort(kind, arr, pool)                                 \
+        MIR_Radix_Sort##kind((arr)->data, (arr)->len, (pool))
+
+/**
+ * \brief Radix-sorts an \ref MIR_Arr of records by the member `keyField`.
+ *
+ * \see MIR_Radix_SortKeyedByReallocF
+ */
+#    define MIR_Arr_RadixSortKeyed(type, keyField, arr, pool)                  \
+        MIR_Radix_SortKeyed(type, keyField, (arr)->data, (arr)->len, (pool))
+
+/**
+ * \brief Radix-sorts a \ref MIR_Vec.
+ *
+ * \see MIR_Arr_RadixSort
+ */
+#    define MIR_Vec_RadixSort(kind, vec, pool)                                 \
+        MIR_Radix_Sort##kind((vec)->data, (vec)->len, (pool))
+
+/**
+ * \brief Radix-sorts a \ref MIR_Vec of records by the member `keyField`.
+ *
+ * \see MIR_Radix_SortKeyedByReallocF
+ */
+#    define MIR_Vec_RadixSortKeyed(type, keyField, vec, pool)                  \
+        MIR_Radix_SortKeyed(type, keyField, (vec)->data, (vec)->len, (pool))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_RADIX_H */
@@ -0,0 +1,319 @@
+/**
+ * \file
+ *
+ * \brief Searching sorted arrays and cache-friendly search layouts
+ *
+ * \details
+ * + \ref MIR_SEARCH_DEFINE generates branchless lower/upper bound searches of
+ *   a sorted array and the same searches over the Eytzinger (BFS order)
+ *   layout of it. The comparator is inlined, as in \ref MIR_SORT_DEFINE
+ * + \ref MIR_STree32 - static B+ tree (S+ tree) of `int32_t` keys with SIMD
+ *   node comparison
+ *
+ * A binary search of a sorted array touches a different cache line at almost
+ * every step and its branches are unpredictable. The branchless variant
+ * turns the branch into a conditional move and prefetches both possible next
+ * probes, but the probes are still far apart. The Eytzinger layout stores the
+ * implicit binary search tree level by level (node `k` has children `2k` and
+ * `2k + 1`), so the next several levels of a search lie next to each other
+ * and can be prefetched a few steps ahead. The S+ tree goes further and puts
+ * 16 keys into a cache-line node searched by a handful of SIMD comparisons,
+ * so a search misses the cache once per 17-way level and takes no
+ * data-dependent branches.
+ *
+ * \code{.c}
+ * #define EntryLess(a, b) ((a)->code < (b)->code)
+ * MIR_SEARCH_DEFINE(struct Entry, Entries, EntryLess)
+ *
+ * MIR_Arr(struct Entry, EntryArr) table;
+ * struct Entry key = {.code = 42};
+ * size_t i = MIR_Arr_LowerBound(Entries, &table, &key);
+ * \endcode
+ */
+
+#ifndef _MIR_COMMON_SEARCH_H
+#define _MIR_COMMON_SEARCH_H
+
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* int32_t, uint64_t */
+
+#include <mir/common/bits.h>   /* MIR_Bits_Ctz64 */
+#include <mir/common/macros.h> /* MIR_INLINE, MIR_PREFETCH */
+#include <mir/common/mem.h>    /* MIR_CACHE_LINE_SIZE */
+
+
+/**
+ * \brief Returns the index of the first element of an \ref MIR_Arr not less
+ * than `key` (or its length).
+ *
+ * \param name name passed to \ref MIR_SEARCH_DEFINE
+ * \param arr  pointer to sorted \ref MIR_Arr struct
+ * \param key  pointer to the key
+ */
+#define MIR_Arr_LowerBound(name, arr, key)                                     \
+    name##_LowerBound((arr)->data, (arr)->len, (key))
+
+/**
+ * \brief Returns the index of the first element of an \ref MIR_Arr greater
+ * than `key` (or its length).
+ *
+ * \see MIR_Arr_LowerBound
+ */
+#define MIR_Arr_UpperBound(name, arr, key)                                     \
+    name##_UpperBound((arr)->data, (arr)->len, (key))
+
+/**
+ * \brief The same as \ref MIR_Arr_LowerBound but for \ref MIR_Vec.
+ */
+#define MIR_Vec_LowerBound(name, vec, key)                                     \
+    name##_LowerBound((vec)->data, (vec)->len, (key))
+
+/**
+ * \brief The same as \ref MIR_Arr_UpperBound but for \ref MIR_Vec.
+ */
+#define MIR_Vec_UpperBound(name, vec, key)                                     \
+    name##_UpperBound((vec)->data, (vec)->len, (key))
+
+
+/**
+ * \brief Defines search functions for sorted arrays of `type` ordered by
+ * `LESS`.
+ *
+ * \param type elements type. **MAY** consist of several tokens
+ * \param name prefix of the generated functions
+ * \param LESS macro or function `int LESS(const type *a, const type *b)`,
+ *             see \ref MIR_SORT_DEFINE
+ *
+ * \details Generated functions:
+ * + `size_t name##_LowerBound(const type *data, size_t len, const type *key)`
+ *   - index of the first element not less than `*key`, or `len`
+ * + `size_t name##_UpperBound(const type *data, size_t len, const type *key)`
+ *   - index of the first element greater than `*key`, or `len`
+ * + `void name##_Eytzinger(const type *sorted, size_t len, type *tree)` -
+ *   copies the sorted array into `tree[1..len]` in the Eytzinger order.
+ *   `tree` **MUST** have room for `len + 1` elements, `tree[0]` is unused
+ * + `size_t name##_EytzingerLowerBound(const type *tree, size_t len,
+ *   const type *key)`, `size_t name##_EytzingerUpperBound(...)` - the same
+ *   searches over the result of `name##_Eytzinger`. They return the index in
+ *   `tree` or `0` if there's no such element
+ */
+#define MIR_SEARCH_DEFINE(type, name, LESS)                                    \
+                                                                               \
+    MIR_INLINE size_t name##_LowerBound(                                       \
+        const type *data, size_t len, const type *key                          \
+    ) {                                                                        \
+        const type *base = data;                                               \
+        size_t half;                                                           \
+                                                                               \
+        if (len == 0u) {                                                       \
+            return 0;                                                          \
+        }                                                                      \
+        while (len > 1u) {                                                     \
+            half = len / 2u;                                                   \
+            MIR_PREFETCH(base + half / 2u);                                    \
+            MIR_PREFETCH(base + half + half / 2u);                             \
+            base = (LESS(&base[half], key)) ? base + half : base;              \
+            len -= half;                                                       \
+        }                                                                      \
+        return (size_t)(base - data) + ((LESS(base, key)) != 0);               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE size_t name##_UpperBound(                                       \
+        const type *data, size_t len, const type *key                          \
+    ) {                                                                        \
+        const type *base = data;                                               \
+        size_t half;                                                           \
+                                                                               \
+        if (len == 0u) {                                                       \
+            return 0;                                                          \
+        }                                                                      \
+        while (len > 1u) {                                                     \
+            half = len / 2u;                                                   \
+            MIR_PREFETCH(base + half / 2u);                                    \
+            MIR_PREFETCH(base + half + half / 2u);                             \
+            base = (LESS(key, &base[half])) ? base : base + half;              \
+            len -= half;                                                       \
+        }                                                                      \
+        return (size_t)(base - data) + ((LESS(key, base)) == 0);               \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##_Eytzinger(                                          \
+        const type *sorted, size_t len, type *tree                             \
+    ) {                                                                        \
+        size_t k = 1;                                                          \
+        size_t i;                                                              \
+                                                                               \
+        if (len == 0u) {                                                       \
+            return;                                                            \
+        }                                                                      \
+        /* NOTE: in-order traversal of the implicit tree, starting from the  \
+         *       leftmost node */                                             \
+        while (2u * k <= len) {                                                \
+            k *= 2u;                                                           \
+        }                                                                      \
+        for (i = 0; i < len; ++i) {                                            \
+            tree[k] = sorted[i];                                               \
+            if (2u * k + 1u <= len) {                                          \
+                k = 2u * k + 1u;                                               \
+                while (2u * k <= len) {                                        \
+                    k *= 2u;                                                   \
+                }                                                              \
+            } else {                                                           \
+                while (k & 1u) {                                               \
+                    k >>= 1u;                                                  \
+                }                                                              \
+                k >>= 1u;                                                      \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE size_t name##_EytzingerLowerBound(                              \
+        const type *tree, size_t len, const type *key                          \
+    ) {                                                                        \
+        size_t k = 1;                                                          \
+        size_t lim = len / __MIR_SEARCH_PREFETCH_STRIDE(type);                 \
+                                                                               \
+        while (k <= len) {                                                     \
+            if (k <= lim) {                                                    \
+                MIR_PREFETCH(tree + k * __MIR_SEARCH_PREFETCH_STRIDE(type));   \
+            }                                                                  \
+            k = 2u * k + ((LESS(&tree[k], key)) != 0);                         \
+        }                                                                      \
+        /* NOTE: the answer is where the search last went left */            \
+        return k >> (MIR_Bits_Ctz64(~(uint64_t)k) + 1u);                       \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE size_t name##_EytzingerUpperBound(                              \
+        const type *tree, size_t len, const type *key                          \
+    ) {                                                                        \
+        size_t k = 1;                                                          \
+        size_t lim = len / __MIR_SEARCH_PREFETCH_STRIDE(type);                 \
+                                                                               \
+        while (k <= len) {                                                     \
+            if (k <= lim) {                                                    \
+                MIR_PREFETCH(tree + k * __MIR_SEARCH_PREFETCH_STRIDE(type));   \
+            }                                                                  \
+            k = 2u * k + ((LESS(key, &tree[k])) == 0);                         \
+        }                                                                      \
+        return k >> (MIR_Bits_Ctz64(~(uint64_t)k) + 1u);                       \
+    }
+
+/* NOTE: the descendants of node `k' four levels down start at `16k', so
+ *       prefetching `16k' elements ahead covers them for 4-byte elements (and
+ *       fewer levels for larger ones). It's done only while `16k <= len', so
+ *       the address stays inside the tree and the product can't wrap */
+#define __MIR_SEARCH_PREFETCH_STRIDE(type)                                     \
+    ((sizeof(type) < MIR_CACHE_LINE_SIZE) ? MIR_CACHE_LINE_SIZE / sizeof(type) \
+                                          : 1u)
+
+
+/**
+ * \brief Number of keys in a \ref MIR_STree32 node (one cache line).
+ */
+#define MIR_STREE32_B 16u
+
+/**
+ * \brief Maximal number of layers of a \ref MIR_STree32 (enough for
+ * `UINT32_MAX` keys).
+ */
+#define MIR_STREE32_MAX_HEIGHT 8u
+
+/**
+ * \brief Static B+ tree (S+ tree) of `int32_t` keys.
+ *
+ * \details The tree is stored layer by layer, the root first, in nodes of
+ * \ref MIR_STREE32_B keys. The last layer is the sorted array itself, padded
+ * with `INT32_MAX` to whole nodes, so the position found in it is the answer.
+ * Node `k` of a layer has children `k * (B + 1) ... k * (B + 1) + B` in the
+ * next one, and its key `j` is the smallest key under child `j + 1`
+ * (`INT32_MAX` if there's no such child). A node is searched by comparing the
+ * key with all keys of the node at once (with SSE2 if available) and counting
+ * the smaller ones, which is the index of the child to descend to.
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ */
+struct MIR_STree32 {
+    /**
+     * \brief All layers.
+     */
+    int32_t *keys;
+
+    /**
+     * \brief Offset of every layer in `keys` (in nodes).
+     */
+    size_t layers[MIR_STREE32_MAX_HEIGHT];
+
+    size_t height;
+    size_t len;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_STree32
+ * struct.
+ */
+#define MIR_STree32_OK 0
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Builds the tree from a sorted array by using provided realloc-like
+ * function.
+ *
+ * \param[in]  reallocF realloc-like function. It **SHOULD** return
+ *                      cache-line-aligned blocks (e.g. \ref
+ *                      MIR_CacheAlignedRealloc)
+ * \param[out] tree     pointer to \ref MIR_STree32 struct
+ * \param[in]  sorted   array of `len` keys in non-decreasing order
+ * \param      len      number of keys. **MUST NOT** exceed `UINT32_MAX`
+ *
+ * \return \ref MIR_STree32_OK on success; `1` on failure
+ */
+extern int MIR_STree32_InitByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_STree32 *tree,
+    const int32_t *sorted, size_t len
+);
+
+/**
+ * \brief Frees the memory by using provided free-like function.
+ */
+extern void
+MIR_STree32_DeinitByFreeF(void (*freeF)(void *), struct MIR_STree32 *tree);
+
+/**
+ * \brief Returns the index in the sorted array of the first key not less than
+ * `key`, or the number of keys.
+ */
+extern size_t
+MIR_STree32_LowerBound(const struct MIR_STree32 *tree, int32_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_STree32_InitByReallocF but uses \ref
+ * MIR_CacheAlignedRealloc.
+ */
+#    define MIR_STree32_Init(tree, sorted, len)                                \
+        MIR_STree32_InitByReallocF(                                            \
+            MIR_CacheAlignedRealloc, (tree), (sorted), (len)                   \
+        )
+
+/**
+ * \brief The same as \ref MIR_STree32_DeinitByFreeF but uses \ref
+ * MIR_AlignedFree.
+ */
+#    define MIR_STree32_Deinit(tree)                                           \
+        MIR_STree32_DeinitByFreeF(MIR_AlignedFree, (tree))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_SEARCH_H */
@@ -0,0 +1,108 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Slab - fixed-size object allocator
+ */
+
+#ifndef _MIR_COMMON_SLAB_H
+#define _MIR_COMMON_SLAB_H
+
+
+#include <stddef.h> /* size_t */
+
+#include <mir/common/mem.h> /* MIR_CACHE_LINE_SIZE */
+
+
+/**
+ * \brief Default number of objects per \ref MIR_Slab chunk.
+ */
+#define MIR_SLAB_CHUNK_OBJS 64u
+
+/**
+ * \brief Allocator of objects of one size, carved out of large chunks.
+ *
+ * \details Chunks are obtained from a realloc-like function (called with
+ * `NULL`) and are returned only by \ref MIR_Slab_DeinitByFreeF, so
+ * allocating and freeing an object is a pointer bump or a free-list pop/push.
+ * Objects are not individually freed to the underlying allocator, which
+ * also means that freeing a whole structure built from slab objects is `O(1)`
+ * per chunk instead of per object.
+ *
+ * Objects of at least \ref MIR_CACHE_LINE_SIZE bytes are padded to a multiple
+ * of it and start at a multiple of it from the chunk start, so they are
+ * cache-line-aligned if the chunk allocator is (e.g. \ref
+ * MIR_CacheAlignedRealloc). Smaller objects are aligned to
+ * `2 * sizeof(void *)`.
+ *
+ * \warning Members **MUST NOT** be modified directly.
+ */
+struct MIR_Slab {
+    /**
+     * \brief Last allocated chunk. The first word of a chunk points to the
+     * previous one.
+     */
+    void *chunks;
+
+    /**
+     * \brief Freed objects, linked through their first word.
+     */
+    void *freeList;
+
+    /**
+     * \brief Not yet used part of the last chunk.
+     */
+    unsigned char *bump;
+    size_t bumpLeft;
+
+    size_t objSize;
+    size_t chunkObjs;
+};
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Inits the slab without allocating.
+ *
+ * \param[out] slab      pointer to \ref MIR_Slab struct
+ * \param      objSize   size of objects. **MUST** be greater than `0`
+ * \param      chunkObjs number of objects per chunk. **MUST** be greater than
+ *                       `0`. See \ref MIR_SLAB_CHUNK_OBJS
+ */
+extern void
+MIR_Slab_Init(struct MIR_Slab *slab, size_t objSize, size_t chunkObjs);
+
+/**
+ * \brief Allocates an object, taking a new chunk from provided realloc-like
+ * function if needed.
+ *
+ * \return pointer to the object or `NULL` on failure
+ */
+extern void *MIR_Slab_AllocByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Slab *slab
+);
+
+/**
+ * \brief Returns an object to the slab.
+ *
+ * \param[in,out] slab pointer to \ref MIR_Slab struct
+ * \param[in]     obj  pointer returned by \ref MIR_Slab_AllocByReallocF of the
+ *                     same slab
+ */
+extern void MIR_Slab_Free(struct MIR_Slab *slab, void *obj);
+
+/**
+ * \brief Frees all chunks (and so all objects) by using provided free-like
+ * function and leaves the slab empty.
+ */
+extern void
+MIR_Slab_DeinitByFreeF(void (*freeF)(void *), struct MIR_Slab *slab);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* _MIR_COMMON_SLAB_H */
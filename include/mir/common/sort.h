@@ -0,0 +1,473 @@
+/**
+ * \file
+ *
+ * \brief Type-specialized sorting
+ *
+ * \details \ref MIR_SORT_DEFINE generates sorting functions for one element
+ * type and one ordering. The comparator is a macro (or an inline function), so
+ * it's inlined into the sorting loops instead of being called through a
+ * function pointer on every comparison as with `qsort`.
+ *
+ * \code{.c}
+ * #define PointLess(a, b) ((a)->x < (b)->x)
+ * MIR_SORT_DEFINE(struct Point, SortPoints, PointLess)
+ *
+ * MIR_Arr(struct Point, Points) points;
+ * ...
+ * MIR_Arr_Sort(SortPoints, &points);
+ * \endcode
+ */
+
+#ifndef _MIR_COMMON_SORT_H
+#define _MIR_COMMON_SORT_H
+
+
+#include <stddef.h> /* size_t */
+#include <string.h> /* memcpy */
+
+#include <mir/common/macros.h> /* MIR_INLINE */
+
+
+/**
+ * \brief Partitions of at most this many elements are sorted by a sorting
+ * network followed by insertion sort.
+ */
+#define MIR_SORT_SMALL 24u
+
+/**
+ * \brief Partitions larger than this use the pseudo-median of nine as the
+ * pivot (the median of three otherwise).
+ */
+#define MIR_SORT_NINTHER_THRESHOLD 128u
+
+
+/**
+ * \brief Sorts an \ref MIR_Arr with a function generated by \ref
+ * MIR_SORT_DEFINE.
+ *
+ * \param name name passed to \ref MIR_SORT_DEFINE
+ * \param arr  pointer to \ref MIR_Arr struct
+ */
+#define MIR_Arr_Sort(name, arr) name((arr)->data, (arr)->len)
+
+/**
+ * \brief Stably sorts an \ref MIR_Arr with a function generated by \ref
+ * MIR_SORT_DEFINE.
+ *
+ * \param name    name passed to \ref MIR_SORT_DEFINE
+ * \param arr     pointer to \ref MIR_Arr struct
+ * \param scratch pointer to at least `(arr)->len / 2` elements
+ */
+#define MIR_Arr_StableSort(name, arr, scratch)                                 \
+    name##_Stable((arr)->data, (arr)->len, (scratch))
+
+/**
+ * \brief Sorts a \ref MIR_Vec with a function generated by \ref
+ * MIR_SORT_DEFINE.
+ *
+ * \param name name passed to \ref MIR_SORT_DEFINE
+ * \param vec  pointer to \ref MIR_Vec struct
+ */
+#define MIR_Vec_Sort(name, vec) name((vec)->data, (vec)->len)
+
+/**
+ * \brief Stably sorts a \ref MIR_Vec with a function generated by \ref
+ * MIR_SORT_DEFINE.
+ *
+ * \param name    name passed to \ref MIR_SORT_DEFINE
+ * \param vec     pointer to \ref MIR_Vec struct
+ * \param scratch pointer to at least `(vec)->len / 2` elements
+ */
+#define MIR_Vec_StableSort(name, vec, scratch)                                 \
+    name##_Stable((vec)->data, (vec)->len, (scratch))
+
+
+/**
+ * \brief Defines sorting functions for elements of type `type` ordered by
+ * `LESS`.
+ *
+ * \param type elements type. **MAY** consist of several tokens
+ * \param name name of the generated functions
+ * \param LESS macro or function `int LESS(const type *a, const type *b)`
+ *             returning non-zero iff `*a` goes strictly before `*b`. It
+ *             **MUST** be a strict weak ordering
+ *
+ * \details Generated functions:
+ * + `void name(type *data, size_t len)` - pattern-defeating quicksort
+ *   (unstable, in place, `O(n log n)` worst case):
+ *   - partitions of at most \ref MIR_SORT_SMALL elements are sorted by an
+ *     optimal sorting network for up to 8 elements plus insertion sort
+ *   - partitioning is a branchless Lomuto scheme: the comparison result only
+ *     selects the next write position, so random input causes no branch
+ *     mispredictions
+ *   - runs of elements equal to the pivot of the parent partition are split
+ *     off in one pass, so inputs with few distinct keys take `O(n k)`
+ *   - already partitioned ranges are finished by a bounded insertion sort,
+ *     which makes sorted and nearly sorted inputs `O(n)`
+ *   - highly unbalanced partitions shuffle a few elements, and after
+ *     `log2(len)` of them the partition is heapsorted
+ * + `void name##_Stable(type *data, size_t len, type *scratch)` - stable
+ *   merge sort using `scratch` of at least `len / 2` elements (**MAY** be
+ *   `NULL` if `len` is at most \ref MIR_SORT_SMALL)
+ *
+ * Functions with names starting with `name##__` are internal.
+ */
+#define MIR_SORT_DEFINE(type, name, LESS)                                      \
+                                                                               \
+    MIR_INLINE void name##__Swap(type *x, type *y) {                           \
+        type tmp = *x;                                                         \
+        *x = *y;                                                               \
+        *y = tmp;                                                              \
+    }                                                                          \
+                                                                               \
+    /* NOTE: orders the pair without branches (for scalar types compilers    \
+     *       emit conditional moves) */                                       \
+    MIR_INLINE void name##__CSwap(type *x, type *y) {                          \
+        int c = (LESS(y, x)) != 0;                                             \
+        type lo = c ? *y : *x;                                                 \
+        type hi = c ? *x : *y;                                                 \
+        *x = lo;                                                               \
+        *y = hi;                                                               \
+    }                                                                          \
+                                                                               \
+    /* NOTE: makes `a[i] <= a[j] <= a[k]` */                                  \
+    MIR_INLINE void name##__Sort3(type *a, size_t i, size_t j, size_t k) {     \
+        name##__CSwap(&a[i], &a[j]);                                           \
+        name##__CSwap(&a[j], &a[k]);                                           \
+        name##__CSwap(&a[i], &a[j]);                                           \
+    }                                                                          \
+                                                                               \
+    /* NOTE: optimal (in size) sorting networks for `n <= 8` */               \
+    MIR_INLINE void name##__Network(type *a, size_t n) {                       \
+        switch (n) {                                                           \
+        case 2:                                                                \
+            name##__CSwap(&a[0], &a[1]);                                       \
+            break;                                                             \
+        case 3:                                                                \
+            name##__Sort3(a, 0, 1, 2);                                         \
+            break;                                                             \
+        case 4:                                                                \
+            __MIR_SORT_CE(name, a, 0, 2), __MIR_SORT_CE(name, a, 1, 3);        \
+            __MIR_SORT_CE(name, a, 0, 1), __MIR_SORT_CE(name, a, 2, 3);        \
+            __MIR_SORT_CE(name, a, 1, 2);                                      \
+            break;                                                             \
+        case 5:                                                                \
+            __MIR_SORT_CE(name, a, 0, 3), __MIR_SORT_CE(name, a, 1, 4);        \
+            __MIR_SORT_CE(name, a, 0, 2), __MIR_SORT_CE(name, a, 1, 3);        \
+            __MIR_SORT_CE(name, a, 0, 1), __MIR_SORT_CE(name, a, 2, 4);        \
+            __MIR_SORT_CE(name, a, 1, 2), __MIR_SORT_CE(name, a, 3, 4);        \
+            __MIR_SORT_CE(name, a, 2, 3);                                      \
+            break;                                                             \
+        case 6:                                                                \
+            __MIR_SORT_CE(name, a, 0, 5), __MIR_SORT_CE(name, a, 1, 3);        \
+            __MIR_SORT_CE(name, a, 2, 4), __MIR_SORT_CE(name, a, 1, 2);        \
+            __MIR_SORT_CE(name, a, 3, 4), __MIR_SORT_CE(name, a, 0, 3);        \
+            __MIR_SORT_CE(name, a, 2, 5), __MIR_SORT_CE(name, a, 0, 1);        \
+            __MIR_SORT_CE(name, a, 2, 3), __MIR_SORT_CE(name, a, 4, 5);        \
+            __MIR_SORT_CE(name, a, 1, 2), __MIR_SORT_CE(name, a, 3, 4);        \
+            break;                                                             \
+        case 7:                                                                \
+            __MIR_SORT_CE(name, a, 0, 6), __MIR_SORT_CE(name, a, 2, 3);        \
+            __MIR_SORT_CE(name, a, 4, 5), __MIR_SORT_CE(name, a, 0, 2);        \
+            __MIR_SORT_CE(name, a, 1, 4), __MIR_SORT_CE(name, a, 3, 6);        \
+            __MIR_SORT_CE(name, a, 0, 1), __MIR_SORT_CE(name, a, 2, 5);        \
+            __MIR_SORT_CE(name, a, 3, 4), __MIR_SORT_CE(name, a, 1, 2);        \
+            __MIR_SORT_CE(name, a, 4, 6), __MIR_SORT_CE(name, a, 2, 3);        \
+            __MIR_SORT_CE(name, a, 4, 5), __MIR_SORT_CE(name, a, 1, 2);        \
+            __MIR_SORT_CE(name, a, 3, 4), __MIR_SORT_CE(name, a, 5, 6);        \
+            break;                                                             \
+        case 8:                                                                \
+            __MIR_SORT_CE(name, a, 0, 2), __MIR_SORT_CE(name, a, 1, 3);        \
+            __MIR_SORT_CE(name, a, 4, 6), __MIR_SORT_CE(name, a, 5, 7);        \
+            __MIR_SORT_CE(name, a, 0, 4), __MIR_SORT_CE(name, a, 1, 5);        \
+            __MIR_SORT_CE(name, a, 2, 6), __MIR_SORT_CE(name, a, 3, 7);        \
+            __MIR_SORT_CE(name, a, 0, 1), __MIR_SORT_CE(name, a, 2, 3);        \
+            __MIR_SORT_CE(name, a, 4, 5), __MIR_SORT_CE(name, a, 6, 7);        \
+            __MIR_SORT_CE(name, a, 2, 4), __MIR_SORT_CE(name, a, 3, 5);        \
+            __MIR_SORT_CE(name, a, 1, 4), __MIR_SORT_CE(name, a, 3, 6);        \
+            __MIR_SORT_CE(name, a, 1, 2), __MIR_SORT_CE(name, a, 3, 4);        \
+            __MIR_SORT_CE(name, a, 5, 6);                                      \
+            break;                                                             \
+        default:                                                               \
+            break;                                                             \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* NOTE: inserts `a[from..n)` into the sorted `a[0..from)`. Stable.      \
+     *       `from` MUST be at least `1` */                                    \
+    MIR_INLINE void name##__Insertion(type *a, size_t n, size_t from) {        \
+        size_t i;                                                              \
+        size_t j;                                                              \
+        type x;                                                                \
+                                                                               \
+        for (i = from; i < n; ++i) {                                           \
+            if (!(LESS(&a[i], &a[i - 1u]))) {                                  \
+                continue;                                                      \
+            }                                                                  \
+            x = a[i];                                                          \
+            j = i;                                                             \
+            do {                                                               \
+                a[j] = a[j - 1u];                                              \
+                --j;                                                           \
+            } while (j > 0u && (LESS(&x, &a[j - 1u])));                        \
+            a[j] = x;                                                          \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* NOTE: insertion sort that gives up after moving 8 elements. Returns   \
+     *       non-zero iff `a` got sorted */                                    \
+    MIR_INLINE int name##__PartialInsertion(type *a, size_t n) {               \
+        size_t moved = 0;                                                      \
+        size_t i;                                                              \
+        size_t j;                                                              \
+        type x;                                                                \
+                                                                               \
+        for (i = 1; i < n; ++i) {                                              \
+            if (!(LESS(&a[i], &a[i - 1u]))) {                                  \
+                continue;                                                      \
+            }                                                                  \
+            x = a[i];                                                          \
+            j = i;                                                             \
+            do {                                                               \
+                a[j] = a[j - 1u];                                              \
+                --j;                                                           \
+            } while (j > 0u && (LESS(&x, &a[j - 1u])));                        \
+            a[j] = x;                                                          \
+            moved += i - j;                                                    \
+            if (moved > 8u) {                                                  \
+                return 0;                                                      \
+            }                                                                  \
+        }                                                                      \
+        return 1;                                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##__Small(type *a, size_t n) {                         \
+        if (n <= 8u) {                                                         \
+            name##__Network(a, n);                                             \
+        } else {                                                               \
+            name##__Network(a, 8u);                                            \
+            name##__Insertion(a, n, 8u);                                       \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##__SiftDown(type *a, size_t n, size_t i) {            \
+        type x = a[i];                                                         \
+        size_t c;                                                              \
+                                                                               \
+        for (;;) {                                                             \
+            c = 2u * i + 1u;                                                   \
+            if (c >= n) {                                                      \
+                break;                                                         \
+            }                                                                  \
+            if (c + 1u < n && (LESS(&a[c], &a[c + 1u]))) {                     \
+                ++c;                                                           \
+            }                                                                  \
+            if (!(LESS(&x, &a[c]))) {                                          \
+                break;                                                         \
+            }                                                                  \
+            a[i] = a[c];                                                       \
+            i = c;                                                             \
+        }                                                                      \
+        a[i] = x;                                                              \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##__HeapSort(type *a, size_t n) {                      \
+        size_t i;                                                              \
+                                                                               \
+        for (i = n / 2u; i-- > 0u;) {                                          \
+            name##__SiftDown(a, n, i);                                         \
+        }                                                                      \
+        for (i = n - 1u; i > 0u; --i) {                                        \
+            name##__Swap(&a[0], &a[i]);                                        \
+            name##__SiftDown(a, i, 0);                                         \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /* NOTE: partitions around the pivot `a[0]` into `< pivot` and `>=      \
+     *       pivot`. Returns the final position of the pivot. Elements that  \
+     *       don't belong to the left part are rotated through `a[i]`        \
+     *       instead of being skipped, so the loop has no data-dependent     \
+     *       branches */                                                       \
+    MIR_INLINE size_t name##__PartitionRight(                                  \
+        type *a, size_t n, int *alreadyPartitioned                             \
+    ) {                                                                        \
+        type pivot = a[0];                                                     \
+        type x;                                                                \
+        size_t i = 1;                                                          \
+        size_t j;                                                              \
+        size_t lt;                                                             \
+        size_t moved = 0;                                                      \
+                                                                               \
+        for (j = 1; j < n; ++j) {                                              \
+            x = a[j];                                                          \
+            lt = (LESS(&x, &pivot)) != 0;                                      \
+            moved |= lt & (size_t)(i != j);                                    \
+            a[j] = a[i];                                                       \
+            a[i] = x;                                                          \
+            i += lt;                                                           \
+        }                                                                      \
+                                                                               \
+        a[0] = a[i - 1u];                                                      \
+        a[i - 1u] = pivot;                                                     \
+        *alreadyPartitioned = (moved == 0u);                                   \
+        return i - 1u;                                                         \
+    }                                                                          \
+                                                                               \
+    /* NOTE: the same but into `<= pivot` and `> pivot`. Used when the pivot \
+     *       equals the element before `a`, so the left part is all equal */  \
+    MIR_INLINE size_t name##__PartitionLeft(type *a, size_t n) {               \
+        type pivot = a[0];                                                     \
+        type x;                                                                \
+        size_t i = 1;                                                          \
+        size_t j;                                                              \
+                                                                               \
+        for (j = 1; j < n; ++j) {                                              \
+            x = a[j];                                                          \
+            a[j] = a[i];                                                       \
+            a[i] = x;                                                          \
+            i += (size_t)((LESS(&pivot, &x)) == 0);                            \
+        }                                                                      \
+                                                                               \
+        a[0] = a[i - 1u];                                                      \
+        a[i - 1u] = pivot;                                                     \
+        return i - 1u;                                                         \
+    }                                                                          \
+                                                                               \
+    /* NOTE: breaks patterns that made the partition unbalanced */            \
+    MIR_INLINE void name##__Shuffle(type *a, size_t n) {                       \
+        size_t q = n / 4u;                                                     \
+                                                                               \
+        name##__Swap(&a[0], &a[q]);                                            \
+        name##__Swap(&a[n - 1u], &a[n - q]);                                   \
+        if (n > MIR_SORT_NINTHER_THRESHOLD) {                                  \
+            name##__Swap(&a[1], &a[q + 1u]);                                   \
+            name##__Swap(&a[2], &a[q + 2u]);                                   \
+            name##__Swap(&a[n - 2u], &a[n - q - 1u]);                          \
+            name##__Swap(&a[n - 3u], &a[n - q - 2u]);                          \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##__Loop(                                              \
+        type *a, size_t n, unsigned badAllowed, int leftmost                   \
+    ) {                                                                        \
+        size_t mid;                                                            \
+        size_t p;                                                              \
+        size_t l;                                                              \
+        size_t r;                                                              \
+        int alreadyPartitioned;                                                \
+                                                                               \
+        for (;;) {                                                             \
+            if (n <= MIR_SORT_SMALL) {                                         \
+                name##__Small(a, n);                                           \
+                return;                                                        \
+            }                                                                  \
+                                                                               \
+            /* NOTE: move the pivot to `a[0]` */                              \
+            mid = n / 2u;                                                      \
+            if (n > MIR_SORT_NINTHER_THRESHOLD) {                              \
+                name##__Sort3(a, 0, mid, n - 1u);                              \
+                name##__Sort3(a, 1, mid - 1u, n - 2u);                         \
+                name##__Sort3(a, 2, mid + 1u, n - 3u);                         \
+                name##__Sort3(a, mid - 1u, mid, mid + 1u);                     \
+                name##__Swap(&a[0], &a[mid]);                                  \
+            } else {                                                           \
+                name##__Sort3(a, mid, 0, n - 1u);                              \
+            }                                                                  \
+                                                                               \
+            /* NOTE: `a[-1]` is the pivot of the parent partition. If it     \
+             *       equals this pivot, skip all elements equal to it */      \
+            if (!leftmost && !(LESS(&a[-1], &a[0]))) {                         \
+                p = name##__PartitionLeft(a, n);                               \
+                a += p + 1u;                                                   \
+                n -= p + 1u;                                                   \
+                continue;                                                      \
+            }                                                                  \
+                                                                               \
+            p = name##__PartitionRight(a, n, &alreadyPartitioned);             \
+            l = p;                                                             \
+            r = n - p - 1u;                                                    \
+            if (l < n / 8u || r < n / 8u) {                                    \
+                if (--badAllowed == 0u) {                                      \
+                    name##__HeapSort(a, n);                                    \
+                    return;                                                    \
+                }                                                              \
+                if (l >= MIR_SORT_SMALL) {                                     \
+                    name##__Shuffle(a, l);                                     \
+                }                                                              \
+                if (r >= MIR_SORT_SMALL) {                                     \
+                    name##__Shuffle(a + p + 1u, r);                            \
+                }                                                              \
+            } else if (alreadyPartitioned &&                                   \
+                       name##__PartialInsertion(a, l) &&                       \
+                       name##__PartialInsertion(a + p + 1u, r)) {              \
+                return;                                                        \
+            }                                                                  \
+                                                                               \
+            /* NOTE: recurse into the smaller part to bound the stack */      \
+            if (l < r) {                                                       \
+                name##__Loop(a, l, badAllowed, leftmost);                      \
+                a += p + 1u;                                                   \
+                n = r;                                                         \
+                leftmost = 0;                                                  \
+            } else {                                                           \
+                name##__Loop(a + p + 1u, r, badAllowed, 0);                    \
+                n = l;                                                         \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name(type *data, size_t len) {                             \
+        unsigned badAllowed = 1;                                               \
+        size_t n;                                                              \
+                                                                               \
+        for (n = len; n > 1u; n /= 2u) {                                       \
+            ++badAllowed;                                                      \
+        }                                                                      \
+        if (len > 1u) {                                                        \
+            name##__Loop(data, len, badAllowed, 1);                            \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##__MergeSort(type *a, size_t n, type *scratch) {      \
+        size_t m;                                                              \
+        size_t i;                                                              \
+        size_t j;                                                              \
+        size_t k;                                                              \
+        size_t right;                                                          \
+                                                                               \
+        if (n <= MIR_SORT_SMALL) {                                             \
+            if (n > 1u) {                                                      \
+                name##__Insertion(a, n, 1u);                                   \
+            }                                                                  \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        m = n / 2u;                                                            \
+        name##__MergeSort(a, m, scratch);                                      \
+        name##__MergeSort(a + m, n - m, scratch);                              \
+        if (!(LESS(&a[m], &a[m - 1u]))) {                                      \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        /* NOTE: the right run is taken only if strictly less, which keeps   \
+         *       the sort stable */                                           \
+        memcpy(scratch, a, m * sizeof(type));                                  \
+        for (i = 0, j = m, k = 0; i < m && j < n; ++k) {                       \
+            right = (LESS(&a[j], &scratch[i])) != 0;                           \
+            a[k] = right ? a[j] : scratch[i];                                  \
+            j += right;                                                        \
+            i += right ^ 1u;                                                   \
+        }                                                                      \
+        if (i < m) {                                                           \
+            memcpy(a + k, scratch + i, (m - i) * sizeof(type));                \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    MIR_INLINE void name##_Stable(type *data, size_t len, type *scratch) {     \
+        name##__MergeSort(data, len, scratch);                                 \
+    }
+
+#define __MIR_SORT_CE(name, a, i, j) name##__CSwap(&(a)[i], &(a)[j])
+
+
+#endif /* _MIR_COMMON_SORT_H */
@@ -0,0 +1,342 @@
+/**
+ * \file
+ *
+ * \brief \ref MIR_Str utilities
+ */
+
+#ifndef _MIR_COMMON_STR_H
+#define _MIR_COMMON_STR_H
+
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* UINT_LEAST32_MAX */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdlib.h> /* free, realloc */
+#endif
+
+#include <mir/common/encodings/utf8.h> /* MIR_UTF8_BufIter */
+#include <mir/common/macros.h>         /* MIR_INLINE */
+#include <mir/common/unicode.h>        /* MIR_UCP */
+#include <mir/internal/assert.h>       /* __MIR_ASSERT_MSG */
+
+
+/**
+ * \brief Owning byte string with small-string optimization.
+ *
+ * \details The struct has the size of three `size_t`. Its last byte is the
+ * *meta* byte:
+ *   + bit `0` - set if the bytes live on the heap
+ *   + bit `1` - set if the bytes are known to be well-formed UTF-8 (see \ref
+ *     MIR_Str_IsValidUTF8)
+ *   + bits `2..7` - the length (inline mode) or the base-2 logarithm of the
+ *     allocation size (heap mode)
+ *
+ * In inline mode up to \ref MIR_STR_INLINE_CAP bytes (`22` on 64-bit
+ * platforms) are stored in the struct itself. In heap mode the struct holds a
+ * pointer to the bytes and the length; the allocation size is always a power
+ * of two, so growing by appending is amortized `O(1)` just like for \ref
+ * MIR_Vec.
+ *
+ * The bytes are always followed by `'\0'`, so \ref MIR_Str_Data can be passed
+ * where a C string is expected (if the bytes don't contain `'\0'`).
+ *
+ * \warning Members **MUST NOT** be accessed directly. Use the functions and
+ * macros below.
+ *
+ * ## Initialization
+ *
+ * \ref MIR_Str_Init - the string doesn't allocate until it outgrows the inline
+ * storage.
+ *
+ * ## Interface
+ *
+ * \note Macros without `ByReallocF`/`ByFreeF` suffix will be defined only if
+ * `MIR_NO_STD_ALLOCATOR` is not defined.
+ *
+ * + \ref MIR_Str_Len, \ref MIR_Str_Data, \ref MIR_Str_Cap, \ref
+ *   MIR_Str_IsInline
+ * + \ref MIR_Str_ReserveByReallocF
+ * + \ref MIR_Str_AppendByReallocF, \ref MIR_Str_AppendStrByReallocF, \ref
+ *   MIR_Str_PushByReallocF, \ref MIR_Str_AppendUCPByReallocF
+ * + \ref MIR_Str_FromBufIterByReallocF, \ref MIR_Str_AsBufIter
+ * + \ref MIR_Str_IsValidUTF8
+ * + \ref MIR_Str_Clear, \ref MIR_Str_DeinitByFreeF
+ */
+struct MIR_Str {
+    union {
+        struct {
+            char *data;
+            size_t len;
+        } heap;
+        unsigned char buf[3u * sizeof(size_t)];
+
+        /* NOTE: alignment only */
+        size_t __align[3];
+    } u;
+};
+
+/**
+ * \brief A constant indicating a successful operation on the \ref MIR_Str
+ * struct.
+ */
+#define MIR_Str_OK 0
+
+/**
+ * \brief Maximum length of the inline string.
+ *
+ * \details One byte is taken by `'\0'` and one by the meta byte.
+ */
+#define MIR_STR_INLINE_CAP (3u * sizeof(size_t) - 2u)
+
+#define __MIR_STR_META(s) ((s)->u.buf[3u * sizeof(size_t) - 1u])
+#define __MIR_STR_HEAP 0x1u
+#define __MIR_STR_UTF8 0x2u
+
+
+/**
+ * \brief Inits an empty inline string.
+ *
+ * \param[out] s pointer to \ref MIR_Str struct
+ */
+MIR_INLINE void MIR_Str_Init(struct MIR_Str *s) {
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    s->u.buf[0] = 0;
+    /* NOTE: empty string is well-formed UTF-8 */
+    __MIR_STR_META(s) = __MIR_STR_UTF8;
+}
+
+/**
+ * \brief Checks whether the bytes are stored in the struct itself.
+ */
+MIR_INLINE int MIR_Str_IsInline(const struct MIR_Str *s) {
+    return (__MIR_STR_META(s) & __MIR_STR_HEAP) == 0u;
+}
+
+/**
+ * \brief Returns the length in bytes (without `'\0'`).
+ */
+MIR_INLINE size_t MIR_Str_Len(const struct MIR_Str *s) {
+    return MIR_Str_IsInline(s) ? (size_t)(__MIR_STR_META(s) >> 2)
+                               : s->u.heap.len;
+}
+
+/**
+ * \brief Returns the pointer to the bytes.
+ *
+ * \warning The pointer is invalidated by any function that may reallocate and
+ * by moving the struct (if the string is inline).
+ */
+MIR_INLINE char *MIR_Str_Data(struct MIR_Str *s) {
+    return MIR_Str_IsInline(s) ? (char *)s->u.buf : s->u.heap.data;
+}
+
+/**
+ * \brief Returns the maximum length the string can reach without reallocation.
+ */
+MIR_INLINE size_t MIR_Str_Cap(const struct MIR_Str *s) {
+    return MIR_Str_IsInline(s)
+               ? MIR_STR_INLINE_CAP
+               : ((size_t)1 << (__MIR_STR_META(s) >> 2)) - 1u;
+}
+
+/**
+ * \brief Truncates the string to zero length. It never reclaims memory.
+ */
+MIR_INLINE void MIR_Str_Clear(struct MIR_Str *s) {
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    if (MIR_Str_IsInline(s)) {
+        s->u.buf[0] = 0;
+        __MIR_STR_META(s) = __MIR_STR_UTF8;
+    } else {
+        s->u.heap.data[0] = '\0';
+        s->u.heap.len = 0;
+        __MIR_STR_META(s) |= __MIR_STR_UTF8;
+    }
+}
+
+/**
+ * \brief Inits the iterator over the bytes of the string without copying.
+ *
+ * \details `replVal` is set to \ref MIR_REPLACEMENT_CHARACTER_CP and `eofVal`
+ * to `UINT_LEAST32_MAX`.
+ *
+ * \warning The iterator is invalidated just like \ref MIR_Str_Data.
+ *
+ * \param[in]  s    pointer to \ref MIR_Str struct
+ * \param[out] iter pointer to the iterator
+ */
+MIR_INLINE void
+MIR_Str_AsBufIter(struct MIR_Str *s, struct MIR_UTF8_BufIter *iter) {
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    iter->buf = (const unsigned char *)MIR_Str_Data(s);
+    iter->cur = iter->buf;
+    iter->lim = iter->buf + MIR_Str_Len(s);
+    iter->replVal = MIR_REPLACEMENT_CHARACTER_CP;
+    iter->eofVal = UINT_LEAST32_MAX;
+}
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Checks whether the string is well-formed UTF-8.
+ *
+ * \details The positive result is cached in the meta byte, so repeated checks
+ * of the same string are `O(1)`. The cache survives appending strings and code
+ * points that are known to be valid and is reset by appending raw bytes.
+ *
+ * \param[in,out] s pointer to \ref MIR_Str struct
+ *
+ * \return `1` if the string is well-formed UTF-8, `0` otherwise
+ */
+extern int MIR_Str_IsValidUTF8(struct MIR_Str *s);
+
+/**
+ * \brief Reserves enough space to hold at least `capacity` bytes.
+ *
+ * \details Does nothing if `capacity` is not greater than \ref MIR_Str_Cap.
+ * Otherwise the allocation grows to the next power of two, but at least twice
+ * (the same policy as pushing to \ref MIR_Vec).
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in,out] s        pointer to \ref MIR_Str struct
+ * \param         capacity new capacity in bytes (without `'\0'`)
+ *
+ * \return \ref MIR_Str_OK on success; `1` on failure
+ */
+extern int MIR_Str_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, size_t capacity
+);
+
+/**
+ * \brief Appends bytes.
+ *
+ * \param[in]     reallocF realloc-like function
+ * \param[in,out] s        pointer to \ref MIR_Str struct
+ * \param[in]     data     bytes to append. **MAY** be `NULL` if `len` is `0`.
+ *                         **MUST NOT** point into `s`
+ * \param         len      number of bytes
+ *
+ * \return \ref MIR_Str_OK on success; `1` on failure (`s` is not changed)
+ */
+extern int MIR_Str_AppendByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, const void *data,
+    size_t len
+);
+
+/**
+ * \brief Appends another string. Keeps the UTF-8 cache if both strings are
+ * known to be valid.
+ *
+ * \details See \ref MIR_Str_AppendByReallocF. `other` **MUST NOT** be `s`.
+ */
+extern int MIR_Str_AppendStrByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s,
+    const struct MIR_Str *other
+);
+
+/**
+ * \brief Appends a byte. Keeps the UTF-8 cache if the byte is ASCII.
+ *
+ * \details See \ref MIR_Str_AppendByReallocF.
+ */
+extern int MIR_Str_PushByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, char c
+);
+
+/**
+ * \brief Appends a code point encoded in UTF-8. Keeps the UTF-8 cache.
+ *
+ * \details See \ref MIR_Str_AppendByReallocF.
+ *
+ * \return \ref MIR_Str_OK on success; `1` on failure or if `cp` is not a
+ * Unicode scalar value (a surrogate or greater than `U+10FFFF`)
+ */
+extern int MIR_Str_AppendUCPByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, MIR_UCP cp
+);
+
+/**
+ * \brief Inits the string with the not yet consumed part (from `cur` to `lim`)
+ * of the buffer of the iterator.
+ *
+ * \details The bytes are copied as is, in one go (they are neither decoded nor
+ * validated). The iterator is not modified.
+ *
+ * \param[in]  reallocF realloc-like function
+ * \param[out] s        pointer to \ref MIR_Str struct
+ * \param[in]  iter     pointer to the iterator
+ *
+ * \return \ref MIR_Str_OK on success; `1` on failure (`s` is initialized as
+ * empty)
+ */
+extern int MIR_Str_FromBufIterByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s,
+    const struct MIR_UTF8_BufIter *iter
+);
+
+/**
+ * \brief Frees the heap storage (if any) and makes the string empty.
+ *
+ * \param[in]     freeF free-like function
+ * \param[in,out] s     pointer to \ref MIR_Str struct
+ */
+extern void MIR_Str_DeinitByFreeF(void (*freeF)(void *), struct MIR_Str *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief The same as \ref MIR_Str_ReserveByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_Reserve(s, capacity)                                       \
+        MIR_Str_ReserveByReallocF(realloc, (s), (capacity))
+
+/**
+ * \brief The same as \ref MIR_Str_AppendByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_Append(s, data, len)                                       \
+        MIR_Str_AppendByReallocF(realloc, (s), (data), (len))
+
+/**
+ * \brief The same as \ref MIR_Str_AppendStrByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_AppendStr(s, other)                                        \
+        MIR_Str_AppendStrByReallocF(realloc, (s), (other))
+
+/**
+ * \brief The same as \ref MIR_Str_PushByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_Push(s, c) MIR_Str_PushByReallocF(realloc, (s), (c))
+
+/**
+ * \brief The same as \ref MIR_Str_AppendUCPByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_AppendUCP(s, cp)                                           \
+        MIR_Str_AppendUCPByReallocF(realloc, (s), (cp))
+
+/**
+ * \brief The same as \ref MIR_Str_FromBufIterByReallocF but uses `realloc`.
+ */
+#    define MIR_Str_FromBufIter(s, iter)                                       \
+        MIR_Str_FromBufIterByReallocF(realloc, (s), (iter))
+
+/**
+ * \brief The same as \ref MIR_Str_DeinitByFreeF but uses `free`.
+ */
+#    define MIR_Str_Deinit(s) MIR_Str_DeinitByFreeF(free, (s))
+
+#endif /* MIR_NO_STD_ALLOCATOR */
+
+
+#endif /* _MIR_COMMON_STR_H */
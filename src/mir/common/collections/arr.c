@@ -53,6 +53,48 @@ int __MIR_Arr_InitByMallocF_impl(
     return MIR_Arr_OK;
 }
 
+/**
+ * \brief Inits \ref MIR_Arr by calling provided aligned_alloc-like function.
+ *
+ * \param[in]  aligned_malloc_f aligned_alloc-like function to be used as an
+ *                              allocator
+ * \param[out] member_data      pointer to `data` member
+ * \param[out] member_len       pointer to `len` member
+ * \param      length           number of elements in array. **MAY** be `0`
+ * \param      elemSize         size of element. **MAY** be `0`
+ * \param      alignment        alignment in bytes. **MUST** be a power of two
+ *
+ * \return \ref MIR_Arr_OK if succeed, `1` otherwise
+ */
+int __MIR_Arr_InitByAlignedMallocF_impl(
+    void *(*aligned_malloc_f)(size_t, size_t), void const **member_data,
+    size_t *member_len, size_t length, size_t elemSize, size_t alignment
+) {
+    void const *ptr;
+    size_t alloc_size;
+
+    if (MIR_u_Mul_WillOverflow(length, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+
+    alloc_size = length * elemSize;
+    if (alloc_size == 0u) {
+        *member_data = NULL;
+        *member_len = 0;
+        return MIR_Arr_OK;
+    }
+
+    ptr = aligned_malloc_f(alignment, alloc_size);
+    if (ptr == NULL) {
+        return 1;
+    }
+
+    *member_data = ptr;
+    *member_len = length;
+
+    return MIR_Arr_OK;
+}
+
 /**
  * \brief Deinits \ref MIR_Arr by calling provided free-like function.
  *
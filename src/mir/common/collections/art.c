@@ -0,0 +1,960 @@
+#include <mir/common/collections/art.h>
+
+#include <stddef.h> /* NULL, offsetof, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT32_MAX, UINT_LEAST32_MAX, uint*_t */
+#include <string.h> /* memcmp, memcpy, memmove, memset */
+
+#ifdef __SSE2__
+#    include <emmintrin.h> /* _mm_* */
+#endif
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/common/bits.h>     /* MIR_Bits_Ctz32 */
+#include <mir/common/mem.h>      /* MIR_FailRealloc */
+#include <mir/common/unicode.h>  /* MIR_REPLACEMENT_CHARACTER_CP */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+#define MAX_PREFIX MIR_ART_MAX_PREFIX
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/* NOTE: leaves are told from inner nodes by the low bit of the pointer, so
+ *       allocations MUST be at least 2-byte aligned */
+#define IS_LEAF(p) (((uintptr_t)(p) & 1u) != 0u)
+#define AS_LEAF(p) ((struct Leaf *)(void *)((uintptr_t)(p) & ~(uintptr_t)1u))
+#define TAG_LEAF(leaf) ((void *)((uintptr_t)(leaf) | 1u))
+
+
+enum { NODE4, NODE16, NODE48, NODE256 };
+
+struct Leaf {
+    void *val;
+    size_t len;
+    unsigned char key[];
+};
+
+struct Node {
+    uint8_t type;
+
+    /* NOTE: number of children */
+    uint16_t n;
+
+    /* NOTE: only the first `MAX_PREFIX' bytes of the prefix are stored */
+    uint32_t prefixLen;
+    unsigned char prefix[MAX_PREFIX];
+
+    /* NOTE: the leaf of the key ending right after the prefix */
+    struct Leaf *term;
+};
+
+struct Node4 {
+    struct Node h;
+    unsigned char keys[4];
+    void *children[4];
+};
+
+struct Node16 {
+    struct Node h;
+    unsigned char keys[16];
+    void *children[16];
+};
+
+struct Node48 {
+    struct Node h;
+
+    /* NOTE: one plus the index of the child, `0' if there is none */
+    unsigned char index[256];
+    void *children[48];
+};
+
+struct Node256 {
+    struct Node h;
+    void *children[256];
+};
+
+static const size_t NODE_SIZES[4] = {
+    sizeof(struct Node4), sizeof(struct Node16), sizeof(struct Node48),
+    sizeof(struct Node256)
+};
+
+static const unsigned NODE_CAPS[4] = {4u, 16u, 48u, 256u};
+
+static const size_t CHUNK_OBJS[4] = {64u, 32u, 16u, 8u};
+
+
+static int BytesEq(const unsigned char *a, const unsigned char *b, size_t n) {
+    return n == 0u || memcmp(a, b, n) == 0;
+}
+
+static int
+LeafIs(const struct Leaf *leaf, const unsigned char *key, size_t len) {
+    return leaf->len == len && BytesEq(leaf->key, key, len);
+}
+
+static struct Leaf *NewLeaf(
+    void *(*reallocF)(void *, size_t), const unsigned char *key, size_t len,
+    void *val
+) {
+    struct Leaf *leaf;
+
+    if (len > SIZE_MAX - sizeof(struct Leaf)) {
+        return NULL;
+    }
+    leaf = (struct Leaf *)reallocF(NULL, sizeof(struct Leaf) + len);
+    if (leaf == NULL) {
+        return NULL;
+    }
+    leaf->val = val;
+    leaf->len = len;
+    if (len > 0u) {
+        memcpy(leaf->key, key, len);
+    }
+    return leaf;
+}
+
+static struct Node *NewNode(
+    void *(*reallocF)(void *, size_t), struct MIR_Art *art, unsigned type
+) {
+    struct Node *n =
+        (struct Node *)MIR_Slab_AllocByReallocF(reallocF, &art->slabs[type]);
+
+    if (n == NULL) {
+        return NULL;
+    }
+    memset(n, 0, NODE_SIZES[type]);
+    n->type = (uint8_t)type;
+    return n;
+}
+
+static void FreeNode(struct MIR_Art *art, struct Node *n) {
+    MIR_Slab_Free(&art->slabs[n->type], n);
+}
+
+static void CopyHeader(struct Node *dst, const struct Node *src) {
+    dst->n = src->n;
+    dst->prefixLen = src->prefixLen;
+    memcpy(dst->prefix, src->prefix, MAX_PREFIX);
+    dst->term = src->term;
+}
+
+/* NOTE: returns the slot of the child for the byte or NULL */
+static void **FindChild(struct Node *n, unsigned char b) {
+    struct Node4 *n4;
+    struct Node16 *n16;
+    struct Node48 *n48;
+    struct Node256 *n256;
+    unsigned i;
+#ifdef __SSE2__
+    unsigned mask;
+#endif
+
+    switch (n->type) {
+    case NODE4:
+        n4 = (struct Node4 *)n;
+        for (i = 0; i < n->n; ++i) {
+            if (n4->keys[i] == b) {
+                return &n4->children[i];
+            }
+        }
+        return NULL;
+    case NODE16:
+        n16 = (struct Node16 *)n;
+#ifdef __SSE2__
+        mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(
+                   _mm_set1_epi8((char)b),
+                   _mm_loadu_si128((const __m128i *)(const void *)n16->keys)
+               )) &
+               ((1u << n->n) - 1u);
+        return (mask != 0u) ? &n16->children[MIR_Bits_Ctz32(mask)] : NULL;
+#else
+        for (i = 0; i < n->n && n16->keys[i] <= b; ++i) {
+            if (n16->keys[i] == b) {
+                return &n16->children[i];
+            }
+        }
+        return NULL;
+#endif
+    case NODE48:
+        n48 = (struct Node48 *)n;
+        return (n48->index[b] != 0u) ? &n48->children[n48->index[b] - 1u]
+                                     : NULL;
+    default:
+        n256 = (struct Node256 *)n;
+        return (n256->children[b] != NULL) ? &n256->children[b] : NULL;
+    }
+}
+
+/* NOTE: returns the first child at position `*pos' or after it in the byte
+ *       order (NULL if there is none), writes its byte to `*b' and moves
+ *       `*pos' past it */
+static void *NextChild(const struct Node *n, unsigned *pos, unsigned char *b) {
+    const struct Node4 *n4;
+    const struct Node16 *n16;
+    const struct Node48 *n48;
+    const struct Node256 *n256;
+    unsigned i;
+
+    switch (n->type) {
+    case NODE4:
+        n4 = (const struct Node4 *)n;
+        if (*pos >= n->n) {
+            return NULL;
+        }
+        *b = n4->keys[*pos];
+        return n4->children[(*pos)++];
+    case NODE16:
+        n16 = (const struct Node16 *)n;
+        if (*pos >= n->n) {
+            return NULL;
+        }
+        *b = n16->keys[*pos];
+        return n16->children[(*pos)++];
+    case NODE48:
+        n48 = (const struct Node48 *)n;
+        for (i = *pos; i < 256u; ++i) {
+            if (n48->index[i] != 0u) {
+                *pos = i + 1u;
+                *b = (unsigned char)i;
+                return n48->children[n48->index[i] - 1u];
+            }
+        }
+        break;
+    default:
+        n256 = (const struct Node256 *)n;
+        for (i = *pos; i < 256u; ++i) {
+            if (n256->children[i] != NULL) {
+                *pos = i + 1u;
+                *b = (unsigned char)i;
+                return n256->children[i];
+            }
+        }
+        break;
+    }
+    *pos = 256u;
+    return NULL;
+}
+
+static struct Leaf *MinLeaf(const void *p) {
+    const struct Node *n;
+    unsigned pos;
+    unsigned char b;
+
+    while (!IS_LEAF(p)) {
+        n = (const struct Node *)p;
+        if (n->term != NULL) {
+            return n->term;
+        }
+        pos = 0;
+        p = NextChild(n, &pos, &b);
+    }
+    return AS_LEAF(p);
+}
+
+/* NOTE: checks only the stored part of the prefix; the leaf is compared in
+ *       the end anyway */
+static int PrefixMayMatch(
+    const struct Node *n, const unsigned char *key, size_t len, size_t depth
+) {
+    return len - depth >= n->prefixLen &&
+           BytesEq(n->prefix, key + depth, MIN(n->prefixLen, MAX_PREFIX));
+}
+
+/* NOTE: returns the length of the common prefix of the node prefix and
+ *       `key[depth..len)'. The part that is not stored is taken from the
+ *       leftmost leaf */
+static size_t PrefixMismatch(
+    const struct Node *n, const unsigned char *key, size_t len, size_t depth
+) {
+    size_t max = MIN(len - depth, (size_t)n->prefixLen);
+    size_t stored = MIN(max, MAX_PREFIX);
+    const struct Leaf *leaf;
+    size_t i;
+
+    for (i = 0; i < stored; ++i) {
+        if (n->prefix[i] != key[depth + i]) {
+            return i;
+        }
+    }
+    if (i < max) {
+        leaf = MinLeaf(n);
+        for (; i < max; ++i) {
+            if (leaf->key[depth + i] != key[depth + i]) {
+                return i;
+            }
+        }
+    }
+    return i;
+}
+
+/* NOTE: keeps the keys of `Node4' and `Node16' sorted for ordered iteration */
+static void AddSorted(
+    unsigned char *keys, void **children, unsigned n, unsigned char b,
+    void *child
+) {
+    unsigned i = 0;
+
+    while (i < n && keys[i] < b) {
+        ++i;
+    }
+    memmove(keys + i + 1, keys + i, n - i);
+    memmove(children + i + 1, children + i, (n - i) * sizeof(void *));
+    keys[i] = b;
+    children[i] = child;
+}
+
+/* NOTE: the node MUST NOT be full */
+static void AddChild(struct Node *n, unsigned char b, void *child) {
+    struct Node48 *n48;
+    unsigned i;
+
+    switch (n->type) {
+    case NODE4:
+        AddSorted(
+            ((struct Node4 *)n)->keys, ((struct Node4 *)n)->children, n->n, b,
+            child
+        );
+        break;
+    case NODE16:
+        AddSorted(
+            ((struct Node16 *)n)->keys, ((struct Node16 *)n)->children, n->n,
+            b, child
+        );
+        break;
+    case NODE48:
+        n48 = (struct Node48 *)n;
+        for (i = 0; n48->children[i] != NULL; ++i) {
+        }
+        n48->children[i] = child;
+        n48->index[b] = (unsigned char)(i + 1u);
+        break;
+    default:
+        ((struct Node256 *)n)->children[b] = child;
+        break;
+    }
+    ++n->n;
+}
+
+/* NOTE: moves the children of `*ref' into a node of the next larger layout */
+static int
+Grow(void *(*reallocF)(void *, size_t), struct MIR_Art *art, void **ref) {
+    struct Node *n = (struct Node *)*ref;
+    struct Node *m = NewNode(reallocF, art, n->type + 1u);
+    unsigned pos = 0;
+    unsigned char b;
+    void *child;
+
+    if (m == NULL) {
+        return 1;
+    }
+    CopyHeader(m, n);
+    m->n = 0;
+    while ((child = NextChild(n, &pos, &b)) != NULL) {
+        AddChild(m, b, child);
+    }
+    FreeNode(art, n);
+    *ref = m;
+    return MIR_Art_OK;
+}
+
+/* NOTE: the leaf becomes the term of the node or its child */
+static void PlaceLeaf(struct Node *n, struct Leaf *leaf, size_t depth) {
+    if (leaf->len == depth) {
+        n->term = leaf;
+    } else {
+        AddChild(n, leaf->key[depth], TAG_LEAF(leaf));
+    }
+}
+
+static void RemoveChild(struct Node *n, unsigned char b, void **slot) {
+    struct Node4 *n4;
+    struct Node16 *n16;
+    struct Node48 *n48;
+    size_t i;
+
+    switch (n->type) {
+    case NODE4:
+        n4 = (struct Node4 *)n;
+        i = (size_t)(slot - n4->children);
+        memmove(n4->keys + i, n4->keys + i + 1, n->n - i - 1u);
+        memmove(slot, slot + 1, (n->n - i - 1u) * sizeof(void *));
+        break;
+    case NODE16:
+        n16 = (struct Node16 *)n;
+        i = (size_t)(slot - n16->children);
+        memmove(n16->keys + i, n16->keys + i + 1, n->n - i - 1u);
+        memmove(slot, slot + 1, (n->n - i - 1u) * sizeof(void *));
+        break;
+    case NODE48:
+        n48 = (struct Node48 *)n;
+        n48->index[b] = 0;
+        *slot = NULL;
+        break;
+    default:
+        *slot = NULL;
+        break;
+    }
+    --n->n;
+}
+
+/* NOTE: restores the invariants of `*ref' after a removal: a node holds at
+ *       least two keys (otherwise it's replaced by the only leaf or merged
+ *       into the only child) and is not much larger than needed */
+static void Compact(struct MIR_Art *art, void **ref) {
+    static const unsigned SHRINK_AT[4] = {0u, 3u, 12u, 37u};
+    struct Node *n = (struct Node *)*ref;
+    struct Node *c;
+    struct Node *m;
+    unsigned char prefix[MAX_PREFIX];
+    unsigned pos = 0;
+    unsigned char b;
+    void *child;
+    size_t k;
+    size_t j;
+
+    if (n->n == 0u) {
+        *ref = TAG_LEAF(n->term);
+        FreeNode(art, n);
+        return;
+    }
+
+    if (n->n == 1u && n->term == NULL) {
+        child = NextChild(n, &pos, &b);
+        if (!IS_LEAF(child)) {
+            c = (struct Node *)child;
+            k = MIN((size_t)n->prefixLen, MAX_PREFIX);
+            memcpy(prefix, n->prefix, k);
+            if (k < MAX_PREFIX) {
+                prefix[k++] = b;
+                j = MIN((size_t)c->prefixLen, MAX_PREFIX - k);
+                memcpy(prefix + k, c->prefix, j);
+                k += j;
+            }
+            memcpy(c->prefix, prefix, k);
+            c->prefixLen += n->prefixLen + 1u;
+        }
+        *ref = child;
+        FreeNode(art, n);
+        return;
+    }
+
+    if (n->n > SHRINK_AT[n->type]) {
+        return;
+    }
+    /* NOTE: slab memory is kept until deinit, so shrinking into a new chunk
+     *       would not save anything. Only already allocated memory is
+     *       reused, which also keeps removal from failing */
+    m = NewNode(MIR_FailRealloc, art, n->type - 1u);
+    if (m == NULL) {
+        return;
+    }
+    CopyHeader(m, n);
+    m->n = 0;
+    while ((child = NextChild(n, &pos, &b)) != NULL) {
+        AddChild(m, b, child);
+    }
+    FreeNode(art, n);
+    *ref = m;
+}
+
+
+/* NOTE: frees the leaf or the term of the node and links the node into the
+ *       list of nodes to visit through the term, so no stack is needed */
+static struct Node *
+FreeOrLink(void (*freeF)(void *), struct Node *list, void *p) {
+    struct Node *n;
+
+    if (p == NULL) {
+        return list;
+    }
+    if (IS_LEAF(p)) {
+        freeF(AS_LEAF(p));
+        return list;
+    }
+    n = (struct Node *)p;
+    if (n->term != NULL) {
+        freeF(n->term);
+    }
+    n->term = (struct Leaf *)(void *)list;
+    return n;
+}
+
+
+void MIR_Art_Init(struct MIR_Art *art) {
+    unsigned i;
+
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+
+    art->root = NULL;
+    art->len = 0;
+    art->maxKeyLen = 0;
+    for (i = 0; i < 4u; ++i) {
+        MIR_Slab_Init(&art->slabs[i], NODE_SIZES[i], CHUNK_OBJS[i]);
+    }
+}
+
+void **MIR_Art_Find(const struct MIR_Art *art, const void *key_, size_t len) {
+    const unsigned char *key = (const unsigned char *)key_;
+    void *p;
+    struct Node *n;
+    struct Leaf *leaf;
+    void **slot;
+    size_t depth = 0;
+
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        key != NULL || len == 0u, "param `key' MUST NOT be NULL"
+    );
+
+    for (p = art->root; p != NULL; p = (slot != NULL) ? *slot : NULL) {
+        if (IS_LEAF(p)) {
+            leaf = AS_LEAF(p);
+            return LeafIs(leaf, key, len) ? &leaf->val : NULL;
+        }
+        n = (struct Node *)p;
+        if (n->prefixLen > 0u) {
+            if (!PrefixMayMatch(n, key, len, depth)) {
+                return NULL;
+            }
+            depth += n->prefixLen;
+        }
+        if (depth == len) {
+            return (n->term != NULL && LeafIs(n->term, key, len))
+                       ? &n->term->val
+                       : NULL;
+        }
+        slot = FindChild(n, key[depth++]);
+    }
+    return NULL;
+}
+
+void **MIR_Art_LongestPrefix(
+    const struct MIR_Art *art, const void *key_, size_t len, size_t *prefixLen
+) {
+    const unsigned char *key = (const unsigned char *)key_;
+    struct Leaf *best = NULL;
+    struct Leaf *leaf;
+    struct Node *n;
+    void **slot;
+    void *p;
+    size_t depth = 0;
+
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        key != NULL || len == 0u, "param `key' MUST NOT be NULL"
+    );
+
+    for (p = art->root; p != NULL; p = (slot != NULL) ? *slot : NULL) {
+        if (IS_LEAF(p)) {
+            leaf = AS_LEAF(p);
+            if (leaf->len <= len && BytesEq(leaf->key, key, leaf->len)) {
+                best = leaf;
+            }
+            break;
+        }
+        /* NOTE: the prefixes are checked exactly, so a term on the way is
+         *       a prefix of the key */
+        n = (struct Node *)p;
+        if (n->prefixLen > 0u) {
+            if (PrefixMismatch(n, key, len, depth) < n->prefixLen) {
+                break;
+            }
+            depth += n->prefixLen;
+        }
+        if (n->term != NULL) {
+            best = n->term;
+        }
+        if (depth == len) {
+            break;
+        }
+        slot = FindChild(n, key[depth++]);
+    }
+
+    if (best == NULL) {
+        return NULL;
+    }
+    if (prefixLen != NULL) {
+        *prefixLen = best->len;
+    }
+    return &best->val;
+}
+
+int MIR_Art_PutByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Art *art, const void *key_,
+    size_t len, void *val
+) {
+    const unsigned char *key = (const unsigned char *)key_;
+    void **ref;
+    struct Leaf *leaf;
+    struct Leaf *old;
+    struct Node *n;
+    struct Node *m;
+    void **slot;
+    size_t depth = 0;
+    size_t max;
+    size_t i;
+    unsigned char b;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        key != NULL || len == 0u, "param `key' MUST NOT be NULL"
+    );
+
+    if (len >= UINT32_MAX) {
+        return 1;
+    }
+
+    /* NOTE: every allocation is done before the tree is modified. Nodes come
+     *       first since they can be returned to the slab without `freeF' */
+    for (ref = &art->root;; ref = slot, ++depth) {
+        if (*ref == NULL) {
+            leaf = NewLeaf(reallocF, key, len, val);
+            if (leaf == NULL) {
+                return 1;
+            }
+            *ref = TAG_LEAF(leaf);
+            break;
+        }
+
+        if (IS_LEAF(*ref)) {
+            old = AS_LEAF(*ref);
+            if (LeafIs(old, key, len)) {
+                old->val = val;
+                return MIR_Art_OK;
+            }
+            /* NOTE: lazy expansion - the leaf is split only now that another
+             *       key shares its path */
+            max = MIN(old->len, len);
+            for (i = depth; i < max && old->key[i] == key[i]; ++i) {
+            }
+            m = NewNode(reallocF, art, NODE4);
+            if (m == NULL) {
+                return 1;
+            }
+            leaf = NewLeaf(reallocF, key, len, val);
+            if (leaf == NULL) {
+                FreeNode(art, m);
+                return 1;
+            }
+            m->prefixLen = (uint32_t)(i - depth);
+            memcpy(m->prefix, key + depth, MIN(i - depth, MAX_PREFIX));
+            PlaceLeaf(m, old, i);
+            PlaceLeaf(m, leaf, i);
+            *ref = m;
+            break;
+        }
+
+        n = (struct Node *)*ref;
+        if (n->prefixLen > 0u) {
+            i = PrefixMismatch(n, key, len, depth);
+            if (i < n->prefixLen) {
+                m = NewNode(reallocF, art, NODE4);
+                if (m == NULL) {
+                    return 1;
+                }
+                leaf = NewLeaf(reallocF, key, len, val);
+                if (leaf == NULL) {
+                    FreeNode(art, m);
+                    return 1;
+                }
+                m->prefixLen = (uint32_t)i;
+                memcpy(m->prefix, n->prefix, MIN(i, MAX_PREFIX));
+                if (n->prefixLen <= MAX_PREFIX) {
+                    b = n->prefix[i];
+                    memmove(
+                        n->prefix, n->prefix + i + 1, n->prefixLen - i - 1u
+                    );
+                } else {
+                    old = MinLeaf(n);
+                    b = old->key[depth + i];
+                    memcpy(
+                        n->prefix, old->key + depth + i + 1,
+                        MIN(n->prefixLen - i - 1u, MAX_PREFIX)
+                    );
+                }
+                n->prefixLen -= (uint32_t)(i + 1u);
+                AddChild(m, b, n);
+                PlaceLeaf(m, leaf, depth + i);
+                *ref = m;
+                break;
+            }
+            depth += n->prefixLen;
+        }
+
+        if (depth == len) {
+            if (n->term != NULL) {
+                n->term->val = val;
+                return MIR_Art_OK;
+            }
+            leaf = NewLeaf(reallocF, key, len, val);
+            if (leaf == NULL) {
+                return 1;
+            }
+            n->term = leaf;
+            break;
+        }
+
+        slot = FindChild(n, key[depth]);
+        if (slot == NULL) {
+            if (n->n == NODE_CAPS[n->type] &&
+                Grow(reallocF, art, ref) != MIR_Art_OK) {
+                return 1;
+            }
+            leaf = NewLeaf(reallocF, key, len, val);
+            if (leaf == NULL) {
+                return 1;
+            }
+            AddChild((struct Node *)*ref, key[depth], TAG_LEAF(leaf));
+            break;
+        }
+    }
+
+    ++art->len;
+    if (len > art->maxKeyLen) {
+        art->maxKeyLen = len;
+    }
+    return MIR_Art_OK;
+}
+
+int MIR_Art_RemoveByFreeF(
+    void (*freeF)(void *), struct MIR_Art *art, const void *key_, size_t len,
+    void **val
+) {
+    const unsigned char *key = (const unsigned char *)key_;
+    void **ref = &art->root;
+    void **nodeRef = NULL;
+    struct Leaf *leaf;
+    struct Node *n;
+    size_t depth = 0;
+
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        key != NULL || len == 0u, "param `key' MUST NOT be NULL"
+    );
+
+    for (;;) {
+        if (*ref == NULL) {
+            return 1;
+        }
+
+        if (IS_LEAF(*ref)) {
+            leaf = AS_LEAF(*ref);
+            if (!LeafIs(leaf, key, len)) {
+                return 1;
+            }
+            if (nodeRef == NULL) {
+                *ref = NULL;
+            } else {
+                RemoveChild((struct Node *)*nodeRef, key[depth - 1u], ref);
+                Compact(art, nodeRef);
+            }
+            break;
+        }
+
+        n = (struct Node *)*ref;
+        if (n->prefixLen > 0u) {
+            if (!PrefixMayMatch(n, key, len, depth)) {
+                return 1;
+            }
+            depth += n->prefixLen;
+        }
+        if (depth == len) {
+            leaf = n->term;
+            if (leaf == NULL || !LeafIs(leaf, key, len)) {
+                return 1;
+            }
+            n->term = NULL;
+            Compact(art, ref);
+            break;
+        }
+
+        nodeRef = ref;
+        ref = FindChild(n, key[depth++]);
+        if (ref == NULL) {
+            return 1;
+        }
+    }
+
+    if (val != NULL) {
+        *val = leaf->val;
+    }
+    freeF(leaf);
+    --art->len;
+    return MIR_Art_OK;
+}
+
+int MIR_Art_PrefixIterByReallocF(
+    void *(*reallocF)(void *, size_t), const struct MIR_Art *art,
+    const void *prefix_, size_t len, struct MIR_Art_Iter *iter
+) {
+    const unsigned char *prefix = (const unsigned char *)prefix_;
+    const struct Leaf *leaf;
+    struct Node *n = NULL;
+    void **slot;
+    void *p;
+    size_t depth = 0;
+    size_t frames;
+    size_t i;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        prefix != NULL || len == 0u, "param `prefix' MUST NOT be NULL"
+    );
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    iter->frames = NULL;
+    iter->depth = 0;
+    iter->leaf = NULL;
+
+    for (p = art->root; p != NULL; p = (slot != NULL) ? *slot : NULL) {
+        if (IS_LEAF(p)) {
+            leaf = AS_LEAF(p);
+            if (leaf->len >= len && BytesEq(leaf->key, prefix, len)) {
+                iter->leaf = leaf;
+            }
+            return MIR_Art_OK;
+        }
+        n = (struct Node *)p;
+        if (n->prefixLen > 0u) {
+            i = PrefixMismatch(n, prefix, len, depth);
+            if (depth + i == len) {
+                break;
+            }
+            if (i < n->prefixLen) {
+                return MIR_Art_OK;
+            }
+            depth += n->prefixLen;
+        }
+        if (depth == len) {
+            break;
+        }
+        slot = FindChild(n, prefix[depth++]);
+    }
+    if (p == NULL) {
+        return MIR_Art_OK;
+    }
+
+    /* NOTE: every inner node below consumes a key byte, so a path from `n'
+     *       to a leaf has at most `maxKeyLen - depth + 1' of them. It also
+     *       has fewer than `len' of them, as each inner node has more keys
+     *       below it than its inner child. `maxKeyLen' never shrinks, so the
+     *       second bound matters once a long key has been removed */
+    frames = art->maxKeyLen - depth + 1u;
+    if (frames > art->len) {
+        frames = art->len;
+    }
+    if (MIR_u_Mul_WillOverflow(frames, sizeof(*iter->frames), SIZE_MAX)) {
+        return 1;
+    }
+    iter->frames = (struct MIR_Art_Frame *)reallocF(
+        NULL, frames * sizeof(*iter->frames)
+    );
+    if (iter->frames == NULL) {
+        return 1;
+    }
+    iter->frames[0].node = n;
+    iter->frames[0].pos = 0;
+    iter->depth = 1;
+    return MIR_Art_OK;
+}
+
+int MIR_Art_IterNext(
+    struct MIR_Art_Iter *iter, struct MIR_UTF8_BufIter *key, void **val
+) {
+    const struct Leaf *leaf = NULL;
+    struct MIR_Art_Frame *f;
+    const struct Node *n;
+    unsigned char b;
+    unsigned pos;
+    void *child;
+
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    if (iter->leaf != NULL) {
+        leaf = (const struct Leaf *)iter->leaf;
+        iter->leaf = NULL;
+    }
+    while (leaf == NULL && iter->depth > 0u) {
+        f = &iter->frames[iter->depth - 1u];
+        n = (const struct Node *)f->node;
+        if (f->pos == 0u) {
+            f->pos = 1;
+            if (n->term != NULL) {
+                leaf = n->term;
+                break;
+            }
+        }
+        pos = f->pos - 1u;
+        child = NextChild(n, &pos, &b);
+        f->pos = pos + 1u;
+        if (child == NULL) {
+            --iter->depth;
+        } else if (IS_LEAF(child)) {
+            leaf = AS_LEAF(child);
+        } else {
+            iter->frames[iter->depth].node = child;
+            iter->frames[iter->depth].pos = 0;
+            ++iter->depth;
+        }
+    }
+    if (leaf == NULL) {
+        return 1;
+    }
+
+    if (key != NULL) {
+        key->buf = leaf->key;
+        key->cur = key->buf;
+        key->lim = key->buf + leaf->len;
+        key->replVal = MIR_REPLACEMENT_CHARACTER_CP;
+        key->eofVal = UINT_LEAST32_MAX;
+    }
+    if (val != NULL) {
+        *val = leaf->val;
+    }
+    return MIR_Art_OK;
+}
+
+void
+MIR_Art_IterDeinitByFreeF(void (*freeF)(void *), struct MIR_Art_Iter *iter) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    if (iter->frames != NULL) {
+        freeF(iter->frames);
+    }
+    iter->frames = NULL;
+    iter->depth = 0;
+    iter->leaf = NULL;
+}
+
+void MIR_Art_DeinitByFreeF(void (*freeF)(void *), struct MIR_Art *art) {
+    struct Node *list = NULL;
+    struct Node *n;
+    unsigned pos;
+    unsigned char b;
+    void *child;
+    unsigned i;
+
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(art != NULL, "param `art' MUST NOT be NULL");
+
+    /* NOTE: the leaves are freed one by one while the nodes go away with the
+     *       slabs */
+    list = FreeOrLink(freeF, list, art->root);
+    while (list != NULL) {
+        n = list;
+        list = (struct Node *)(void *)n->term;
+        pos = 0;
+        while ((child = NextChild(n, &pos, &b)) != NULL) {
+            list = FreeOrLink(freeF, list, child);
+        }
+    }
+
+    for (i = 0; i < 4u; ++i) {
+        MIR_Slab_DeinitByFreeF(freeF, &art->slabs[i]);
+    }
+    MIR_Art_Init(art);
+}
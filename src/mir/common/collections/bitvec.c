@@ -0,0 +1,355 @@
+#include <mir/common/collections/bitvec.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, uint64_t */
+#include <string.h> /* memset */
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#    include <immintrin.h> /* _mm256_*, _pdep_u64 */
+#elif defined(__SSE2__)
+#    include <emmintrin.h> /* _mm_* */
+#endif
+
+#include <mir/common/bits.h> /* MIR_Bits_Ctz64, MIR_Bits_Popcount64 */
+
+
+#define WORDS(nbits) ((nbits) / 64u + ((nbits) % 64u != 0u))
+
+#define BLOCK_WORDS (MIR_BITVEC_BLOCK_BITS / 64u)
+
+
+/* NOTE: clears the bits of the last word past `len' */
+static void ClearTail(struct MIR_BitVec *bv) {
+    if (bv->len % 64u != 0u) {
+        bv->words[bv->len / 64u] &= ((uint64_t)1 << (bv->len % 64u)) - 1u;
+    }
+}
+
+/* NOTE: returns the position of the set bit number `r' of `w' */
+static unsigned SelectInWord(uint64_t w, unsigned r) {
+#ifdef __BMI2__
+    return MIR_Bits_Ctz64(_pdep_u64((uint64_t)1 << r, w));
+#else
+    for (; r != 0u; --r) {
+        w &= w - 1u;
+    }
+    return MIR_Bits_Ctz64(w);
+#endif
+}
+
+
+int MIR_BitVec_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, size_t nbits
+) {
+    uint64_t *words;
+    size_t cap = WORDS(nbits);
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    if (cap <= bv->cap) {
+        return MIR_BitVec_OK;
+    }
+    if (cap > SIZE_MAX / sizeof(uint64_t)) {
+        return 1;
+    }
+    words = (uint64_t *)reallocF(bv->words, cap * sizeof(uint64_t));
+    if (words == NULL) {
+        return 1;
+    }
+    bv->words = words;
+    bv->cap = cap;
+    return MIR_BitVec_OK;
+}
+
+int MIR_BitVec_ResizeByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, size_t nbits
+) {
+    size_t used;
+
+    if (MIR_BitVec_ReserveByReallocF(reallocF, bv, nbits) != MIR_BitVec_OK) {
+        return 1;
+    }
+    /* NOTE: the tail of the last word is already `0' */
+    used = WORDS(bv->len);
+    if (WORDS(nbits) > used) {
+        memset(
+            bv->words + used, 0, (WORDS(nbits) - used) * sizeof(uint64_t)
+        );
+    }
+    bv->len = nbits;
+    ClearTail(bv);
+    return MIR_BitVec_OK;
+}
+
+int MIR_BitVec_PushByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec *bv, int bit
+) {
+    size_t i;
+
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    i = bv->len;
+    if (i % 64u == 0u) {
+        if (i / 64u == bv->cap &&
+            MIR_BitVec_ReserveByReallocF(
+                reallocF, bv, (bv->cap == 0u) ? 64u : 2u * i
+            ) != MIR_BitVec_OK) {
+            return 1;
+        }
+        bv->words[i / 64u] = 0;
+    }
+    bv->words[i / 64u] |= (uint64_t)(bit != 0) << (i % 64u);
+    bv->len = i + 1u;
+    return MIR_BitVec_OK;
+}
+
+void MIR_BitVec_DeinitByFreeF(void (*freeF)(void *), struct MIR_BitVec *bv) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    if (bv->words != NULL) {
+        freeF(bv->words);
+    }
+    MIR_BitVec_Init(bv);
+}
+
+void MIR_BitVec_Fill(struct MIR_BitVec *bv, int bit) {
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    if (bv->len == 0u) {
+        return;
+    }
+    memset(bv->words, (bit != 0) ? 0xff : 0, WORDS(bv->len) * sizeof(uint64_t));
+    ClearTail(bv);
+}
+
+/* NOTE: defines an in-place bulk operation. `SSE' and `AVX' are the
+ *       intrinsics computing `EXPR(d, s)' on vector registers */
+#define BULK_OP(name, EXPR, SSE, AVX)                                          \
+    void MIR_BitVec_##name(                                                    \
+        struct MIR_BitVec *dst, const struct MIR_BitVec *src                   \
+    ) {                                                                        \
+        uint64_t *d;                                                           \
+        const uint64_t *s;                                                     \
+        size_t n;                                                              \
+        size_t i = 0;                                                          \
+                                                                               \
+        __MIR_ASSERT_MSG(dst != NULL, "param `dst' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(src != NULL, "param `src' MUST NOT be NULL");         \
+        __MIR_ASSERT_MSG(                                                      \
+            dst->len == src->len, "the lengths MUST be equal"                  \
+        );                                                                     \
+                                                                               \
+        d = dst->words;                                                        \
+        s = src->words;                                                        \
+        n = WORDS(dst->len);                                                   \
+        BULK_AVX(AVX);                                                         \
+        BULK_SSE(SSE);                                                         \
+        for (; i < n; ++i) {                                                   \
+            d[i] = EXPR(d[i], s[i]);                                           \
+        }                                                                      \
+    }
+
+#ifdef __AVX2__
+#    define BULK_AVX(op)                                                       \
+        for (; i + 4u <= n; i += 4u) {                                         \
+            _mm256_storeu_si256(                                               \
+                (__m256i *)(void *)(d + i),                                    \
+                op(_mm256_loadu_si256((const __m256i *)(const void *)(d + i)), \
+                   _mm256_loadu_si256((const __m256i *)(const void *)(s + i))) \
+            );                                                                 \
+        }
+#else
+#    define BULK_AVX(op) ((void)0)
+#endif
+
+#ifdef __SSE2__
+#    define BULK_SSE(op)                                                       \
+        for (; i + 2u <= n; i += 2u) {                                         \
+            _mm_storeu_si128(                                                  \
+                (__m128i *)(void *)(d + i),                                    \
+                op(_mm_loadu_si128((const __m128i *)(const void *)(d + i)),    \
+                   _mm_loadu_si128((const __m128i *)(const void *)(s + i)))    \
+            );                                                                 \
+        }
+#else
+#    define BULK_SSE(op) ((void)0)
+#endif
+
+#define AND(a, b) ((a) & (b))
+#define OR(a, b) ((a) | (b))
+#define XOR(a, b) ((a) ^ (b))
+#define ANDNOT(a, b) ((a) & ~(b))
+
+/* NOTE: `_mm_andnot_si128(a, b)' is `~a & b' */
+#define SSE_ANDNOT(a, b) _mm_andnot_si128((b), (a))
+#define AVX_ANDNOT(a, b) _mm256_andnot_si256((b), (a))
+
+BULK_OP(And, AND, _mm_and_si128, _mm256_and_si256)
+BULK_OP(Or, OR, _mm_or_si128, _mm256_or_si256)
+BULK_OP(Xor, XOR, _mm_xor_si128, _mm256_xor_si256)
+BULK_OP(AndNot, ANDNOT, SSE_ANDNOT, AVX_ANDNOT)
+
+size_t MIR_BitVec_Count(const struct MIR_BitVec *bv) {
+    size_t n;
+    size_t i;
+    size_t c0 = 0;
+    size_t c1 = 0;
+
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    /* NOTE: two independent sums keep both popcount units busy */
+    n = WORDS(bv->len);
+    for (i = 0; i + 2u <= n; i += 2u) {
+        c0 += MIR_Bits_Popcount64(bv->words[i]);
+        c1 += MIR_Bits_Popcount64(bv->words[i + 1u]);
+    }
+    if (i < n) {
+        c0 += MIR_Bits_Popcount64(bv->words[i]);
+    }
+    return c0 + c1;
+}
+
+size_t MIR_BitVec_FindNext(const struct MIR_BitVec *bv, size_t from) {
+    size_t n;
+    size_t i;
+    uint64_t w;
+
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    if (from >= bv->len) {
+        return bv->len;
+    }
+    n = WORDS(bv->len);
+    i = from / 64u;
+    w = bv->words[i] & (~(uint64_t)0 << (from % 64u));
+    while (w == 0u) {
+        if (++i == n) {
+            return bv->len;
+        }
+        w = bv->words[i];
+    }
+    return i * 64u + MIR_Bits_Ctz64(w);
+}
+
+int MIR_BitVec_Index_BuildByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_BitVec_Index *idx,
+    const struct MIR_BitVec *bv
+) {
+    size_t nwords;
+    size_t ones;
+    size_t size;
+    size_t b;
+    size_t i;
+    size_t j = 0;
+    uint64_t sum = 0;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(idx != NULL, "param `idx' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(bv != NULL, "param `bv' MUST NOT be NULL");
+
+    nwords = WORDS(bv->len);
+    ones = MIR_BitVec_Count(bv);
+    idx->nblocks = (nwords + BLOCK_WORDS - 1u) / BLOCK_WORDS;
+    idx->nsamples = (ones + MIR_BITVEC_SELECT_SAMPLE - 1u) /
+                    MIR_BITVEC_SELECT_SAMPLE;
+
+    /* NOTE: both arrays share one block */
+    size = (idx->nblocks + 1u) * sizeof(uint64_t) +
+           (idx->nsamples + 1u) * sizeof(size_t);
+    idx->blocks = (uint64_t *)reallocF(NULL, size);
+    if (idx->blocks == NULL) {
+        return 1;
+    }
+    idx->samples = (size_t *)(void *)(idx->blocks + idx->nblocks + 1u);
+
+    for (b = 0; b < idx->nblocks; ++b) {
+        idx->blocks[b] = sum;
+        for (i = b * BLOCK_WORDS; i < nwords && i < (b + 1u) * BLOCK_WORDS;
+             ++i) {
+            sum += MIR_Bits_Popcount64(bv->words[i]);
+        }
+        for (; j < idx->nsamples &&
+               (uint64_t)j * MIR_BITVEC_SELECT_SAMPLE < sum;
+             ++j) {
+            idx->samples[j] = b;
+        }
+    }
+    idx->blocks[idx->nblocks] = sum;
+    idx->samples[idx->nsamples] = idx->nblocks;
+    return MIR_BitVec_Index_OK;
+}
+
+void MIR_BitVec_Index_DeinitByFreeF(
+    void (*freeF)(void *), struct MIR_BitVec_Index *idx
+) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(idx != NULL, "param `idx' MUST NOT be NULL");
+
+    freeF(idx->blocks);
+    idx->blocks = NULL;
+    idx->samples = NULL;
+    idx->nblocks = 0;
+    idx->nsamples = 0;
+}
+
+size_t MIR_BitVec_Rank(
+    const struct MIR_BitVec *bv, const struct MIR_BitVec_Index *idx, size_t pos
+) {
+    size_t b;
+    size_t i;
+    size_t r;
+
+    __MIR_ASSERT_MSG(
+        pos <= bv->len, "OOB: param `pos' MUST NOT be greater than bv->len"
+    );
+
+    b = pos / MIR_BITVEC_BLOCK_BITS;
+    r = (size_t)idx->blocks[b];
+    for (i = b * BLOCK_WORDS; i < pos / 64u; ++i) {
+        r += MIR_Bits_Popcount64(bv->words[i]);
+    }
+    if (pos % 64u != 0u) {
+        r += MIR_Bits_Popcount64(
+            bv->words[i] & (((uint64_t)1 << (pos % 64u)) - 1u)
+        );
+    }
+    return r;
+}
+
+size_t MIR_BitVec_Select(
+    const struct MIR_BitVec *bv, const struct MIR_BitVec_Index *idx, size_t k
+) {
+    size_t lo;
+    size_t hi;
+    size_t mid;
+    size_t i;
+    size_t r;
+    unsigned c;
+
+    if (k >= idx->blocks[idx->nblocks]) {
+        return bv->len;
+    }
+
+    /* NOTE: the last block `b' in the sample range with `blocks[b] <= k' */
+    lo = idx->samples[k / MIR_BITVEC_SELECT_SAMPLE];
+    hi = idx->samples[k / MIR_BITVEC_SELECT_SAMPLE + 1u];
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1u) / 2u;
+        if (idx->blocks[mid] <= k) {
+            lo = mid;
+        } else {
+            hi = mid - 1u;
+        }
+    }
+
+    r = k - (size_t)idx->blocks[lo];
+    for (i = lo * BLOCK_WORDS;; ++i) {
+        c = MIR_Bits_Popcount64(bv->words[i]);
+        if (r < c) {
+            return i * 64u + SelectInWord(bv->words[i], (unsigned)r);
+        }
+        r -= c;
+    }
+}
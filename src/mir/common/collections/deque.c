@@ -0,0 +1,180 @@
+#include <mir/common/collections/deque.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <string.h> /* memcpy */
+#if __STDC_VERSION__ >= 199901L
+#    include <stdint.h> /* SIZE_MAX */
+#endif
+
+#include <mir/common/arith.h> /* MIR_u_Mul_WillOverflow */
+
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items using
+ * giving realloc-like function and unwraps the ring.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than
+ * `*member_cap`. Otherwise `new_capacity` is rounded up to a power of two.
+ *
+ * \param[in]     realloc_f    realloc-like function to be used
+ * \param[in,out] member_data  pointer to `data` member
+ * \param[in,out] member_head  pointer to `head` member
+ * \param[in,out] member_cap   pointer to `cap` member
+ * \param         len          `len` member
+ * \param         new_capacity new capacity. **MAY** be `0`
+ * \param         elemSize     size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_Deque_OK on success; `1` on failure
+ */
+int __MIR_Deque_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t *member_head,
+    size_t *member_cap, size_t len, size_t new_capacity, size_t elemSize
+) {
+    unsigned char *new_ptr;
+    size_t cap = *member_cap;
+    size_t head = *member_head;
+    size_t capacity;
+    size_t headRun;
+    size_t tailRun;
+
+    if (new_capacity <= cap) {
+        return MIR_Deque_OK;
+    }
+
+    capacity = 1;
+    while (capacity < new_capacity) {
+        if (capacity > SIZE_MAX / 2u) {
+            return 1;
+        }
+        capacity *= 2u;
+    }
+    if (MIR_u_Mul_WillOverflow(capacity, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+
+    /* NOTE: see `__MIR_Vec_ReserveByReallocF_impl` on why the size is never
+     *       `0` here */
+    new_ptr = (unsigned char *)realloc_f(*member_data, capacity * elemSize);
+    if (new_ptr == NULL) {
+        return 1;
+    }
+
+    /* NOTE: the ring was `[head, cap)` + `[0, tailRun)`. As `capacity >=
+     *       2 * cap`, either run fits right after/before the other one */
+    if (head + len > cap) {
+        headRun = cap - head;
+        tailRun = len - headRun;
+        if (tailRun <= headRun) {
+            memcpy(new_ptr + cap * elemSize, new_ptr, tailRun * elemSize);
+        } else {
+            memcpy(
+                new_ptr + (capacity - headRun) * elemSize,
+                new_ptr + head * elemSize, headRun * elemSize
+            );
+            head = capacity - headRun;
+        }
+    }
+
+    *member_data = new_ptr;
+    *member_head = head;
+    *member_cap = capacity;
+    return MIR_Deque_OK;
+}
+
+/**
+ * \brief Describes `n` slots starting at the (unmasked) ring index `start` as
+ * spans.
+ *
+ * \param[in]  data     `data` member
+ * \param      cap      `cap` member. **MUST** be a power of two if `n` isn't
+ *                      `0`
+ * \param      start    ring index of the first slot. It's masked by `cap - 1`
+ * \param      n        number of slots. **MUST NOT** be greater than `cap`
+ * \param      elemSize size of element
+ * \param[out] spans    resulting spans
+ */
+void __MIR_Deque_Spans_impl(
+    void *data, size_t cap, size_t start, size_t n, size_t elemSize,
+    struct MIR_Deque_Spans *spans
+) {
+    if (n == 0u) {
+        spans->first = NULL;
+        spans->firstLen = 0;
+        spans->second = NULL;
+        spans->secondLen = 0;
+        return;
+    }
+
+    start &= cap - 1u;
+    spans->first = (unsigned char *)data + start * elemSize;
+    if (n <= cap - start) {
+        spans->firstLen = n;
+        spans->second = NULL;
+        spans->secondLen = 0;
+    } else {
+        spans->firstLen = cap - start;
+        spans->second = data;
+        spans->secondLen = n - (cap - start);
+    }
+}
+
+/**
+ * \brief Removes up to `n` elements from the front and describes them as
+ * spans.
+ *
+ * \return number of removed elements
+ */
+size_t __MIR_Deque_PopFrontN_impl(
+    void *data, size_t *member_head, size_t *member_len, size_t cap, size_t n,
+    size_t elemSize, struct MIR_Deque_Spans *spans
+) {
+    if (n > *member_len) {
+        n = *member_len;
+    }
+
+    __MIR_Deque_Spans_impl(data, cap, *member_head, n, elemSize, spans);
+    if (n != 0u) {
+        *member_head = (*member_head + n) & (cap - 1u);
+        *member_len -= n;
+    }
+    return n;
+}
+
+/**
+ * \brief Copies elements between the spans and the array.
+ *
+ * \param[in] spans    spans
+ * \param     arr      array of at least `firstLen + secondLen` elements
+ * \param     toSpans  non-zero to copy from the array to the spans, `0` to
+ *                     copy from the spans to the array
+ * \param     elemSize size of element
+ */
+void __MIR_Deque_CopySpans_impl(
+    const struct MIR_Deque_Spans *spans, void *arr, int toSpans,
+    size_t elemSize
+) {
+    unsigned char *second;
+
+    if (spans->secondLen == 0u) {
+        second = NULL;
+    } else {
+        second = (unsigned char *)arr + spans->firstLen * elemSize;
+    }
+
+    if (toSpans != 0) {
+        if (spans->firstLen != 0u) {
+            memcpy(spans->first, arr, spans->firstLen * elemSize);
+        }
+        if (spans->secondLen != 0u) {
+            memcpy(spans->second, second, spans->secondLen * elemSize);
+        }
+    } else {
+        if (spans->firstLen != 0u) {
+            memcpy(arr, spans->first, spans->firstLen * elemSize);
+        }
+        if (spans->secondLen != 0u) {
+            memcpy(second, spans->second, spans->secondLen * elemSize);
+        }
+    }
+}
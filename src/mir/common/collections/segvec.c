@@ -0,0 +1,61 @@
+#include <mir/common/collections/segvec.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/* NOTE: the capacity is always `F * (2^n - 1)' for `n' segments, i.e. it's
+ *       the index of the first element of segment `n' */
+#define SegCount(cap) __MIR_SegVec_Seg(cap)
+
+
+int __MIR_SegVec_ReserveByReallocF_impl(
+    void *(*reallocF)(void *, size_t), void **member_segs, size_t *member_cap,
+    size_t new_capacity, size_t elemSize
+) {
+    size_t seg;
+    size_t seg_len;
+    void *ptr;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(elemSize > 0u, "param `elemSize' MUST be greater than 0");
+
+    while (*member_cap < new_capacity) {
+        seg = SegCount(*member_cap);
+        seg_len = MIR_SegVec_SegLen(seg);
+        if (seg + 1u >= MIR_SEGVEC_MAX_SEGS ||
+            MIR_u_Mul_WillOverflow(seg_len, elemSize, SIZE_MAX) != 0) {
+            return 1;
+        }
+
+        /* NOTE: `reallocF(NULL, ..)' is `malloc(..)' and the size is > 0 */
+        ptr = reallocF(NULL, seg_len * elemSize);
+        if (ptr == NULL) {
+            return 1;
+        }
+        member_segs[seg] = ptr;
+        *member_cap += seg_len;
+    }
+    return MIR_SegVec_OK;
+}
+
+void __MIR_SegVec_ShrinkByFreeF_impl(
+    void (*freeF)(void *), void **member_segs, size_t *member_cap, size_t len
+) {
+    size_t keep = (len == 0u) ? 0u : __MIR_SegVec_Seg(len - 1u) + 1u;
+    size_t seg = SegCount(*member_cap);
+
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        len <= *member_cap, "param `len' MUST NOT be greater than `*member_cap'"
+    );
+
+    while (seg > keep) {
+        freeF(member_segs[--seg]);
+        *member_cap -= MIR_SegVec_SegLen(seg);
+    }
+}
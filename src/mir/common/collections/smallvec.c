@@ -0,0 +1,66 @@
+#include <mir/common/collections/smallvec.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <string.h> /* memcpy */
+#if __STDC_VERSION__ >= 199901L
+#    include <stdint.h> /* SIZE_MAX */
+#endif
+
+#include <mir/common/arith.h> /* MIR_u_Mul_WillOverflow */
+
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items using
+ * giving realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than
+ * `*member_cap`. If `*member_data` points to `member_buf` the elements are
+ * copied to a newly allocated array.
+ *
+ * \param[in]     realloc_f    realloc-like function to be used
+ * \param[in,out] member_data  pointer to `data` member
+ * \param[in,out] member_cap   pointer to `cap` member
+ * \param[in]     member_buf   pointer to the first element of `buf` member
+ * \param         len          value of `len` member
+ * \param         new_capacity new capacity
+ * \param         elemSize     size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_SmallVec_OK on success; `1` on failure
+ */
+int __MIR_SmallVec_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t *member_cap,
+    void *member_buf, size_t len, size_t new_capacity, size_t elemSize
+) {
+    void *new_ptr;
+    size_t new_size;
+
+    if (new_capacity <= *member_cap) {
+        return MIR_SmallVec_OK;
+    }
+
+    if (MIR_u_Mul_WillOverflow(new_capacity, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+    new_size = new_capacity * elemSize;
+
+    /* NOTE: `new_size > 0` as `new_capacity > *member_cap >= N > 0` and
+     *       `elemSize > 0`. See `__MIR_Vec_ReserveByReallocF_impl` */
+    if (*member_data == member_buf) {
+        new_ptr = realloc_f(NULL, new_size);
+        if (new_ptr == NULL) {
+            return 1;
+        }
+        /* NOTE: `len * elemSize` can't overflow as `len <= N` */
+        memcpy(new_ptr, member_buf, len * elemSize);
+    } else {
+        new_ptr = realloc_f(*member_data, new_size);
+        if (new_ptr == NULL) {
+            return 1;
+        }
+    }
+
+    *member_data = new_ptr;
+    *member_cap = new_capacity;
+    return MIR_SmallVec_OK;
+}
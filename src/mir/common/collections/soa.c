@@ -0,0 +1,83 @@
+#include <mir/common/collections/soa.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+#include <string.h> /* memmove */
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/* NOTE: offset of column `k' for the given capacity; `1' on overflow */
+static int ColumnOffset(
+    const size_t *sizes, size_t k, size_t capacity, size_t *offset
+) {
+    size_t off = 0;
+    size_t bytes;
+    size_t j;
+
+    for (j = 0; j < k; ++j) {
+        if (MIR_u_Mul_WillOverflow(capacity, sizes[j], SIZE_MAX) != 0) {
+            return 1;
+        }
+        bytes = capacity * sizes[j];
+        if (bytes > SIZE_MAX - (MIR_SOA_ALIGN - 1u) - off) {
+            return 1;
+        }
+        off += (bytes + (MIR_SOA_ALIGN - 1u)) & ~(size_t)(MIR_SOA_ALIGN - 1u);
+    }
+    *offset = off;
+    return MIR_SoA_OK;
+}
+
+int __MIR_SoA_ReserveByReallocF_impl(
+    void *(*reallocF)(void *, size_t), void **member_block, size_t *member_cap,
+    size_t len, size_t new_capacity, const size_t *sizes, size_t nfields,
+    size_t *offsets
+) {
+    unsigned char *block;
+    size_t old_offset;
+    size_t new_size;
+    size_t k;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(nfields > 0u, "param `nfields' MUST be greater than 0");
+    __MIR_ASSERT_MSG(
+        new_capacity > *member_cap,
+        "param `new_capacity' MUST be greater than `*member_cap'"
+    );
+    __MIR_ASSERT_MSG(
+        len <= *member_cap, "param `len' MUST NOT be greater than `*member_cap'"
+    );
+
+    /* NOTE: the size of the block is the offset of a column past the last */
+    if (ColumnOffset(sizes, nfields, new_capacity, &new_size) != MIR_SoA_OK) {
+        return 1;
+    }
+
+    /* NOTE: `new_size > 0' as `new_capacity > 0' and all sizes are > 0 */
+    block = (unsigned char *)reallocF(*member_block, new_size);
+    if (block == NULL) {
+        return 1;
+    }
+
+    /* NOTE: every column moves towards the end of the block, so moving them
+     *       from the last one keeps the not yet moved ones intact: the new
+     *       place of column `k' ends before the new place of column `k + 1',
+     *       and the old columns before `k' end before its old offset */
+    for (k = nfields; k-- > 0u;) {
+        (void)ColumnOffset(sizes, k, new_capacity, &offsets[k]);
+        if (len == 0u) {
+            continue;
+        }
+        (void)ColumnOffset(sizes, k, *member_cap, &old_offset);
+        if (old_offset != offsets[k]) {
+            memmove(block + offsets[k], block + old_offset, len * sizes[k]);
+        }
+    }
+
+    *member_block = block;
+    *member_cap = new_capacity;
+    return MIR_SoA_OK;
+}
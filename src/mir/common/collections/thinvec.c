@@ -0,0 +1,95 @@
+#include <mir/common/collections/thinvec.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT32_MAX */
+
+#include <mir/common/arith.h> /* MIR_u_*_WillOverflow */
+
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items using
+ * giving realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than the current
+ * capacity.
+ *
+ * \param[in]     realloc_f    realloc-like function to be used
+ * \param[in,out] member_data  pointer to `data` member
+ * \param         new_capacity new capacity. **MAY** be `0`
+ * \param         elemSize     size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_ThinVec_OK on success; `1` on failure (including the case
+ * when `new_capacity` is greater than `UINT32_MAX`)
+ */
+int __MIR_ThinVec_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t new_capacity,
+    size_t elemSize
+) {
+    union MIR_ThinVec_Header *hdr;
+    size_t new_size;
+
+    hdr = (*member_data == NULL) ? NULL
+                                 : (union MIR_ThinVec_Header *)*member_data - 1;
+
+    if (new_capacity <= ((hdr == NULL) ? 0u : hdr->h.cap)) {
+        return MIR_ThinVec_OK;
+    }
+
+    if (new_capacity > UINT32_MAX) {
+        return 1;
+    }
+
+    if (MIR_u_Mul_WillOverflow(new_capacity, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+    new_size = new_capacity * elemSize;
+    if (MIR_u_Add_WillOverflow(new_size, sizeof(*hdr)) != 0) {
+        return 1;
+    }
+    new_size += sizeof(*hdr);
+
+    hdr = (union MIR_ThinVec_Header *)realloc_f(hdr, new_size);
+    if (hdr == NULL) {
+        return 1;
+    }
+    if (*member_data == NULL) {
+        hdr->h.len = 0;
+    }
+    hdr->h.cap = (uint32_t)new_capacity;
+
+    *member_data = hdr + 1;
+    return MIR_ThinVec_OK;
+}
+
+/**
+ * \brief Doubles the capacity (clamping it to `UINT32_MAX`) using giving
+ * realloc-like function.
+ *
+ * \param[in]     realloc_f   realloc-like function to be used
+ * \param[in,out] member_data pointer to `data` member
+ * \param         elemSize    size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_ThinVec_OK on success; `1` on failure
+ */
+int __MIR_ThinVec_GrowByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data, size_t elemSize
+) {
+    size_t cap;
+
+    cap = (*member_data == NULL)
+              ? 0u
+              : ((union MIR_ThinVec_Header *)*member_data - 1)->h.cap;
+
+    if (cap == UINT32_MAX) {
+        return 1;
+    }
+
+    return __MIR_ThinVec_ReserveByReallocF_impl(
+        realloc_f, member_data,
+        (cap == 0u)                ? 1u
+        : (cap > UINT32_MAX / 2u) ? (size_t)UINT32_MAX
+                                   : cap * 2u,
+        elemSize
+    );
+}
@@ -60,3 +60,132 @@ int __MIR_Vec_ReserveByReallocF_impl(
     *member_cap = new_capacity;
     return MIR_Vec_OK;
 }
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items using
+ * giving aligned realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than
+ * `*member_cap`.
+ *
+ * \param[in]     aligned_realloc_f aligned realloc-like function to be used
+ * \param[in,out] member_data       pointer to `data` member
+ * \param[in,out] member_cap        pointer to `cap` member
+ * \param         new_capacity      new capacity. **MAY** be `0`
+ * \param         elemSize          size of element. **MUST** be greater than
+ *                                  `0`
+ * \param         alignment         alignment in bytes. **MUST** be a power of
+ *                                  two
+ *
+ * \return \ref MIR_Vec_OK on success; `1` on failure
+ */
+int __MIR_Vec_ReserveByAlignedReallocF_impl(
+    void *(*aligned_realloc_f)(void *, size_t, size_t), void **member_data,
+    size_t *member_cap, size_t new_capacity, size_t elemSize, size_t alignment
+) {
+    void *new_ptr;
+
+    if (new_capacity <= *member_cap) {
+        return MIR_Vec_OK;
+    }
+
+    if (MIR_u_Mul_WillOverflow(new_capacity, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+
+    /* NOTE: `new_capacity * elemSize > 0`. See
+     *       `__MIR_Vec_ReserveByReallocF_impl` */
+    new_ptr = aligned_realloc_f(
+        *member_data, alignment, new_capacity * elemSize
+    );
+    if (new_ptr == NULL) {
+        return 1;
+    }
+
+    *member_data = new_ptr;
+    *member_cap = new_capacity;
+    return MIR_Vec_OK;
+}
+
+/**
+ * \brief Shrinks the capacity to `capacity` (but not below `len`) using giving
+ * realloc-like and free-like functions.
+ *
+ * \details Does nothing if `capacity` is equal to or greater than
+ * `*member_cap`. If the resulting capacity is `0` the memory is freed.
+ *
+ * \param[in]     realloc_f   realloc-like function to be used
+ * \param[in]     free_f      free-like function to be used
+ * \param[in,out] member_data pointer to `data` member
+ * \param[in,out] member_cap  pointer to `cap` member
+ * \param         len         value of `len` member
+ * \param         capacity    desired capacity. **MAY** be `0`
+ * \param         elemSize    size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_Vec_OK on success; `1` on failure. On failure the members
+ * are left untouched
+ */
+int __MIR_Vec_ShrinkToByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void (*free_f)(void *),
+    void **member_data, size_t *member_cap, size_t len, size_t capacity,
+    size_t elemSize
+) {
+    void *new_ptr;
+
+    if (capacity < len) {
+        capacity = len;
+    }
+
+    if (capacity >= *member_cap) {
+        return MIR_Vec_OK;
+    }
+
+    /* NOTE: see `__MIR_Vec_ReserveByReallocF_impl` on why `realloc(.., 0)`
+     *       can't be used here */
+    if (capacity == 0u) {
+        free_f(*member_data);
+        *member_data = NULL;
+        *member_cap = 0;
+        return MIR_Vec_OK;
+    }
+
+    /* NOTE: can't overflow as `capacity < *member_cap` */
+    new_ptr = realloc_f(*member_data, capacity * elemSize);
+    if (new_ptr == NULL) {
+        return 1;
+    }
+
+    *member_data = new_ptr;
+    *member_cap = capacity;
+    return MIR_Vec_OK;
+}
+
+/**
+ * \brief Shrinks the capacity to `2 * len` if `len` dropped below
+ * `*member_cap / factor`.
+ *
+ * \details Shrinking is best effort, so failures are ignored.
+ *
+ * \param[in]     realloc_f   realloc-like function to be used
+ * \param[in]     free_f      free-like function to be used
+ * \param[in,out] member_data pointer to `data` member
+ * \param[in,out] member_cap  pointer to `cap` member
+ * \param         len         value of `len` member
+ * \param         factor      shrink factor. **MUST** be greater than `2`
+ * \param         elemSize    size of element. **MUST** be greater than `0`
+ */
+void __MIR_Vec_AutoShrinkByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void (*free_f)(void *),
+    void **member_data, size_t *member_cap, size_t len, size_t factor,
+    size_t elemSize
+) {
+    if (len >= *member_cap / factor) {
+        return;
+    }
+
+    /* NOTE: `2 * len` can't overflow as `len < *member_cap / factor` and
+     *       `factor > 2` */
+    (void)__MIR_Vec_ShrinkToByReallocF_impl(
+        realloc_f, free_f, member_data, member_cap, len, 2u * len, elemSize
+    );
+}
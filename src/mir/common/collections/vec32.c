@@ -0,0 +1,55 @@
+#include <mir/common/collections/vec32.h>
+
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT32_MAX */
+
+#include <mir/common/arith.h> /* MIR_u_Mul_WillOverflow */
+
+
+/**
+ * \brief Reserves enough space to hold at least `new_capacity` items using
+ * giving realloc-like function.
+ *
+ * \details Does nothing if `new_capacity` is equal to or less than
+ * `*member_cap`.
+ *
+ * \param[in]     realloc_f    realloc-like function to be used
+ * \param[in,out] member_data  pointer to `data` member
+ * \param[in,out] member_cap   pointer to `cap` member
+ * \param         new_capacity new capacity. **MAY** be `0`
+ * \param         elemSize     size of element. **MUST** be greater than `0`
+ *
+ * \return \ref MIR_Vec32_OK on success; `1` on failure (including the case
+ * when `new_capacity` is greater than `UINT32_MAX`)
+ */
+int __MIR_Vec32_ReserveByReallocF_impl(
+    void *(*realloc_f)(void *, size_t), void **member_data,
+    uint32_t *member_cap, size_t new_capacity, size_t elemSize
+) {
+    void *new_ptr;
+    size_t new_size;
+
+    if (new_capacity <= *member_cap) {
+        return MIR_Vec32_OK;
+    }
+
+    if (new_capacity > UINT32_MAX) {
+        return 1;
+    }
+
+    if (MIR_u_Mul_WillOverflow(new_capacity, elemSize, SIZE_MAX) != 0) {
+        return 1;
+    }
+    new_size = new_capacity * elemSize;
+
+    /* NOTE: `new_size > 0`. See `__MIR_Vec_ReserveByReallocF_impl` */
+    new_ptr = realloc_f(*member_data, new_size);
+    if (new_ptr == NULL) {
+        return 1;
+    }
+
+    *member_data = new_ptr;
+    *member_cap = (uint32_t)new_capacity;
+    return MIR_Vec32_OK;
+}
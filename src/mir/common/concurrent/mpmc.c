@@ -0,0 +1,227 @@
+/* NOTE: `syscall' is not declared in strict ISO C mode */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include <mir/common/concurrent/mpmc.h>
+
+#include <stddef.h> /* NULL, ptrdiff_t, size_t */
+#include <stdint.h> /* SIZE_MAX, uint32_t */
+#include <string.h> /* memcpy */
+
+#ifdef __linux__
+#    include <linux/futex.h> /* FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE */
+#    include <sys/syscall.h> /* SYS_futex */
+#    include <unistd.h>      /* syscall */
+#endif
+
+#include <mir/common/atomic.h>   /* MIR_Atomic_* */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/* NOTE: number of failed attempts before a blocking call parks the thread */
+#define SPIN_TRIES 128u
+
+#define SEQ_SIZE sizeof(MIR_Atomic(size_t))
+
+
+static MIR_Atomic(size_t) *SlotSeq(const struct MIR_MPMC *q, size_t pos) {
+    return (MIR_Atomic(size_t) *)(void *)(q->shared.s.slots +
+                                          (pos & q->shared.s.mask) *
+                                              q->shared.s.slotSize);
+}
+
+/* NOTE: sleeps until `ev->seq` changes from `key` (or spuriously) */
+static void Park(struct __MIR_MPMC_Event *ev, uint32_t key) {
+#ifdef __linux__
+    syscall(
+        SYS_futex, (void *)&ev->seq, FUTEX_WAIT_PRIVATE, key, NULL, NULL, 0
+    );
+#else
+    (void)ev;
+    (void)key;
+    MIR_Atomic_SpinPause();
+#endif
+}
+
+/* NOTE: wakes one parked thread, if any. The fence pairs with the one in
+ *       `Wait': either the waiter sees the new element/slot or this function
+ *       sees the waiter */
+static void Notify(struct __MIR_MPMC_Event *ev) {
+#ifdef __linux__
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+    if (MIR_Atomic_Load(&ev->waiters, MIR_ATOMIC_RELAXED) == 0u) {
+        return;
+    }
+    MIR_Atomic_FetchAdd(&ev->seq, 1u, MIR_ATOMIC_RELEASE);
+    syscall(SYS_futex, (void *)&ev->seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+    (void)ev;
+#endif
+}
+
+/* NOTE: pushes `elem' if `out' is `NULL' and pops into `out' otherwise */
+static int Try(struct MIR_MPMC *q, const void *elem, void *out) {
+    return (out == NULL) ? MIR_MPMC_TryPush(q, elem) : MIR_MPMC_TryPop(q, out);
+}
+
+/* NOTE: retries `Try' until it succeeds, parking on `ev' after `SPIN_TRIES'
+ *       failures */
+static void Wait(
+    struct MIR_MPMC *q, struct __MIR_MPMC_Event *ev, const void *elem,
+    void *out
+) {
+    unsigned spins;
+    uint32_t key;
+
+    for (spins = 0; spins < SPIN_TRIES; ++spins) {
+        if (Try(q, elem, out) == MIR_MPMC_OK) {
+            return;
+        }
+        MIR_Atomic_SpinPause();
+    }
+
+    for (;;) {
+        key = MIR_Atomic_Load(&ev->seq, MIR_ATOMIC_ACQUIRE);
+        MIR_Atomic_FetchAdd(&ev->waiters, 1u, MIR_ATOMIC_RELAXED);
+        MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+        if (Try(q, elem, out) == MIR_MPMC_OK) {
+            MIR_Atomic_FetchSub(&ev->waiters, 1u, MIR_ATOMIC_RELAXED);
+            return;
+        }
+        Park(ev, key);
+        MIR_Atomic_FetchSub(&ev->waiters, 1u, MIR_ATOMIC_RELAXED);
+    }
+}
+
+
+int MIR_MPMC_InitByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_MPMC *q, size_t capacity,
+    size_t elemSize
+) {
+    size_t cap = 2u;
+    size_t slotSize;
+    size_t i;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(q != NULL, "param `q' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(elemSize != 0u, "param `elemSize' MUST NOT be 0");
+
+    /* NOTE: slots are kept aligned for the sequence number */
+    if (elemSize > SIZE_MAX - 2u * SEQ_SIZE) {
+        return 1;
+    }
+    slotSize = (SEQ_SIZE + elemSize + SEQ_SIZE - 1u) / SEQ_SIZE * SEQ_SIZE;
+
+    while (cap < capacity) {
+        if (cap > SIZE_MAX / 2u) {
+            return 1;
+        }
+        cap *= 2u;
+    }
+    if (cap > SIZE_MAX / slotSize) {
+        return 1;
+    }
+    q->shared.s.slots = (unsigned char *)reallocF(NULL, cap * slotSize);
+    if (q->shared.s.slots == NULL) {
+        return 1;
+    }
+    q->shared.s.mask = cap - 1u;
+    q->shared.s.slotSize = slotSize;
+    q->shared.s.elemSize = elemSize;
+
+    for (i = 0; i < cap; ++i) {
+        MIR_Atomic_Init(SlotSeq(q, i), i);
+    }
+    MIR_Atomic_Init(&q->notEmpty.e.seq, 0u);
+    MIR_Atomic_Init(&q->notEmpty.e.waiters, 0u);
+    MIR_Atomic_Init(&q->notFull.e.seq, 0u);
+    MIR_Atomic_Init(&q->notFull.e.waiters, 0u);
+    MIR_Atomic_Init(&q->enq.pos, 0);
+    MIR_Atomic_Init(&q->deq.pos, 0);
+    return MIR_MPMC_OK;
+}
+
+void MIR_MPMC_DeinitByFreeF(void (*freeF)(void *), struct MIR_MPMC *q) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(q != NULL, "param `q' MUST NOT be NULL");
+
+    freeF(q->shared.s.slots);
+    q->shared.s.slots = NULL;
+}
+
+size_t MIR_MPMC_Cap(const struct MIR_MPMC *q) {
+    return q->shared.s.mask + 1u;
+}
+
+int MIR_MPMC_TryPush(struct MIR_MPMC *q, const void *elem) {
+    size_t pos = MIR_Atomic_Load(&q->enq.pos, MIR_ATOMIC_RELAXED);
+    MIR_Atomic(size_t) *seq;
+    size_t s;
+
+    /* NOTE: the slot is free iff its sequence number equals the position. It
+     *       lags behind by `cap - 1` while the previous element is still
+     *       there and runs ahead if another producer has already taken it */
+    for (;;) {
+        seq = SlotSeq(q, pos);
+        s = MIR_Atomic_Load(seq, MIR_ATOMIC_ACQUIRE);
+        if (s == pos) {
+            if (MIR_Atomic_CompareExchangeWeak(
+                    &q->enq.pos, &pos, pos + 1u, MIR_ATOMIC_RELAXED,
+                    MIR_ATOMIC_RELAXED
+                )) {
+                break;
+            }
+        } else if ((ptrdiff_t)(s - pos) < 0) {
+            return 1;
+        } else {
+            pos = MIR_Atomic_Load(&q->enq.pos, MIR_ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy((unsigned char *)seq + SEQ_SIZE, elem, q->shared.s.elemSize);
+    MIR_Atomic_Store(seq, pos + 1u, MIR_ATOMIC_RELEASE);
+    Notify(&q->notEmpty.e);
+    return MIR_MPMC_OK;
+}
+
+int MIR_MPMC_TryPop(struct MIR_MPMC *q, void *out) {
+    size_t pos = MIR_Atomic_Load(&q->deq.pos, MIR_ATOMIC_RELAXED);
+    MIR_Atomic(size_t) *seq;
+    size_t s;
+
+    /* NOTE: the slot is full iff its sequence number is `pos + 1` */
+    for (;;) {
+        seq = SlotSeq(q, pos);
+        s = MIR_Atomic_Load(seq, MIR_ATOMIC_ACQUIRE);
+        if (s == pos + 1u) {
+            if (MIR_Atomic_CompareExchangeWeak(
+                    &q->deq.pos, &pos, pos + 1u, MIR_ATOMIC_RELAXED,
+                    MIR_ATOMIC_RELAXED
+                )) {
+                break;
+            }
+        } else if ((ptrdiff_t)(s - (pos + 1u)) < 0) {
+            return 1;
+        } else {
+            pos = MIR_Atomic_Load(&q->deq.pos, MIR_ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(out, (unsigned char *)seq + SEQ_SIZE, q->shared.s.elemSize);
+    MIR_Atomic_Store(seq, pos + q->shared.s.mask + 1u, MIR_ATOMIC_RELEASE);
+    Notify(&q->notFull.e);
+    return MIR_MPMC_OK;
+}
+
+void MIR_MPMC_Push(struct MIR_MPMC *q, const void *elem) {
+    __MIR_ASSERT_MSG(elem != NULL, "param `elem' MUST NOT be NULL");
+
+    Wait(q, &q->notFull.e, elem, NULL);
+}
+
+void MIR_MPMC_Pop(struct MIR_MPMC *q, void *out) {
+    __MIR_ASSERT_MSG(out != NULL, "param `out' MUST NOT be NULL");
+
+    Wait(q, &q->notEmpty.e, NULL, out);
+}
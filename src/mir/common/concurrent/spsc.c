@@ -0,0 +1,385 @@
+#include <mir/common/concurrent/spsc.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+#include <string.h> /* memcpy */
+
+#include <mir/common/atomic.h>   /* MIR_Atomic_* */
+#include <mir/common/macros.h>   /* MIR_LIKELY */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/* NOTE: record header value that tells the consumer to skip to the beginning
+ *       of the buffer */
+#define RECORD_WRAP SIZE_MAX
+#define RECORD_ALIGN sizeof(size_t)
+#define RECORD_MIN_CAP 16u
+
+#define RECORD_SIZE(len)                                                       \
+    (RECORD_ALIGN + (((len) + RECORD_ALIGN - 1u) & ~(RECORD_ALIGN - 1u)))
+
+
+/* NOTE: returns the number of slots that are free from the producer's point of
+ *       view, refreshing the cached head only if less than `want` are free */
+static size_t ProducerRoom(
+    struct __MIR_SPSC_Side *prod, struct MIR_SPSC *ring, size_t want
+) {
+    size_t room = prod->cap - (prod->local - prod->cachedOther);
+
+    if (room < want) {
+        prod->cachedOther =
+            MIR_Atomic_Load(&ring->cons.s.pos, MIR_ATOMIC_ACQUIRE);
+        room = prod->cap - (prod->local - prod->cachedOther);
+    }
+    return room;
+}
+
+/* NOTE: the same for the consumer */
+static size_t ConsumerAvail(
+    struct __MIR_SPSC_Side *cons, struct MIR_SPSC *ring, size_t want
+) {
+    size_t avail = cons->cachedOther - cons->local;
+
+    if (avail < want) {
+        cons->cachedOther =
+            MIR_Atomic_Load(&ring->prod.s.pos, MIR_ATOMIC_ACQUIRE);
+        avail = cons->cachedOther - cons->local;
+    }
+    return avail;
+}
+
+static void MakeSpans(
+    const struct __MIR_SPSC_Side *side, size_t pos, size_t n,
+    struct MIR_SPSC_Spans *spans
+) {
+    size_t start = pos & (side->cap - 1u);
+    size_t run = side->cap - start;
+
+    spans->first = side->buf + start * side->elemSize;
+    if (n <= run) {
+        spans->firstLen = n;
+        spans->second = NULL;
+        spans->secondLen = 0;
+    } else {
+        spans->firstLen = run;
+        spans->second = side->buf;
+        spans->secondLen = n - run;
+    }
+}
+
+
+int MIR_SPSC_InitByMallocF(
+    void *(*mallocF)(size_t), struct MIR_SPSC *ring, size_t capacity,
+    size_t elemSize
+) {
+    size_t cap = (elemSize == 0u) ? RECORD_MIN_CAP : 1u;
+    size_t unit = (elemSize == 0u) ? 1u : elemSize;
+    unsigned char *buf;
+
+    __MIR_ASSERT_MSG(mallocF != NULL, "param `mallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(ring != NULL, "param `ring' MUST NOT be NULL");
+
+    while (cap < capacity) {
+        if (cap > SIZE_MAX / 2u) {
+            return 1;
+        }
+        cap *= 2u;
+    }
+    if (cap > SIZE_MAX / unit) {
+        return 1;
+    }
+    buf = (unsigned char *)mallocF(cap * unit);
+    if (buf == NULL) {
+        return 1;
+    }
+
+    MIR_Atomic_Init(&ring->prod.s.pos, 0);
+    ring->prod.s.local = 0;
+    ring->prod.s.cachedOther = 0;
+    ring->prod.s.buf = buf;
+    ring->prod.s.cap = cap;
+    ring->prod.s.elemSize = elemSize;
+
+    MIR_Atomic_Init(&ring->cons.s.pos, 0);
+    ring->cons.s.local = 0;
+    ring->cons.s.cachedOther = 0;
+    ring->cons.s.buf = buf;
+    ring->cons.s.cap = cap;
+    ring->cons.s.elemSize = elemSize;
+    return MIR_SPSC_OK;
+}
+
+void MIR_SPSC_DeinitByFreeF(void (*freeF)(void *), struct MIR_SPSC *ring) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(ring != NULL, "param `ring' MUST NOT be NULL");
+
+    freeF(ring->prod.s.buf);
+    ring->prod.s.buf = NULL;
+    ring->cons.s.buf = NULL;
+}
+
+size_t MIR_SPSC_Cap(const struct MIR_SPSC *ring) {
+    return ring->prod.s.cap;
+}
+
+
+int MIR_SPSC_TryPush(struct MIR_SPSC *ring, const void *elem) {
+    struct __MIR_SPSC_Side *prod = &ring->prod.s;
+
+    __MIR_ASSERT_MSG(prod->elemSize != 0u, "the ring MUST be in element mode");
+
+    if (ProducerRoom(prod, ring, 1u) == 0u) {
+        return 1;
+    }
+    memcpy(
+        prod->buf + (prod->local & (prod->cap - 1u)) * prod->elemSize, elem,
+        prod->elemSize
+    );
+    ++prod->local;
+    MIR_Atomic_Store(&prod->pos, prod->local, MIR_ATOMIC_RELEASE);
+    return MIR_SPSC_OK;
+}
+
+int MIR_SPSC_TryPop(struct MIR_SPSC *ring, void *out) {
+    struct __MIR_SPSC_Side *cons = &ring->cons.s;
+
+    __MIR_ASSERT_MSG(cons->elemSize != 0u, "the ring MUST be in element mode");
+
+    if (ConsumerAvail(cons, ring, 1u) == 0u) {
+        return 1;
+    }
+    memcpy(
+        out, cons->buf + (cons->local & (cons->cap - 1u)) * cons->elemSize,
+        cons->elemSize
+    );
+    ++cons->local;
+    MIR_Atomic_Store(&cons->pos, cons->local, MIR_ATOMIC_RELEASE);
+    return MIR_SPSC_OK;
+}
+
+size_t MIR_SPSC_Reserve(
+    struct MIR_SPSC *ring, size_t n, struct MIR_SPSC_Spans *spans
+) {
+    struct __MIR_SPSC_Side *prod = &ring->prod.s;
+    size_t room;
+
+    __MIR_ASSERT_MSG(prod->elemSize != 0u, "the ring MUST be in element mode");
+
+    room = ProducerRoom(prod, ring, n);
+    if (n > room) {
+        n = room;
+    }
+    MakeSpans(prod, prod->local, n, spans);
+    return n;
+}
+
+void MIR_SPSC_Commit(struct MIR_SPSC *ring, size_t n) {
+    struct __MIR_SPSC_Side *prod = &ring->prod.s;
+
+    __MIR_ASSERT_MSG(
+        n <= prod->cap - (prod->local - prod->cachedOther),
+        "param `n' MUST NOT exceed the number of reserved slots"
+    );
+
+    prod->local += n;
+    MIR_Atomic_Store(&prod->pos, prod->local, MIR_ATOMIC_RELEASE);
+}
+
+size_t
+MIR_SPSC_Peek(struct MIR_SPSC *ring, size_t n, struct MIR_SPSC_Spans *spans) {
+    struct __MIR_SPSC_Side *cons = &ring->cons.s;
+    size_t avail;
+
+    __MIR_ASSERT_MSG(cons->elemSize != 0u, "the ring MUST be in element mode");
+
+    avail = ConsumerAvail(cons, ring, n);
+    if (n > avail) {
+        n = avail;
+    }
+    MakeSpans(cons, cons->local, n, spans);
+    return n;
+}
+
+void MIR_SPSC_Release(struct MIR_SPSC *ring, size_t n) {
+    struct __MIR_SPSC_Side *cons = &ring->cons.s;
+
+    __MIR_ASSERT_MSG(
+        n <= cons->cachedOther - cons->local,
+        "param `n' MUST NOT exceed the number of peeked elements"
+    );
+
+    cons->local += n;
+    MIR_Atomic_Store(&cons->pos, cons->local, MIR_ATOMIC_RELEASE);
+}
+
+size_t MIR_SPSC_PushN(struct MIR_SPSC *ring, const void *elems, size_t n) {
+    struct MIR_SPSC_Spans spans;
+    size_t elemSize = ring->prod.s.elemSize;
+
+    n = MIR_SPSC_Reserve(ring, n, &spans);
+    if (n == 0u) {
+        return 0;
+    }
+    memcpy(spans.first, elems, spans.firstLen * elemSize);
+    if (spans.secondLen != 0u) {
+        memcpy(
+            spans.second,
+            (const unsigned char *)elems + spans.firstLen * elemSize,
+            spans.secondLen * elemSize
+        );
+    }
+    MIR_SPSC_Commit(ring, n);
+    return n;
+}
+
+size_t MIR_SPSC_PopN(struct MIR_SPSC *ring, void *out, size_t n) {
+    struct MIR_SPSC_Spans spans;
+    size_t elemSize = ring->cons.s.elemSize;
+
+    n = MIR_SPSC_Peek(ring, n, &spans);
+    if (n == 0u) {
+        return 0;
+    }
+    memcpy(out, spans.first, spans.firstLen * elemSize);
+    if (spans.secondLen != 0u) {
+        memcpy(
+            (unsigned char *)out + spans.firstLen * elemSize, spans.second,
+            spans.secondLen * elemSize
+        );
+    }
+    MIR_SPSC_Release(ring, n);
+    return n;
+}
+
+
+void *MIR_SPSC_BeginRecord(struct MIR_SPSC *ring, size_t len) {
+    struct __MIR_SPSC_Side *prod = &ring->prod.s;
+    size_t size;
+    size_t start;
+    size_t run;
+    size_t want;
+    size_t wrap = RECORD_WRAP;
+
+    __MIR_ASSERT_MSG(prod->elemSize == 0u, "the ring MUST be in record mode");
+
+    /* NOTE: with records of at most a half of the buffer, skipping the rest
+     *       of the buffer never asks for more than the whole buffer */
+    if (len > prod->cap / 2u - RECORD_ALIGN) {
+        return NULL;
+    }
+    size = RECORD_SIZE(len);
+
+    /* NOTE: records never wrap. If the record doesn't fit before the end of
+     *       the buffer, the rest of the buffer is skipped */
+    start = prod->local & (prod->cap - 1u);
+    run = prod->cap - start;
+    want = (size <= run) ? size : run + size;
+    if (ProducerRoom(prod, ring, want) < want) {
+        return NULL;
+    }
+
+    if (size > run) {
+        /* NOTE: `run` is a multiple of `RECORD_ALIGN`, so the header fits */
+        memcpy(prod->buf + start, &wrap, sizeof(size_t));
+        prod->local += run;
+        start = 0;
+    }
+    memcpy(prod->buf + start, &len, sizeof(size_t));
+    prod->local += size;
+    return prod->buf + start + RECORD_ALIGN;
+}
+
+void MIR_SPSC_Publish(struct MIR_SPSC *ring) {
+    struct __MIR_SPSC_Side *prod = &ring->prod.s;
+
+    MIR_Atomic_Store(&prod->pos, prod->local, MIR_ATOMIC_RELEASE);
+}
+
+/* NOTE: finds the next record without consuming it. Returns the position
+ *       right after it via `next` */
+static const unsigned char *
+PeekRecord(struct MIR_SPSC *ring, size_t *len, size_t *next) {
+    struct __MIR_SPSC_Side *cons = &ring->cons.s;
+    size_t pos = cons->local;
+    size_t start;
+    size_t header;
+
+    if (ConsumerAvail(cons, ring, 1u) == 0u) {
+        return NULL;
+    }
+    start = pos & (cons->cap - 1u);
+    memcpy(&header, cons->buf + start, sizeof(size_t));
+    if (header == RECORD_WRAP) {
+        /* NOTE: the producer publishes the wrap marker together with the
+         *       record following it */
+        pos += cons->cap - start;
+        start = 0;
+        memcpy(&header, cons->buf, sizeof(size_t));
+    }
+
+    *len = header;
+    *next = pos + RECORD_SIZE(header);
+    return cons->buf + start + RECORD_ALIGN;
+}
+
+const void *MIR_SPSC_NextRecord(struct MIR_SPSC *ring, size_t *len) {
+    const unsigned char *payload;
+    size_t next;
+
+    __MIR_ASSERT_MSG(
+        ring->cons.s.elemSize == 0u, "the ring MUST be in record mode"
+    );
+    __MIR_ASSERT_MSG(len != NULL, "param `len' MUST NOT be NULL");
+
+    payload = PeekRecord(ring, len, &next);
+    if (payload != NULL) {
+        ring->cons.s.local = next;
+    }
+    return payload;
+}
+
+void MIR_SPSC_Consume(struct MIR_SPSC *ring) {
+    struct __MIR_SPSC_Side *cons = &ring->cons.s;
+
+    MIR_Atomic_Store(&cons->pos, cons->local, MIR_ATOMIC_RELEASE);
+}
+
+int
+MIR_SPSC_TryPushRecord(struct MIR_SPSC *ring, const void *data, size_t len) {
+    void *payload = MIR_SPSC_BeginRecord(ring, len);
+
+    if (payload == NULL) {
+        return 1;
+    }
+    if (len != 0u) {
+        memcpy(payload, data, len);
+    }
+    MIR_SPSC_Publish(ring);
+    return MIR_SPSC_OK;
+}
+
+int MIR_SPSC_TryPopRecord(
+    struct MIR_SPSC *ring, void *out, size_t outCap, size_t *len
+) {
+    const unsigned char *payload;
+    size_t next;
+
+    __MIR_ASSERT_MSG(
+        ring->cons.s.elemSize == 0u, "the ring MUST be in record mode"
+    );
+    __MIR_ASSERT_MSG(len != NULL, "param `len' MUST NOT be NULL");
+
+    payload = PeekRecord(ring, len, &next);
+    if (payload == NULL) {
+        return 1;
+    }
+    if (*len > outCap) {
+        return 2;
+    }
+    if (*len != 0u) {
+        memcpy(out, payload, *len);
+    }
+    ring->cons.s.local = next;
+    MIR_SPSC_Consume(ring);
+    return MIR_SPSC_OK;
+}
@@ -0,0 +1,542 @@
+/* NOTE: `pthread_*', `sched_yield' and `sysconf' are POSIX */
+#ifndef _POSIX_C_SOURCE
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <mir/common/concurrent/threadpool.h>
+
+#ifdef MIR_HAS_PTHREADS
+
+#    include <pthread.h> /* pthread_* */
+#    include <sched.h>   /* sched_yield */
+#    include <stddef.h>  /* NULL, ptrdiff_t, size_t */
+#    include <stdint.h>  /* SIZE_MAX */
+#    include <unistd.h>  /* sysconf */
+
+#    include <mir/common/atomic.h>   /* MIR_Atomic_* */
+#    include <mir/common/mem.h>      /* MIR_CACHE_LINE_SIZE */
+#    include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+/* NOTE: number of fruitless scans before a worker goes to sleep */
+#    define IDLE_SCANS 64u
+
+#    define DEQUE_MASK (MIR_THREADPOOL_DEQUE_CAP - 1u)
+
+#    if (MIR_THREADPOOL_DEQUE_CAP & DEQUE_MASK) != 0
+#        error "mirlib: MIR_THREADPOOL_DEQUE_CAP MUST be a power of two"
+#    endif
+
+
+/**
+ * \brief A single \ref MIR_ThreadPool_ParallelFor call.
+ *
+ * \details It lives on the stack of the calling thread, which doesn't return
+ * until `pending` drops to `0`.
+ */
+struct Job {
+    void (*fn)(void *ctx, size_t begin, size_t end);
+    void *ctx;
+    size_t grain;
+
+    /**
+     * \brief Number of indices not run yet.
+     */
+    MIR_Atomic(size_t) pending;
+};
+
+/**
+ * \brief Range `[begin, end)` of a job.
+ */
+struct Task {
+    struct Job *job;
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * \brief Deque slot.
+ *
+ * \details A thief reads a slot before it claims it, while the owner may be
+ * overwriting it (the claim fails then). The members are atomics to keep that
+ * race well-defined.
+ */
+struct Slot {
+    MIR_Atomic(struct Job *) job;
+    MIR_Atomic(size_t) begin;
+    MIR_Atomic(size_t) end;
+};
+
+struct Worker {
+    /**
+     * \brief Index of the oldest range. Advanced by thieves (and by the owner
+     * taking the last range).
+     */
+    union {
+        MIR_Atomic(size_t) v;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } top;
+
+    union {
+        struct {
+            /**
+             * \brief One past the newest range. Written by the owner only.
+             */
+            MIR_Atomic(size_t) bottom;
+
+            struct MIR_ThreadPool *pool;
+            size_t index;
+            unsigned rng;
+            pthread_t thread;
+
+            MIR_Atomic(size_t) tasks;
+            MIR_Atomic(size_t) steals;
+            MIR_Atomic(size_t) failedSteals;
+            MIR_Atomic(size_t) idle;
+            MIR_Atomic(size_t) parks;
+        } s;
+        unsigned char __pad[2u * MIR_CACHE_LINE_SIZE];
+    } own;
+
+    struct Slot slots[MIR_THREADPOOL_DEQUE_CAP];
+};
+
+struct __MIR_ThreadPool_State {
+    /**
+     * \brief Maps a thread to its \ref Worker of this pool.
+     */
+    pthread_key_t self;
+
+    /**
+     * \brief Serializes non-worker callers, which share the last deque.
+     */
+    pthread_mutex_t submitLock;
+
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wake;
+    MIR_Atomic(size_t) sleepers;
+    MIR_Atomic(int) stop;
+
+    /**
+     * \brief `nthreads + 1` workers. The last one has no thread.
+     */
+    struct Worker *workers;
+};
+
+
+static MIR_Atomic(struct MIR_ThreadPool *) defaultPool;
+
+
+/* NOTE: increments a counter owned by the calling thread */
+static void Count(MIR_Atomic(size_t) *counter) {
+    MIR_Atomic_Store(
+        counter, MIR_Atomic_Load(counter, MIR_ATOMIC_RELAXED) + 1u,
+        MIR_ATOMIC_RELAXED
+    );
+}
+
+/* NOTE: owner only. Returns `1` if the deque is full */
+static int Push(struct Worker *w, struct Job *job, size_t begin, size_t end) {
+    size_t b = MIR_Atomic_Load(&w->own.s.bottom, MIR_ATOMIC_RELAXED);
+    size_t t = MIR_Atomic_Load(&w->top.v, MIR_ATOMIC_ACQUIRE);
+    struct Slot *slot = &w->slots[b & DEQUE_MASK];
+
+    if (b - t >= MIR_THREADPOOL_DEQUE_CAP) {
+        return 1;
+    }
+    MIR_Atomic_Store(&slot->job, job, MIR_ATOMIC_RELAXED);
+    MIR_Atomic_Store(&slot->begin, begin, MIR_ATOMIC_RELAXED);
+    MIR_Atomic_Store(&slot->end, end, MIR_ATOMIC_RELAXED);
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_RELEASE);
+    MIR_Atomic_Store(&w->own.s.bottom, b + 1u, MIR_ATOMIC_RELAXED);
+    return 0;
+}
+
+static void ReadSlot(const struct Slot *slot, struct Task *task) {
+    task->job = MIR_Atomic_Load(&slot->job, MIR_ATOMIC_RELAXED);
+    task->begin = MIR_Atomic_Load(&slot->begin, MIR_ATOMIC_RELAXED);
+    task->end = MIR_Atomic_Load(&slot->end, MIR_ATOMIC_RELAXED);
+}
+
+/* NOTE: owner only. Takes the newest range. Returns `1` if there is none */
+static int Pop(struct Worker *w, struct Task *task) {
+    size_t b = MIR_Atomic_Load(&w->own.s.bottom, MIR_ATOMIC_RELAXED) - 1u;
+    size_t t;
+    int rc = 0;
+
+    MIR_Atomic_Store(&w->own.s.bottom, b, MIR_ATOMIC_RELAXED);
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+    t = MIR_Atomic_Load(&w->top.v, MIR_ATOMIC_RELAXED);
+
+    if ((ptrdiff_t)(b - t) < 0) {
+        MIR_Atomic_Store(&w->own.s.bottom, b + 1u, MIR_ATOMIC_RELAXED);
+        return 1;
+    }
+    ReadSlot(&w->slots[b & DEQUE_MASK], task);
+    if (b == t) {
+        /* NOTE: the last range, race with thieves for it */
+        if (!MIR_Atomic_CompareExchangeStrong(
+                &w->top.v, &t, t + 1u, MIR_ATOMIC_SEQ_CST, MIR_ATOMIC_RELAXED
+            )) {
+            rc = 1;
+        }
+        MIR_Atomic_Store(&w->own.s.bottom, b + 1u, MIR_ATOMIC_RELAXED);
+    }
+    return rc;
+}
+
+/* NOTE: takes the oldest range of `victim'. Returns `1` if there is none and
+ *       `2` if another thread won the race for it */
+static int Steal(struct Worker *victim, struct Task *task) {
+    size_t t = MIR_Atomic_Load(&victim->top.v, MIR_ATOMIC_ACQUIRE);
+    size_t b;
+
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+    b = MIR_Atomic_Load(&victim->own.s.bottom, MIR_ATOMIC_ACQUIRE);
+    if ((ptrdiff_t)(b - t) <= 0) {
+        return 1;
+    }
+    ReadSlot(&victim->slots[t & DEQUE_MASK], task);
+    if (!MIR_Atomic_CompareExchangeStrong(
+            &victim->top.v, &t, t + 1u, MIR_ATOMIC_SEQ_CST, MIR_ATOMIC_RELAXED
+        )) {
+        return 2;
+    }
+    return 0;
+}
+
+static int HasWork(const struct Worker *w) {
+    size_t t = MIR_Atomic_Load(&w->top.v, MIR_ATOMIC_RELAXED);
+    size_t b = MIR_Atomic_Load(&w->own.s.bottom, MIR_ATOMIC_RELAXED);
+
+    return (ptrdiff_t)(b - t) > 0;
+}
+
+/* NOTE: pops a range of `w' or steals one, starting at a random victim.
+ *       Returns `1` if no range was found */
+static int FindTask(struct Worker *w, struct Task *task) {
+    struct __MIR_ThreadPool_State *st = w->own.s.pool->state;
+    size_t n = w->own.s.pool->nthreads + 1u;
+    size_t victim;
+    size_t i;
+    int rc;
+
+    if (Pop(w, task) == 0) {
+        return 0;
+    }
+
+    /* NOTE: xorshift32 */
+    w->own.s.rng ^= w->own.s.rng << 13;
+    w->own.s.rng ^= w->own.s.rng >> 17;
+    w->own.s.rng ^= w->own.s.rng << 5;
+    victim = w->own.s.rng % n;
+
+    for (i = 0; i < n; ++i, victim = (victim + 1u == n) ? 0u : victim + 1u) {
+        if (victim == w->own.s.index) {
+            continue;
+        }
+        rc = Steal(&st->workers[victim], task);
+        if (rc == 0) {
+            Count(&w->own.s.steals);
+            return 0;
+        }
+        if (rc == 2) {
+            Count(&w->own.s.failedSteals);
+        }
+    }
+    return 1;
+}
+
+/* NOTE: wakes a sleeping worker, if any. The fence pairs with the one in
+ *       `Park': either the sleeper sees the new range or this function sees
+ *       the sleeper */
+static void WakeOne(struct __MIR_ThreadPool_State *st) {
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+    if (MIR_Atomic_Load(&st->sleepers, MIR_ATOMIC_RELAXED) == 0u) {
+        return;
+    }
+    pthread_mutex_lock(&st->sleepLock);
+    pthread_cond_signal(&st->wake);
+    pthread_mutex_unlock(&st->sleepLock);
+}
+
+/* NOTE: sleeps until a range is pushed or the pool is stopped */
+static void Park(struct Worker *w) {
+    struct __MIR_ThreadPool_State *st = w->own.s.pool->state;
+    size_t n = w->own.s.pool->nthreads + 1u;
+    size_t i;
+
+    pthread_mutex_lock(&st->sleepLock);
+    MIR_Atomic_FetchAdd(&st->sleepers, 1u, MIR_ATOMIC_RELAXED);
+    MIR_Atomic_ThreadFence(MIR_ATOMIC_SEQ_CST);
+    for (i = 0; i < n; ++i) {
+        if (HasWork(&st->workers[i])) {
+            break;
+        }
+    }
+    if (i == n && MIR_Atomic_Load(&st->stop, MIR_ATOMIC_RELAXED) == 0) {
+        Count(&w->own.s.parks);
+        pthread_cond_wait(&st->wake, &st->sleepLock);
+    }
+    MIR_Atomic_FetchSub(&st->sleepers, 1u, MIR_ATOMIC_RELAXED);
+    pthread_mutex_unlock(&st->sleepLock);
+}
+
+/* NOTE: splits `[begin, end)' pushing the upper halves and runs what's left */
+static void RunRange(
+    struct Worker *w, struct Job *job, size_t begin, size_t end
+) {
+    size_t mid;
+
+    while (end - begin > job->grain) {
+        mid = begin + (end - begin) / 2u;
+        if (Push(w, job, mid, end) != 0) {
+            break;
+        }
+        WakeOne(w->own.s.pool->state);
+        end = mid;
+    }
+
+    job->fn(job->ctx, begin, end);
+    Count(&w->own.s.tasks);
+
+    /* NOTE: `job' MUST NOT be touched after this */
+    MIR_Atomic_FetchSub(&job->pending, end - begin, MIR_ATOMIC_ACQ_REL);
+}
+
+static void *WorkerMain(void *arg) {
+    struct Worker *w = (struct Worker *)arg;
+    struct __MIR_ThreadPool_State *st = w->own.s.pool->state;
+    struct Task task;
+    unsigned scans = 0;
+
+    pthread_setspecific(st->self, w);
+    for (;;) {
+        if (FindTask(w, &task) == 0) {
+            RunRange(w, task.job, task.begin, task.end);
+            scans = 0;
+            continue;
+        }
+        if (MIR_Atomic_Load(&st->stop, MIR_ATOMIC_ACQUIRE) != 0) {
+            break;
+        }
+
+        Count(&w->own.s.idle);
+        if (++scans < IDLE_SCANS) {
+            MIR_Atomic_SpinPause();
+            sched_yield();
+            continue;
+        }
+        scans = 0;
+        Park(w);
+    }
+    return NULL;
+}
+
+static void InitWorker(
+    struct Worker *w, struct MIR_ThreadPool *pool, size_t index
+) {
+    MIR_Atomic_Init(&w->top.v, 0);
+    MIR_Atomic_Init(&w->own.s.bottom, 0);
+    w->own.s.pool = pool;
+    w->own.s.index = index;
+    w->own.s.rng = (unsigned)index * 2654435761u + 1u;
+    MIR_Atomic_Init(&w->own.s.tasks, 0);
+    MIR_Atomic_Init(&w->own.s.steals, 0);
+    MIR_Atomic_Init(&w->own.s.failedSteals, 0);
+    MIR_Atomic_Init(&w->own.s.idle, 0);
+    MIR_Atomic_Init(&w->own.s.parks, 0);
+}
+
+/* NOTE: stops and joins the first `started' workers */
+static void StopWorkers(struct MIR_ThreadPool *pool, size_t started) {
+    struct __MIR_ThreadPool_State *st = pool->state;
+    size_t i;
+
+    MIR_Atomic_Store(&st->stop, 1, MIR_ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&st->sleepLock);
+    pthread_cond_broadcast(&st->wake);
+    pthread_mutex_unlock(&st->sleepLock);
+
+    for (i = 0; i < started; ++i) {
+        pthread_join(st->workers[i].own.s.thread, NULL);
+    }
+}
+
+static void DestroyState(
+    void (*freeF)(void *), struct __MIR_ThreadPool_State *st
+) {
+    pthread_cond_destroy(&st->wake);
+    pthread_mutex_destroy(&st->sleepLock);
+    pthread_mutex_destroy(&st->submitLock);
+    pthread_key_delete(st->self);
+    freeF(st->workers);
+    freeF(st);
+}
+
+
+int MIR_ThreadPool_InitByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_ThreadPool *pool, size_t nthreads
+) {
+    struct __MIR_ThreadPool_State *st;
+    long ncpu;
+    size_t i;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(pool != NULL, "param `pool' MUST NOT be NULL");
+
+    if (nthreads == 0u) {
+        ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (ncpu > 0) ? (size_t)ncpu : 1u;
+    }
+    if (nthreads >= SIZE_MAX / sizeof(struct Worker)) {
+        return 1;
+    }
+
+    st = (struct __MIR_ThreadPool_State *)reallocF(NULL, sizeof(*st));
+    if (st == NULL) {
+        return 1;
+    }
+    st->workers = (struct Worker *)reallocF(
+        NULL, (nthreads + 1u) * sizeof(struct Worker)
+    );
+    if (st->workers == NULL) {
+        freeF(st);
+        return 1;
+    }
+    if (pthread_key_create(&st->self, NULL) != 0) {
+        freeF(st->workers);
+        freeF(st);
+        return 1;
+    }
+    pthread_mutex_init(&st->submitLock, NULL);
+    pthread_mutex_init(&st->sleepLock, NULL);
+    pthread_cond_init(&st->wake, NULL);
+    MIR_Atomic_Init(&st->sleepers, 0);
+    MIR_Atomic_Init(&st->stop, 0);
+
+    pool->state = st;
+    pool->nthreads = nthreads;
+    for (i = 0; i <= nthreads; ++i) {
+        InitWorker(&st->workers[i], pool, i);
+    }
+    for (i = 0; i < nthreads; ++i) {
+        if (pthread_create(
+                &st->workers[i].own.s.thread, NULL, WorkerMain,
+                &st->workers[i]
+            ) != 0) {
+            StopWorkers(pool, i);
+            DestroyState(freeF, st);
+            pool->state = NULL;
+            return 1;
+        }
+    }
+    return MIR_ThreadPool_OK;
+}
+
+void MIR_ThreadPool_DeinitByFreeF(
+    void (*freeF)(void *), struct MIR_ThreadPool *pool
+) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(pool != NULL, "param `pool' MUST NOT be NULL");
+
+    StopWorkers(pool, pool->nthreads);
+    DestroyState(freeF, pool->state);
+    pool->state = NULL;
+    pool->nthreads = 0;
+}
+
+void MIR_ThreadPool_ParallelFor(
+    struct MIR_ThreadPool *pool, size_t begin, size_t end, size_t grain,
+    void (*fn)(void *ctx, size_t begin, size_t end), void *ctx
+) {
+    struct __MIR_ThreadPool_State *st;
+    struct Worker *w;
+    struct Job job;
+    struct Task task;
+    unsigned scans = 0;
+    int external = 0;
+
+    __MIR_ASSERT_MSG(fn != NULL, "param `fn' MUST NOT be NULL");
+
+    if (begin >= end) {
+        return;
+    }
+    if (grain == 0u) {
+        grain = 1;
+    }
+    if (pool == NULL || end - begin <= grain) {
+        fn(ctx, begin, end);
+        return;
+    }
+
+    st = pool->state;
+    /* NOTE: a non-worker caller owns the shared deque until it returns, so
+     *       nested calls made by it while helping don't lock again */
+    w = (struct Worker *)pthread_getspecific(st->self);
+    if (w == NULL) {
+        pthread_mutex_lock(&st->submitLock);
+        w = &st->workers[pool->nthreads];
+        pthread_setspecific(st->self, w);
+        external = 1;
+    }
+
+    job.fn = fn;
+    job.ctx = ctx;
+    job.grain = grain;
+    MIR_Atomic_Init(&job.pending, end - begin);
+
+    /* NOTE: while waiting, the caller runs whatever it finds, including
+     *       ranges of other jobs */
+    RunRange(w, &job, begin, end);
+    while (MIR_Atomic_Load(&job.pending, MIR_ATOMIC_ACQUIRE) != 0u) {
+        if (FindTask(w, &task) == 0) {
+            RunRange(w, task.job, task.begin, task.end);
+            scans = 0;
+            continue;
+        }
+        Count(&w->own.s.idle);
+        MIR_Atomic_SpinPause();
+        if (++scans >= IDLE_SCANS) {
+            sched_yield();
+        }
+    }
+
+    if (external) {
+        pthread_setspecific(st->self, NULL);
+        pthread_mutex_unlock(&st->submitLock);
+    }
+}
+
+void MIR_ThreadPool_GetStats(
+    const struct MIR_ThreadPool *pool, size_t index,
+    struct MIR_ThreadPool_Stats *stats
+) {
+    struct Worker *w;
+
+    __MIR_ASSERT_MSG(pool != NULL, "param `pool' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        index <= pool->nthreads, "param `index' MUST NOT exceed `nthreads'"
+    );
+    __MIR_ASSERT_MSG(stats != NULL, "param `stats' MUST NOT be NULL");
+
+    w = &pool->state->workers[index];
+    stats->tasks = MIR_Atomic_Load(&w->own.s.tasks, MIR_ATOMIC_RELAXED);
+    stats->steals = MIR_Atomic_Load(&w->own.s.steals, MIR_ATOMIC_RELAXED);
+    stats->failedSteals =
+        MIR_Atomic_Load(&w->own.s.failedSteals, MIR_ATOMIC_RELAXED);
+    stats->idle = MIR_Atomic_Load(&w->own.s.idle, MIR_ATOMIC_RELAXED);
+    stats->parks = MIR_Atomic_Load(&w->own.s.parks, MIR_ATOMIC_RELAXED);
+}
+
+void MIR_ThreadPool_SetDefault(struct MIR_ThreadPool *pool) {
+    MIR_Atomic_Store(&defaultPool, pool, MIR_ATOMIC_RELEASE);
+}
+
+struct MIR_ThreadPool *MIR_ThreadPool_GetDefault(void) {
+    return MIR_Atomic_Load(&defaultPool, MIR_ATOMIC_ACQUIRE);
+}
+
+#endif /* MIR_HAS_PTHREADS */
@@ -1,6 +1,7 @@
 #include <mir/common/encodings/utf8.h>
 
-#include <stddef.h> /* NULL */
+#include <stddef.h> /* NULL, size_t */
+#include <string.h> /* memcpy */
 
 #include <mir/common/macros.h>
 #include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
@@ -145,3 +146,83 @@ int MIR_UTF8_BufIter_SkipBOM(struct MIR_UTF8_BufIter *iter) {
         return 1;
     }
 }
+
+int MIR_UTF8_IsValid(const unsigned char *buf, size_t len) {
+    const unsigned char *lim = buf + len;
+    const struct ByteRange *byteRange;
+    unsigned int n;
+    unsigned long word;
+    const struct ByteRange SecondByteRanges[5] = {
+        {0x80, 0xBF},
+        {0xA0, 0xBF},
+        {0x80, 0x9F},
+        {0x90, 0xBF},
+        {0x80, 0x8F}
+    };
+
+    __MIR_ASSERT_MSG(
+        (buf != NULL) || (len == 0u), "param `buf' MUST NOT be NULL"
+    );
+
+    while (buf < lim) {
+        /* NOTE: ASCII fast path. `~0UL / 0xFF * 0x80` is `0x80` in every
+         *       byte of the word */
+        while ((size_t)(lim - buf) >= sizeof(word)) {
+            memcpy(&word, buf, sizeof(word));
+            if ((word & (~0UL / 0xFF * 0x80)) != 0u) {
+                break;
+            }
+            buf += sizeof(word);
+        }
+        if (buf >= lim) {
+            break;
+        }
+
+        if (*buf <= 0x7F) {
+            ++buf;
+            continue;
+        } else if (MIR_InRange(*buf, 0xC2, 0xDF)) {
+            n = 1;
+            byteRange = &SecondByteRanges[0];
+        } else if (MIR_InRange(*buf, 0xE0, 0xE0)) {
+            n = 2;
+            byteRange = &SecondByteRanges[1];
+        } else if (
+            /* clang-format off */
+            MIR_InRange(*buf, 0xE1, 0xEC) ||
+            MIR_InRange(*buf, 0xEE, 0xEF)
+            /* clang-format on */
+        ) {
+            n = 2;
+            byteRange = &SecondByteRanges[0];
+        } else if (MIR_InRange(*buf, 0xED, 0xED)) {
+            n = 2;
+            byteRange = &SecondByteRanges[2];
+        } else if (MIR_InRange(*buf, 0xF0, 0xF0)) {
+            n = 3;
+            byteRange = &SecondByteRanges[3];
+        } else if (MIR_InRange(*buf, 0xF1, 0xF3)) {
+            n = 3;
+            byteRange = &SecondByteRanges[0];
+        } else if (MIR_InRange(*buf, 0xF4, 0xF4)) {
+            n = 3;
+            byteRange = &SecondByteRanges[4];
+        } else {
+            return 0;
+        }
+
+        if ((size_t)(lim - buf) <= n) {
+            return 0;
+        }
+        ++buf;
+        for (; n > 0u; --n) {
+            if (!MIR_InRange(*buf, byteRange->lo, byteRange->hi)) {
+                return 0;
+            }
+            byteRange = &SecondByteRanges[0]; /* reset to 80..BF */
+            ++buf;
+        }
+    }
+
+    return 1;
+}
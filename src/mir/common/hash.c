@@ -0,0 +1,154 @@
+#include <mir/common/hash.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* uint64_t, uintptr_t */
+#include <time.h>   /* clock, time */
+#if defined(__linux__) && defined(__GLIBC__)
+#    include <sys/auxv.h> /* AT_RANDOM, getauxval */
+#endif
+
+#include <mir/common/atomic.h> /* MIR_Atomic, MIR_Atomic_* */
+
+
+/* NOTE: `0' means "not generated yet" */
+static MIR_Atomic(uint64_t) gSeed;
+
+
+/* NOTE: the reads are assembled byte by byte, so the hash doesn't depend on
+ *       endianness. Compilers turn them into a single load on little-endian
+ *       targets */
+static uint64_t Read64(const unsigned char *p) {
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+           (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+           (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static uint64_t Read32(const unsigned char *p) {
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+           (uint64_t)p[3] << 24;
+}
+
+/* NOTE: reads 1, 2 or 3 bytes */
+static uint64_t Read3(const unsigned char *p, size_t len) {
+    return (uint64_t)p[0] << 16 | (uint64_t)p[len >> 1] << 8 | p[len - 1];
+}
+
+/* NOTE: the seed is mixed into both multiplicands, so an input can zero one of
+ *       them (and so the product) only for the seed it was chosen for */
+static uint64_t Round(uint64_t a, uint64_t b, uint64_t seed) {
+    return __MIR_Hash_Mum(
+        a ^ seed ^ __MIR_HASH_SECRET1, b ^ seed ^ __MIR_HASH_SECRET2
+    );
+}
+
+
+uint64_t MIR_Hash_Bytes(const void *data, size_t len, uint64_t seed) {
+    const unsigned char *p = (const unsigned char *)data;
+    uint64_t a;
+    uint64_t b;
+    uint64_t seed1;
+    uint64_t seed2;
+    size_t i;
+
+    seed ^= __MIR_Hash_Mum(seed ^ __MIR_HASH_SECRET0, __MIR_HASH_SECRET1);
+
+    if (len <= 16u) {
+        if (len >= 4u) {
+            /* NOTE: two (possibly overlapping) pairs of 4-byte reads cover
+             *       any length from 4 to 16 */
+            a = (Read32(p) << 32) | Read32(p + ((len >> 3) << 2));
+            b = (Read32(p + len - 4u) << 32) |
+                Read32(p + len - 4u - ((len >> 3) << 2));
+        } else if (len > 0u) {
+            a = Read3(p, len);
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        i = len;
+        if (i > 48u) {
+            seed1 = seed;
+            seed2 = seed;
+            do {
+                seed = Round(Read64(p), Read64(p + 8), seed);
+                seed1 = __MIR_Hash_Mum(
+                    Read64(p + 16) ^ seed1 ^ __MIR_HASH_SECRET2,
+                    Read64(p + 24) ^ seed1 ^ __MIR_HASH_SECRET3
+                );
+                seed2 = __MIR_Hash_Mum(
+                    Read64(p + 32) ^ seed2 ^ __MIR_HASH_SECRET3,
+                    Read64(p + 40) ^ seed2 ^ __MIR_HASH_SECRET1
+                );
+                p += 48;
+                i -= 48u;
+            } while (i > 48u);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16u) {
+            seed = Round(Read64(p), Read64(p + 8), seed);
+            i -= 16u;
+            p += 16;
+        }
+        /* NOTE: the last 16 bytes (possibly overlapping the processed ones) */
+        a = Read64(p + i - 16u);
+        b = Read64(p + i - 8u);
+    }
+
+    a = Round(a, b, seed) ^ __MIR_HASH_SECRET0 ^ (uint64_t)len;
+    return __MIR_Hash_Mum(a, a ^ seed ^ __MIR_HASH_SECRET3);
+}
+
+uint64_t
+MIR_Hash_UTF8BufIter(const struct MIR_UTF8_BufIter *iter, uint64_t seed) {
+    if (iter->cur == NULL) {
+        return MIR_Hash_Bytes(NULL, 0, seed);
+    }
+    return MIR_Hash_Bytes(iter->cur, (size_t)(iter->lim - iter->cur), seed);
+}
+
+
+static uint64_t GenerateSeed(void) {
+    uint64_t seed = 0;
+    unsigned char local;
+
+#if defined(__linux__) && defined(__GLIBC__) && defined(AT_RANDOM)
+    /* NOTE: 16 random bytes placed by the kernel on the initial stack */
+    const unsigned char *random = (const unsigned char *)getauxval(AT_RANDOM);
+    if (random != NULL) {
+        seed = Read64(random) ^ Read64(random + 8);
+    }
+#endif
+
+    /* NOTE: the addresses are randomized by ASLR (if any) */
+    seed = MIR_Hash_U64((uint64_t)(uintptr_t)&local, seed);
+    seed = MIR_Hash_U64((uint64_t)(uintptr_t)&gSeed, seed);
+    seed = MIR_Hash_U64((uint64_t)time(NULL), seed);
+    seed = MIR_Hash_U64((uint64_t)clock(), seed);
+
+    return (seed != 0u) ? seed : __MIR_HASH_SECRET0;
+}
+
+uint64_t MIR_Hash_Seed(void) {
+    uint64_t seed = MIR_Atomic_Load(&gSeed, MIR_ATOMIC_ACQUIRE);
+    uint64_t expected = 0;
+
+    if (MIR_LIKELY(seed != 0u)) {
+        return seed;
+    }
+
+    /* NOTE: if several threads race here, all of them will use the seed of
+     *       the winner */
+    seed = GenerateSeed();
+    if (!MIR_Atomic_CompareExchangeStrong(
+            &gSeed, &expected, seed, MIR_ATOMIC_ACQ_REL, MIR_ATOMIC_ACQUIRE
+        )) {
+        seed = expected;
+    }
+    return seed;
+}
+
+void MIR_Hash_SetSeed(uint64_t seed) {
+    MIR_Atomic_Store(&gSeed, seed, MIR_ATOMIC_RELEASE);
+}
@@ -0,0 +1,237 @@
+#include <mir/common/interner.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, UINT32_MAX */
+#include <string.h> /* memcmp, memcpy, memset */
+
+#include <mir/common/arith.h> /* MIR_u_Add_WillOverflow */
+#include <mir/common/hash.h>  /* MIR_Hash_Bytes, MIR_Hash_Seed */
+
+
+#define MIN_INDEX_CAP 16u
+
+
+/* NOTE: returns the slot holding the string or the empty slot where it should
+ *       be inserted. The index MUST be allocated */
+static struct MIR_Interner_Slot *FindSlot(
+    const struct MIR_Interner *in, const void *data, size_t len, uint32_t hash
+) {
+    size_t mask = in->indexCap - 1u;
+    size_t i = hash & mask;
+    struct MIR_Interner_Slot *slot;
+
+    for (;; i = (i + 1u) & mask) {
+        slot = &in->index[i];
+        if (slot->id == 0u) {
+            return slot;
+        }
+        if (slot->hash == hash &&
+            MIR_Interner_Len(in, slot->id - 1u) == len &&
+            memcmp(MIR_Interner_Data(in, slot->id - 1u), data, len) == 0) {
+            return slot;
+        }
+    }
+}
+
+/* NOTE: moves the index into a new table of `newCap` slots. The cached hashes
+ *       make it unnecessary to touch the strings */
+static int GrowIndex(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, size_t newCap
+) {
+    struct MIR_Interner_Slot *index;
+    size_t mask = newCap - 1u;
+    size_t i;
+    size_t j;
+
+    if (newCap > SIZE_MAX / sizeof(*index)) {
+        return 1;
+    }
+    index = (struct MIR_Interner_Slot *)reallocF(NULL, newCap * sizeof(*index));
+    if (index == NULL) {
+        return 1;
+    }
+    memset(index, 0, newCap * sizeof(*index));
+
+    for (i = 0; i < in->indexCap; ++i) {
+        if (in->index[i].id == 0u) {
+            continue;
+        }
+        for (j = in->index[i].hash & mask; index[j].id != 0u;
+             j = (j + 1u) & mask) {
+        }
+        index[j] = in->index[i];
+    }
+
+    if (in->index != NULL) {
+        freeF(in->index);
+    }
+    in->index = index;
+    in->indexCap = newCap;
+    return MIR_Interner_OK;
+}
+
+/* NOTE: makes the index big enough for `count` strings */
+static int ReserveIndex(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, size_t count
+) {
+    size_t newCap = (in->indexCap == 0u) ? MIN_INDEX_CAP : in->indexCap;
+
+    while (newCap / 2u < count) {
+        if (newCap > SIZE_MAX / 2u) {
+            return 1;
+        }
+        newCap *= 2u;
+    }
+    if (newCap == in->indexCap) {
+        return MIR_Interner_OK;
+    }
+    return GrowIndex(reallocF, freeF, in, newCap);
+}
+
+
+void MIR_Interner_Init(struct MIR_Interner *in) {
+    __MIR_ASSERT_MSG(in != NULL, "param `in' MUST NOT be NULL");
+
+    MIR_Vec_Init(&in->bytes);
+    MIR_Vec_Init(&in->offsets);
+    in->index = NULL;
+    in->indexCap = 0;
+    in->seed = MIR_Hash_Seed();
+}
+
+int MIR_Interner_Find(
+    const struct MIR_Interner *in, const void *data, size_t len, uint32_t *id
+) {
+    const struct MIR_Interner_Slot *slot;
+
+    __MIR_ASSERT_MSG(in != NULL, "param `in' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        (data != NULL) || (len == 0u), "param `data' MUST NOT be NULL"
+    );
+    __MIR_ASSERT_MSG(id != NULL, "param `id' MUST NOT be NULL");
+
+    if (in->indexCap == 0u) {
+        return 1;
+    }
+    slot = FindSlot(
+        in, data, len, (uint32_t)MIR_Hash_Bytes(data, len, in->seed)
+    );
+    if (slot->id == 0u) {
+        return 1;
+    }
+    *id = slot->id - 1u;
+    return MIR_Interner_OK;
+}
+
+int MIR_Interner_InternByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, const void *data, size_t len, uint32_t *id
+) {
+    struct MIR_Interner_Slot *slot;
+    uint32_t hash;
+    size_t newCap;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(in != NULL, "param `in' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        (data != NULL) || (len == 0u), "param `data' MUST NOT be NULL"
+    );
+    __MIR_ASSERT_MSG(id != NULL, "param `id' MUST NOT be NULL");
+
+    hash = (uint32_t)MIR_Hash_Bytes(data, len, in->seed);
+    if (in->indexCap != 0u) {
+        slot = FindSlot(in, data, len, hash);
+        if (slot->id != 0u) {
+            *id = slot->id - 1u;
+            return MIR_Interner_OK;
+        }
+    }
+
+    /* NOTE: `UINT32_MAX` is reserved, as the index stores `id + 1` */
+    if (in->offsets.len >= (size_t)UINT32_MAX) {
+        return 1;
+    }
+    if (ReserveIndex(reallocF, freeF, in, in->offsets.len + 1u) !=
+        MIR_Interner_OK) {
+        return 1;
+    }
+
+    /* NOTE: the arena grows geometrically, so appending is amortized O(1) */
+    if (MIR_u_Add_WillOverflow(in->bytes.len, len + 1u) != 0 ||
+        len + 1u == 0u) {
+        return 1;
+    }
+    if (in->bytes.len + len + 1u > in->bytes.cap) {
+        newCap = (in->bytes.cap <= SIZE_MAX / 2u) ? in->bytes.cap * 2u : 0u;
+        if (newCap < in->bytes.len + len + 1u) {
+            newCap = in->bytes.len + len + 1u;
+        }
+        if (MIR_Vec_ReserveByReallocF(char, reallocF, &in->bytes, newCap) !=
+            MIR_Vec_OK) {
+            return 1;
+        }
+    }
+    if (MIR_Vec_PushByReallocF(
+            size_t, reallocF, &in->offsets, &in->bytes.len
+        ) != MIR_Vec_OK) {
+        return 1;
+    }
+    if (len != 0u) {
+        memcpy(in->bytes.data + in->bytes.len, data, len);
+    }
+    in->bytes.data[in->bytes.len + len] = '\0';
+    in->bytes.len += len + 1u;
+
+    /* NOTE: the index may have been rebuilt above, so search again */
+    slot = FindSlot(in, data, len, hash);
+    *id = (uint32_t)(in->offsets.len - 1u);
+    slot->id = *id + 1u;
+    slot->hash = hash;
+    return MIR_Interner_OK;
+}
+
+int MIR_Interner_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Interner *in, size_t count, size_t bytes
+) {
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(in != NULL, "param `in' MUST NOT be NULL");
+
+    /* NOTE: every string takes one more byte for '\0' */
+    if (MIR_u_Add_WillOverflow(bytes, count) != 0 ||
+        MIR_u_Add_WillOverflow(in->bytes.len, bytes + count) != 0 ||
+        MIR_u_Add_WillOverflow(in->offsets.len, count) != 0) {
+        return 1;
+    }
+    if (ReserveIndex(reallocF, freeF, in, in->offsets.len + count) !=
+            MIR_Interner_OK ||
+        MIR_Vec_ReserveByReallocF(
+            char, reallocF, &in->bytes, in->bytes.len + bytes + count
+        ) != MIR_Vec_OK ||
+        MIR_Vec_ReserveByReallocF(
+            size_t, reallocF, &in->offsets, in->offsets.len + count
+        ) != MIR_Vec_OK) {
+        return 1;
+    }
+    return MIR_Interner_OK;
+}
+
+void
+MIR_Interner_DeinitByFreeF(void (*freeF)(void *), struct MIR_Interner *in) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(in != NULL, "param `in' MUST NOT be NULL");
+
+    MIR_Vec_DeinitByFreeF(freeF, &in->bytes);
+    MIR_Vec_DeinitByFreeF(freeF, &in->offsets);
+    if (in->index != NULL) {
+        freeF(in->index);
+    }
+    MIR_Vec_Init(&in->bytes);
+    MIR_Vec_Init(&in->offsets);
+    in->index = NULL;
+    in->indexCap = 0;
+}
@@ -1,6 +1,110 @@
 #include <mir/common/mem.h>
 
 #include <stddef.h> /* NULL */
+#ifndef MIR_NO_STD_ALLOCATOR
+#    include <stdint.h> /* uintptr_t */
+#    include <stdlib.h> /* free, realloc */
+#    include <string.h> /* memcpy, memmove */
+
+#    include <mir/common/arith.h>    /* MIR_u_Add_WillOverflow */
+#    include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+#endif
 
 
 void *MIR_FailRealloc(void *__ptr, size_t __newSize) { return NULL; }
+
+
+#ifndef MIR_NO_STD_ALLOCATOR
+
+/**
+ * \brief Header placed right in front of every aligned block.
+ *
+ * \details It's accessed by `memcpy` only, so it needs no alignment.
+ */
+struct AlignedHeader {
+    /**
+     * \brief Offset of the aligned block from the pointer returned by
+     * `realloc`.
+     */
+    size_t offset;
+    /**
+     * \brief Usable size of the aligned block in bytes.
+     */
+    size_t size;
+};
+
+static struct AlignedHeader ReadHeader(const unsigned char *ptr) {
+    struct AlignedHeader hdr;
+
+    memcpy(&hdr, ptr - sizeof(hdr), sizeof(hdr));
+    return hdr;
+}
+
+void *MIR_AlignedMalloc(size_t alignment, size_t size) {
+    return MIR_AlignedRealloc(NULL, alignment, size);
+}
+
+void *MIR_AlignedRealloc(void *ptr, size_t alignment, size_t size) {
+    struct AlignedHeader hdr;
+    unsigned char *raw;
+    unsigned char *aligned;
+    size_t total;
+    size_t offset;
+
+    __MIR_ASSERT_MSG(
+        alignment != 0u && (alignment & (alignment - 1u)) == 0u,
+        "param `alignment' MUST be a power of two"
+    );
+
+    /* NOTE: `size + sizeof(hdr) + alignment - 1` bytes are enough to place
+     *       the header and the aligned block */
+    if (MIR_u_Add_WillOverflow(size, sizeof(hdr) + alignment - 1u) != 0) {
+        return NULL;
+    }
+    total = size + sizeof(hdr) + alignment - 1u;
+
+    if (ptr != NULL) {
+        hdr = ReadHeader((unsigned char *)ptr);
+        raw = (unsigned char *)ptr - hdr.offset;
+    } else {
+        hdr.offset = 0;
+        hdr.size = 0;
+        raw = NULL;
+    }
+
+    raw = (unsigned char *)realloc(raw, total);
+    if (raw == NULL) {
+        return NULL;
+    }
+
+    aligned = raw + sizeof(hdr);
+    aligned += (alignment - (uintptr_t)aligned % alignment) % alignment;
+    offset = (size_t)(aligned - raw);
+
+    /* NOTE: `realloc` preserves the bytes, not the alignment */
+    if (ptr != NULL && offset != hdr.offset) {
+        memmove(
+            aligned, raw + hdr.offset, (hdr.size < size) ? hdr.size : size
+        );
+    }
+
+    hdr.offset = offset;
+    hdr.size = size;
+    memcpy(aligned - sizeof(hdr), &hdr, sizeof(hdr));
+
+    return aligned;
+}
+
+void *MIR_CacheAlignedRealloc(void *ptr, size_t size) {
+    return MIR_AlignedRealloc(ptr, MIR_CACHE_LINE_SIZE, size);
+}
+
+void MIR_AlignedFree(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    free((unsigned char *)ptr - ReadHeader((unsigned char *)ptr).offset);
+}
+
+#endif /* MIR_NO_STD_ALLOCATOR */
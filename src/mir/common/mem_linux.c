@@ -0,0 +1,337 @@
+/* NOTE: `mremap' and `MREMAP_MAYMOVE' are GNU extensions */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
+#include <mir/common/mem.h>
+
+#if defined(__linux__) && !defined(MIR_NO_STD_ALLOCATOR)
+
+#    include <stddef.h>   /* NULL, size_t */
+#    include <stdint.h>   /* SIZE_MAX */
+#    include <stdlib.h>   /* free, malloc, realloc */
+#    include <string.h>   /* memcpy */
+#    include <sys/mman.h> /* madvise, mmap, mremap, munmap */
+#    include <unistd.h>   /* sysconf */
+
+#    include <mir/common/arith.h>  /* MIR_u_Add_WillOverflow */
+#    include <mir/common/atomic.h> /* MIR_Atomic, MIR_Atomic_* */
+
+
+/**
+ * \brief Header placed in front of every block returned by \ref
+ * MIR_MremapRealloc.
+ *
+ * \details It's a union only to keep the block suitably aligned for any scalar
+ * type.
+ */
+union MremapHeader {
+    struct {
+        /**
+         * \brief Usable size of the block in bytes.
+         */
+        size_t size;
+        /**
+         * \brief Length of the mapping (including the header) or `0` if the
+         * block was allocated by `malloc`.
+         */
+        size_t mapLen;
+    } h;
+
+    /* NOTE: alignment only */
+    long double __ld;
+    void *__ptr;
+};
+
+static size_t PageSize(void) {
+    static MIR_Atomic(size_t) pageSize;
+    size_t res = MIR_Atomic_Load(&pageSize, MIR_ATOMIC_RELAXED);
+
+    if (res == 0) {
+        long sz = sysconf(_SC_PAGESIZE);
+        res = (sz > 0) ? (size_t)sz : 4096u;
+        MIR_Atomic_Store(&pageSize, res, MIR_ATOMIC_RELAXED);
+    }
+    return res;
+}
+
+/**
+ * \brief Rounds `size` up to the page size.
+ *
+ * \return rounded size or `0` on overflow
+ */
+static size_t RoundToPage(size_t size) {
+    size_t mask = PageSize() - 1u;
+
+    if (MIR_u_Add_WillOverflow(size, mask) != 0) {
+        return 0;
+    }
+    return (size + mask) & ~mask;
+}
+
+void *MIR_MremapRealloc(void *ptr, size_t newSize) {
+    union MremapHeader *hdr;
+    union MremapHeader *newHdr;
+    size_t total;
+    size_t mapLen;
+
+    if (MIR_u_Add_WillOverflow(newSize, sizeof(*hdr)) != 0) {
+        return NULL;
+    }
+    total = newSize + sizeof(*hdr);
+
+    hdr = (ptr == NULL) ? NULL : (union MremapHeader *)ptr - 1;
+
+    if (total < MIR_MREMAP_THRESHOLD && (hdr == NULL || hdr->h.mapLen == 0)) {
+        newHdr = (union MremapHeader *)realloc(hdr, total);
+        if (newHdr == NULL) {
+            return NULL;
+        }
+        newHdr->h.size = newSize;
+        newHdr->h.mapLen = 0;
+        return newHdr + 1;
+    }
+
+    mapLen = RoundToPage(total);
+    if (mapLen == 0) {
+        return NULL;
+    }
+
+    if (hdr != NULL && hdr->h.mapLen != 0) {
+        /* NOTE: the fast path - the kernel moves page table entries instead of
+         *       copying the data */
+        newHdr = (union MremapHeader *)mremap(
+            hdr, hdr->h.mapLen, mapLen, MREMAP_MAYMOVE
+        );
+        if ((void *)newHdr == MAP_FAILED) {
+            return NULL;
+        }
+    } else {
+        newHdr = (union MremapHeader *)mmap(
+            NULL, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0
+        );
+        if ((void *)newHdr == MAP_FAILED) {
+            return NULL;
+        }
+        /* NOTE: the block crosses the threshold, so it's copied for the first
+         *       and the last time */
+        if (hdr != NULL) {
+            memcpy(newHdr + 1, hdr + 1, hdr->h.size);
+            free(hdr);
+        }
+    }
+
+    newHdr->h.size = newSize;
+    newHdr->h.mapLen = mapLen;
+    return newHdr + 1;
+}
+
+void MIR_MremapFree(void *ptr) {
+    union MremapHeader *hdr;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    hdr = (union MremapHeader *)ptr - 1;
+    if (hdr->h.mapLen != 0) {
+        (void)munmap(hdr, hdr->h.mapLen);
+    } else {
+        free(hdr);
+    }
+}
+
+
+/**
+ * \brief Header placed in front of every block returned by \ref
+ * MIR_HugePageMalloc.
+ *
+ * \details It's padded to \ref MIR_CACHE_LINE_SIZE, so that huge page backed
+ * blocks are cache line aligned.
+ */
+union HugePageHeader {
+    struct {
+        /**
+         * \brief Usable size of the block in bytes.
+         */
+        size_t size;
+        /**
+         * \brief Length of the mapping or `0` if the block was allocated by
+         * `malloc`.
+         */
+        size_t mapLen;
+    } h;
+
+    unsigned char __pad[MIR_CACHE_LINE_SIZE];
+};
+
+/**
+ * \brief Maps `len` bytes at a \ref MIR_HUGE_PAGE_SIZE aligned address and
+ * advises the kernel to back them by huge pages.
+ *
+ * \param len length of the mapping. **MUST** be a multiple of \ref
+ *            MIR_HUGE_PAGE_SIZE
+ *
+ * \return pointer to the mapping or \c NULL on failure
+ */
+static void *MapHuge(size_t len) {
+    unsigned char *raw;
+    unsigned char *aligned;
+    size_t head;
+    size_t tail;
+
+    if (MIR_u_Add_WillOverflow(len, MIR_HUGE_PAGE_SIZE) != 0) {
+        return NULL;
+    }
+
+    /* NOTE: `mmap` guarantees page alignment only, so map one huge page more
+     *       and unmap the misaligned head and the tail */
+    raw = (unsigned char *)mmap(
+        NULL, len + MIR_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if ((void *)raw == MAP_FAILED) {
+        return NULL;
+    }
+
+    head = (MIR_HUGE_PAGE_SIZE - (size_t)raw % MIR_HUGE_PAGE_SIZE) %
+           MIR_HUGE_PAGE_SIZE;
+    tail = MIR_HUGE_PAGE_SIZE - head;
+    aligned = raw + head;
+
+    if (head != 0) {
+        (void)munmap(raw, head);
+    }
+    if (tail != 0) {
+        (void)munmap(aligned + len, tail);
+    }
+
+#    ifdef MADV_HUGEPAGE
+    /* NOTE: failure here means that THP are not available. The mapping is
+     *       still usable with regular pages */
+    (void)madvise(aligned, len, MADV_HUGEPAGE);
+#    endif
+
+    return aligned;
+}
+
+/**
+ * \brief Grows the mapping of `oldLen` bytes at `addr` to `newLen` bytes
+ * keeping it \ref MIR_HUGE_PAGE_SIZE aligned.
+ *
+ * \details The mapping is extended in place if possible. Otherwise an aligned
+ * range is reserved by \ref MapHuge and the pages are moved over it by the
+ * kernel, so the data is never copied.
+ *
+ * \return pointer to the mapping or \c NULL on failure (in which case the
+ * original mapping is left untouched)
+ */
+static void *RemapHuge(void *addr, size_t oldLen, size_t newLen) {
+    void *res = mremap(addr, oldLen, newLen, 0);
+
+    if (res == MAP_FAILED) {
+        void *target = MapHuge(newLen);
+
+        if (target == NULL) {
+            return NULL;
+        }
+        /* NOTE: `MREMAP_FIXED' atomically replaces the reserved range */
+        res = mremap(
+            addr, oldLen, newLen, MREMAP_MAYMOVE | MREMAP_FIXED, target
+        );
+        if (res == MAP_FAILED) {
+            (void)munmap(target, newLen);
+            return NULL;
+        }
+    }
+
+#    ifdef MADV_HUGEPAGE
+    /* NOTE: the grown tail is a new part of the mapping, so advise again */
+    (void)madvise(res, newLen, MADV_HUGEPAGE);
+#    endif
+
+    return res;
+}
+
+void *MIR_HugePageMalloc(size_t size) {
+    return MIR_HugePageRealloc(NULL, size);
+}
+
+void *MIR_HugePageRealloc(void *ptr, size_t newSize) {
+    union HugePageHeader *hdr;
+    union HugePageHeader *newHdr;
+    size_t total;
+    size_t mapLen;
+
+    if (MIR_u_Add_WillOverflow(newSize, sizeof(*hdr)) != 0) {
+        return NULL;
+    }
+    total = newSize + sizeof(*hdr);
+
+    hdr = (ptr == NULL) ? NULL : (union HugePageHeader *)ptr - 1;
+
+    if (newSize < MIR_HUGE_PAGE_THRESHOLD) {
+        if (hdr != NULL && hdr->h.mapLen != 0) {
+            /* NOTE: shrinking a mapped block - keep it mapped */
+            hdr->h.size = newSize;
+            return ptr;
+        }
+        newHdr = (union HugePageHeader *)realloc(hdr, total);
+        if (newHdr == NULL) {
+            return NULL;
+        }
+        newHdr->h.size = newSize;
+        newHdr->h.mapLen = 0;
+        return newHdr + 1;
+    }
+
+    if (hdr != NULL && hdr->h.mapLen >= total) {
+        hdr->h.size = newSize;
+        return ptr;
+    }
+
+    if (MIR_u_Add_WillOverflow(total, MIR_HUGE_PAGE_SIZE - 1u) != 0) {
+        return NULL;
+    }
+    mapLen = (total + MIR_HUGE_PAGE_SIZE - 1u) & ~(MIR_HUGE_PAGE_SIZE - 1u);
+
+    if (hdr != NULL && hdr->h.mapLen != 0) {
+        newHdr = (union HugePageHeader *)RemapHuge(hdr, hdr->h.mapLen, mapLen);
+        if (newHdr == NULL) {
+            return NULL;
+        }
+    } else {
+        newHdr = (union HugePageHeader *)MapHuge(mapLen);
+        if (newHdr == NULL) {
+            return NULL;
+        }
+        /* NOTE: the block crosses the threshold, so it's copied for the first
+         *       and the last time */
+        if (hdr != NULL) {
+            memcpy(newHdr + 1, hdr + 1, hdr->h.size);
+            free(hdr);
+        }
+    }
+
+    newHdr->h.size = newSize;
+    newHdr->h.mapLen = mapLen;
+    return newHdr + 1;
+}
+
+void MIR_HugePageFree(void *ptr) {
+    union HugePageHeader *hdr;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    hdr = (union HugePageHeader *)ptr - 1;
+    if (hdr->h.mapLen != 0) {
+        (void)munmap(hdr, hdr->h.mapLen);
+    } else {
+        free(hdr);
+    }
+}
+
+#endif /* __linux__ && !MIR_NO_STD_ALLOCATOR */
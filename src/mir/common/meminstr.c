@@ -0,0 +1,272 @@
+#include <mir/common/meminstr.h>
+
+#include <string.h> /* memcpy, memset */
+
+
+#ifndef MIR_MEM_INSTR
+
+void MIR_Instr_GetStats(struct MIR_InstrStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+#else /* MIR_MEM_INSTR */
+
+#    include <stddef.h> /* NULL, size_t */
+#    include <stdint.h> /* SIZE_MAX */
+#    ifndef MIR_NO_STD_ALLOCATOR
+#        include <stdlib.h> /* free, realloc */
+#        ifdef __GLIBC__
+#            include <malloc.h> /* malloc_usable_size */
+#        endif
+#    endif
+
+#    include <mir/common/arith.h>  /* MIR_u_Add_WillOverflow */
+#    include <mir/common/atomic.h> /* MIR_Atomic, MIR_Atomic_* */
+#    include <mir/common/env.h>    /* MIR_THREAD_LOCAL */
+
+
+/**
+ * \brief Counters of one thread.
+ *
+ * \details Counters are written only by the owning thread (so plain load+store
+ * is enough) and are read by any thread.
+ */
+struct Counters {
+    MIR_Atomic(size_t) allocs;
+    MIR_Atomic(size_t) reallocs;
+    MIR_Atomic(size_t) frees;
+    MIR_Atomic(size_t) failures;
+    MIR_Atomic(size_t) bytesRequested;
+    MIR_Atomic(size_t) bytesAllocated;
+    MIR_Atomic(size_t) bytesFreed;
+    MIR_Atomic(size_t) bytesMoved;
+    MIR_Atomic(size_t) bytesSlack;
+    MIR_Atomic(size_t) sizeClasses[MIR_INSTR_SIZE_CLASSES];
+
+    struct Counters *next;
+};
+
+/**
+ * \brief Header placed in front of every instrumented block.
+ *
+ * \details It's a union only to keep the block suitably aligned for any scalar
+ * type.
+ */
+union Header {
+    size_t size;
+
+    /* NOTE: alignment only */
+    long double __ld;
+    void *__ptr;
+};
+
+
+#    ifndef MIR_NO_STD_ALLOCATOR
+static void *(*gReallocF)(void *, size_t) = realloc;
+static void (*gFreeF)(void *) = free;
+#    else
+static void *(*gReallocF)(void *, size_t) = NULL;
+static void (*gFreeF)(void *) = NULL;
+#    endif
+
+/* NOTE: list of the counters of all threads that have ever allocated. The
+ *       counters are never freed, as they are needed after the thread exits */
+static MIR_Atomic(struct Counters *) gCountersList;
+
+#    ifdef MIR_THREAD_LOCAL
+
+static MIR_THREAD_LOCAL struct Counters *tCounters;
+
+/**
+ * \brief Increments a counter owned by the current thread.
+ */
+#        define Inc(counter, val)                                              \
+            MIR_Atomic_Store(                                                  \
+                &(counter),                                                    \
+                MIR_Atomic_Load(&(counter), MIR_ATOMIC_RELAXED) + (val),       \
+                MIR_ATOMIC_RELAXED                                             \
+            )
+
+#    else /* MIR_THREAD_LOCAL */
+
+/* NOTE: no TLS - all threads share one set of counters */
+static struct Counters gSharedCounters;
+
+#        define Inc(counter, val)                                              \
+            (void)MIR_Atomic_FetchAdd(&(counter), (val), MIR_ATOMIC_RELAXED)
+
+#    endif /* MIR_THREAD_LOCAL */
+
+
+/**
+ * \brief Returns the counters of the current thread.
+ *
+ * \return pointer to the counters or \c NULL if they can't be allocated
+ */
+static struct Counters *GetCounters(void) {
+#    ifdef MIR_THREAD_LOCAL
+    struct Counters *counters;
+    struct Counters *head;
+
+    if (tCounters != NULL) {
+        return tCounters;
+    }
+
+    counters = (struct Counters *)gReallocF(NULL, sizeof(*counters));
+    if (counters == NULL) {
+        return NULL;
+    }
+    memset(counters, 0, sizeof(*counters));
+
+    head = MIR_Atomic_Load(&gCountersList, MIR_ATOMIC_RELAXED);
+    do {
+        counters->next = head;
+    } while (!MIR_Atomic_CompareExchangeWeak(
+        &gCountersList, &head, counters, MIR_ATOMIC_RELEASE, MIR_ATOMIC_RELAXED
+    ));
+
+    tCounters = counters;
+    return counters;
+#    else
+    struct Counters *expected = NULL;
+
+    (void)MIR_Atomic_CompareExchangeStrong(
+        &gCountersList, &expected, &gSharedCounters, MIR_ATOMIC_RELEASE,
+        MIR_ATOMIC_RELAXED
+    );
+    return &gSharedCounters;
+#    endif
+}
+
+static size_t SizeClass(size_t size) {
+    size_t cls = 0;
+
+    while (size != 0u) {
+        size >>= 1;
+        ++cls;
+    }
+    return (cls < MIR_INSTR_SIZE_CLASSES) ? cls : MIR_INSTR_SIZE_CLASSES - 1u;
+}
+
+static size_t UsableSize(union Header *hdr) {
+#    if !defined(MIR_NO_STD_ALLOCATOR) && defined(__GLIBC__)
+    if (gReallocF == realloc) {
+        return malloc_usable_size(hdr) - sizeof(*hdr);
+    }
+#    endif
+    return hdr->size;
+}
+
+void MIR_Instr_SetBackend(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *)
+) {
+    gReallocF = reallocF;
+    gFreeF = freeF;
+}
+
+void *MIR_InstrMalloc(size_t size) { return MIR_InstrRealloc(NULL, size); }
+
+void *MIR_InstrRealloc(void *ptr, size_t size) {
+    struct Counters *counters;
+    union Header *oldHdr;
+    union Header *hdr;
+    size_t oldSize;
+
+    counters = GetCounters();
+
+    oldHdr = (ptr == NULL) ? NULL : (union Header *)ptr - 1;
+    oldSize = (oldHdr == NULL) ? 0u : oldHdr->size;
+
+    if (MIR_u_Add_WillOverflow(size, sizeof(*hdr)) != 0) {
+        hdr = NULL;
+    } else {
+        hdr = (union Header *)gReallocF(oldHdr, size + sizeof(*hdr));
+    }
+
+    if (counters == NULL) {
+        if (hdr == NULL) {
+            return NULL;
+        }
+        hdr->size = size;
+        return hdr + 1;
+    }
+
+    if (hdr == NULL) {
+        Inc(counters->failures, 1u);
+        return NULL;
+    }
+    hdr->size = size;
+
+    if (oldHdr == NULL) {
+        Inc(counters->allocs, 1u);
+    } else {
+        Inc(counters->reallocs, 1u);
+        Inc(counters->bytesFreed, oldSize);
+        /* NOTE: comparing a pointer to a freed block is fine as long as it's
+         *       not dereferenced (and it's compared as an integer) */
+        if ((size_t)hdr != (size_t)oldHdr) {
+            Inc(counters->bytesMoved, (oldSize < size) ? oldSize : size);
+        }
+    }
+    Inc(counters->bytesRequested, size);
+    Inc(counters->bytesAllocated, size);
+    Inc(counters->bytesSlack, UsableSize(hdr) - size);
+    Inc(counters->sizeClasses[SizeClass(size)], 1u);
+
+    return hdr + 1;
+}
+
+void MIR_InstrFree(void *ptr) {
+    struct Counters *counters;
+    union Header *hdr;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    hdr = (union Header *)ptr - 1;
+
+    counters = GetCounters();
+    if (counters != NULL) {
+        Inc(counters->frees, 1u);
+        Inc(counters->bytesFreed, hdr->size);
+    }
+
+    gFreeF(hdr);
+}
+
+void MIR_Instr_GetStats(struct MIR_InstrStats *stats) {
+    struct Counters *counters;
+    size_t allocated = 0;
+    size_t freed = 0;
+    size_t i;
+
+    memset(stats, 0, sizeof(*stats));
+
+    counters = MIR_Atomic_Load(&gCountersList, MIR_ATOMIC_ACQUIRE);
+    for (; counters != NULL; counters = counters->next) {
+#    define Sum(dst, counter)                                                  \
+        (dst) += MIR_Atomic_Load(&(counter), MIR_ATOMIC_RELAXED)
+
+        Sum(stats->allocs, counters->allocs);
+        Sum(stats->reallocs, counters->reallocs);
+        Sum(stats->frees, counters->frees);
+        Sum(stats->failures, counters->failures);
+        Sum(stats->bytesRequested, counters->bytesRequested);
+        Sum(stats->bytesMoved, counters->bytesMoved);
+        Sum(stats->bytesSlack, counters->bytesSlack);
+        Sum(allocated, counters->bytesAllocated);
+        Sum(freed, counters->bytesFreed);
+        for (i = 0; i < MIR_INSTR_SIZE_CLASSES; ++i) {
+            Sum(stats->sizeClasses[i], counters->sizeClasses[i]);
+        }
+
+#    undef Sum
+    }
+
+    /* NOTE: a block may be allocated by one thread and freed by another, so
+     *       only the merged difference is meaningful */
+    stats->bytesLive = allocated - freed;
+}
+
+#endif /* MIR_MEM_INSTR */
@@ -0,0 +1,628 @@
+#include <mir/common/radix.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX, uint*_t */
+#include <string.h> /* memcmp, memcpy, memset */
+
+#include <mir/common/concurrent/threadpool.h> /* MIR_ThreadPool_ParallelFor */
+#include <mir/common/env.h>                   /* MIR_HAS_PTHREADS */
+#include <mir/common/macros.h>                /* MIR_INLINE, MIR_PREFETCH_W */
+#include <mir/common/mem.h>                   /* MIR_CACHE_LINE_SIZE */
+#include <mir/internal/assert.h>              /* __MIR_ASSERT_MSG */
+
+
+#define RADIX 256u
+
+/* NOTE: upper bound of the number of chunks of a parallel LSD sort */
+#define MAX_CHUNKS 64u
+
+/* NOTE: size of a write-combining buffer (one per bucket) */
+#define WC_BYTES MIR_CACHE_LINE_SIZE
+
+/* NOTE: how many elements ahead the passes prefetch keys and destinations */
+#define PREFETCH_DIST 16u
+
+
+/**
+ * \brief State of an LSD sort shared by the chunks.
+ */
+struct Lsd {
+    unsigned char *src;
+    unsigned char *dst;
+    size_t len;
+    size_t elemSize;
+    size_t keyOffset;
+    size_t keySize;
+    size_t nchunks;
+
+    /**
+     * \brief Digit of the current pass (`0` is the least significant).
+     */
+    size_t digit;
+
+    /**
+     * \brief `[nchunks][keySize][RADIX]` digit counts.
+     */
+    size_t *counts;
+
+    /**
+     * \brief `[nchunks][RADIX]` next destination index of every bucket.
+     */
+    size_t *offsets;
+
+    /**
+     * \brief `[nchunks][RADIX][WC_BYTES]` write-combining buffers.
+     */
+    unsigned char *wc;
+};
+
+static uint64_t LoadKey(const unsigned char *p, size_t keySize) {
+    uint8_t k8;
+    uint16_t k16;
+    uint32_t k32;
+    uint64_t k64;
+
+    switch (keySize) {
+    case 1u:
+        memcpy(&k8, p, 1u);
+        return k8;
+    case 2u:
+        memcpy(&k16, p, 2u);
+        return k16;
+    case 4u:
+        memcpy(&k32, p, 4u);
+        return k32;
+    default:
+        memcpy(&k64, p, 8u);
+        return k64;
+    }
+}
+
+static size_t ChunkBegin(const struct Lsd *s, size_t c) {
+    size_t q = s->len / s->nchunks;
+    size_t r = s->len % s->nchunks;
+
+    return q * c + (c < r ? c : r);
+}
+
+/* NOTE: the `...Impl' functions take `elemSize' and `keySize' as arguments, so
+ *       the calls with constants in `DISPATCH' are specialized by the compiler
+ *       for plain 32- and 64-bit keys */
+#define DISPATCH(impl, s, c)                                                   \
+    do {                                                                       \
+        if ((s)->elemSize == 4u && (s)->keySize == 4u) {                       \
+            impl((s), (c), 4u, 4u);                                            \
+        } else if ((s)->elemSize == 8u && (s)->keySize == 8u) {                \
+            impl((s), (c), 8u, 8u);                                            \
+        } else {                                                               \
+            impl((s), (c), (s)->elemSize, (s)->keySize);                       \
+        }                                                                      \
+    } while (0)
+
+MIR_INLINE void
+CountAllImpl(struct Lsd *s, size_t c, size_t elemSize, size_t keySize) {
+    size_t *hist = s->counts + c * keySize * RADIX;
+    const unsigned char *p = s->src + s->keyOffset;
+    size_t end = ChunkBegin(s, c + 1u);
+    size_t i;
+    size_t d;
+    uint64_t k;
+
+    memset(hist, 0, keySize * RADIX * sizeof(size_t));
+    for (i = ChunkBegin(s, c); i < end; ++i) {
+        if (i + PREFETCH_DIST < end) {
+            MIR_PREFETCH(p + (i + PREFETCH_DIST) * elemSize);
+        }
+        k = LoadKey(p + i * elemSize, keySize);
+        for (d = 0; d < keySize; ++d) {
+            ++hist[d * RADIX + (size_t)((k >> (8u * d)) & 0xffu)];
+        }
+    }
+}
+
+MIR_INLINE void
+CountDigitImpl(struct Lsd *s, size_t c, size_t elemSize, size_t keySize) {
+    size_t *hist = s->counts + (c * keySize + s->digit) * RADIX;
+    const unsigned char *p = s->src + s->keyOffset;
+    unsigned shift = 8u * (unsigned)s->digit;
+    size_t end = ChunkBegin(s, c + 1u);
+    size_t i;
+
+    memset(hist, 0, RADIX * sizeof(size_t));
+    for (i = ChunkBegin(s, c); i < end; ++i) {
+        if (i + PREFETCH_DIST < end) {
+            MIR_PREFETCH(p + (i + PREFETCH_DIST) * elemSize);
+        }
+        ++hist[(size_t)((LoadKey(p + i * elemSize, keySize) >> shift) & 0xffu)];
+    }
+}
+
+MIR_INLINE void
+ScatterImpl(struct Lsd *s, size_t c, size_t elemSize, size_t keySize) {
+    size_t *off = s->offsets + c * RADIX;
+    unsigned char *wc = s->wc + c * RADIX * WC_BYTES;
+    const unsigned char *src = s->src;
+    unsigned char *dst = s->dst;
+    unsigned shift = 8u * (unsigned)s->digit;
+    const unsigned char *keys = s->src + s->keyOffset;
+    size_t wcCap = WC_BYTES / elemSize;
+    size_t end = ChunkBegin(s, c + 1u);
+    size_t i = ChunkBegin(s, c);
+    size_t b;
+    unsigned char fill[RADIX];
+    unsigned char need[RADIX];
+    uintptr_t head;
+
+#define DIGIT(j)                                                               \
+    ((size_t)(LoadKey(keys + (j) * elemSize, keySize) >> shift) & 0xffu)
+
+    if (wcCap < 2u) {
+        for (; i < end; ++i) {
+            if (i + PREFETCH_DIST < end) {
+                MIR_PREFETCH_W(dst + off[DIGIT(i + PREFETCH_DIST)] * elemSize);
+            }
+            b = DIGIT(i);
+            memcpy(dst + off[b] * elemSize, src + i * elemSize, elemSize);
+            ++off[b];
+        }
+        return;
+    }
+
+    /* NOTE: elements are gathered per bucket and written out a cache line at
+     *       a time, so the scatter doesn't thrash the TLB and the store
+     *       buffer with 256 interleaved streams. The first flush of a bucket
+     *       only fills up the line its range starts in, so the following
+     *       ones are whole aligned lines (if `elemSize' divides the line) */
+    memset(fill, 0, sizeof(fill));
+    for (b = 0; b < RADIX; ++b) {
+        head = (uintptr_t)(dst + off[b] * elemSize) % WC_BYTES;
+        head = (WC_BYTES - head) / elemSize;
+        need[b] = (unsigned char)((head > 0u) ? head : wcCap);
+    }
+    for (; i < end; ++i) {
+        b = DIGIT(i);
+        memcpy(
+            wc + b * WC_BYTES + fill[b] * elemSize, src + i * elemSize, elemSize
+        );
+        if (++fill[b] == need[b]) {
+            memcpy(
+                dst + off[b] * elemSize, wc + b * WC_BYTES, fill[b] * elemSize
+            );
+            off[b] += fill[b];
+            fill[b] = 0;
+            need[b] = (unsigned char)wcCap;
+        }
+    }
+    for (b = 0; b < RADIX; ++b) {
+        if (fill[b] != 0u) {
+            memcpy(
+                dst + off[b] * elemSize, wc + b * WC_BYTES, fill[b] * elemSize
+            );
+        }
+    }
+
+#undef DIGIT
+}
+
+static void CountAllTask(void *ctx, size_t begin, size_t end) {
+    struct Lsd *s = (struct Lsd *)ctx;
+
+    for (; begin < end; ++begin) {
+        DISPATCH(CountAllImpl, s, begin);
+    }
+}
+
+static void CountDigitTask(void *ctx, size_t begin, size_t end) {
+    struct Lsd *s = (struct Lsd *)ctx;
+
+    for (; begin < end; ++begin) {
+        DISPATCH(CountDigitImpl, s, begin);
+    }
+}
+
+static void ScatterTask(void *ctx, size_t begin, size_t end) {
+    struct Lsd *s = (struct Lsd *)ctx;
+
+    for (; begin < end; ++begin) {
+        DISPATCH(ScatterImpl, s, begin);
+    }
+}
+
+static void CopyTask(void *ctx, size_t begin, size_t end) {
+    struct Lsd *s = (struct Lsd *)ctx;
+    size_t from;
+    size_t to;
+
+    for (; begin < end; ++begin) {
+        from = ChunkBegin(s, begin);
+        to = ChunkBegin(s, begin + 1u);
+        memcpy(
+            s->dst + from * s->elemSize, s->src + from * s->elemSize,
+            (to - from) * s->elemSize
+        );
+    }
+}
+
+static void ForChunks(
+    struct Lsd *s, struct MIR_ThreadPool *pool,
+    void (*fn)(void *ctx, size_t begin, size_t end)
+) {
+#ifdef MIR_HAS_PTHREADS
+    if (s->nchunks > 1u) {
+        MIR_ThreadPool_ParallelFor(pool, 0, s->nchunks, 1u, fn, s);
+        return;
+    }
+#else
+    (void)pool;
+#endif
+    fn(s, 0, s->nchunks);
+}
+
+/* NOTE: returns non-zero iff all keys have the same digit `d' */
+static int IsTrivialDigit(const struct Lsd *s, size_t d) {
+    size_t b;
+    size_t c;
+    size_t n;
+
+    for (b = 0; b < RADIX; ++b) {
+        n = 0;
+        for (c = 0; c < s->nchunks; ++c) {
+            n += s->counts[(c * s->keySize + d) * RADIX + b];
+        }
+        if (n != 0u) {
+            return n == s->len;
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * \brief State of an MSD sort.
+ */
+struct Msd {
+    struct MIR_Radix_Span *data;
+    struct MIR_Radix_Span *tmp;
+
+    /**
+     * \brief Byte at the current depth plus one, or `0` past the end.
+     */
+    uint16_t *oracle;
+
+    /**
+     * \brief Stack of unsorted buckets. Buckets on the stack are disjoint and
+     * longer than \ref MIR_RADIX_SPANS_SMALL, so `len / (SMALL + 1)` entries
+     * are enough, and a parallel sort gives every top-level bucket its own
+     * part of it.
+     */
+    struct MsdTask *stack;
+
+    /**
+     * \brief Bounds of the top-level buckets of a parallel sort.
+     */
+    size_t bounds[RADIX + 2u];
+
+    /**
+     * \brief Depth of the top-level split of a parallel sort.
+     */
+    size_t depth;
+};
+
+struct MsdTask {
+    size_t begin;
+    size_t len;
+    size_t depth;
+};
+
+/* NOTE: all spans share the prefix of length `depth' */
+static int SpanLess(
+    const struct MIR_Radix_Span *a, const struct MIR_Radix_Span *b,
+    size_t depth
+) {
+    size_t la = a->len - depth;
+    size_t lb = b->len - depth;
+    size_t n = (la < lb) ? la : lb;
+    int r = (n == 0u) ? 0 : memcmp(a->data + depth, b->data + depth, n);
+
+    return r < 0 || (r == 0 && la < lb);
+}
+
+static void InsertionSort(struct MIR_Radix_Span *a, size_t n, size_t depth) {
+    struct MIR_Radix_Span x;
+    size_t i;
+    size_t j;
+
+    for (i = 1; i < n; ++i) {
+        x = a[i];
+        for (j = i; j > 0u && SpanLess(&x, &a[j - 1u], depth); --j) {
+            a[j] = a[j - 1u];
+        }
+        a[j] = x;
+    }
+}
+
+/* NOTE: partitions `n' spans starting at `begin' by the byte at `depth' and
+ *       stores the start of every bucket (`0' is the ended strings) and `n'
+ *       into `bounds' */
+static void Partition(
+    struct Msd *m, size_t begin, size_t n, size_t depth,
+    size_t bounds[RADIX + 2u]
+) {
+    struct MIR_Radix_Span *a = m->data + begin;
+    struct MIR_Radix_Span *t = m->tmp + begin;
+    uint16_t *o = m->oracle + begin;
+    size_t count[RADIX + 1u];
+    size_t pos[RADIX + 1u];
+    size_t i;
+    size_t k;
+    size_t sum = 0;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < n; ++i) {
+        o[i] = (depth < a[i].len) ? (uint16_t)(a[i].data[depth] + 1u) : 0u;
+        ++count[o[i]];
+    }
+    for (k = 0; k <= RADIX; ++k) {
+        bounds[k] = pos[k] = sum;
+        sum += count[k];
+    }
+    bounds[RADIX + 1u] = n;
+
+    if (count[o[0]] == n) {
+        return;
+    }
+    for (i = 0; i < n; ++i) {
+        t[pos[o[i]]++] = a[i];
+    }
+    memcpy(a, t, n * sizeof(*a));
+}
+
+/* NOTE: sorts `n' spans starting at `begin' sharing the prefix of length
+ *       `depth'. `stack' MUST have room for `n / (SMALL + 1)' entries */
+static void SortSpans(
+    struct Msd *m, struct MsdTask *stack, size_t begin, size_t n, size_t depth
+) {
+    size_t bounds[RADIX + 2u];
+    struct MsdTask t;
+    size_t top = 0;
+    size_t k;
+    size_t cnt;
+
+    t.begin = begin;
+    t.len = n;
+    t.depth = depth;
+    for (;;) {
+        Partition(m, t.begin, t.len, t.depth, bounds);
+        for (k = 1; k <= RADIX; ++k) {
+            cnt = bounds[k + 1u] - bounds[k];
+            if (cnt > MIR_RADIX_SPANS_SMALL) {
+                stack[top].begin = t.begin + bounds[k];
+                stack[top].len = cnt;
+                stack[top].depth = t.depth + 1u;
+                ++top;
+            } else if (cnt > 1u) {
+                InsertionSort(m->data + t.begin + bounds[k], cnt, t.depth + 1u);
+            }
+        }
+        if (top == 0u) {
+            break;
+        }
+        t = stack[--top];
+    }
+}
+
+#ifdef MIR_HAS_PTHREADS
+
+static void SortBucketsTask(void *ctx, size_t begin, size_t end) {
+    struct Msd *m = (struct Msd *)ctx;
+    size_t lo;
+    size_t n;
+
+    for (; begin < end; ++begin) {
+        lo = m->bounds[begin];
+        n = m->bounds[begin + 1u] - lo;
+        if (n > MIR_RADIX_SPANS_SMALL) {
+            SortSpans(
+                m, m->stack + lo / (MIR_RADIX_SPANS_SMALL + 1u) + begin, lo, n,
+                m->depth + 1u
+            );
+        } else if (n > 1u) {
+            InsertionSort(m->data + lo, n, m->depth + 1u);
+        }
+    }
+}
+
+#endif /* MIR_HAS_PTHREADS */
+
+
+int __MIR_Radix_SortKeyed_impl(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), void *data,
+    size_t len, size_t elemSize, size_t keyOffset, size_t keySize,
+    struct MIR_ThreadPool *pool
+) {
+    struct Lsd s;
+    unsigned char *scratch;
+    unsigned char *tmp;
+    size_t d;
+    size_t b;
+    size_t c;
+    size_t sum;
+    int first = 1;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        data != NULL || len == 0u, "param `data' MUST NOT be NULL"
+    );
+    __MIR_ASSERT_MSG(
+        keySize == 1u || keySize == 2u || keySize == 4u || keySize == 8u,
+        "param `keySize' MUST be 1, 2, 4 or 8"
+    );
+    __MIR_ASSERT_MSG(
+        keyOffset + keySize <= elemSize, "the key MUST be inside the element"
+    );
+
+    if (len < 2u) {
+        return MIR_Radix_OK;
+    }
+
+    s.nchunks = 1u;
+#ifdef MIR_HAS_PTHREADS
+    if (pool != NULL && len >= MIR_RADIX_PARALLEL_MIN) {
+        s.nchunks = (pool->nthreads < MAX_CHUNKS) ? pool->nthreads + 1u
+                                                  : MAX_CHUNKS;
+    }
+#endif
+
+    if (len > SIZE_MAX / elemSize) {
+        return 1;
+    }
+    scratch = (unsigned char *)reallocF(NULL, len * elemSize);
+    if (scratch == NULL) {
+        return 1;
+    }
+    s.counts = (size_t *)reallocF(
+        NULL, s.nchunks * ((keySize + 1u) * RADIX * sizeof(size_t) +
+                           RADIX * WC_BYTES)
+    );
+    if (s.counts == NULL) {
+        freeF(scratch);
+        return 1;
+    }
+    s.offsets = s.counts + s.nchunks * keySize * RADIX;
+    s.wc = (unsigned char *)(s.offsets + s.nchunks * RADIX);
+    s.src = (unsigned char *)data;
+    s.dst = scratch;
+    s.len = len;
+    s.elemSize = elemSize;
+    s.keyOffset = keyOffset;
+    s.keySize = keySize;
+
+    ForChunks(&s, pool, CountAllTask);
+    for (d = 0; d < keySize; ++d) {
+        /* NOTE: the totals don't change from pass to pass, so the stale
+         *       per-chunk counts are still good for this check */
+        if (IsTrivialDigit(&s, d)) {
+            continue;
+        }
+        s.digit = d;
+        if (!first && s.nchunks > 1u) {
+            ForChunks(&s, pool, CountDigitTask);
+        }
+        first = 0;
+
+        sum = 0;
+        for (b = 0; b < RADIX; ++b) {
+            for (c = 0; c < s.nchunks; ++c) {
+                s.offsets[c * RADIX + b] = sum;
+                sum += s.counts[(c * keySize + d) * RADIX + b];
+            }
+        }
+        ForChunks(&s, pool, ScatterTask);
+
+        tmp = s.src;
+        s.src = s.dst;
+        s.dst = tmp;
+    }
+    if (s.src == scratch) {
+        ForChunks(&s, pool, CopyTask);
+    }
+
+    freeF(s.counts);
+    freeF(scratch);
+    return MIR_Radix_OK;
+}
+
+int MIR_Radix_SortU32ByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), uint32_t *data,
+    size_t len, struct MIR_ThreadPool *pool
+) {
+    return __MIR_Radix_SortKeyed_impl(
+        reallocF, freeF, data, len, sizeof(*data), 0, sizeof(*data), pool
+    );
+}
+
+int MIR_Radix_SortU64ByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *), uint64_t *data,
+    size_t len, struct MIR_ThreadPool *pool
+) {
+    return __MIR_Radix_SortKeyed_impl(
+        reallocF, freeF, data, len, sizeof(*data), 0, sizeof(*data), pool
+    );
+}
+
+int MIR_Radix_SortSpansByReallocF(
+    void *(*reallocF)(void *, size_t), void (*freeF)(void *),
+    struct MIR_Radix_Span *data, size_t len, struct MIR_ThreadPool *pool
+) {
+    struct Msd m;
+    size_t stackLen;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        data != NULL || len == 0u, "param `data' MUST NOT be NULL"
+    );
+
+    if (len <= MIR_RADIX_SPANS_SMALL) {
+        InsertionSort(data, len, 0);
+        return MIR_Radix_OK;
+    }
+
+    /* NOTE: `+ RADIX + 2' is the slack of the per-bucket stack parts */
+    stackLen = len / (MIR_RADIX_SPANS_SMALL + 1u) + RADIX + 2u;
+    if (len > SIZE_MAX / (sizeof(*m.tmp) + sizeof(*m.oracle)) ||
+        stackLen > SIZE_MAX / sizeof(*m.stack)) {
+        return 1;
+    }
+    m.tmp = (struct MIR_Radix_Span *)reallocF(
+        NULL, len * (sizeof(*m.tmp) + sizeof(*m.oracle))
+    );
+    if (m.tmp == NULL) {
+        return 1;
+    }
+    m.stack = (struct MsdTask *)reallocF(NULL, stackLen * sizeof(*m.stack));
+    if (m.stack == NULL) {
+        freeF(m.tmp);
+        return 1;
+    }
+    m.oracle = (uint16_t *)(void *)(m.tmp + len);
+    m.data = data;
+
+#ifdef MIR_HAS_PTHREADS
+    if (pool != NULL && len >= MIR_RADIX_PARALLEL_MIN) {
+        size_t n;
+        size_t k;
+
+        /* NOTE: descend until the strings are split, then sort the buckets in
+         *       parallel */
+        for (m.depth = 0;; ++m.depth) {
+            Partition(&m, 0, len, m.depth, m.bounds);
+            for (k = 0; k <= RADIX; ++k) {
+                n = m.bounds[k + 1u] - m.bounds[k];
+                if (n != 0u) {
+                    break;
+                }
+            }
+            if (n != len) {
+                MIR_ThreadPool_ParallelFor(
+                    pool, 1u, RADIX + 1u, 1u, SortBucketsTask, &m
+                );
+                break;
+            }
+            if (k == 0u) {
+                break;
+            }
+        }
+    } else {
+        SortSpans(&m, m.stack, 0, len, 0);
+    }
+#else
+    (void)pool;
+    SortSpans(&m, m.stack, 0, len, 0);
+#endif
+
+    freeF(m.stack);
+    freeF(m.tmp);
+    return MIR_Radix_OK;
+}
@@ -0,0 +1,159 @@
+#include <mir/common/search.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* INT32_MAX, SIZE_MAX, UINT32_MAX */
+#include <string.h> /* memcpy */
+
+#ifdef __SSE2__
+#    include <emmintrin.h> /* _mm_* */
+#endif
+
+#include <mir/common/bits.h>     /* MIR_Bits_Popcount64 */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+#define B MIR_STREE32_B
+
+
+/* NOTE: returns the number of keys of the node less than `key' */
+#ifdef __SSE2__
+static unsigned NodeRank(const int32_t *node, __m128i key) {
+    const __m128i *p = (const __m128i *)(const void *)node;
+    __m128i lo = _mm_packs_epi32(
+        _mm_cmpgt_epi32(key, _mm_loadu_si128(p)),
+        _mm_cmpgt_epi32(key, _mm_loadu_si128(p + 1))
+    );
+    __m128i hi = _mm_packs_epi32(
+        _mm_cmpgt_epi32(key, _mm_loadu_si128(p + 2)),
+        _mm_cmpgt_epi32(key, _mm_loadu_si128(p + 3))
+    );
+
+    return MIR_Bits_Popcount64(
+        (uint64_t)(unsigned)_mm_movemask_epi8(_mm_packs_epi16(lo, hi))
+    );
+}
+#else
+static unsigned NodeRank(const int32_t *node, int32_t key) {
+    unsigned n = 0;
+    unsigned i;
+
+    for (i = 0; i < B; ++i) {
+        n += (unsigned)(node[i] < key);
+    }
+    return n;
+}
+#endif
+
+
+int MIR_STree32_InitByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_STree32 *tree,
+    const int32_t *sorted, size_t len
+) {
+    size_t sizes[MIR_STREE32_MAX_HEIGHT];
+    size_t nodes = 0;
+    size_t leaves;
+    size_t h;
+    size_t l;
+    size_t k;
+    size_t j;
+    size_t c;
+    int32_t *leaf;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(tree != NULL, "param `tree' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        sorted != NULL || len == 0u, "param `sorted' MUST NOT be NULL"
+    );
+
+    tree->keys = NULL;
+    tree->height = 0;
+    tree->len = len;
+    if (len == 0u) {
+        return MIR_STree32_OK;
+    }
+    if (len > UINT32_MAX) {
+        return 1;
+    }
+
+    /* NOTE: layer sizes from the leaves up, then reversed */
+    leaves = (len + B - 1u) / B;
+    for (c = leaves;; c = (c + B) / (B + 1u)) {
+        sizes[tree->height++] = c;
+        nodes += c;
+        if (c == 1u) {
+            break;
+        }
+    }
+    for (h = 0; h < tree->height / 2u; ++h) {
+        c = sizes[h];
+        sizes[h] = sizes[tree->height - 1u - h];
+        sizes[tree->height - 1u - h] = c;
+    }
+    for (h = 0, c = 0; h < tree->height; c += sizes[h++]) {
+        tree->layers[h] = c;
+    }
+
+    if (nodes > SIZE_MAX / (B * sizeof(int32_t))) {
+        return 1;
+    }
+    tree->keys = (int32_t *)reallocF(NULL, nodes * B * sizeof(int32_t));
+    if (tree->keys == NULL) {
+        return 1;
+    }
+
+    leaf = tree->keys + tree->layers[tree->height - 1u] * B;
+    memcpy(leaf, sorted, len * sizeof(int32_t));
+    for (j = len; j < leaves * B; ++j) {
+        leaf[j] = INT32_MAX;
+    }
+
+    /* NOTE: key `j' of an internal node is the first key of the leftmost
+     *       leaf under child `j + 1' */
+    for (h = 0; h + 1u < tree->height; ++h) {
+        for (k = 0; k < sizes[h]; ++k) {
+            for (j = 0; j < B; ++j) {
+                c = k * (B + 1u) + j + 1u;
+                for (l = h + 1u; l + 1u < tree->height; ++l) {
+                    c *= B + 1u;
+                }
+                tree->keys[(tree->layers[h] + k) * B + j] =
+                    (c < leaves) ? leaf[c * B] : INT32_MAX;
+            }
+        }
+    }
+    return MIR_STree32_OK;
+}
+
+void MIR_STree32_DeinitByFreeF(
+    void (*freeF)(void *), struct MIR_STree32 *tree
+) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(tree != NULL, "param `tree' MUST NOT be NULL");
+
+    if (tree->keys != NULL) {
+        freeF(tree->keys);
+    }
+    tree->keys = NULL;
+    tree->height = 0;
+    tree->len = 0;
+}
+
+size_t MIR_STree32_LowerBound(const struct MIR_STree32 *tree, int32_t key) {
+    size_t k = 0;
+    size_t h;
+    size_t i;
+#ifdef __SSE2__
+    __m128i x = _mm_set1_epi32(key);
+#else
+    int32_t x = key;
+#endif
+
+    if (tree->height == 0u) {
+        return 0;
+    }
+    for (h = 0; h + 1u < tree->height; ++h) {
+        k = k * (B + 1u) + NodeRank(tree->keys + (tree->layers[h] + k) * B, x);
+    }
+    i = k * B + NodeRank(tree->keys + (tree->layers[h] + k) * B, x);
+    return (i < tree->len) ? i : tree->len;
+}
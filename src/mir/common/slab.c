@@ -0,0 +1,99 @@
+#include <mir/common/slab.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <stdint.h> /* SIZE_MAX */
+
+#include <mir/common/arith.h>    /* MIR_u_Mul_WillOverflow */
+#include <mir/internal/assert.h> /* __MIR_ASSERT_MSG */
+
+
+#define SMALL_ALIGN (2u * sizeof(void *))
+
+
+void MIR_Slab_Init(struct MIR_Slab *slab, size_t objSize, size_t chunkObjs) {
+    size_t align = (objSize >= MIR_CACHE_LINE_SIZE) ? MIR_CACHE_LINE_SIZE
+                                                    : SMALL_ALIGN;
+
+    __MIR_ASSERT_MSG(slab != NULL, "param `slab' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(objSize > 0u, "param `objSize' MUST be greater than 0");
+    __MIR_ASSERT_MSG(
+        chunkObjs > 0u, "param `chunkObjs' MUST be greater than 0"
+    );
+
+    slab->chunks = NULL;
+    slab->freeList = NULL;
+    slab->bump = NULL;
+    slab->bumpLeft = 0;
+    /* NOTE: an object holds the free-list link while it's free */
+    if (objSize < sizeof(void *)) {
+        objSize = sizeof(void *);
+    }
+    slab->objSize = (objSize + align - 1u) & ~(align - 1u);
+    slab->chunkObjs = chunkObjs;
+}
+
+void *MIR_Slab_AllocByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Slab *slab
+) {
+    /* NOTE: the header keeps the objects aligned the same way as the chunk */
+    size_t header = (slab->objSize >= MIR_CACHE_LINE_SIZE)
+                        ? MIR_CACHE_LINE_SIZE
+                        : SMALL_ALIGN;
+    unsigned char *chunk;
+    void *obj;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(slab != NULL, "param `slab' MUST NOT be NULL");
+
+    if (slab->freeList != NULL) {
+        obj = slab->freeList;
+        slab->freeList = *(void **)obj;
+        return obj;
+    }
+
+    if (slab->bumpLeft == 0u) {
+        if (MIR_u_Mul_WillOverflow(slab->chunkObjs, slab->objSize, SIZE_MAX) ||
+            slab->chunkObjs * slab->objSize > SIZE_MAX - header) {
+            return NULL;
+        }
+        chunk = (unsigned char *)reallocF(
+            NULL, header + slab->chunkObjs * slab->objSize
+        );
+        if (chunk == NULL) {
+            return NULL;
+        }
+        *(void **)(void *)chunk = slab->chunks;
+        slab->chunks = chunk;
+        slab->bump = chunk + header;
+        slab->bumpLeft = slab->chunkObjs;
+    }
+
+    obj = slab->bump;
+    slab->bump += slab->objSize;
+    --slab->bumpLeft;
+    return obj;
+}
+
+void MIR_Slab_Free(struct MIR_Slab *slab, void *obj) {
+    __MIR_ASSERT_MSG(slab != NULL, "param `slab' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(obj != NULL, "param `obj' MUST NOT be NULL");
+
+    *(void **)obj = slab->freeList;
+    slab->freeList = obj;
+}
+
+void MIR_Slab_DeinitByFreeF(void (*freeF)(void *), struct MIR_Slab *slab) {
+    void *chunk;
+
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(slab != NULL, "param `slab' MUST NOT be NULL");
+
+    while (slab->chunks != NULL) {
+        chunk = slab->chunks;
+        slab->chunks = *(void **)chunk;
+        freeF(chunk);
+    }
+    slab->freeList = NULL;
+    slab->bump = NULL;
+    slab->bumpLeft = 0;
+}
@@ -0,0 +1,217 @@
+#include <mir/common/str.h>
+
+#include <stddef.h> /* NULL, size_t */
+#include <string.h> /* memcpy */
+
+#include <mir/common/bits.h>            /* MIR_Bits_Clz64 */
+#include <mir/common/collections/vec.h> /* __MIR_Vec_ReserveByReallocF_impl */
+
+
+static const char *ConstData(const struct MIR_Str *s) {
+    return MIR_Str_IsInline(s) ? (const char *)s->u.buf : s->u.heap.data;
+}
+
+/* NOTE: writes the length and the trailing '\0'; keeps the flags */
+static void SetLen(struct MIR_Str *s, size_t len) {
+    if (MIR_Str_IsInline(s)) {
+        s->u.buf[len] = 0;
+        __MIR_STR_META(s) =
+            (unsigned char)((len << 2) | (__MIR_STR_META(s) & 0x3u));
+    } else {
+        s->u.heap.data[len] = '\0';
+        s->u.heap.len = len;
+    }
+}
+
+
+int MIR_Str_IsValidUTF8(struct MIR_Str *s) {
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    if ((__MIR_STR_META(s) & __MIR_STR_UTF8) != 0u) {
+        return 1;
+    }
+    if (MIR_UTF8_IsValid(
+            (const unsigned char *)MIR_Str_Data(s), MIR_Str_Len(s)
+        ) == 0) {
+        return 0;
+    }
+    __MIR_STR_META(s) |= __MIR_STR_UTF8;
+    return 1;
+}
+
+int MIR_Str_ReserveByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, size_t capacity
+) {
+    void *data;
+    size_t size;
+    size_t newSize;
+    size_t len;
+    unsigned log2;
+
+    __MIR_ASSERT_MSG(reallocF != NULL, "param `reallocF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    if (capacity <= MIR_Str_Cap(s)) {
+        return MIR_Str_OK;
+    }
+    /* NOTE: `capacity + 1` (for '\0') rounded up to a power of two */
+    if (capacity > ((size_t)-1 >> 1)) {
+        return 1;
+    }
+    log2 = 64u - (unsigned)MIR_Bits_Clz64((uint64_t)capacity);
+    newSize = (size_t)1 << log2;
+
+    if (MIR_Str_IsInline(s)) {
+        data = NULL;
+        size = 0;
+    } else {
+        data = s->u.heap.data;
+        /* NOTE: both sizes are powers of two, so the allocation grows at
+         *       least twice, just like in `MIR_Vec_PushByReallocF` */
+        size = MIR_Str_Cap(s) + 1u;
+    }
+
+    if (__MIR_Vec_ReserveByReallocF_impl(reallocF, &data, &size, newSize, 1u) !=
+        MIR_Vec_OK) {
+        return 1;
+    }
+
+    if (MIR_Str_IsInline(s)) {
+        len = MIR_Str_Len(s);
+        memcpy(data, s->u.buf, len + 1u);
+        s->u.heap.len = len;
+    }
+    s->u.heap.data = (char *)data;
+    __MIR_STR_META(s) = (unsigned char)((log2 << 2) |
+                                        (__MIR_STR_META(s) & __MIR_STR_UTF8) |
+                                        __MIR_STR_HEAP);
+    return MIR_Str_OK;
+}
+
+int MIR_Str_AppendByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, const void *data,
+    size_t len
+) {
+    size_t oldLen;
+
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(
+        (data != NULL) || (len == 0u), "param `data' MUST NOT be NULL"
+    );
+
+    if (len == 0u) {
+        return MIR_Str_OK;
+    }
+    oldLen = MIR_Str_Len(s);
+    if (len > (size_t)-1 - oldLen ||
+        MIR_Str_ReserveByReallocF(reallocF, s, oldLen + len) != MIR_Str_OK) {
+        return 1;
+    }
+
+    memcpy(MIR_Str_Data(s) + oldLen, data, len);
+    SetLen(s, oldLen + len);
+    __MIR_STR_META(s) &= (unsigned char)~__MIR_STR_UTF8;
+    return MIR_Str_OK;
+}
+
+int MIR_Str_AppendStrByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s,
+    const struct MIR_Str *other
+) {
+    unsigned utf8;
+
+    __MIR_ASSERT_MSG(other != NULL, "param `other' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(s != other, "param `other' MUST NOT be `s'");
+
+    utf8 = __MIR_STR_META(s) & __MIR_STR_META(other) & __MIR_STR_UTF8;
+    if (MIR_Str_AppendByReallocF(
+            reallocF, s, ConstData(other), MIR_Str_Len(other)
+        ) != MIR_Str_OK) {
+        return 1;
+    }
+    __MIR_STR_META(s) |= (unsigned char)utf8;
+    return MIR_Str_OK;
+}
+
+int MIR_Str_PushByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, char c
+) {
+    unsigned utf8;
+
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    utf8 = ((unsigned char)c <= 0x7Fu) ? (__MIR_STR_META(s) & __MIR_STR_UTF8)
+                                       : 0u;
+    if (MIR_Str_AppendByReallocF(reallocF, s, &c, 1u) != MIR_Str_OK) {
+        return 1;
+    }
+    __MIR_STR_META(s) |= (unsigned char)utf8;
+    return MIR_Str_OK;
+}
+
+int MIR_Str_AppendUCPByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s, MIR_UCP cp
+) {
+    unsigned char buf[4];
+    size_t n;
+    unsigned utf8;
+
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    if (cp <= 0x7Fu) {
+        buf[0] = (unsigned char)cp;
+        n = 1;
+    } else if (cp <= 0x7FFu) {
+        buf[0] = (unsigned char)(0xC0u | (cp >> 6));
+        buf[1] = (unsigned char)(0x80u | (cp & 0x3Fu));
+        n = 2;
+    } else if (cp <= 0xFFFFu) {
+        if (MIR_InRange(cp, 0xD800u, 0xDFFFu)) {
+            return 1;
+        }
+        buf[0] = (unsigned char)(0xE0u | (cp >> 12));
+        buf[1] = (unsigned char)(0x80u | ((cp >> 6) & 0x3Fu));
+        buf[2] = (unsigned char)(0x80u | (cp & 0x3Fu));
+        n = 3;
+    } else if (cp <= 0x10FFFFu) {
+        buf[0] = (unsigned char)(0xF0u | (cp >> 18));
+        buf[1] = (unsigned char)(0x80u | ((cp >> 12) & 0x3Fu));
+        buf[2] = (unsigned char)(0x80u | ((cp >> 6) & 0x3Fu));
+        buf[3] = (unsigned char)(0x80u | (cp & 0x3Fu));
+        n = 4;
+    } else {
+        return 1;
+    }
+
+    utf8 = __MIR_STR_META(s) & __MIR_STR_UTF8;
+    if (MIR_Str_AppendByReallocF(reallocF, s, buf, n) != MIR_Str_OK) {
+        return 1;
+    }
+    __MIR_STR_META(s) |= (unsigned char)utf8;
+    return MIR_Str_OK;
+}
+
+int MIR_Str_FromBufIterByReallocF(
+    void *(*reallocF)(void *, size_t), struct MIR_Str *s,
+    const struct MIR_UTF8_BufIter *iter
+) {
+    __MIR_ASSERT_MSG(iter != NULL, "param `iter' MUST NOT be NULL");
+
+    MIR_Str_Init(s);
+    if (iter->cur == NULL) {
+        return MIR_Str_OK;
+    }
+    return MIR_Str_AppendByReallocF(
+        reallocF, s, iter->cur, (size_t)(iter->lim - iter->cur)
+    );
+}
+
+void MIR_Str_DeinitByFreeF(void (*freeF)(void *), struct MIR_Str *s) {
+    __MIR_ASSERT_MSG(freeF != NULL, "param `freeF' MUST NOT be NULL");
+    __MIR_ASSERT_MSG(s != NULL, "param `s' MUST NOT be NULL");
+
+    if (!MIR_Str_IsInline(s)) {
+        freeF(s->u.heap.data);
+    }
+    MIR_Str_Init(s);
+}
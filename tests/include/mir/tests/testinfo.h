@@ -12,7 +12,7 @@ typedef struct __tagMIR_TEST_TestInfo {
     int severity;
 } MIR_TEST_TestInfo;
 
-#define MIR_TEST_TEST_INFOS_LEN ((size_t)0)
+#define MIR_TEST_TEST_INFOS_LEN ((size_t)7)
 
 extern const MIR_TEST_TestInfo *MIR_TEST_TEST_INFOS[MIR_TEST_TEST_INFOS_LEN];
 
@@ -0,0 +1,367 @@
+#include <mir/tests/common.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mir/common/collections/art.h>
+
+
+#define MAX_KEY_LEN 48u
+#define MAX_KEYS 600u
+
+/* NOTE: longer than `MIR_ART_MAX_PREFIX', so that compressed paths are
+ *       compared optimistically and split past the stored bytes */
+static const char LONG_PREFIX[] = "shared-prefix-0123456789";
+
+struct Entry {
+    unsigned char key[MAX_KEY_LEN];
+    size_t len;
+    void *val;
+};
+
+/* NOTE: brute-force model of the tree */
+static struct Entry model[MAX_KEYS];
+static size_t modelLen;
+
+static uint64_t rngState;
+
+static uint64_t Rand(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static void *ValOf(size_t n) {
+    return (void *)(uintptr_t)(n * 2u + 2u);
+}
+
+static int KeyCmp(
+    const unsigned char *a, size_t aLen, const unsigned char *b, size_t bLen
+) {
+    size_t n = mir_test_min(aLen, bLen);
+    int res = (n > 0u) ? memcmp(a, b, n) : 0;
+
+    if (res != 0) {
+        return res;
+    }
+    return (aLen > bLen) - (aLen < bLen);
+}
+
+static int EntryCmp(const void *a, const void *b) {
+    const struct Entry *x = (const struct Entry *)a;
+    const struct Entry *y = (const struct Entry *)b;
+
+    return KeyCmp(x->key, x->len, y->key, y->len);
+}
+
+static struct Entry *ModelFind(const unsigned char *key, size_t len) {
+    size_t i;
+
+    for (i = 0; i < modelLen; ++i) {
+        if (KeyCmp(model[i].key, model[i].len, key, len) == 0) {
+            return &model[i];
+        }
+    }
+    return NULL;
+}
+
+/* NOTE: keys over a tiny alphabet (with `'\0'` and `0xff`), so that they
+ *       often share prefixes and are prefixes of each other */
+static size_t RandKey(unsigned char *key) {
+    static const unsigned char ALPHABET[4] = {'a', 'b', '\0', 0xffu};
+    size_t len = 0;
+    size_t n;
+
+    if (Rand() % 3u == 0u) {
+        len = Rand() % sizeof(LONG_PREFIX);
+        memcpy(key, LONG_PREFIX, len);
+    }
+    n = Rand() % 12u;
+    for (; n > 0u && len < MAX_KEY_LEN; --n) {
+        key[len++] = ALPHABET[Rand() % 4u];
+    }
+    return len;
+}
+
+static void CheckAll(struct MIR_Art *art) {
+    size_t i;
+    void **val;
+
+    TEST_ASSERT_EQUAL_size_t(modelLen, MIR_Art_Len(art));
+    for (i = 0; i < modelLen; ++i) {
+        val = MIR_Art_Find(art, model[i].key, model[i].len);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_PTR(model[i].val, *val);
+    }
+}
+
+static void CheckLongestPrefix(
+    struct MIR_Art *art, const unsigned char *key, size_t len
+) {
+    const struct Entry *best = NULL;
+    size_t prefixLen = (size_t)-1;
+    void **val;
+    size_t i;
+
+    for (i = 0; i < modelLen; ++i) {
+        if (model[i].len <= len &&
+            (best == NULL || model[i].len > best->len) &&
+            (model[i].len == 0u ||
+             memcmp(model[i].key, key, model[i].len) == 0)) {
+            best = &model[i];
+        }
+    }
+
+    val = MIR_Art_LongestPrefix(art, key, len, &prefixLen);
+    if (best == NULL) {
+        TEST_ASSERT_NULL(val);
+    } else {
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_PTR(best->val, *val);
+        TEST_ASSERT_EQUAL_size_t(best->len, prefixLen);
+    }
+}
+
+static void CheckPrefixIter(
+    struct MIR_Art *art, const unsigned char *prefix, size_t len
+) {
+    static struct Entry expected[MAX_KEYS];
+    struct MIR_Art_Iter it;
+    struct MIR_UTF8_BufIter key;
+    void *val;
+    size_t n = 0;
+    size_t i;
+
+    for (i = 0; i < modelLen; ++i) {
+        if (model[i].len >= len &&
+            (len == 0u || memcmp(model[i].key, prefix, len) == 0)) {
+            expected[n++] = model[i];
+        }
+    }
+    qsort(expected, n, sizeof(*expected), EntryCmp);
+
+    TEST_ASSERT_EQUAL_INT(
+        MIR_Art_OK, MIR_Art_PrefixIter(art, prefix, len, &it)
+    );
+    for (i = 0; i < n; ++i) {
+        TEST_ASSERT_EQUAL_INT(MIR_Art_OK, MIR_Art_IterNext(&it, &key, &val));
+        TEST_ASSERT_EQUAL_size_t(
+            expected[i].len, (size_t)(key.lim - key.cur)
+        );
+        TEST_ASSERT_EQUAL_MEMORY(expected[i].key, key.cur, expected[i].len);
+        TEST_ASSERT_EQUAL_PTR(expected[i].val, val);
+    }
+    TEST_ASSERT_EQUAL_INT(1, MIR_Art_IterNext(&it, NULL, NULL));
+    MIR_Art_IterDeinit(&it);
+}
+
+/* NOTE: size of the last block allocated by `RecordingRealloc' */
+static size_t lastAllocSize;
+
+static void *RecordingRealloc(void *ptr, size_t size) {
+    lastAllocSize = size;
+    return realloc(ptr, size);
+}
+
+static void Put(struct MIR_Art *art, const void *key, size_t len, void *val) {
+    struct Entry *e = ModelFind((const unsigned char *)key, len);
+
+    TEST_ASSERT_EQUAL_INT(MIR_Art_OK, MIR_Art_Put(art, key, len, val));
+    if (e == NULL) {
+        e = &model[modelLen++];
+        memcpy(e->key, key, len);
+        e->len = len;
+    }
+    e->val = val;
+}
+
+static void Remove(struct MIR_Art *art, const void *key, size_t len) {
+    struct Entry *e = ModelFind((const unsigned char *)key, len);
+    void *val = NULL;
+
+    if (e == NULL) {
+        TEST_ASSERT_EQUAL_INT(1, MIR_Art_Remove(art, key, len, &val));
+        return;
+    }
+    TEST_ASSERT_EQUAL_INT(MIR_Art_OK, MIR_Art_Remove(art, key, len, &val));
+    TEST_ASSERT_EQUAL_PTR(e->val, val);
+    TEST_ASSERT_NULL(MIR_Art_Find(art, key, len));
+    *e = model[--modelLen];
+}
+
+
+MIR_TEST_DEF(TEST_MAJOR, art_model) {
+    struct MIR_Art art;
+    unsigned char key[MAX_KEY_LEN];
+    size_t len;
+    size_t round;
+    size_t op;
+
+    rngState = 88172645463325252u;
+    modelLen = 0;
+    MIR_Art_Init(&art);
+
+    for (round = 0; round < 40u; ++round) {
+        /* NOTE: odd rounds mostly remove, so nodes shrink and merge back */
+        for (op = 0; op < 200u; ++op) {
+            len = RandKey(key);
+            if (Rand() % 4u < ((round % 2u == 0u) ? 3u : 1u)) {
+                if (modelLen < MAX_KEYS) {
+                    Put(&art, key, len, ValOf(round * 1000u + op));
+                }
+            } else if (modelLen > 0u && Rand() % 2u == 0u) {
+                struct Entry victim = model[Rand() % modelLen];
+                Remove(&art, victim.key, victim.len);
+            } else {
+                Remove(&art, key, len);
+            }
+        }
+
+        CheckAll(&art);
+        for (op = 0; op < 50u; ++op) {
+            len = RandKey(key);
+            TEST_ASSERT_TRUE(
+                (MIR_Art_Find(&art, key, len) == NULL) ==
+                (ModelFind(key, len) == NULL)
+            );
+            CheckLongestPrefix(&art, key, len);
+            CheckPrefixIter(&art, key, Rand() % (len + 1u));
+        }
+        CheckPrefixIter(&art, NULL, 0);
+    }
+
+    while (modelLen > 0u) {
+        Remove(&art, model[0].key, model[0].len);
+    }
+    CheckAll(&art);
+    TEST_ASSERT_NULL(art.root);
+    MIR_Art_Deinit(&art);
+}
+
+MIR_TEST_DEF(TEST_MAJOR, art_prefix_chain) {
+    struct MIR_Art art;
+    unsigned char key[MAX_KEY_LEN + 8u];
+    size_t i;
+
+    modelLen = 0;
+    MIR_Art_Init(&art);
+
+    /* NOTE: every key is a prefix of the next one, so there is an inner node
+     *       at every depth and the iterator stack is as deep as it can be */
+    memset(key, 'x', sizeof(key));
+    for (i = 0; i <= MAX_KEY_LEN; ++i) {
+        Put(&art, key, i, ValOf(i));
+    }
+    CheckAll(&art);
+    CheckPrefixIter(&art, NULL, 0);
+    CheckPrefixIter(&art, key, 1);
+    CheckPrefixIter(&art, key, 17);
+    CheckPrefixIter(&art, key, MAX_KEY_LEN);
+    CheckPrefixIter(&art, key, MAX_KEY_LEN + 1u);
+    CheckLongestPrefix(&art, key, sizeof(key));
+    CheckLongestPrefix(&art, key, 33);
+
+    /* NOTE: keys differing from a long compressed path at every position,
+     *       before and after the stored `MIR_ART_MAX_PREFIX' bytes */
+    for (i = 0; i < sizeof(LONG_PREFIX) - 1u; ++i) {
+        memcpy(key, LONG_PREFIX, sizeof(LONG_PREFIX) - 1u);
+        Put(&art, key, sizeof(LONG_PREFIX) - 1u, ValOf(100u));
+        key[i] = 'Z';
+        Put(&art, key, sizeof(LONG_PREFIX) - 1u, ValOf(200u + i));
+        CheckAll(&art);
+        CheckPrefixIter(&art, (const unsigned char *)LONG_PREFIX, i + 1u);
+        CheckLongestPrefix(&art, key, sizeof(LONG_PREFIX) - 1u);
+    }
+    CheckPrefixIter(&art, NULL, 0);
+
+    /* NOTE: removal order that splices the chain from the middle */
+    while (modelLen > 0u) {
+        i = modelLen / 2u;
+        memcpy(key, model[i].key, model[i].len);
+        Remove(&art, key, model[i].len);
+        CheckAll(&art);
+        CheckPrefixIter(&art, NULL, 0);
+    }
+    TEST_ASSERT_NULL(art.root);
+
+    /* NOTE: a removed long key doesn't make the iterator stack of a small
+     *       tree long */
+    {
+        static unsigned char longKey[4096];
+        struct MIR_Art_Iter it;
+
+        memset(longKey, 'y', sizeof(longKey));
+        /* NOTE: too long for the model */
+        TEST_ASSERT_EQUAL_INT(
+            MIR_Art_OK,
+            MIR_Art_Put(&art, longKey, sizeof(longKey), ValOf(1u))
+        );
+        Put(&art, longKey, 1, ValOf(2u));
+        TEST_ASSERT_EQUAL_INT(
+            MIR_Art_OK, MIR_Art_Remove(&art, longKey, sizeof(longKey), NULL)
+        );
+        Put(&art, "ya", 2, ValOf(3u));
+        Put(&art, "yb", 2, ValOf(4u));
+        TEST_ASSERT_EQUAL_INT(
+            MIR_Art_OK,
+            MIR_Art_PrefixIterByReallocF(RecordingRealloc, &art, NULL, 0, &it)
+        );
+        TEST_ASSERT_TRUE(
+            lastAllocSize <= MIR_Art_Len(&art) * sizeof(*it.frames)
+        );
+        MIR_Art_IterDeinit(&it);
+        CheckPrefixIter(&art, NULL, 0);
+    }
+    MIR_Art_Deinit(&art);
+}
+
+MIR_TEST_DEF(TEST_MAJOR, art_grow_shrink) {
+    struct MIR_Art art;
+    unsigned char key[2];
+    size_t order[256];
+    size_t i;
+    size_t j;
+    size_t tmp;
+
+    rngState = 2463534242u;
+    modelLen = 0;
+    MIR_Art_Init(&art);
+
+    /* NOTE: one node with a key ending at it and 256 children, grown through
+     *       all four layouts and shrunk back */
+    key[0] = 'k';
+    Put(&art, key, 1, ValOf(256u));
+    for (i = 0; i < 256u; ++i) {
+        key[1] = (unsigned char)i;
+        Put(&art, key, 2, ValOf(i));
+        if (i == 3u || i == 15u || i == 47u || i == 255u) {
+            CheckAll(&art);
+            CheckPrefixIter(&art, key, 1);
+        }
+    }
+
+    for (i = 0; i < 256u; ++i) {
+        order[i] = i;
+    }
+    for (i = 255u; i > 0u; --i) {
+        j = (size_t)(Rand() % (i + 1u));
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (i = 0; i < 256u; ++i) {
+        key[1] = (unsigned char)order[i];
+        Remove(&art, key, 2);
+        if (i % 8u == 0u || i > 250u) {
+            CheckAll(&art);
+            CheckPrefixIter(&art, key, 1);
+            CheckLongestPrefix(&art, key, 2);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(1, MIR_Art_Len(&art));
+    Remove(&art, key, 1);
+    TEST_ASSERT_NULL(art.root);
+    MIR_Art_Deinit(&art);
+}
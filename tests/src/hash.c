@@ -0,0 +1,73 @@
+#include <mir/tests/common.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <mir/common/hash.h>
+
+
+/* NOTE: for a seed-independent hash, inputs that zero one multiplicand of a
+ *       round collide under every seed. Here it's the first word of a
+ *       16-byte block equal to the secret it's xored with */
+MIR_TEST_DEF(TEST_VITAL, hash_flooding) {
+    static const uint64_t SEEDS[3] = {1u, 2u, 3u};
+    unsigned char key[3][32];
+    uint64_t h[3][3];
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < 3u; ++i) {
+        memset(key[i], 0, sizeof(key[i]));
+        for (j = 0; j < 8u; ++j) {
+            key[i][j] = (unsigned char)(__MIR_HASH_SECRET1 >> (8u * j));
+        }
+        key[i][8] = (unsigned char)i;
+    }
+
+    for (i = 0; i < 3u; ++i) {
+        for (j = 0; j < 3u; ++j) {
+            h[i][j] = MIR_Hash_Bytes(key[j], sizeof(key[j]), SEEDS[i]);
+        }
+        TEST_ASSERT_TRUE(h[i][0] != h[i][1]);
+        TEST_ASSERT_TRUE(h[i][0] != h[i][2]);
+        TEST_ASSERT_TRUE(h[i][1] != h[i][2]);
+    }
+    for (j = 0; j < 3u; ++j) {
+        TEST_ASSERT_TRUE(h[0][j] != h[1][j]);
+        TEST_ASSERT_TRUE(h[0][j] != h[2][j]);
+        TEST_ASSERT_TRUE(h[1][j] != h[2][j]);
+    }
+
+    /* NOTE: the same for the integer mixer and the secret it's xored with */
+    for (i = 0; i < 3u; ++i) {
+        TEST_ASSERT_TRUE(MIR_Hash_U64(__MIR_HASH_SECRET0, SEEDS[i]) != 0u);
+        TEST_ASSERT_TRUE(
+            MIR_Hash_U64(__MIR_HASH_SECRET0, SEEDS[i]) !=
+            MIR_Hash_U64(__MIR_HASH_SECRET0, SEEDS[(i + 1u) % 3u])
+        );
+    }
+}
+
+/* NOTE: the vectors documented in `mir/common/hash.h' */
+MIR_TEST_DEF(TEST_VITAL, hash_vectors) {
+    static const struct {
+        const char *input;
+        uint64_t hash;
+    } BYTES[] = {
+        {"", 0xa6dc601bc3257c4bu},
+        {"a", 0x8c83531b1eda0096u},
+        {"abc", 0x77af92db2746f1aeu},
+        {"message digest", 0xda5621b998be86b2u},
+        {"abcdefghijklmnopqrstuvwxyz", 0x5e08f8efd5913e34u},
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(BYTES) / sizeof(BYTES[0]); ++i) {
+        TEST_ASSERT_EQUAL_UINT64(
+            BYTES[i].hash,
+            MIR_Hash_Bytes(BYTES[i].input, strlen(BYTES[i].input), 0)
+        );
+    }
+    TEST_ASSERT_EQUAL_UINT64(0xca813bf4c7abf0a9u, MIR_Hash_U64(0, 0));
+    TEST_ASSERT_EQUAL_UINT64(0x0193556b07301504u, MIR_Hash_U64(1, 0));
+}
@@ -1,9 +1,27 @@
 #include <mir/tests/testinfo.h>
 
+#include <mir/tests/common.h>
+
 
 #define INFO_OF(name) __MIR_TEST_INFO_##name
 
 
+MIR_TEST_DECL(art_grow_shrink);
+MIR_TEST_DECL(art_model);
+MIR_TEST_DECL(art_prefix_chain);
+MIR_TEST_DECL(hash_flooding);
+MIR_TEST_DECL(hash_vectors);
+MIR_TEST_DECL(threadpool_nested);
+MIR_TEST_DECL(threadpool_ranges);
+
+
 const MIR_TEST_TestInfo *MIR_TEST_TEST_INFOS[MIR_TEST_TEST_INFOS_LEN] = {
     /* WARNING: KEEP IT SORTED! */
+    &INFO_OF(art_grow_shrink),
+    &INFO_OF(art_model),
+    &INFO_OF(art_prefix_chain),
+    &INFO_OF(hash_flooding),
+    &INFO_OF(hash_vectors),
+    &INFO_OF(threadpool_nested),
+    &INFO_OF(threadpool_ranges),
 };
@@ -0,0 +1,152 @@
+#include <mir/tests/common.h>
+
+#include <stddef.h>
+
+#include <mir/common/concurrent/threadpool.h>
+#include <mir/common/env.h>
+
+#ifdef MIR_HAS_PTHREADS
+#    include <mir/common/atomic.h>
+#    include <mir/common/collections/arr.h>
+
+
+#    define NTHREADS 4u
+#    define ROUNDS 8u
+#    define OUTER 64u
+#    define INNER 500u
+#    define INNER_GRAIN 7u
+
+/* NOTE: how many times every index has been visited */
+static MIR_Atomic(unsigned) visits[OUTER * INNER];
+
+MIR_Arr(MIR_Atomic(unsigned), Visits);
+
+static struct MIR_ThreadPool pool;
+
+static void Visit(void *ctx, size_t begin, size_t end) {
+    MIR_Atomic(unsigned) *row = (MIR_Atomic(unsigned) *)ctx;
+
+    for (; begin < end; ++begin) {
+        MIR_Atomic_FetchAdd(&row[begin], 1u, MIR_ATOMIC_RELAXED);
+    }
+}
+
+static void VisitRows(void *ctx, size_t begin, size_t end) {
+    (void)ctx;
+
+    /* NOTE: a nested loop per outer index, run by whichever thread got it */
+    for (; begin < end; ++begin) {
+        MIR_ThreadPool_ParallelFor(
+            &pool, 0, INNER, INNER_GRAIN, Visit, &visits[begin * INNER]
+        );
+    }
+}
+
+static void ResetVisits(size_t len) {
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        MIR_Atomic_Store(&visits[i], 0u, MIR_ATOMIC_RELAXED);
+    }
+}
+
+static void CheckVisits(size_t from, size_t to, size_t len) {
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        TEST_ASSERT_EQUAL_UINT(
+            (from <= i && i < to) ? 1u : 0u,
+            MIR_Atomic_Load(&visits[i], MIR_ATOMIC_RELAXED)
+        );
+    }
+}
+#endif /* MIR_HAS_PTHREADS */
+
+
+MIR_TEST_DEF(TEST_MAJOR, threadpool_nested) {
+#ifdef MIR_HAS_PTHREADS
+    struct MIR_ThreadPool_Stats stats;
+    size_t tasks = 0;
+    size_t workerTasks = 0;
+    size_t steals = 0;
+    size_t round;
+    size_t i;
+
+    TEST_ASSERT_EQUAL_INT(
+        MIR_ThreadPool_OK, MIR_ThreadPool_Init(&pool, NTHREADS)
+    );
+
+    for (round = 0; round < ROUNDS; ++round) {
+        ResetVisits(OUTER * INNER);
+        MIR_ThreadPool_ParallelFor(&pool, 0, OUTER, 1, VisitRows, NULL);
+        CheckVisits(0, OUTER * INNER, OUTER * INNER);
+    }
+
+    /* NOTE: every outer index is a range of its own and every inner loop is
+     *       split into ranges of at most `INNER_GRAIN' indices */
+    for (i = 0; i <= pool.nthreads; ++i) {
+        MIR_ThreadPool_GetStats(&pool, i, &stats);
+        tasks += stats.tasks;
+        if (i < pool.nthreads) {
+            workerTasks += stats.tasks;
+            steals += stats.steals;
+        }
+    }
+    TEST_ASSERT_TRUE(
+        tasks >=
+        ROUNDS * OUTER * (1u + (INNER + INNER_GRAIN - 1u) / INNER_GRAIN)
+    );
+    /* NOTE: the loops are started by this thread, so workers get ranges only
+     *       by stealing them */
+    TEST_ASSERT_TRUE(workerTasks == 0u || steals > 0u);
+
+    MIR_ThreadPool_Deinit(&pool);
+#else
+    TEST_IGNORE_MESSAGE("no POSIX threads");
+#endif
+}
+
+MIR_TEST_DEF(TEST_MAJOR, threadpool_ranges) {
+#ifdef MIR_HAS_PTHREADS
+    static const size_t RANGES[][3] = {
+        /* begin, end, grain */
+        {0, 0, 1},       {5, 5, 1},       {7, 3, 1},     {0, 1, 1},
+        {3, 1000, 0},    {3, 1000, 1},    {0, 997, 13},  {100, 4000, 64},
+        {1, 4000, 3999}, {0, 4000, 4000}, {0, 4000, 1u << 20},
+    };
+    struct Visits arr;
+    size_t r;
+
+    TEST_ASSERT_EQUAL_INT(
+        MIR_ThreadPool_OK, MIR_ThreadPool_Init(&pool, NTHREADS)
+    );
+
+    for (r = 0; r < sizeof(RANGES) / sizeof(RANGES[0]); ++r) {
+        ResetVisits(OUTER * INNER);
+        MIR_ThreadPool_ParallelFor(
+            &pool, RANGES[r][0], RANGES[r][1], RANGES[r][2], Visit, visits
+        );
+        CheckVisits(RANGES[r][0], RANGES[r][1], OUTER * INNER);
+
+        ResetVisits(OUTER * INNER);
+        MIR_ThreadPool_ParallelFor(
+            NULL, RANGES[r][0], RANGES[r][1], RANGES[r][2], Visit, visits
+        );
+        CheckVisits(RANGES[r][0], RANGES[r][1], OUTER * INNER);
+    }
+
+    /* NOTE: `MIR_PARALLEL_FOR' runs on the default pool */
+    arr.data = visits;
+    arr.len = 3000;
+    MIR_ThreadPool_SetDefault(&pool);
+    TEST_ASSERT_EQUAL_PTR(&pool, MIR_ThreadPool_GetDefault());
+    ResetVisits(OUTER * INNER);
+    MIR_PARALLEL_FOR(&arr, 16, Visit, arr.data);
+    CheckVisits(0, arr.len, OUTER * INNER);
+    MIR_ThreadPool_SetDefault(NULL);
+
+    MIR_ThreadPool_Deinit(&pool);
+#else
+    TEST_IGNORE_MESSAGE("no POSIX threads");
+#endif
+}
@@ -1,3 +1,12 @@
 function(mir_test_add test_name)
     add_test(NAME ${test_name} COMMAND libmirtestdriver "--test=${test_name}")
 endfunction()
+
+
+mir_test_add(art_grow_shrink)
+mir_test_add(art_model)
+mir_test_add(art_prefix_chain)
+mir_test_add(hash_flooding)
+mir_test_add(hash_vectors)
+mir_test_add(threadpool_nested)
+mir_test_add(threadpool_ranges)